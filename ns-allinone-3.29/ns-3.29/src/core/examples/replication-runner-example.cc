@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+/**
+ * \file
+ * \ingroup core-examples
+ * Example program illustrating use of ns3::ReplicationRunner
+ *
+ * The scenario, a single queue fed by exponential arrivals, is built
+ * once; each replication then runs in its own process with its own
+ * run number.  For instance
+ *
+ * `./waf --run "replication-runner-example --replications=8 --jobs=4 --RngRun=10"`
+ *
+ * runs replications 10 to 17, four at a time, prints their outputs in
+ * run order and writes the mean waiting time of every run, one per
+ * line, to `replication-runner-example.txt`.
+ */
+
+using namespace ns3;
+
+namespace {
+
+/** A single-server queue with exponential arrivals and service times. */
+class Queue
+{
+public:
+  Queue ()
+    : m_busyUntil (Seconds (0)),
+      m_waiting (Seconds (0)),
+      m_customers (0)
+  {
+    m_arrival = CreateObject<ExponentialRandomVariable> ();
+    m_arrival->SetAttribute ("Mean", DoubleValue (1.0));
+    m_service = CreateObject<ExponentialRandomVariable> ();
+    m_service->SetAttribute ("Mean", DoubleValue (0.8));
+  }
+  /** Start the arrivals. */
+  void Start (void)
+  {
+    Simulator::Schedule (Seconds (m_arrival->GetValue ()), &Queue::Arrive, this);
+  }
+  /** \return The mean waiting time, in seconds. */
+  double GetMeanWaiting (void) const
+  {
+    return m_customers ? m_waiting.GetSeconds () / m_customers : 0;
+  }
+  /** \return The number of served customers. */
+  uint32_t GetCustomers (void) const
+  {
+    return m_customers;
+  }
+private:
+  /** Handle an arrival. */
+  void Arrive (void)
+  {
+    Time now = Simulator::Now ();
+    Time start = std::max (now, m_busyUntil);
+    m_waiting += start - now;
+    m_busyUntil = start + Seconds (m_service->GetValue ());
+    m_customers++;
+    Start ();
+  }
+
+  Ptr<ExponentialRandomVariable> m_arrival;  //!< Inter-arrival times
+  Ptr<ExponentialRandomVariable> m_service;  //!< Service times
+  Time m_busyUntil;                          //!< End of the current service
+  Time m_waiting;                            //!< Total waiting time
+  uint32_t m_customers;                      //!< Number of arrivals
+};
+
+}  // unnamed namespace
+
+
+int main (int argc, char *argv[])
+{
+  double duration = 10000;
+  ReplicationRunner runner;
+  runner.SetReplications (4);
+
+  CommandLine cmd;
+  cmd.AddValue ("duration", "Simulated time of each replication, in seconds", duration);
+  runner.AddCommandLineArguments (cmd);
+  cmd.Parse (argc, argv);
+
+  std::string stats = "replication-runner-example.txt";
+  runner.AddAggregatedFile (stats);
+
+  Queue queue;
+  queue.Start ();
+  Simulator::Stop (Seconds (duration));
+
+  if (!runner.Run ())
+    {
+      Simulator::Destroy ();
+      return runner.GetFailedReplications ();
+    }
+
+  std::cout << queue.GetCustomers () << " customers, mean waiting time "
+            << queue.GetMeanWaiting () << " s" << std::endl;
+  std::ofstream out (runner.GetFilename (stats).c_str ());
+  out << runner.GetRun () << " " << queue.GetMeanWaiting () << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
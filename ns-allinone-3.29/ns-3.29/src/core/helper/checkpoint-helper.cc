@@ -0,0 +1,223 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "checkpoint-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup core-helpers
+ * ns3::CheckpointHelper implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CheckpointHelper");
+
+CheckpointHelper::CheckpointHelper ()
+  : m_branches (1),
+    m_maxParallel (0),
+    m_firstRun (1),
+    m_firstRunSet (false),
+    m_reseed (true),
+    m_isBranch (false),
+    m_branch (0),
+    m_failed (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CheckpointHelper::SetBranches (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ABORT_MSG_IF (n == 0, "A checkpoint needs at least one branch");
+  m_branches = n;
+}
+
+void
+CheckpointHelper::SetMaxParallel (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  m_maxParallel = n;
+}
+
+void
+CheckpointHelper::SetFirstRun (uint64_t run)
+{
+  NS_LOG_FUNCTION (this << run);
+  m_firstRun = run;
+  m_firstRunSet = true;
+}
+
+void
+CheckpointHelper::SetReseed (bool reseed)
+{
+  NS_LOG_FUNCTION (this << reseed);
+  m_reseed = reseed;
+}
+
+void
+CheckpointHelper::SetBranchCallback (Callback<void, uint32_t> cb)
+{
+  NS_LOG_FUNCTION (this << &cb);
+  m_branchCallback = cb;
+}
+
+void
+CheckpointHelper::Schedule (Time at)
+{
+  NS_LOG_FUNCTION (this << at);
+  NS_ABORT_MSG_IF (at < Simulator::Now (), "Checkpoint time is in the past");
+  if (!m_firstRunSet)
+    {
+      m_firstRun = RngSeedManager::GetRun ();
+    }
+  Simulator::Schedule (at - Simulator::Now (), &CheckpointHelper::Fork, this);
+}
+
+bool
+CheckpointHelper::IsBranch (void) const
+{
+  return m_isBranch;
+}
+
+uint32_t
+CheckpointHelper::GetBranch (void) const
+{
+  return m_branch;
+}
+
+uint32_t
+CheckpointHelper::GetFailedBranches (void) const
+{
+  return m_failed;
+}
+
+void
+CheckpointHelper::Fork (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_UNLESS (Simulator::GetImplementation ()->GetInstanceTypeId ()
+                       == DefaultSimulatorImpl::GetTypeId (),
+                       "Only ns3::DefaultSimulatorImpl can be checkpointed");
+
+  // Buffered output would otherwise be written once per branch.
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::fflush (0);
+
+  m_failed = 0;
+  std::set<pid_t> running;
+  for (uint32_t i = 0; i < m_branches; ++i)
+    {
+      while (m_maxParallel != 0 && running.size () >= m_maxParallel)
+        {
+          WaitOne (running);
+        }
+      pid_t pid = fork ();
+      NS_ABORT_MSG_IF (pid < 0, "fork() failed: " << std::strerror (errno));
+      if (pid == 0)
+        {
+          m_isBranch = true;
+          m_branch = i;
+          if (m_reseed)
+            {
+              RngSeedManager::SetRun (m_firstRun + i);
+              RandomVariableStream::ReseedAll ();
+            }
+          NS_LOG_INFO ("Branch " << i << " continuing from " << Simulator::Now ().As (Time::S));
+          if (!m_branchCallback.IsNull ())
+            {
+              m_branchCallback (i);
+            }
+          return;
+        }
+      running.insert (pid);
+    }
+
+  while (!running.empty ())
+    {
+      WaitOne (running);
+    }
+  Simulator::Stop ();
+}
+
+void
+CheckpointHelper::WaitOne (std::set<pid_t> &running)
+{
+  NS_LOG_FUNCTION (this << running.size ());
+  // Only reap our branches: the other children of the process (e.g.,
+  // forked by the user) are left to their owner.
+  bool block = false;
+  while (true)
+    {
+      for (std::set<pid_t>::iterator it = running.begin (); it != running.end (); ++it)
+        {
+          int status;
+          pid_t pid = waitpid (*it, &status, block ? 0 : WNOHANG);
+          if (pid == *it)
+            {
+              running.erase (it);
+              if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+                {
+                  NS_LOG_WARN ("Branch process " << pid << " failed");
+                  m_failed++;
+                }
+              return;
+            }
+          NS_ABORT_MSG_IF (pid < 0 && errno != EINTR, "waitpid() failed: " << std::strerror (errno));
+          if (block)
+            {
+              break;
+            }
+        }
+      if (block)
+        {
+          // Interrupted by a signal.
+          continue;
+        }
+      // Sleep until a child exits, without reaping it.
+      siginfo_t info;
+      std::memset (&info, 0, sizeof (info));
+      if (waitid (P_ALL, 0, &info, WEXITED | WNOWAIT) < 0)
+        {
+          NS_ABORT_MSG_IF (errno != EINTR, "waitid() failed: " << std::strerror (errno));
+        }
+      else if (running.find (info.si_pid) == running.end ())
+        {
+          // A child we did not fork has exited; it stays a zombie until
+          // its owner reaps it, so waitid() would keep returning it.
+          // Block on one of our branches instead.
+          block = true;
+        }
+    }
+}
+
+} // namespace ns3
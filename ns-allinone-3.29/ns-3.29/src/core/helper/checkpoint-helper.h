@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef CHECKPOINT_HELPER_H
+#define CHECKPOINT_HELPER_H
+
+#include <set>
+#include <sys/types.h>
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
+
+/**
+ * \file
+ * \ingroup core-helpers
+ * ns3::CheckpointHelper declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup core-helpers
+ *
+ * \brief Branch a running simulation into several processes at a
+ * checkpoint time.
+ *
+ * Scenarios often spend their first simulated seconds on association,
+ * routing convergence or TCP slow start before the measurement window
+ * opens.  Instead of paying for that warm-up in every replication,
+ * the simulation runs once up to the checkpoint; there the process
+ * image, which holds the complete simulation state (scheduler contents,
+ * objects, packet queues and RNG streams), is fork()ed once per branch.
+ *
+ * Each branch continues the event loop from the checkpoint.  Unless
+ * disabled with SetReseed(), branch \c i first sets
+ * \ref GlobalValueRngRun "RngRun" to <tt>firstRun + i</tt> and calls
+ * RandomVariableStream::ReseedAll, so branches are independent
+ * replications of the measurement window.  The branch callback then
+ * runs in the branch process and can change parameters, open output
+ * files or schedule extra events.
+ *
+ * The process holding the checkpoint waits for all branches to exit
+ * and then stops its own simulation, so after Simulator::Run returns
+ * the scenario must check IsBranch() before producing any output:
+ *
+ * \code
+ *   CheckpointHelper checkpoint;
+ *   checkpoint.SetBranches (8);
+ *   checkpoint.Schedule (Seconds (60));
+ *   Simulator::Stop (Seconds (120));
+ *   Simulator::Run ();
+ *   if (!checkpoint.IsBranch ())
+ *     {
+ *       Simulator::Destroy ();
+ *       return checkpoint.GetFailedBranches ();
+ *     }
+ *   // report the results of branch checkpoint.GetBranch ()
+ * \endcode
+ *
+ * Only the single-threaded ns3::DefaultSimulatorImpl can be branched.
+ * File descriptors (sockets, pcap and ascii traces) opened before the
+ * checkpoint are shared by all branches; open per-branch outputs from
+ * the branch callback instead.
+ *
+ * The checkpoint lives in memory only: it cannot be written to a file
+ * and restored by an unrelated process, since scheduled events hold
+ * arbitrary callbacks which have no serialized form.
+ */
+class CheckpointHelper
+{
+public:
+  CheckpointHelper ();
+
+  /**
+   * \brief Set the number of branches forked at the checkpoint.
+   * \param [in] n The number of branches.
+   */
+  void SetBranches (uint32_t n);
+
+  /**
+   * \brief Set the maximum number of branches running at the same time.
+   *
+   * Further branches are forked as running ones exit.
+   * \param [in] n The maximum number of concurrent branches; 0 (default)
+   * runs all branches at once.
+   */
+  void SetMaxParallel (uint32_t n);
+
+  /**
+   * \brief Set the run number of the first branch.
+   *
+   * By default the first branch uses the run number current when
+   * Schedule() is called.
+   * \param [in] run The run number of branch 0.
+   */
+  void SetFirstRun (uint64_t run);
+
+  /**
+   * \brief Set whether branches restart the RNG streams.
+   * \param [in] reseed If \c true (default), each branch draws from
+   * its own run number after the checkpoint.
+   */
+  void SetReseed (bool reseed);
+
+  /**
+   * \brief Set the callback invoked in each branch right after the fork.
+   * \param [in] cb The callback, given the branch index.
+   */
+  void SetBranchCallback (Callback<void, uint32_t> cb);
+
+  /**
+   * \brief Schedule the checkpoint.
+   * \param [in] at The absolute simulation time of the checkpoint.
+   */
+  void Schedule (Time at);
+
+  /**
+   * \brief Check whether this process is one of the branches.
+   * \return \c true in a branch process, \c false in the process which
+   * holds the checkpoint, or if the checkpoint was never reached.
+   */
+  bool IsBranch (void) const;
+
+  /**
+   * \brief Get the index of this branch.
+   * \return The branch index, in [0, n).
+   */
+  uint32_t GetBranch (void) const;
+
+  /**
+   * \brief Get the number of branches which did not exit successfully.
+   *
+   * Only meaningful in the process holding the checkpoint.
+   * \return The number of failed branches.
+   */
+  uint32_t GetFailedBranches (void) const;
+
+private:
+  /** Fork the branches; executed at the checkpoint time. */
+  void Fork (void);
+
+  /**
+   * Wait for one branch to exit.
+   * \param [in,out] running The process ids of the running branches.
+   */
+  void WaitOne (std::set<pid_t> &running);
+
+  uint32_t m_branches;                    //!< Number of branches
+  uint32_t m_maxParallel;                 //!< Maximum concurrent branches
+  uint64_t m_firstRun;                    //!< Run number of branch 0
+  bool m_firstRunSet;                     //!< SetFirstRun() was called
+  bool m_reseed;                          //!< Restart RNG streams in branches
+  Callback<void, uint32_t> m_branchCallback; //!< Invoked in each branch
+  bool m_isBranch;                        //!< This process is a branch
+  uint32_t m_branch;                      //!< Index of this branch
+  uint32_t m_failed;                      //!< Number of failed branches
+};
+
+} // namespace ns3
+
+#endif /* CHECKPOINT_HELPER_H */
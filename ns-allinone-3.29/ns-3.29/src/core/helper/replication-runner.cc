@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "replication-runner.h"
+#include "ns3/simulator.h"
+#include "ns3/command-line.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup core-helpers
+ * ns3::ReplicationRunner implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReplicationRunner");
+
+ReplicationRunner::ReplicationRunner ()
+  : m_replications (1),
+    m_jobs (0),
+    m_prefix ("replication"),
+    m_firstRun (1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ReplicationRunner::AddCommandLineArguments (CommandLine &cmd)
+{
+  NS_LOG_FUNCTION (this << &cmd);
+  cmd.AddValue ("replications", "Number of independent replications, starting at RngRun", m_replications);
+  cmd.AddValue ("jobs", "Maximum number of replications run in parallel (0 for one per processor)", m_jobs);
+  cmd.AddValue ("replicationPrefix", "Prefix of the per-replication output files", m_prefix);
+}
+
+void
+ReplicationRunner::SetReplications (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  m_replications = n;
+}
+
+void
+ReplicationRunner::SetJobs (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  m_jobs = n;
+}
+
+void
+ReplicationRunner::SetOutputPrefix (std::string prefix)
+{
+  NS_LOG_FUNCTION (this << prefix);
+  m_prefix = prefix;
+}
+
+void
+ReplicationRunner::AddAggregatedFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_aggregated.push_back (filename);
+}
+
+std::string
+ReplicationRunner::GetRunFilename (std::string filename, uint64_t run)
+{
+  std::ostringstream oss;
+  oss << filename << "-run" << run;
+  return oss.str ();
+}
+
+std::string
+ReplicationRunner::GetFilename (std::string filename) const
+{
+  if (!m_checkpoint.IsBranch ())
+    {
+      return filename;
+    }
+  return GetRunFilename (filename, GetRun ());
+}
+
+uint64_t
+ReplicationRunner::GetRun (void) const
+{
+  return m_firstRun + m_checkpoint.GetBranch ();
+}
+
+uint32_t
+ReplicationRunner::GetFailedReplications (void) const
+{
+  return m_checkpoint.GetFailedBranches ();
+}
+
+bool
+ReplicationRunner::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_replications == 0, "Nothing to run");
+  uint32_t jobs = m_jobs;
+  if (jobs == 0)
+    {
+      long cpus = sysconf (_SC_NPROCESSORS_ONLN);
+      jobs = cpus > 0 ? static_cast<uint32_t> (cpus) : 1;
+    }
+  m_firstRun = RngSeedManager::GetRun ();
+
+  m_checkpoint.SetBranches (m_replications);
+  m_checkpoint.SetMaxParallel (jobs);
+  m_checkpoint.SetFirstRun (m_firstRun);
+  m_checkpoint.SetBranchCallback (MakeCallback (&ReplicationRunner::StartWorker, this));
+  m_checkpoint.Schedule (Simulator::Now ());
+  NS_LOG_INFO ("Running " << m_replications << " replications from run "
+                          << m_firstRun << " on " << jobs << " workers");
+  Simulator::Run ();
+  if (m_checkpoint.IsBranch ())
+    {
+      return true;
+    }
+  Aggregate ();
+  return false;
+}
+
+void
+ReplicationRunner::StartWorker (uint32_t replication)
+{
+  NS_LOG_FUNCTION (this << replication);
+  std::string filename = GetRunFilename (m_prefix, m_firstRun + replication) + ".out";
+  int fd = open (filename.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  NS_ABORT_MSG_IF (fd < 0, "Could not open " << filename << ": " << std::strerror (errno));
+  dup2 (fd, STDOUT_FILENO);
+  close (fd);
+}
+
+void
+ReplicationRunner::Aggregate (void) const
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_replications; ++i)
+    {
+      uint64_t run = m_firstRun + i;
+      std::string filename = GetRunFilename (m_prefix, run) + ".out";
+      std::ifstream in (filename.c_str ());
+      std::cout << "# RngRun " << run << std::endl;
+      if (in.good () && in.peek () != std::ifstream::traits_type::eof ())
+        {
+          std::cout << in.rdbuf ();
+        }
+    }
+  std::cout.flush ();
+
+  for (std::vector<std::string>::const_iterator f = m_aggregated.begin (); f != m_aggregated.end (); ++f)
+    {
+      std::ofstream out (f->c_str ());
+      NS_ABORT_MSG_UNLESS (out.good (), "Could not open " << *f);
+      for (uint32_t i = 0; i < m_replications; ++i)
+        {
+          std::ifstream in (GetRunFilename (*f, m_firstRun + i).c_str ());
+          if (in.good () && in.peek () != std::ifstream::traits_type::eof ())
+            {
+              out << in.rdbuf ();
+            }
+          else
+            {
+              NS_LOG_WARN ("No " << *f << " output for run " << m_firstRun + i);
+            }
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+#include <string>
+#include <vector>
+#include "ns3/checkpoint-helper.h"
+
+/**
+ * \file
+ * \ingroup core-helpers
+ * ns3::ReplicationRunner declaration.
+ */
+
+namespace ns3 {
+
+class CommandLine;
+
+/**
+ * \ingroup core-helpers
+ *
+ * \brief Run independent replications of a scenario in parallel
+ * worker processes.
+ *
+ * The scenario is built once; Run() then fork()s one worker per
+ * replication, at most \c jobs of them at a time.  Worker \c i sets
+ * \ref GlobalValueRngRun "RngRun" to <tt>firstRun + i</tt>, restarts
+ * the RNG streams and runs the simulation to completion.  Its standard
+ * output is redirected to <tt>prefix-run\<run\>.out</tt>; once all
+ * workers are done, the parent prints those files in run order, each
+ * after a <tt># RngRun \<run\></tt> line.  Statistics files registered
+ * with AddAggregatedFile() are written by each worker under
+ * GetFilename() and concatenated by the parent in the same order.
+ *
+ * \code
+ *   ReplicationRunner runner;
+ *   CommandLine cmd;
+ *   runner.AddCommandLineArguments (cmd);
+ *   cmd.Parse (argc, argv);
+ *   runner.AddAggregatedFile ("delay.txt");
+ *   // build the scenario
+ *   Simulator::Stop (Seconds (10));
+ *   if (!runner.Run ())
+ *     {
+ *       Simulator::Destroy ();
+ *       return runner.GetFailedReplications ();
+ *     }
+ *   std::ofstream delay (runner.GetFilename ("delay.txt").c_str ());
+ *   // report the results of replication runner.GetRun ()
+ *   Simulator::Destroy ();
+ * \endcode
+ *
+ * The first run number defaults to the \ref GlobalValueRngRun "RngRun"
+ * current when Run() is called, so <tt>--RngRun=100 --replications=50</tt>
+ * executes runs 100 to 149.
+ */
+class ReplicationRunner
+{
+public:
+  ReplicationRunner ();
+
+  /**
+   * \brief Register the \c replications, \c jobs and \c replicationPrefix
+   * arguments.
+   * \param [in,out] cmd The command line.
+   */
+  void AddCommandLineArguments (CommandLine &cmd);
+
+  /**
+   * \brief Set the number of replications.
+   * \param [in] n The number of replications.
+   */
+  void SetReplications (uint32_t n);
+
+  /**
+   * \brief Set the maximum number of concurrent workers.
+   * \param [in] n The number of workers; 0 (default) uses one per
+   * online processor.
+   */
+  void SetJobs (uint32_t n);
+
+  /**
+   * \brief Set the prefix of the per-replication output files.
+   * \param [in] prefix The file name prefix.
+   */
+  void SetOutputPrefix (std::string prefix);
+
+  /**
+   * \brief Register a file to be aggregated across replications.
+   * \param [in] filename The name of the aggregated file.
+   */
+  void AddAggregatedFile (std::string filename);
+
+  /**
+   * \brief Get the name under which this process writes a file.
+   * \param [in] filename The name of the aggregated file.
+   * \return In a worker, the per-replication name of \p filename;
+   * \p filename itself otherwise.
+   */
+  std::string GetFilename (std::string filename) const;
+
+  /**
+   * \brief Run all replications.
+   * \return \c true in a worker, after its simulation completed;
+   * \c false in the parent, after all workers exited and their output
+   * was aggregated.
+   */
+  bool Run (void);
+
+  /**
+   * \brief Get the run number of this worker.
+   * \return The run number.
+   */
+  uint64_t GetRun (void) const;
+
+  /**
+   * \brief Get the number of replications which did not exit successfully.
+   * \return The number of failed replications.
+   */
+  uint32_t GetFailedReplications (void) const;
+
+private:
+  /**
+   * Redirect the standard output of a worker.
+   * \param [in] replication The replication index.
+   */
+  void StartWorker (uint32_t replication);
+
+  /**
+   * Get the per-replication name of a file.
+   * \param [in] filename The base file name.
+   * \param [in] run The run number.
+   * \return The file name.
+   */
+  static std::string GetRunFilename (std::string filename, uint64_t run);
+
+  /** Concatenate the worker outputs, in run order. */
+  void Aggregate (void) const;
+
+  CheckpointHelper m_checkpoint;          //!< Forks the workers
+  uint32_t m_replications;                //!< Number of replications
+  uint32_t m_jobs;                        //!< Maximum concurrent workers
+  std::string m_prefix;                   //!< Prefix of the stdout files
+  std::vector<std::string> m_aggregated;  //!< Files to aggregate
+  uint64_t m_firstRun;                    //!< Run number of replication 0
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_RUNNER_H */
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "non-copyable.h"
+#include <atomic>
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::MpscQueue declaration and template implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup thread
+ *
+ * \brief An unbounded lock-free multiple-producer, single-consumer queue.
+ *
+ * Any thread can Push() items, with a single atomic exchange and no
+ * lock; a single consumer thread Pop()s them in the order in which the
+ * exchanges took place.  This is the intrusive-stub queue described by
+ * Dmitry Vyukov: the consumer owns a stub node whose successor holds
+ * the next item.
+ *
+ * A producer which was preempted between its exchange and the link to
+ * its node hides the items pushed after it until it resumes, so the
+ * consumer can transiently see an empty queue.  Producers should
+ * therefore wake the consumer up only after Push() returned.
+ *
+ * \tparam T \explicit The item type, which must be copyable.
+ */
+template <typename T>
+class MpscQueue : private NonCopyable
+{
+public:
+  MpscQueue ();
+  ~MpscQueue ();
+
+  /**
+   * \brief Add an item; safe from any thread.
+   * \param [in] item The item.
+   */
+  void Push (const T &item);
+
+  /**
+   * \brief Remove the oldest item; consumer thread only.
+   * \param [out] item The item removed.
+   * \return \c false if the queue was empty.
+   */
+  bool Pop (T &item);
+
+  /**
+   * \brief Check for pending items; consumer thread only.
+   * \return \c true if Pop() would fail.
+   */
+  bool IsEmpty (void) const;
+
+private:
+  /** A queue node. */
+  struct Node
+  {
+    std::atomic<Node *> next;  //!< The next node
+    T item;                    //!< The item
+  };
+
+  std::atomic<Node *> m_tail;  //!< Last node, where producers append
+  Node *m_head;                //!< Stub node, owned by the consumer
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+MpscQueue<T>::MpscQueue ()
+{
+  m_head = new Node;
+  m_head->next.store (0, std::memory_order_relaxed);
+  m_tail.store (m_head, std::memory_order_relaxed);
+}
+
+template <typename T>
+MpscQueue<T>::~MpscQueue ()
+{
+  T item;
+  while (Pop (item))
+    {
+    }
+  delete m_head;
+}
+
+template <typename T>
+void
+MpscQueue<T>::Push (const T &item)
+{
+  Node *node = new Node;
+  node->next.store (0, std::memory_order_relaxed);
+  node->item = item;
+  Node *prev = m_tail.exchange (node, std::memory_order_acq_rel);
+  prev->next.store (node, std::memory_order_release);
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Pop (T &item)
+{
+  Node *head = m_head;
+  Node *next = head->next.load (std::memory_order_acquire);
+  if (next == 0)
+    {
+      return false;
+    }
+  item = next->item;
+  m_head = next;
+  delete head;
+  return true;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty (void) const
+{
+  return m_head->next.load (std::memory_order_acquire) == 0;
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
@@ -0,0 +1,537 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "profiling-simulator-impl.h"
+#include "default-simulator-impl.h"
+#include "simulator.h"
+#include "event-impl.h"
+#include "string.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ProfilingSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("ProfilingSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (ProfilingSimulatorImpl);
+
+namespace {
+/**
+ * Get an object factory configured to the default simulator implementation.
+ * \return The factory.
+ */
+ObjectFactory
+GetDefaultSimulatorImplFactory ()
+{
+  ObjectFactory factory;
+  factory.SetTypeId (DefaultSimulatorImpl::GetTypeId ());
+  return factory;
+}
+} // unnamed namespace
+
+/**
+ * \ingroup simulator
+ * Wraps a scheduled event to measure its handler.
+ */
+class ProfilingSimulatorImpl::ProfiledEvent : public EventImpl
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] profiler The profiler.
+   * \param [in] context The context the event will be executed in.
+   * \param [in] event The wrapped event; the reference is adopted.
+   */
+  ProfiledEvent (ProfilingSimulatorImpl *profiler, uint32_t context, EventImpl *event)
+    : m_profiler (profiler),
+      m_context (context),
+      m_event (event)
+  {
+  }
+  virtual ~ProfiledEvent ()
+  {
+    m_event->Unref ();
+  }
+protected:
+  virtual void Notify (void)
+  {
+    if (m_event->IsCancelled ())
+      {
+        return;
+      }
+    Clock::time_point start = Clock::now ();
+    if (m_profiler->m_running)
+      {
+        m_profiler->m_dispatched++;
+        m_profiler->m_dispatchNs += std::chrono::duration_cast<std::chrono::nanoseconds>
+          (start - m_profiler->m_lastHandlerEnd).count ();
+      }
+    m_event->Invoke ();
+    Clock::time_point end = Clock::now ();
+    Stats &stats = m_profiler->Lookup (m_context, &typeid (*m_event));
+    stats.invocations++;
+    stats.handlerNs += std::chrono::duration_cast<std::chrono::nanoseconds> (end - start).count ();
+    m_profiler->m_lastHandlerEnd = end;
+  }
+private:
+  ProfilingSimulatorImpl *m_profiler;  //!< The profiler
+  uint32_t m_context;                  //!< The context of the event
+  EventImpl *m_event;                  //!< The wrapped event
+};
+
+ProfilingSimulatorImpl::Stats::Stats ()
+  : invocations (0),
+    handlerNs (0),
+    scheduled (0),
+    scheduleNs (0)
+{
+}
+
+void
+ProfilingSimulatorImpl::Stats::Add (const Stats &o)
+{
+  invocations += o.invocations;
+  handlerNs += o.handlerNs;
+  scheduled += o.scheduled;
+  scheduleNs += o.scheduleNs;
+}
+
+TypeId
+ProfilingSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ProfilingSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<ProfilingSimulatorImpl> ()
+    .AddAttribute ("SimulatorImplFactory",
+                   "Factory for the underlying simulator implementation being profiled.",
+                   ObjectFactoryValue (GetDefaultSimulatorImplFactory ()),
+                   MakeObjectFactoryAccessor (&ProfilingSimulatorImpl::m_simulatorImplFactory),
+                   MakeObjectFactoryChecker ())
+    .AddAttribute ("ReportFile",
+                   "File receiving the profile report at Simulator::Destroy; "
+                   "empty to disable, \"-\" for the standard output.",
+                   StringValue ("ns3-profile.txt"),
+                   MakeStringAccessor (&ProfilingSimulatorImpl::m_reportFile),
+                   MakeStringChecker ())
+    .AddAttribute ("FoldedFile",
+                   "File receiving the profile as flamegraph folded stacks at "
+                   "Simulator::Destroy; empty to disable.",
+                   StringValue ("ns3-profile.folded"),
+                   MakeStringAccessor (&ProfilingSimulatorImpl::m_foldedFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+ProfilingSimulatorImpl::ProfilingSimulatorImpl ()
+  : m_lastKey (Simulator::NO_CONTEXT, 0),
+    m_last (0),
+    m_dispatched (0),
+    m_dispatchNs (0),
+    m_running (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ProfilingSimulatorImpl::~ProfilingSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ProfilingSimulatorImpl::NotifyConstructionCompleted (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_simulator = m_simulatorImplFactory.Create<SimulatorImpl> ();
+  SimulatorImpl::NotifyConstructionCompleted ();
+}
+
+void
+ProfilingSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_simulator)
+    {
+      m_simulator->Dispose ();
+      m_simulator = 0;
+    }
+  SimulatorImpl::DoDispose ();
+}
+
+void
+ProfilingSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  m_simulator->Destroy ();
+  WriteReports ();
+}
+
+bool
+ProfilingSimulatorImpl::IsFinished (void) const
+{
+  return m_simulator->IsFinished ();
+}
+
+void
+ProfilingSimulatorImpl::Stop (void)
+{
+  m_simulator->Stop ();
+}
+
+void
+ProfilingSimulatorImpl::Stop (const Time &delay)
+{
+  m_simulator->Stop (delay);
+}
+
+ProfilingSimulatorImpl::Stats &
+ProfilingSimulatorImpl::Lookup (uint32_t context, const std::type_info *type)
+{
+  // Events of the same type often follow each other.
+  Key key (context, type);
+  if (m_last == 0 || key != m_lastKey)
+    {
+      m_last = &m_stats[key];
+      m_lastKey = key;
+    }
+  return *m_last;
+}
+
+EventId
+ProfilingSimulatorImpl::DoSchedule (uint32_t context, const Time &delay, EventImpl *event, bool withContext)
+{
+  ProfiledEvent *profiled = new ProfiledEvent (this, context, event);
+  Clock::time_point start = Clock::now ();
+  EventId id;
+  if (withContext)
+    {
+      m_simulator->ScheduleWithContext (context, delay, profiled);
+    }
+  else
+    {
+      id = m_simulator->Schedule (delay, profiled);
+    }
+  Clock::time_point end = Clock::now ();
+  Stats &stats = Lookup (context, &typeid (*event));
+  stats.scheduled++;
+  stats.scheduleNs += std::chrono::duration_cast<std::chrono::nanoseconds> (end - start).count ();
+  return id;
+}
+
+EventId
+ProfilingSimulatorImpl::Schedule (const Time &delay, EventImpl *event)
+{
+  return DoSchedule (m_simulator->GetContext (), delay, event, false);
+}
+
+void
+ProfilingSimulatorImpl::ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event)
+{
+  DoSchedule (context, delay, event, true);
+}
+
+EventId
+ProfilingSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return DoSchedule (m_simulator->GetContext (), Time (0), event, false);
+}
+
+EventId
+ProfilingSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  return m_simulator->ScheduleDestroy (event);
+}
+
+void
+ProfilingSimulatorImpl::Remove (const EventId &id)
+{
+  m_simulator->Remove (id);
+}
+
+void
+ProfilingSimulatorImpl::Cancel (const EventId &id)
+{
+  m_simulator->Cancel (id);
+}
+
+bool
+ProfilingSimulatorImpl::IsExpired (const EventId &id) const
+{
+  return m_simulator->IsExpired (id);
+}
+
+void
+ProfilingSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_running = true;
+  m_lastHandlerEnd = Clock::now ();
+  m_simulator->Run ();
+  m_running = false;
+}
+
+Time
+ProfilingSimulatorImpl::Now (void) const
+{
+  return m_simulator->Now ();
+}
+
+Time
+ProfilingSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  return m_simulator->GetDelayLeft (id);
+}
+
+Time
+ProfilingSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return m_simulator->GetMaximumSimulationTime ();
+}
+
+void
+ProfilingSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_simulator->SetScheduler (schedulerFactory);
+}
+
+uint32_t
+ProfilingSimulatorImpl::GetSystemId (void) const
+{
+  return m_simulator->GetSystemId ();
+}
+
+uint32_t
+ProfilingSimulatorImpl::GetContext (void) const
+{
+  return m_simulator->GetContext ();
+}
+
+uint64_t
+ProfilingSimulatorImpl::GetInvocations (uint32_t context) const
+{
+  uint64_t invocations = 0;
+  for (std::map<Key, Stats>::const_iterator i = m_stats.begin (); i != m_stats.end (); ++i)
+    {
+      if (i->first.first == context)
+        {
+          invocations += i->second.invocations;
+        }
+    }
+  return invocations;
+}
+
+std::string
+ProfilingSimulatorImpl::GetTypeName (const std::type_info *type)
+{
+  std::string name = type->name ();
+#ifdef __GNUC__
+  int status;
+  char *demangled = abi::__cxa_demangle (type->name (), 0, 0, &status);
+  if (status == 0 && demangled != 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+#endif
+  return name;
+}
+
+std::map<std::string, ProfilingSimulatorImpl::Stats>
+ProfilingSimulatorImpl::GetByType (void) const
+{
+  // type_info objects are not guaranteed to be unique across shared
+  // libraries, so merge them by name.
+  std::map<const std::type_info *, std::string> names;
+  std::map<std::string, Stats> byType;
+  for (std::map<Key, Stats>::const_iterator i = m_stats.begin (); i != m_stats.end (); ++i)
+    {
+      std::map<const std::type_info *, std::string>::iterator name = names.find (i->first.second);
+      if (name == names.end ())
+        {
+          name = names.insert (std::make_pair (i->first.second, GetTypeName (i->first.second))).first;
+        }
+      byType[name->second].Add (i->second);
+    }
+  return byType;
+}
+
+namespace {
+/**
+ * Order report rows by decreasing handler time.
+ * \param [in] a The first row.
+ * \param [in] b The second row.
+ * \return \c true if \p a goes first.
+ */
+template <typename T, typename S>
+bool
+ByHandlerTime (const std::pair<T, S> &a, const std::pair<T, S> &b)
+{
+  return a.second.handlerNs > b.second.handlerNs;
+}
+} // unnamed namespace
+
+void
+ProfilingSimulatorImpl::Report (std::ostream &os) const
+{
+  Stats total;
+  std::map<uint32_t, Stats> byContext;
+  for (std::map<Key, Stats>::const_iterator i = m_stats.begin (); i != m_stats.end (); ++i)
+    {
+      total.Add (i->second);
+      byContext[i->first.first].Add (i->second);
+    }
+  double totalMs = total.handlerNs / 1e6;
+
+  std::ios_base::fmtflags flags = os.flags ();
+  os << std::fixed;
+  os << "Event handlers: " << total.invocations << " invocations, "
+     << std::setprecision (3) << totalMs << " ms" << std::endl;
+  os << "Scheduler insertions: " << total.scheduled << ", "
+     << total.scheduleNs / 1e6 << " ms" << std::endl;
+  os << "Dispatch between handlers: " << m_dispatched << ", "
+     << m_dispatchNs / 1e6 << " ms" << std::endl;
+
+  std::map<std::string, Stats> byType = GetByType ();
+  std::vector<std::pair<std::string, Stats> > types (byType.begin (), byType.end ());
+  std::sort (types.begin (), types.end (), ByHandlerTime<std::string, Stats>);
+  os << std::endl << "By event type:" << std::endl;
+  os << std::setw (12) << "total ms" << std::setw (8) << "%"
+     << std::setw (14) << "invocations" << std::setw (12) << "mean us"
+     << std::setw (12) << "insert us" << "  type" << std::endl;
+  for (std::vector<std::pair<std::string, Stats> >::const_iterator i = types.begin (); i != types.end (); ++i)
+    {
+      const Stats &s = i->second;
+      os << std::setw (12) << std::setprecision (3) << s.handlerNs / 1e6
+         << std::setw (8) << std::setprecision (2) << (totalMs > 0 ? 100.0 * s.handlerNs / total.handlerNs : 0)
+         << std::setw (14) << s.invocations
+         << std::setw (12) << std::setprecision (3) << (s.invocations ? s.handlerNs / 1e3 / s.invocations : 0)
+         << std::setw (12) << (s.scheduled ? s.scheduleNs / 1e3 / s.scheduled : 0)
+         << "  " << i->first << std::endl;
+    }
+
+  std::vector<std::pair<uint32_t, Stats> > contexts (byContext.begin (), byContext.end ());
+  std::sort (contexts.begin (), contexts.end (), ByHandlerTime<uint32_t, Stats>);
+  os << std::endl << "By context:" << std::endl;
+  os << std::setw (12) << "total ms" << std::setw (8) << "%"
+     << std::setw (14) << "invocations" << std::setw (12) << "mean us"
+     << "  context" << std::endl;
+  for (std::vector<std::pair<uint32_t, Stats> >::const_iterator i = contexts.begin (); i != contexts.end (); ++i)
+    {
+      const Stats &s = i->second;
+      os << std::setw (12) << std::setprecision (3) << s.handlerNs / 1e6
+         << std::setw (8) << std::setprecision (2) << (totalMs > 0 ? 100.0 * s.handlerNs / total.handlerNs : 0)
+         << std::setw (14) << s.invocations
+         << std::setw (12) << std::setprecision (3) << (s.invocations ? s.handlerNs / 1e3 / s.invocations : 0)
+         << "  ";
+      if (i->first == Simulator::NO_CONTEXT)
+        {
+          os << "none";
+        }
+      else
+        {
+          os << i->first;
+        }
+      os << std::endl;
+    }
+  os.flags (flags);
+}
+
+void
+ProfilingSimulatorImpl::ReportFolded (std::ostream &os) const
+{
+  std::map<const std::type_info *, std::string> names;
+  for (std::map<Key, Stats>::const_iterator i = m_stats.begin (); i != m_stats.end (); ++i)
+    {
+      uint64_t us = i->second.handlerNs / 1000;
+      if (us == 0)
+        {
+          continue;
+        }
+      std::map<const std::type_info *, std::string>::iterator name = names.find (i->first.second);
+      if (name == names.end ())
+        {
+          std::string typeName = GetTypeName (i->first.second);
+          // ';' separates the frames
+          std::replace (typeName.begin (), typeName.end (), ';', ',');
+          name = names.insert (std::make_pair (i->first.second, typeName)).first;
+        }
+      os << "ns-3;";
+      if (i->first.first == Simulator::NO_CONTEXT)
+        {
+          os << "no context";
+        }
+      else
+        {
+          os << "context " << i->first.first;
+        }
+      os << ";" << name->second << " " << us << std::endl;
+    }
+}
+
+void
+ProfilingSimulatorImpl::WriteReports (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_reportFile == "-")
+    {
+      Report (std::cout);
+    }
+  else if (m_reportFile != "")
+    {
+      std::ofstream os (m_reportFile.c_str ());
+      if (os.good ())
+        {
+          Report (os);
+        }
+      else
+        {
+          NS_LOG_WARN ("Could not open " << m_reportFile);
+        }
+    }
+  if (m_foldedFile != "")
+    {
+      std::ofstream os (m_foldedFile.c_str ());
+      if (os.good ())
+        {
+          ReportFolded (os);
+        }
+      else
+        {
+          NS_LOG_WARN ("Could not open " << m_foldedFile);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PROFILING_SIMULATOR_IMPL_H
+#define PROFILING_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "object-factory.h"
+
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ProfilingSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief A simulator implementation which measures the wall-clock time
+ * spent in each event handler.
+ *
+ * It forwards every call to an underlying implementation (by default
+ * ns3::DefaultSimulatorImpl, see the \c SimulatorImplFactory attribute)
+ * and wraps each scheduled event to record, per event callback type
+ * and per context (node id):
+ *
+ *   - the number of invocations,
+ *   - the wall-clock time spent in the handler,
+ *   - the time spent inserting the event in the scheduler,
+ *
+ * as well as the dispatch time between consecutive handlers, which is
+ * dominated by removing the next event from the scheduler.
+ *
+ * The event callback type is the dynamic type of the EventImpl, which
+ * MakeEvent() derives from the class and signature of the scheduled
+ * function, so handlers with the same signature on the same class are
+ * reported together.
+ *
+ * At Simulator::Destroy a report sorted by total handler time is written
+ * to the \c ReportFile, and a flamegraph-compatible "folded stacks" file,
+ * with one <tt>ns-3;context;type microseconds</tt> line per context and
+ * type, to the \c FoldedFile.  To profile any program, run it with
+ *
+ * \code
+ *   --SimulatorImplementationType=ns3::ProfilingSimulatorImpl
+ * \endcode
+ *
+ * Each event costs one additional allocation and four clock reads.
+ * The measurements are not protected against concurrent access, so
+ * events must only be scheduled from the simulation thread.
+ */
+class ProfilingSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  ProfilingSimulatorImpl ();
+  ~ProfilingSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * \brief Get the number of handler invocations in a context.
+   * \param [in] context The context.
+   * \return The number of events executed in \p context.
+   */
+  uint64_t GetInvocations (uint32_t context) const;
+
+  /**
+   * \brief Write the profile report.
+   * \param [in,out] os The output stream.
+   */
+  void Report (std::ostream &os) const;
+
+  /**
+   * \brief Write the profile as flamegraph folded stacks.
+   * \param [in,out] os The output stream.
+   */
+  void ReportFolded (std::ostream &os) const;
+
+private:
+  class ProfiledEvent;
+  friend class ProfiledEvent;
+
+  /** The clock used for all measurements. */
+  typedef std::chrono::steady_clock Clock;
+
+  /** Accumulated measurements. */
+  struct Stats
+  {
+    Stats ();
+    /**
+     * Accumulate other measurements.
+     * \param [in] o The measurements to add.
+     */
+    void Add (const Stats &o);
+    uint64_t invocations;   //!< Number of handler invocations
+    uint64_t handlerNs;     //!< Time spent in the handlers
+    uint64_t scheduled;     //!< Number of scheduler insertions
+    uint64_t scheduleNs;    //!< Time spent inserting in the scheduler
+  };
+
+  virtual void DoDispose (void);
+  virtual void NotifyConstructionCompleted (void);
+
+  /**
+   * Wrap an event and schedule it.
+   * \param [in] context The context of the event.
+   * \param [in] delay The delay to the event.
+   * \param [in] event The event.
+   * \param [in] withContext Whether to use ScheduleWithContext.
+   * \return The id of the scheduled event.
+   */
+  EventId DoSchedule (uint32_t context, const Time &delay, EventImpl *event, bool withContext);
+
+  /**
+   * Get the measurements of an event type in a context.
+   * \param [in] context The context.
+   * \param [in] type The event type.
+   * \return The measurements.
+   */
+  Stats & Lookup (uint32_t context, const std::type_info *type);
+
+  /**
+   * Get a readable name of an event type.
+   * \param [in] type The event type.
+   * \return The demangled name.
+   */
+  static std::string GetTypeName (const std::type_info *type);
+
+  /**
+   * Get the measurements aggregated by type name.
+   * \return The measurements, by type name.
+   */
+  std::map<std::string, Stats> GetByType (void) const;
+
+  /** Write the report files. */
+  void WriteReports (void) const;
+
+  Ptr<SimulatorImpl> m_simulator;         //!< The underlying implementation
+  ObjectFactory m_simulatorImplFactory;   //!< Creates m_simulator
+  std::string m_reportFile;               //!< Path of the report
+  std::string m_foldedFile;               //!< Path of the folded stacks
+
+  /** Key of the measurements: context and event type. */
+  typedef std::pair<uint32_t, const std::type_info *> Key;
+  std::map<Key, Stats> m_stats;           //!< Measurements
+  Key m_lastKey;                          //!< Key of the last lookup
+  Stats *m_last;                          //!< Result of the last lookup
+  uint64_t m_dispatched;                  //!< Number of dispatches measured
+  uint64_t m_dispatchNs;                  //!< Time between handlers
+  Clock::time_point m_lastHandlerEnd;     //!< End of the last handler
+  bool m_running;                         //!< Inside Run()
+};
+
+} // namespace ns3
+
+#endif /* PROFILING_SIMULATOR_IMPL_H */
@@ -73,16 +73,47 @@ RandomVariableStream::GetTypeId (void)
 }
 
 RandomVariableStream::RandomVariableStream()
-  : m_rng (0)
+  : m_rng (0),
+    m_streamIndex (0)
 {
   NS_LOG_FUNCTION (this);
+  GetStreams ().insert (this);
 }
 RandomVariableStream::~RandomVariableStream()
 {
   NS_LOG_FUNCTION (this);
+  GetStreams ().erase (this);
   delete m_rng;
 }
 
+std::set<RandomVariableStream *> &
+RandomVariableStream::GetStreams (void)
+{
+  // Never destroyed, so streams owned by static objects can still
+  // unregister themselves during program exit.
+  static std::set<RandomVariableStream *> *streams = new std::set<RandomVariableStream *> ();
+  return *streams;
+}
+
+void
+RandomVariableStream::ReseedAll (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  uint32_t seed = RngSeedManager::GetSeed ();
+  uint64_t run = RngSeedManager::GetRun ();
+  std::set<RandomVariableStream *> &streams = GetStreams ();
+  for (std::set<RandomVariableStream *>::iterator i = streams.begin (); i != streams.end (); ++i)
+    {
+      RandomVariableStream *stream = *i;
+      if (stream->m_rng == 0)
+        {
+          continue;
+        }
+      delete stream->m_rng;
+      stream->m_rng = new RngStream (seed, stream->m_streamIndex, run);
+    }
+}
+
 void
 RandomVariableStream::SetAntithetic(bool isAntithetic)
 {
@@ -108,6 +139,7 @@ RandomVariableStream::SetStream (int64_t stream)
       // number assignment.
       uint64_t nextStream = RngSeedManager::GetNextStreamIndex ();
       NS_ASSERT(nextStream <= ((1ULL)<<63));
+      m_streamIndex = nextStream;
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              nextStream,
                              RngSeedManager::GetRun ());
@@ -118,6 +150,7 @@ RandomVariableStream::SetStream (int64_t stream)
       // number assignment.
       uint64_t base = ((1ULL)<<63);
       uint64_t target = base + stream;
+      m_streamIndex = target;
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              target,
                              RngSeedManager::GetRun ());
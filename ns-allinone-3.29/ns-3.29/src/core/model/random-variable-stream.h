@@ -30,6 +30,7 @@
 #include "object.h"
 #include "attribute-helper.h"
 #include <stdint.h>
+#include <set>
 
 /**
  * \file
@@ -149,6 +150,18 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Restart every live stream from the current seed and run.
+   *
+   * Each stream keeps the stream number it was allocated, but its
+   * state is recomputed from the current \ref GlobalValueRngSeed
+   * "RngSeed" and \ref GlobalValueRngRun "RngRun".  This lets a process
+   * which branched from an already running simulation (see
+   * ns3::CheckpointHelper) draw independent replications without
+   * rebuilding the objects that own the streams.
+   */
+  static void ReseedAll (void);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RngStream.
@@ -187,6 +200,15 @@ private:
   /** The stream number for the RngStream. */
   int64_t m_stream;
 
+  /** The absolute RngStream index, after automatic allocation. */
+  uint64_t m_streamIndex;
+
+  /**
+   * Get the set of all live streams.
+   * \return The set of all live streams.
+   */
+  static std::set<RandomVariableStream *> & GetStreams (void);
+
 };  // class RandomVariableStream
 
   
@@ -34,6 +34,7 @@
 
 
 #include <cmath>
+#include <thread>
 
 
 /**
@@ -85,9 +86,12 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
   // uid 1 is "now" events
   // uid 2 is "destroy" events
   m_uid = 4; 
+  m_pendingEvents = 0;
   // before ::Run is entered, the m_currentUid will be zero
   m_currentUid = 0;
   m_currentTs = 0;
+  m_injectFloorTs = 0;
+  m_injecting = 0;
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
 
@@ -107,6 +111,7 @@ void
 RealtimeSimulatorImpl::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  MergeInjectedEvents ();
   while (!m_events->IsEmpty ())
     {
       Scheduler::Event next = m_events->RemoveNext ();
@@ -149,19 +154,89 @@ RealtimeSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
 
   Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
 
-  { 
-    CriticalSection cs (m_mutex);
+  if (m_events != 0)
+    {
+      while (m_events->IsEmpty () == false)
+        {
+          Scheduler::Event next = m_events->RemoveNext ();
+          scheduler->Insert (next);
+        }
+    }
+  m_events = scheduler;
+}
 
-    if (m_events != 0)
-      {
-        while (m_events->IsEmpty () == false)
-          {
-            Scheduler::Event next = m_events->RemoveNext ();
-            scheduler->Insert (next);
-          }
-      }
-    m_events = scheduler;
-  }
+void
+RealtimeSimulatorImpl::Insert (Scheduler::Event &ev)
+{
+  if (SystemThread::Equals (m_main))
+    {
+      // The simulation thread is not waiting in the synchronizer while
+      // it executes an event, so there is nobody to signal.
+      ev.key.m_uid = m_uid++;
+      m_pendingEvents++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
+  else
+    {
+      //
+      // The timestamp may have been computed from a current time that the
+      // simulation thread has since moved past.  ProcessOneEvent raises
+      // m_injectFloorTs before executing an event and then waits for the
+      // threads between here and the end of the push, so an event which
+      // reads the floor before it is raised is merged in time, and one
+      // which reads it after is not earlier than the event executed.
+      // Taking the uid after the floor keeps the uids of the events of a
+      // given timestamp in execution order, which IsExpired relies on.
+      //
+      m_pendingEvents++;
+      m_injecting++;
+      uint64_t floor = m_injectFloorTs;
+      if (ev.key.m_ts < floor)
+        {
+          ev.key.m_ts = floor;
+        }
+      ev.key.m_uid = m_uid++;
+      Injection injection;
+      injection.ev = ev;
+      injection.remove = false;
+      m_injected.Push (injection);
+      m_injecting--;
+      m_synchronizer->Signal ();
+    }
+}
+
+void
+RealtimeSimulatorImpl::MergeInjectedEvents (void)
+{
+  Injection injection;
+  while (m_injected.Pop (injection))
+    {
+      Scheduler::Event &ev = injection.ev;
+      if (injection.remove)
+        {
+          //
+          // The removing thread cancelled the event, which may have been
+          // executed since.  It was merged before its removal, which was
+          // pushed after it.
+          //
+          if (ev.key.m_ts < m_currentTs
+              || (ev.key.m_ts == m_currentTs && ev.key.m_uid <= m_currentUid))
+            {
+              continue;
+            }
+          m_events->Remove (ev);
+          m_unscheduledEvents--;
+          m_pendingEvents--;
+          ev.impl->Unref ();
+          continue;
+        }
+      NS_ASSERT_MSG (ev.key.m_ts >= m_currentTs,
+                     "RealtimeSimulatorImpl::MergeInjectedEvents(): "
+                     "injected event earlier than m_currentTs");
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
 }
 
 void
@@ -206,62 +281,77 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
       //
       uint64_t tsNow;
 
-      { 
-        CriticalSection cs (m_mutex);
-        //
-        // Since we are in realtime mode, the time to delay has got to be the 
-        // difference between the current realtime and the timestamp of the next 
-        // event.  Since m_currentTs is actually the timestamp of the last event we 
-        // executed, it's not particularly meaningful for us here since real time has
-        // certainly elapsed since it was last updated.
-        //
-        // It is possible that the current realtime has drifted past the next event
-        // time so we need to be careful about that and not delay in that case.
-        //
-        NS_ASSERT_MSG (m_synchronizer->Realtime (), 
-                       "RealtimeSimulatorImpl::ProcessOneEvent (): Synchronizer reports not Realtime ()");
-
-        //
-        // tsNow is set to the normalized current real time.  When the simulation was
-        // started, the current real time was effectively set to zero; so tsNow is
-        // the current "real" simulation time.
-        //
-        // tsNext is the simulation time of the next event we want to execute.
-        //
-        tsNow = m_synchronizer->GetCurrentRealtime ();
-        tsNext = NextTs ();
-
-        //
-        // tsDelay is therefore the real time we need to delay in order to bring the
-        // real time in sync with the simulation time.  If we wait for this amount of
-        // real time, we will accomplish moving the simulation time at the same rate
-        // as the real time.  This is typically called "pacing" the simulation time.
-        //
-        // We do have to be careful if we are falling behind.  If so, tsDelay must be
-        // zero.  If we're late, don't dawdle.
-        //
-        if (tsNext <= tsNow)
-          {
-            tsDelay = 0;
-          }
-        else
-          {
-            tsDelay = tsNext - tsNow;
-          }
+      MergeInjectedEvents ();
+      if (m_events->IsEmpty ())
+        {
+          // Every event was removed by other threads
+          return;
+        }
 
-        //
-        // We've figured out how long we need to delay in order to pace the 
-        // simulation time with the real time.  We're going to sleep, but need
-        // to work with the synchronizer to make sure we're awakened if something 
-        // external happens (like a packet is received).  This next line resets
-        // the synchronizer so that any future event will cause it to interrupt.
-        //
-        m_synchronizer->SetCondition (false);
-      }
+      //
+      // Since we are in realtime mode, the time to delay has got to be the 
+      // difference between the current realtime and the timestamp of the next 
+      // event.  Since m_currentTs is actually the timestamp of the last event we 
+      // executed, it's not particularly meaningful for us here since real time has
+      // certainly elapsed since it was last updated.
+      //
+      // It is possible that the current realtime has drifted past the next event
+      // time so we need to be careful about that and not delay in that case.
+      //
+      NS_ASSERT_MSG (m_synchronizer->Realtime (), 
+                     "RealtimeSimulatorImpl::ProcessOneEvent (): Synchronizer reports not Realtime ()");
+
+      //
+      // tsNow is set to the normalized current real time.  When the simulation was
+      // started, the current real time was effectively set to zero; so tsNow is
+      // the current "real" simulation time.
+      //
+      // tsNext is the simulation time of the next event we want to execute.
+      //
+      tsNow = m_synchronizer->GetCurrentRealtime ();
+      tsNext = NextTs ();
+
+      //
+      // tsDelay is therefore the real time we need to delay in order to bring the
+      // real time in sync with the simulation time.  If we wait for this amount of
+      // real time, we will accomplish moving the simulation time at the same rate
+      // as the real time.  This is typically called "pacing" the simulation time.
+      //
+      // We do have to be careful if we are falling behind.  If so, tsDelay must be
+      // zero.  If we're late, don't dawdle.
+      //
+      if (tsNext <= tsNow)
+        {
+          tsDelay = 0;
+        }
+      else
+        {
+          tsDelay = tsNext - tsNow;
+        }
+
+      //
+      // We've figured out how long we need to delay in order to pace the 
+      // simulation time with the real time.  We're going to sleep, but need
+      // to work with the synchronizer to make sure we're awakened if something 
+      // external happens (like a packet is received).  This next line resets
+      // the synchronizer so that any future event will cause it to interrupt.
+      //
+      m_synchronizer->SetCondition (false);
+
+      //
+      // An event injected after the merge above had its signal cleared
+      // by SetCondition: pick it up before deciding to sleep.  Injecting
+      // threads signal only after their event is visible in the queue,
+      // so any later injection will interrupt the wait below.
+      //
+      if (!m_injected.IsEmpty ())
+        {
+          continue;
+        }
 
       //
       // We have a time to delay.  This time may actually not be valid anymore
-      // since we released the critical section immediately above, and a real-time
+      // since we looked at the event list immediately above, and a real-time
       // ScheduleReal or ScheduleRealNow may have snuck in, well, between the 
       // closing brace above and this comment so to speak.  If this is the case, 
       // that schedule operation will have done a synchronizer Signal() that 
@@ -272,7 +362,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
       // requires a SpinWait down in the synchronizer.  What will happen is that 
       // whan Synchronize calls SpinWait, SpinWait will look directly at its 
       // condition variable.  Note that we set this condition variable to false 
-      // inside the critical section above. 
+      // above, before the last look at the injected events.
       //
       // SpinWait will go into a forever loop until either the time has expired or
       // until the condition variable becomes true.  A true condition indicates that
@@ -310,26 +400,45 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
   //
   // If we break out of the for-loop above, we have waited until the time specified
   // by the event that was at the head of the event list when we started the process.
-  // Since there is a bunch of code that was executed outside a critical section (the
-  // Synchronize call) we cannot be sure that the event at the head of the event list
+  // Since other threads may have scheduled or removed events during the Synchronize
+  // call, we cannot be sure that the event at the head of the event list
   // is the one we think it is.  What we can be sure of is that it is time to execute
   // whatever event is at the head of this list if the list is in time order.
   //
   Scheduler::Event next;
 
-  { 
-    CriticalSection cs (m_mutex);
-
+  {
     // 
-    // We do know we're waiting for an event, so there had better be an event on the 
-    // event queue.  Let's pull it off.  When we release the critical section, the
-    // event we're working on won't be on the list and so subsequent operations won't
-    // mess with us.
+    // We do know we're waiting for an event, but other threads may have removed
+    // it meanwhile.  Let's pull the next one off.  Once it is off the list,
+    // subsequent operations won't mess with us.
     //
-    NS_ASSERT_MSG (m_events->IsEmpty () == false, 
-                   "RealtimeSimulatorImpl::ProcessOneEvent(): event queue is empty");
+    // Other threads may still be pushing events computed from an earlier
+    // current time.  Raise the floor of the injected events to the next
+    // event, wait for the threads which may have read the previous floor,
+    // and look again if one of their events comes first.
+    //
+    MergeInjectedEvents ();
+    uint32_t uid;
+    do
+      {
+        if (m_events->IsEmpty ())
+          {
+            return;
+          }
+        Scheduler::Event head = m_events->PeekNext ();
+        uid = head.key.m_uid;
+        m_injectFloorTs = head.key.m_ts;
+        while (m_injecting != 0)
+          {
+            std::this_thread::yield ();
+          }
+        MergeInjectedEvents ();
+      }
+    while (m_events->IsEmpty () || m_events->PeekNext ().key.m_uid != uid);
     next = m_events->RemoveNext ();
     m_unscheduledEvents--;
+    m_pendingEvents--;
 
     //
     // We cannot make any assumption that "next" is the same event we originally waited 
@@ -346,9 +455,12 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
     // executing.  From the rest of the simulation's point of view, simulation time
     // is frozen until the next event is executed.
     //
+    // IsExpired reads m_currentTs before m_currentUid from other threads,
+    // so the uid is updated first.
+    //
+    m_currentUid = next.key.m_uid;
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
-    m_currentUid = next.key.m_uid;
 
     // 
     // We're about to run the event and we've done our best to synchronize this
@@ -396,17 +508,11 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
 bool 
 RealtimeSimulatorImpl::IsFinished (void) const
 {
-  bool rc;
-  {
-    CriticalSection cs (m_mutex);
-    rc = m_events->IsEmpty () || m_stop;
-  }
-
-  return rc;
+  return m_pendingEvents == 0 || m_stop;
 }
 
 //
-// Peeks into event list.  Should be called with critical section locked.
+// Peeks into event list.  Simulation thread only.
 //
 uint64_t
 RealtimeSimulatorImpl::NextTs (void) const
@@ -438,23 +544,11 @@ RealtimeSimulatorImpl::Run (void)
  
   while (!m_stop) 
     {
-      bool process = false;
-      {
-        CriticalSection cs (m_mutex);
-
-        if (!m_events->IsEmpty ())
-          {
-            process = true;
-          }
-        else
-          {
-            // Get current timestamp while holding the critical section
-            tsNow = m_synchronizer->GetCurrentRealtime ();
-          }
-      }
- 
-      if (!process)
+      MergeInjectedEvents ();
+      if (m_events->IsEmpty ())
         {
+          tsNow = m_synchronizer->GetCurrentRealtime ();
+
           // Sleep until signalled
           tsNow = m_synchronizer->Synchronize (tsNow, tsDelay);
 
@@ -469,12 +563,8 @@ RealtimeSimulatorImpl::Run (void)
   // If the simulator stopped naturally by lack of events, make a
   // consistency test to check that we didn't lose any events along the way.
   //
-  {
-    CriticalSection cs (m_mutex);
-
-    NS_ASSERT_MSG (m_events->IsEmpty () == false || m_unscheduledEvents == 0,
-                   "RealtimeSimulatorImpl::Run(): Empty queue and unprocessed events");
-  }
+  NS_ASSERT_MSG (m_events->IsEmpty () == false || m_unscheduledEvents == 0,
+                 "RealtimeSimulatorImpl::Run(): Empty queue and unprocessed events");
 
   m_running = false;
 }
@@ -514,25 +604,12 @@ RealtimeSimulatorImpl::Schedule (Time const &delay, EventImpl *impl)
   NS_LOG_FUNCTION (this << delay << impl);
 
   Scheduler::Event ev;
-  {
-    CriticalSection cs (m_mutex);
-    //
-    // This is the reason we had to bring the absolute time calculation in from the
-    // simulator.h into the implementation.  Since the implementations may be 
-    // multi-threaded, we need this calculation to be atomic.  You can see it is
-    // here since we are running in a CriticalSection.
-    //
-    Time tAbsolute = Simulator::Now () + delay;
-    NS_ASSERT_MSG (delay.IsPositive (), "RealtimeSimulatorImpl::Schedule(): Negative delay");
-    ev.impl = impl;
-    ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
-    ev.key.m_context = GetContext ();
-    ev.key.m_uid = m_uid;
-    m_uid++;
-    m_unscheduledEvents++;
-    m_events->Insert (ev);
-    m_synchronizer->Signal ();
-  }
+  Time tAbsolute = Simulator::Now () + delay;
+  NS_ASSERT_MSG (delay.IsPositive (), "RealtimeSimulatorImpl::Schedule(): Negative delay");
+  ev.impl = impl;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = GetContext ();
+  Insert (ev);
 
   return EventId (impl, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
@@ -542,35 +619,27 @@ RealtimeSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
 {
   NS_LOG_FUNCTION (this << context << delay << impl);
 
-  {
-    CriticalSection cs (m_mutex);
-    uint64_t ts;
+  uint64_t ts;
 
-    if (SystemThread::Equals (m_main))
-      {
-        ts = m_currentTs + delay.GetTimeStep ();
-      }
-    else
-      {
-        //
-        // If the simulator is running, we're pacing and have a meaningful 
-        // realtime clock.  If we're not, then m_currentTs is where we stopped.
-        // 
-        ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
-        ts += delay.GetTimeStep ();
-      }
+  if (SystemThread::Equals (m_main))
+    {
+      ts = m_currentTs + delay.GetTimeStep ();
+    }
+  else
+    {
+      //
+      // If the simulator is running, we're pacing and have a meaningful 
+      // realtime clock.  If we're not, then m_currentTs is where we stopped.
+      // 
+      ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs.load ();
+      ts += delay.GetTimeStep ();
+    }
 
-    NS_ASSERT_MSG (ts >= m_currentTs, "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
-    Scheduler::Event ev;
-    ev.impl = impl;
-    ev.key.m_ts = ts;
-    ev.key.m_context = context;
-    ev.key.m_uid = m_uid;
-    m_uid++;
-    m_unscheduledEvents++;
-    m_events->Insert (ev);
-    m_synchronizer->Signal ();
-  }
+  Scheduler::Event ev;
+  ev.impl = impl;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  Insert (ev);
 }
 
 EventId
@@ -578,18 +647,10 @@ RealtimeSimulatorImpl::ScheduleNow (EventImpl *impl)
 {
   NS_LOG_FUNCTION (this << impl);
   Scheduler::Event ev;
-  {
-    CriticalSection cs (m_mutex);
-
-    ev.impl = impl;
-    ev.key.m_ts = m_currentTs;
-    ev.key.m_context = GetContext ();
-    ev.key.m_uid = m_uid;
-    m_uid++;
-    m_unscheduledEvents++;
-    m_events->Insert (ev);
-    m_synchronizer->Signal ();
-  }
+  ev.impl = impl;
+  ev.key.m_ts = m_currentTs;
+  ev.key.m_context = GetContext ();
+  Insert (ev);
 
   return EventId (impl, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
@@ -608,20 +669,12 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext (uint32_t context, Time const
 {
   NS_LOG_FUNCTION (this << context << time << impl);
 
-  {
-    CriticalSection cs (m_mutex);
-
-    uint64_t ts = m_synchronizer->GetCurrentRealtime () + time.GetTimeStep ();
-    NS_ASSERT_MSG (ts >= m_currentTs, "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
-    Scheduler::Event ev;
-    ev.impl = impl;
-    ev.key.m_ts = ts;
-    ev.key.m_uid = m_uid;
-    m_uid++;
-    m_unscheduledEvents++;
-    m_events->Insert (ev);
-    m_synchronizer->Signal ();
-  }
+  uint64_t ts = m_synchronizer->GetCurrentRealtime () + time.GetTimeStep ();
+  Scheduler::Event ev;
+  ev.impl = impl;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  Insert (ev);
 }
 
 void
@@ -635,26 +688,16 @@ void
 RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext (uint32_t context, EventImpl *impl)
 {
   NS_LOG_FUNCTION (this << context << impl);
-  {
-    CriticalSection cs (m_mutex);
-
-    //
-    // If the simulator is running, we're pacing and have a meaningful 
-    // realtime clock.  If we're not, then m_currentTs is were we stopped.
-    // 
-    uint64_t ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
-    NS_ASSERT_MSG (ts >= m_currentTs, 
-                   "RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext(): schedule for time < m_currentTs");
-    Scheduler::Event ev;
-    ev.impl = impl;
-    ev.key.m_ts = ts;
-    ev.key.m_uid = m_uid;
-    ev.key.m_context = context;
-    m_uid++;
-    m_unscheduledEvents++;
-    m_events->Insert (ev);
-    m_synchronizer->Signal ();
-  }
+  //
+  // If the simulator is running, we're pacing and have a meaningful 
+  // realtime clock.  If we're not, then m_currentTs is were we stopped.
+  // 
+  uint64_t ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs.load ();
+  Scheduler::Event ev;
+  ev.impl = impl;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  Insert (ev);
 }
 
 void
@@ -686,7 +729,6 @@ RealtimeSimulatorImpl::ScheduleDestroy (EventImpl *impl)
     //
     id = EventId (Ptr<EventImpl> (impl, false), m_currentTs, 0xffffffff, 2);
     m_destroyEvents.push_back (id);
-    m_uid++;
   }
 
   return id;
@@ -730,20 +772,34 @@ RealtimeSimulatorImpl::Remove (const EventId &id)
       return;
     }
 
-  {
-    CriticalSection cs (m_mutex);
-
-    Scheduler::Event event;
-    event.impl = id.PeekEventImpl ();
-    event.key.m_ts = id.GetTs ();
-    event.key.m_context = id.GetContext ();
-    event.key.m_uid = id.GetUid ();
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
 
-    m_events->Remove (event);
-    m_unscheduledEvents--;
-    event.impl->Cancel ();
-    event.impl->Unref ();
-  }
+  if (SystemThread::Equals (m_main))
+    {
+      // The event may have been injected by another thread
+      MergeInjectedEvents ();
+      m_events->Remove (event);
+      m_unscheduledEvents--;
+      m_pendingEvents--;
+      event.impl->Cancel ();
+      event.impl->Unref ();
+    }
+  else
+    {
+      //
+      // Cancel the event now, in case it comes due before the simulation
+      // thread takes it off the event list.
+      //
+      event.impl->Cancel ();
+      Injection injection;
+      injection.ev = event;
+      injection.remove = true;
+      m_injected.Push (injection);
+    }
 }
 
 void
@@ -785,9 +841,10 @@ RealtimeSimulatorImpl::IsExpired (const EventId &id) const
   //
   // The same is true for the next line involving the m_currentUid.
   //
+  uint64_t currentTs = m_currentTs;
   if (id.PeekEventImpl () == 0 ||
-      id.GetTs () < m_currentTs ||
-      (id.GetTs () == m_currentTs && id.GetUid () <= m_currentUid) ||
+      id.GetTs () < currentTs ||
+      (id.GetTs () == currentTs && id.GetUid () <= m_currentUid) ||
       id.PeekEventImpl ()->IsCancelled ()) 
     {
       return true;
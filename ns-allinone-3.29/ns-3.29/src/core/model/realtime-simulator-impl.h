@@ -30,7 +30,9 @@
 #include "assert.h"
 #include "log.h"
 #include "system-mutex.h"
+#include "mpsc-queue.h"
 
+#include <atomic>
 #include <list>
 
 /**
@@ -52,6 +54,22 @@ namespace ns3 {
  * \ingroup realtime
  *
  * Realtime version of SimulatorImpl.
+ *
+ * The event list is only accessed by the simulation thread (the thread
+ * which runs the simulation, or which created the simulator before it
+ * runs), without any lock.  Events scheduled from other threads (for
+ * instance by the reader threads of FdNetDevice or TapBridge) are pushed
+ * on a lock-free queue, which the simulation thread merges into the event
+ * list before each scheduling decision.  Such events are never scheduled
+ * earlier than the simulation time at which they are merged.  An event
+ * removed by another thread is cancelled at once, and its removal is
+ * pushed on the same queue, for the simulation thread to take it off the
+ * event list.  IsFinished reads an atomic count of the pending events.
+ *
+ * Before executing an event, the simulation thread waits for the threads
+ * which are between reading the earliest timestep allowed for their event
+ * and pushing it, so that no injected event is executed late.  Only the
+ * destroy events are protected by a mutex.
  */
 class RealtimeSimulatorImpl : public SimulatorImpl
 {
@@ -172,6 +190,20 @@ private:
   uint64_t NextTs (void) const;
   /** Process the next event. */
   void ProcessOneEvent (void);
+  /**
+   * Give an event its uid and add it to the event list, or to the
+   * injection queue if called from another thread than the simulation
+   * thread.  An event injected by another thread is delayed to
+   * #m_injectFloorTs if it is earlier.
+   * \param [in,out] ev The event; its uid and timestamp are updated.
+   */
+  void Insert (Scheduler::Event &ev);
+  /**
+   * Move the events injected by other threads to the event list, and
+   * remove from it the events removed by other threads.  Simulation
+   * thread only.
+   */
+  void MergeInjectedEvents (void);
   /** Destructor implementation. */
   virtual void DoDispose (void);
 
@@ -180,31 +212,54 @@ private:
   /** Container for events to be run at destroy time. */
   DestroyEvents m_destroyEvents;
   /** Has the stopping condition been reached? */
-  bool m_stop;
+  std::atomic<bool> m_stop;
   /** Is the simulator currently running. */
-  bool m_running;
+  std::atomic<bool> m_running;
 
   /**
-   * \name Mutex-protected variables.
+   * \name Simulation thread variables.
    *
-   * These variables are protected by #m_mutex.
+   * These variables are only modified by the simulation thread.
    */
   /**@{*/
   /** The event list. */
   Ptr<Scheduler> m_events;
   /**< Number of events in the event list. */
   int m_unscheduledEvents;
-  /**< Unique id for the next event to be scheduled. */
-  uint32_t m_uid;
-  /**< Unique id of the current event. */
-  uint32_t m_currentUid;
-  /**< Timestep of the current event. */
-  uint64_t m_currentTs;
+  /**< Unique id of the current event; also read by other threads. */
+  std::atomic<uint32_t> m_currentUid;
+  /**< Timestep of the current event; also read by other threads. */
+  std::atomic<uint64_t> m_currentTs;
   /**< Execution context. */
   uint32_t m_currentContext;  
   /**@}*/
 
-  /** Mutex to control access to key state. */  
+  /**< Unique id for the next event to be scheduled. */
+  std::atomic<uint32_t> m_uid;
+  /** Number of events scheduled and neither executed nor removed, from any thread. */
+  std::atomic<uint32_t> m_pendingEvents;
+
+  /** An event scheduled or removed by another thread. */
+  struct Injection
+  {
+    Scheduler::Event ev;  /**< The event. */
+    bool remove;          /**< Whether the event is removed rather than scheduled. */
+  };
+  /**
+   * Events scheduled or removed by other threads, not yet applied to
+   * #m_events, in the order of their push.
+   */
+  MpscQueue<Injection> m_injected;
+  /**
+   * Earliest timestep of the events injected by other threads.  The
+   * simulation thread raises it to the timestep of the next event before
+   * executing it.
+   */
+  std::atomic<uint64_t> m_injectFloorTs;
+  /** Number of threads injecting an event, from reading #m_injectFloorTs to their push. */
+  std::atomic<uint32_t> m_injecting;
+
+  /** Mutex to control access to the destroy events. */
   mutable SystemMutex m_mutex;  
 
   /** The synchronizer in use to track real time. */
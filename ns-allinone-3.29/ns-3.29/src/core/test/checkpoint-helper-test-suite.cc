@@ -0,0 +1,291 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/checkpoint-helper.h"
+#include "ns3/replication-runner.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * CheckpointHelper and ReplicationRunner test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that branches continue from the checkpoint state and that
+ * each one draws from its own run number.
+ */
+class CheckpointHelperTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  CheckpointHelperTestCase ();
+  virtual void DoRun (void);
+private:
+  /** Advance the shared state and draw a random value. */
+  void Step (void);
+  /**
+   * Record the branch index, as seen by the branch callback.
+   * \param [in] branch The branch index.
+   */
+  void Branch (uint32_t branch);
+
+  Ptr<UniformRandomVariable> m_rv;  //!< The stream shared by all branches
+  uint32_t m_steps;                 //!< Number of Step() invocations
+  double m_value;                   //!< Last value drawn
+  int64_t m_branch;                 //!< Index given to the branch callback
+};
+
+CheckpointHelperTestCase::CheckpointHelperTestCase ()
+  : TestCase ("Check that branches resume from the checkpoint"),
+    m_steps (0),
+    m_value (0),
+    m_branch (-1)
+{
+}
+
+void
+CheckpointHelperTestCase::Step (void)
+{
+  m_steps++;
+  m_value = m_rv->GetValue ();
+}
+
+void
+CheckpointHelperTestCase::Branch (uint32_t branch)
+{
+  m_branch = branch;
+}
+
+void
+CheckpointHelperTestCase::DoRun (void)
+{
+  const uint32_t branches = 3;
+  const uint64_t firstRun = 7;
+
+  std::vector<std::string> files;
+  for (uint32_t i = 0; i < branches; ++i)
+    {
+      std::ostringstream oss;
+      oss << "branch-" << i;
+      files.push_back (CreateTempDirFilename (oss.str ()));
+      unlink (files.back ().c_str ());
+    }
+
+  // A child of the test process which the helper must not reap.
+  pid_t foreign = fork ();
+  if (foreign == 0)
+    {
+      _exit (3);
+    }
+  NS_TEST_ASSERT_MSG_GT (foreign, 0, "fork() failed");
+
+  m_rv = CreateObject<UniformRandomVariable> ();
+  m_rv->SetStream (42);
+
+  CheckpointHelper checkpoint;
+  checkpoint.SetBranches (branches);
+  checkpoint.SetFirstRun (firstRun);
+  checkpoint.SetBranchCallback (MakeCallback (&CheckpointHelperTestCase::Branch, this));
+  checkpoint.Schedule (Seconds (2));
+  Simulator::Schedule (Seconds (1), &CheckpointHelperTestCase::Step, this);
+  Simulator::Schedule (Seconds (3), &CheckpointHelperTestCase::Step, this);
+  Simulator::Stop (Seconds (4));
+  Simulator::Run ();
+
+  if (checkpoint.IsBranch ())
+    {
+      // Report through the file system and leave without returning
+      // to the test runner.
+      std::ofstream out (files[checkpoint.GetBranch ()].c_str ());
+      out.precision (17);
+      out << m_branch << " " << m_steps << " " << m_value << std::endl;
+      out.close ();
+      _exit (out.fail () ? 1 : 0);
+    }
+
+  Simulator::Destroy ();
+  int status;
+  NS_TEST_ASSERT_MSG_EQ (waitpid (foreign, &status, 0), foreign, "A child not forked by the helper was reaped");
+  NS_TEST_ASSERT_MSG_EQ (WEXITSTATUS (status), 3, "Wrong exit status of the child not forked by the helper");
+  NS_TEST_ASSERT_MSG_EQ (checkpoint.GetFailedBranches (), 0, "A branch failed");
+  NS_TEST_ASSERT_MSG_EQ (m_steps, 1, "The checkpoint process should stop at the checkpoint");
+
+  uint64_t run = RngSeedManager::GetRun ();
+  for (uint32_t i = 0; i < branches; ++i)
+    {
+      std::ifstream in (files[i].c_str ());
+      NS_TEST_ASSERT_MSG_EQ (in.good (), true, "Missing output of branch " << i);
+      int64_t branch;
+      uint32_t steps;
+      double value;
+      in >> branch >> steps >> value;
+      NS_TEST_ASSERT_MSG_EQ (branch, i, "Wrong branch index");
+      NS_TEST_ASSERT_MSG_EQ (steps, 2, "Branch did not resume from the checkpoint");
+
+      // The first value drawn after the checkpoint must be the first
+      // value of the same stream in run firstRun + i.
+      RngSeedManager::SetRun (firstRun + i);
+      Ptr<UniformRandomVariable> expected = CreateObject<UniformRandomVariable> ();
+      expected->SetStream (42);
+      double expectedValue = expected->GetValue ();
+      RngSeedManager::SetRun (run);
+      NS_TEST_ASSERT_MSG_EQ_TOL (value, expectedValue, 1e-15, "Branch was not reseeded");
+    }
+}
+
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that ReplicationRunner runs every replication on its own run
+ * number and aggregates their outputs in run order.
+ */
+class ReplicationRunnerTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ReplicationRunnerTestCase ();
+  virtual void DoRun (void);
+private:
+  /** Draw a random value. */
+  void Draw (void);
+
+  Ptr<UniformRandomVariable> m_rv;  //!< The stream shared by all replications
+  double m_value;                   //!< Last value drawn
+};
+
+ReplicationRunnerTestCase::ReplicationRunnerTestCase ()
+  : TestCase ("Check that replications are run and aggregated"),
+    m_value (0)
+{
+}
+
+void
+ReplicationRunnerTestCase::Draw (void)
+{
+  m_value = m_rv->GetValue ();
+}
+
+void
+ReplicationRunnerTestCase::DoRun (void)
+{
+  const uint32_t replications = 4;
+  const uint64_t firstRun = 11;
+  std::string stats = CreateTempDirFilename ("stats.txt");
+
+  uint64_t run = RngSeedManager::GetRun ();
+  RngSeedManager::SetRun (firstRun);
+  m_rv = CreateObject<UniformRandomVariable> ();
+  m_rv->SetStream (43);
+
+  ReplicationRunner runner;
+  runner.SetReplications (replications);
+  runner.SetJobs (2);
+  runner.SetOutputPrefix (CreateTempDirFilename ("replication"));
+  runner.AddAggregatedFile (stats);
+  Simulator::Schedule (Seconds (1), &ReplicationRunnerTestCase::Draw, this);
+
+  // Capture the aggregated standard output.
+  std::ostringstream captured;
+  std::streambuf *saved = std::cout.rdbuf (captured.rdbuf ());
+  bool worker = runner.Run ();
+  std::cout.rdbuf (saved);
+
+  if (worker)
+    {
+      std::ofstream out (runner.GetFilename (stats).c_str ());
+      out.precision (17);
+      out << runner.GetRun () << " " << m_value << std::endl;
+      out.close ();
+      std::cout << "worker " << runner.GetRun () << std::endl;
+      _exit (out.fail () ? 1 : 0);
+    }
+
+  Simulator::Destroy ();
+  RngSeedManager::SetRun (run);
+  NS_TEST_ASSERT_MSG_EQ (runner.GetFailedReplications (), 0, "A replication failed");
+
+  std::ostringstream expectedOutput;
+  for (uint32_t i = 0; i < replications; ++i)
+    {
+      expectedOutput << "# RngRun " << firstRun + i << std::endl
+                     << "worker " << firstRun + i << std::endl;
+    }
+  NS_TEST_ASSERT_MSG_EQ (captured.str (), expectedOutput.str (), "Standard output not aggregated in run order");
+
+  std::ifstream in (stats.c_str ());
+  for (uint32_t i = 0; i < replications; ++i)
+    {
+      uint64_t workerRun;
+      double value;
+      in >> workerRun >> value;
+      NS_TEST_ASSERT_MSG_EQ (in.good (), true, "Missing statistics of replication " << i);
+      NS_TEST_ASSERT_MSG_EQ (workerRun, firstRun + i, "Statistics not aggregated in run order");
+
+      RngSeedManager::SetRun (firstRun + i);
+      Ptr<UniformRandomVariable> expected = CreateObject<UniformRandomVariable> ();
+      expected->SetStream (43);
+      double expectedValue = expected->GetValue ();
+      RngSeedManager::SetRun (run);
+      NS_TEST_ASSERT_MSG_EQ_TOL (value, expectedValue, 1e-15, "Replication did not use its own run");
+    }
+}
+
+
+/**
+ * \ingroup core-tests
+ * CheckpointHelper test suite.
+ */
+class CheckpointHelperTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  CheckpointHelperTestSuite ()
+    : TestSuite ("checkpoint-helper")
+  {
+    AddTestCase (new CheckpointHelperTestCase ());
+    AddTestCase (new ReplicationRunnerTestCase ());
+  }
+};
+
+/**
+ * \ingroup core-tests
+ * CheckpointHelperTestSuite instance variable.
+ */
+static CheckpointHelperTestSuite g_checkpointHelperTestSuite;
+
+
+}  // namespace tests
+
+}  // namespace ns3
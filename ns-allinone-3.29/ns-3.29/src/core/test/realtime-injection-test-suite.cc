@@ -0,0 +1,276 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/system-thread.h"
+#include "ns3/mpsc-queue.h"
+
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup realtime
+ * MpscQueue and RealtimeSimulatorImpl event injection test suite.
+ */
+
+using namespace ns3;
+
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that MpscQueue delivers every item pushed by concurrent
+ * producers exactly once, in the order each producer pushed them.
+ */
+class MpscQueueTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  MpscQueueTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Push the items of a producer.
+   * \param [in] context The test case and the index of the producer.
+   */
+  static void Produce (std::pair<MpscQueueTestCase *, uint32_t> context);
+
+  /** Number of items pushed by each producer. */
+  static const uint32_t N_ITEMS = 20000;
+  /** The queue, of (producer, sequence number) items. */
+  MpscQueue<std::pair<uint32_t, uint32_t> > m_queue;
+};
+
+MpscQueueTestCase::MpscQueueTestCase ()
+  : TestCase ("Check MpscQueue with concurrent producers")
+{
+}
+
+void
+MpscQueueTestCase::Produce (std::pair<MpscQueueTestCase *, uint32_t> context)
+{
+  for (uint32_t i = 0; i < N_ITEMS; ++i)
+    {
+      context.first->m_queue.Push (std::make_pair (context.second, i));
+    }
+}
+
+void
+MpscQueueTestCase::DoRun (void)
+{
+  std::pair<uint32_t, uint32_t> item;
+  NS_TEST_ASSERT_MSG_EQ (m_queue.IsEmpty (), true, "New queue not empty");
+  NS_TEST_ASSERT_MSG_EQ (m_queue.Pop (item), false, "Item popped from an empty queue");
+  m_queue.Push (std::make_pair (7, 1));
+  m_queue.Push (std::make_pair (7, 2));
+  NS_TEST_ASSERT_MSG_EQ (m_queue.IsEmpty (), false, "Queue empty after a push");
+  NS_TEST_ASSERT_MSG_EQ (m_queue.Pop (item), true, "No item popped");
+  NS_TEST_ASSERT_MSG_EQ (item.second, 1, "Items not popped in order");
+  NS_TEST_ASSERT_MSG_EQ (m_queue.Pop (item), true, "No item popped");
+  NS_TEST_ASSERT_MSG_EQ (item.second, 2, "Items not popped in order");
+  NS_TEST_ASSERT_MSG_EQ (m_queue.Pop (item), false, "Item popped from an empty queue");
+
+  const uint32_t producers = 4;
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < producers; ++i)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&MpscQueueTestCase::Produce,
+                                                                  std::make_pair (this, i))));
+    }
+  for (uint32_t i = 0; i < producers; ++i)
+    {
+      threads[i]->Start ();
+    }
+
+  // Consume while the producers push.
+  std::vector<uint32_t> next (producers, 0);
+  uint32_t popped = 0;
+  bool ordered = true;
+  while (popped < producers * N_ITEMS)
+    {
+      if (!m_queue.Pop (item))
+        {
+          std::this_thread::yield ();
+          continue;
+        }
+      ++popped;
+      if (item.first >= producers || item.second != next[item.first])
+        {
+          ordered = false;
+          break;
+        }
+      next[item.first]++;
+    }
+  for (uint32_t i = 0; i < producers; ++i)
+    {
+      threads[i]->Join ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (ordered, true, "Item lost, duplicated or out of the order of its producer");
+  NS_TEST_ASSERT_MSG_EQ (m_queue.IsEmpty (), true, "Items left after all were popped");
+}
+
+
+/**
+ * \ingroup core-tests
+ *
+ * Check Schedule, Cancel and Remove called from another thread than the
+ * simulation thread of RealtimeSimulatorImpl, while it executes events.
+ * Every third event is cancelled and every third is removed: they must
+ * not run, and the others must.
+ */
+class RealtimeInjectionTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  RealtimeInjectionTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Schedule, check and cancel or remove the events; runs in its own thread.
+   * \param [in] me The test case.
+   */
+  static void Inject (RealtimeInjectionTestCase *me);
+  /** Keep the simulation thread busy. */
+  void Tick (void);
+  /**
+   * An injected event.
+   * \param [in] i The index of the event.
+   */
+  void Injected (uint32_t i);
+  /** Wait for the injecting thread. */
+  void Join (void);
+
+  /** Number of events injected. */
+  static const uint32_t N_EVENTS = 200;
+  Ptr<SystemThread> m_thread;       //!< The injecting thread
+  std::vector<bool> m_executed;     //!< Whether each injected event ran
+  uint32_t m_pendingErrors;         //!< Injected events reported expired or late
+};
+
+RealtimeInjectionTestCase::RealtimeInjectionTestCase ()
+  : TestCase ("Check Schedule, Cancel and Remove from another thread"),
+    m_pendingErrors (0)
+{
+}
+
+void
+RealtimeInjectionTestCase::DoSetup (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+}
+
+void
+RealtimeInjectionTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+void
+RealtimeInjectionTestCase::Inject (RealtimeInjectionTestCase *me)
+{
+  for (uint32_t i = 0; i < N_EVENTS; ++i)
+    {
+      Time delay = MilliSeconds (100);
+      EventId id = Simulator::Schedule (delay, &RealtimeInjectionTestCase::Injected, me, i);
+      if (Simulator::IsExpired (id) || Simulator::GetDelayLeft (id) > delay)
+        {
+          me->m_pendingErrors++;
+        }
+      if (i % 3 == 1)
+        {
+          Simulator::Cancel (id);
+        }
+      else if (i % 3 == 2)
+        {
+          Simulator::Remove (id);
+        }
+      std::this_thread::sleep_for (std::chrono::microseconds (500));
+    }
+}
+
+void
+RealtimeInjectionTestCase::Tick (void)
+{
+  Simulator::Schedule (MicroSeconds (50), &RealtimeInjectionTestCase::Tick, this);
+}
+
+void
+RealtimeInjectionTestCase::Injected (uint32_t i)
+{
+  m_executed[i] = true;
+}
+
+void
+RealtimeInjectionTestCase::Join (void)
+{
+  m_thread->Join ();
+}
+
+void
+RealtimeInjectionTestCase::DoRun (void)
+{
+  m_executed.assign (N_EVENTS, false);
+  m_thread = Create<SystemThread> (MakeBoundCallback (&RealtimeInjectionTestCase::Inject, this));
+
+  Simulator::Schedule (MicroSeconds (50), &RealtimeInjectionTestCase::Tick, this);
+  Simulator::Schedule (MilliSeconds (500), &RealtimeInjectionTestCase::Join, this);
+  Simulator::Stop (MilliSeconds (700));
+  m_thread->Start ();
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_thread = 0;
+
+  NS_TEST_ASSERT_MSG_EQ (m_pendingErrors, 0, "Pending injected events reported expired or late");
+  for (uint32_t i = 0; i < N_EVENTS; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_executed[i], (i % 3 == 0),
+                             "Injected event " << i << (i % 3 == 0 ? " did not run" : " ran though cancelled"));
+    }
+}
+
+
+/**
+ * \ingroup core-tests
+ *
+ * MpscQueue and RealtimeSimulatorImpl event injection test suite.
+ */
+class RealtimeInjectionTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  RealtimeInjectionTestSuite ();
+};
+
+RealtimeInjectionTestSuite::RealtimeInjectionTestSuite ()
+  : TestSuite ("realtime-injection")
+{
+  AddTestCase (new MpscQueueTestCase, TestCase::QUICK);
+  AddTestCase (new RealtimeInjectionTestCase, TestCase::QUICK);
+}
+
+static RealtimeInjectionTestSuite g_realtimeInjectionTestSuite; //!< Static variable for test initialization
@@ -23,6 +23,9 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/profiling-simulator-impl.h"
+#include "ns3/string.h"
+#include <sstream>
 
 using namespace ns3;
 
@@ -461,6 +464,50 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class ProfilingSimulatorImplTestCase : public TestCase
+{
+public:
+  ProfilingSimulatorImplTestCase ();
+private:
+  virtual void DoRun (void);
+  void EventA (void) {}
+  void EventB (int) {}
+};
+
+ProfilingSimulatorImplTestCase::ProfilingSimulatorImplTestCase ()
+  : TestCase ("Check that ProfilingSimulatorImpl counts handlers per context")
+{
+}
+void
+ProfilingSimulatorImplTestCase::DoRun (void)
+{
+  Ptr<ProfilingSimulatorImpl> profiler = CreateObjectWithAttributes<ProfilingSimulatorImpl>
+      ("ReportFile", StringValue (""), "FoldedFile", StringValue (""));
+  Simulator::SetImplementation (profiler);
+
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Simulator::ScheduleWithContext (1, Seconds (i), &ProfilingSimulatorImplTestCase::EventA, this);
+    }
+  Simulator::ScheduleWithContext (2, Seconds (1), &ProfilingSimulatorImplTestCase::EventB, this, 0);
+  Simulator::ScheduleWithContext (2, Seconds (2), &ProfilingSimulatorImplTestCase::EventB, this, 1);
+  EventId cancelled = Simulator::Schedule (Seconds (5), &ProfilingSimulatorImplTestCase::EventA, this);
+  Simulator::Cancel (cancelled);
+  NS_TEST_EXPECT_MSG_EQ (cancelled.IsExpired (), true, "Event should be cancelled");
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (profiler->GetInvocations (1), 3, "Wrong number of handlers in context 1");
+  NS_TEST_EXPECT_MSG_EQ (profiler->GetInvocations (2), 2, "Wrong number of handlers in context 2");
+  NS_TEST_EXPECT_MSG_EQ (profiler->GetInvocations (Simulator::NO_CONTEXT), 0, "Cancelled event should not run");
+  std::ostringstream report;
+  profiler->Report (report);
+  NS_TEST_EXPECT_MSG_EQ ((report.str ().find ("Event handlers: 5 invocations") != std::string::npos),
+                         true, "Unexpected report " << report.str ());
+  NS_TEST_EXPECT_MSG_EQ ((report.str ().find ("Scheduler insertions: 6") != std::string::npos),
+                         true, "Unexpected report " << report.str ());
+  Simulator::Destroy ();
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -477,5 +524,6 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new ProfilingSimulatorImplTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -36,19 +36,32 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
+#include <cerrno>
+#include <cstring>
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <net/ethernet.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("FdNetDevice");
 
 FdNetDeviceFdReader::FdNetDeviceFdReader ()
-  : m_bufferSize (65536) // Defaults to maximum TCP window size
+  : m_bufferSize (65536), // Defaults to maximum TCP window size
+    m_batchSize (1)
 {
 }
 
+FdNetDeviceFdReader::~FdNetDeviceFdReader ()
+{
+  for (std::vector<uint8_t *>::iterator i = m_buffers.begin (); i != m_buffers.end (); ++i)
+    {
+      free (*i);
+    }
+}
+
 void
 FdNetDeviceFdReader::SetBufferSize (uint32_t bufferSize)
 {
@@ -56,10 +69,102 @@ FdNetDeviceFdReader::SetBufferSize (uint32_t bufferSize)
   m_bufferSize = bufferSize;
 }
 
+void
+FdNetDeviceFdReader::SetBatchSize (uint32_t batchSize)
+{
+  NS_LOG_FUNCTION (this << batchSize);
+  m_batchSize = batchSize;
+}
+
+void
+FdNetDeviceFdReader::SetBatchCallback (Callback<void, const Batch &> cb)
+{
+  m_batchCallback = cb;
+}
+
+bool
+FdNetDeviceFdReader::IsBatchRead (void) const
+{
+#ifdef HAVE_RECVMMSG
+  return m_batchSize > 1 && !m_batchCallback.IsNull ();
+#else
+  return false;
+#endif
+}
+
+FdReader::Data FdNetDeviceFdReader::DoReadBatch (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_RECVMMSG
+  //
+  // Buffers handed to the callback are replaced here, the others are
+  // kept for the next call.
+  //
+  m_buffers.resize (m_batchSize, 0);
+  std::vector<struct iovec> iov (m_batchSize);
+  std::vector<struct mmsghdr> msgs (m_batchSize);
+  for (uint32_t i = 0; i < m_batchSize; ++i)
+    {
+      if (m_buffers[i] == 0)
+        {
+          m_buffers[i] = (uint8_t *)malloc (m_bufferSize);
+          NS_ABORT_MSG_IF (m_buffers[i] == 0, "malloc() failed");
+        }
+      iov[i].iov_base = m_buffers[i];
+      iov[i].iov_len = m_bufferSize;
+      std::memset (&msgs[i], 0, sizeof (msgs[i]));
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+  NS_LOG_LOGIC ("Calling recvmmsg on fd " << m_fd);
+  int n = recvmmsg (m_fd, &msgs[0], m_batchSize, MSG_DONTWAIT, 0);
+  if (n < 0)
+    {
+      if (errno == ENOTSOCK)
+        {
+          NS_LOG_LOGIC ("fd " << m_fd << " is not a socket, reading one frame at a time");
+          m_batchSize = 1;
+          return DoRead ();
+        }
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+        {
+          return FdReader::Data (0, -1);
+        }
+      return FdReader::Data (0, 0);
+    }
+
+  Batch frames;
+  frames.reserve (n);
+  for (int i = 0; i < n; ++i)
+    {
+      if (msgs[i].msg_len > 0)
+        {
+          frames.push_back (std::make_pair (m_buffers[i], static_cast<ssize_t> (msgs[i].msg_len)));
+          m_buffers[i] = 0;
+        }
+    }
+  NS_LOG_LOGIC ("Read " << frames.size () << " frames on fd " << m_fd);
+  if (!frames.empty ())
+    {
+      m_batchCallback (frames);
+    }
+  return FdReader::Data (0, -1);
+#else
+  m_batchSize = 1;
+  return DoRead ();
+#endif
+}
+
 FdReader::Data FdNetDeviceFdReader::DoRead (void)
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_batchSize > 1 && !m_batchCallback.IsNull ())
+    {
+      return DoReadBatch ();
+    }
+
   uint8_t *buf = (uint8_t *)malloc (m_bufferSize);
   NS_ABORT_MSG_IF (buf == 0, "malloc() failed");
 
@@ -115,6 +220,16 @@ FdNetDevice::GetTypeId (void)
                    UintegerValue (1000),
                    MakeUintegerAccessor (&FdNetDevice::m_maxPendingReads),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BatchSize",
+                   "The maximum number of frames read or written per system "
+                   "call when the file descriptor is a socket.  Values larger "
+                   "than one receive with recvmmsg(), forward each batch to "
+                   "the simulator in a single event, and queue the frames "
+                   "sent at the same simulation time to write them with "
+                   "sendmmsg().",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&FdNetDevice::SetBatchSize),
+                   MakeUintegerChecker<uint32_t> (1))
     //
     // Trace sources at the "top" of the net device, where packets transition
     // to/from higher layers.  These points do not really correspond to the
@@ -174,6 +289,9 @@ FdNetDevice::FdNetDevice ()
     m_fdReader (0),
     m_isBroadcast (true),
     m_isMulticast (false),
+    m_batchSize (1),
+    m_batchTx (false),
+    m_batchTxDrops (0),
     m_startEvent (),
     m_stopEvent ()
 {
@@ -206,6 +324,7 @@ void
 FdNetDevice::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_flushEvent);
   StopDevice ();
   NetDevice::DoDispose ();
 }
@@ -225,6 +344,25 @@ FdNetDevice::GetEncapsulationMode (void) const
   return m_encapMode;
 }
 
+void
+FdNetDevice::SetBatchSize (uint32_t batchSize)
+{
+  NS_LOG_FUNCTION (this << batchSize);
+  m_batchSize = batchSize;
+}
+
+bool
+FdNetDevice::IsBatchIo (void) const
+{
+  return m_batchTx && m_fdReader != 0 && m_fdReader->IsBatchRead ();
+}
+
+uint64_t
+FdNetDevice::GetBatchTxDrops (void) const
+{
+  return m_batchTxDrops;
+}
+
 void
 FdNetDevice::Start (Time tStart)
 {
@@ -262,7 +400,12 @@ FdNetDevice::StartDevice (void)
   m_fdReader = Create<FdNetDeviceFdReader> ();
   // 22 bytes covers 14 bytes Ethernet header with possible 8 bytes LLC/SNAP
   m_fdReader->SetBufferSize (m_mtu + 22);
+  m_fdReader->SetBatchSize (m_batchSize);
+  m_fdReader->SetBatchCallback (MakeCallback (&FdNetDevice::ReceiveBatchCallback, this));
   m_fdReader->Start (m_fd, MakeCallback (&FdNetDevice::ReceiveCallback, this));
+#ifdef HAVE_RECVMMSG
+  m_batchTx = m_batchSize > 1;
+#endif
 
   NotifyLinkUp ();
 }
@@ -278,6 +421,8 @@ FdNetDevice::StopDevice (void)
       m_fdReader = 0;
     }
 
+  FlushTransmit ();
+
   if (m_fd != -1)
     {
       close (m_fd);
@@ -317,6 +462,52 @@ FdNetDevice::ReceiveCallback (uint8_t *buf, ssize_t len)
     }
 }
 
+void
+FdNetDevice::ReceiveBatchCallback (const FdNetDeviceFdReader::Batch &frames)
+{
+  NS_LOG_FUNCTION (this << frames.size ());
+  uint32_t queued = 0;
+
+  {
+    CriticalSection cs (m_pendingReadMutex);
+    for (FdNetDeviceFdReader::Batch::const_iterator i = frames.begin (); i != frames.end (); ++i)
+      {
+        if (m_pendingQueue.size () >= m_maxPendingReads)
+          {
+            NS_LOG_WARN ("Packet dropped");
+            free (i->first);
+          }
+        else
+          {
+            m_pendingQueue.push (*i);
+            ++queued;
+          }
+      }
+  }
+
+  if (queued > 0)
+    {
+      Simulator::ScheduleWithContext (m_nodeId, Time (0), MakeEvent (&FdNetDevice::ForwardUpBatch, this, queued));
+    }
+  if (queued < frames.size ())
+    {
+      struct timespec time = {
+        0, 100000000L
+      };                                        // 100 ms
+      nanosleep (&time, NULL);
+    }
+}
+
+void
+FdNetDevice::ForwardUpBatch (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      ForwardUp ();
+    }
+}
+
 /**
  * \ingroup fd-net-device
  * \brief Synthesize PI header for the kernel
@@ -363,24 +554,6 @@ AddPIHeader (uint8_t *&buf, size_t &len)
   buf = buf2;
 }
 
-/**
- * \ingroup fd-net-device
- * \brief Removes PI header
- * \param buf the buffer to add the header to
- * \param len the buffer length
- */
-static void
-RemovePIHeader (uint8_t *&buf, ssize_t &len)
-{
-  // strip PI header if present, shrink buffer
-  if (len >= 4)
-    {
-      len -= 4;
-      memmove (buf, buf + 4, len);
-      buf = (uint8_t*)realloc (buf, len);
-    }
-}
-
 void
 FdNetDevice::ForwardUp (void)
 {
@@ -399,16 +572,17 @@ FdNetDevice::ForwardUp (void)
 
   NS_LOG_FUNCTION (this << buf << len);
 
-  // We need to remove the PI header and ignore it
-  if (m_encapMode == DIXPI)
+  // We need to skip the PI header and ignore it
+  ssize_t offset = 0;
+  if (m_encapMode == DIXPI && len >= 4)
     {
-      RemovePIHeader (buf, len);
+      offset = 4;
     }
 
   //
   // Create a packet out of the buffer we received and free that buffer.
   //
-  Ptr<Packet> packet = Create<Packet> (reinterpret_cast<const uint8_t *> (buf), len);
+  Ptr<Packet> packet = Create<Packet> (reinterpret_cast<const uint8_t *> (buf + offset), len - offset);
   free (buf);
   buf = 0;
 
@@ -587,6 +761,28 @@ FdNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& de
       AddPIHeader (buffer, len);
     }
 
+  if (m_batchSize > 1)
+    {
+      //
+      // Queue the frame and write all the frames sent at this simulation
+      // time together, or as soon as the batch is full.
+      //
+      TxFrame frame;
+      frame.buf = buffer;
+      frame.len = len;
+      frame.packet = packet;
+      m_txBatch.push_back (frame);
+      if (m_txBatch.size () >= m_batchSize)
+        {
+          FlushTransmit ();
+        }
+      else if (!m_flushEvent.IsRunning ())
+        {
+          m_flushEvent = Simulator::ScheduleNow (&FdNetDevice::FlushTransmit, this);
+        }
+      return true;
+    }
+
   ssize_t written = write (m_fd, buffer, len);
   free (buffer);
 
@@ -599,6 +795,81 @@ FdNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& de
   return true;
 }
 
+void
+FdNetDevice::FlushTransmit (void)
+{
+  NS_LOG_FUNCTION (this << m_txBatch.size ());
+  Simulator::Cancel (m_flushEvent);
+  if (m_txBatch.empty ())
+    {
+      return;
+    }
+
+  size_t n = m_txBatch.size ();
+  size_t sent = 0;
+#ifdef HAVE_RECVMMSG
+  std::vector<struct iovec> iov (n);
+  std::vector<struct mmsghdr> msgs (n);
+  for (size_t i = 0; i < n; ++i)
+    {
+      iov[i].iov_base = m_txBatch[i].buf;
+      iov[i].iov_len = m_txBatch[i].len;
+      std::memset (&msgs[i], 0, sizeof (msgs[i]));
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+  while (m_batchTx && sent < n)
+    {
+      int r = sendmmsg (m_fd, &msgs[sent], n - sent, 0);
+      if (r < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          if (errno == ENOTSOCK)
+            {
+              NS_LOG_LOGIC ("fd " << m_fd << " is not a socket, writing one frame at a time");
+              m_batchTx = false;
+            }
+          else
+            {
+              NS_LOG_WARN ("sendmmsg() failed: " << std::strerror (errno));
+            }
+          break;
+        }
+      sent += r;
+    }
+  for (size_t i = 0; i < sent; ++i)
+    {
+      if (msgs[i].msg_len != m_txBatch[i].len)
+        {
+          m_batchTxDrops++;
+          m_macTxDropTrace (m_txBatch[i].packet);
+        }
+    }
+#endif
+
+  // Not a socket, or sendmmsg() failed: write the remaining frames one
+  // at a time
+  for (size_t i = sent; i < n; ++i)
+    {
+      ssize_t written = write (m_fd, m_txBatch[i].buf, m_txBatch[i].len);
+      if (written == -1 || (size_t) written != m_txBatch[i].len)
+        {
+          NS_LOG_WARN ("Dropping a queued frame: " << (written == -1 ? std::strerror (errno) : "short write"));
+          m_batchTxDrops++;
+          m_macTxDropTrace (m_txBatch[i].packet);
+        }
+    }
+
+  for (size_t i = 0; i < n; ++i)
+    {
+      free (m_txBatch[i].buf);
+    }
+  m_txBatch.clear ();
+}
+
 void
 FdNetDevice::SetFileDescriptor (int fd)
 {
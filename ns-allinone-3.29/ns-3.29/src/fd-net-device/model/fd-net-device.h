@@ -36,8 +36,10 @@
 #include "ns3/unix-fd-reader.h"
 #include "ns3/system-mutex.h"
 
+#include <atomic>
 #include <utility>
 #include <queue>
+#include <vector>
 
 namespace ns3 {
 
@@ -51,21 +53,66 @@ namespace ns3 {
 /**
  * \ingroup fd-net-device
  * \brief This class performs the actual data reading from the sockets.
+ *
+ * When a batch size larger than one and a batch callback are set, and
+ * the file descriptor is a socket, each wake-up of the read thread
+ * receives up to the batch size frames with a single recvmmsg() call
+ * and hands all of them to the batch callback.  Otherwise frames are
+ * read one at a time and handed to the read callback given to Start().
  */
 class FdNetDeviceFdReader : public FdReader
 {
 public:
   FdNetDeviceFdReader ();
+  ~FdNetDeviceFdReader ();
+
+  /**
+   * A batch of received frames.  The buffers are allocated with malloc()
+   * and ownership is transferred to the batch callback.
+   */
+  typedef std::vector<std::pair<uint8_t *, ssize_t> > Batch;
 
   /**
    * Set size of the read buffer.
    */
   void SetBufferSize (uint32_t bufferSize);
 
+  /**
+   * Set the maximum number of frames received per system call.
+   * \param batchSize The batch size.
+   */
+  void SetBatchSize (uint32_t batchSize);
+
+  /**
+   * Set the callback invoked, in the read thread, with each batch of
+   * frames received with recvmmsg().
+   * \param cb The batch callback.
+   */
+  void SetBatchCallback (Callback<void, const Batch &> cb);
+
+  /**
+   * \return true if frames are received with recvmmsg(): the batch size
+   * is larger than one, a batch callback is set, the system provides
+   * recvmmsg() and the file descriptor did not turn out not to be a
+   * socket.
+   */
+  bool IsBatchRead (void) const;
+
 private:
   FdReader::Data DoRead (void);
 
+  /**
+   * Receive a batch of frames and hand them to the batch callback.
+   * \return A negative length if frames were received, zero if reading
+   * should stop, and a positive length if recvmmsg() is not supported
+   * on this file descriptor and a single frame was read instead.
+   */
+  FdReader::Data DoReadBatch (void);
+
   uint32_t m_bufferSize; //!< size of the read buffer
+  std::atomic<uint32_t> m_batchSize;  //!< maximum number of frames per recvmmsg()
+  Callback<void, const Batch &> m_batchCallback; //!< receives the batches
+  std::vector<uint8_t *> m_buffers; //!< buffers of the next batch
 };
 
 class Node;
@@ -136,6 +183,33 @@ public:
    */
   void SetFileDescriptor (int fd);
 
+  /**
+   * Set the maximum number of frames read or written per system call.
+   *
+   * A batch size larger than one enables recvmmsg() and sendmmsg() on
+   * socket file descriptors; see the \c BatchSize attribute.
+   *
+   * \param batchSize The batch size.
+   */
+  void SetBatchSize (uint32_t batchSize);
+
+  /**
+   * \return true if the device receives frames with recvmmsg() and sends
+   * them with sendmmsg(): the batch size is larger than one, the system
+   * provides these calls and the file descriptor is a socket.
+   */
+  bool IsBatchIo (void) const;
+
+  /**
+   * With a batch size larger than one, Send() and SendFrom() return true
+   * once the frame is queued, before it is written.  The frames which
+   * then fail to be written are reported by the MacTxDrop trace source
+   * and counted here.
+   *
+   * \return The number of queued frames which failed to be written.
+   */
+  uint64_t GetBatchTxDrops (void) const;
+
   /**
    * Set a start time for the device.
    *
@@ -214,11 +288,28 @@ private:
    */
   void ReceiveCallback (uint8_t *buf, ssize_t len);
 
+  /**
+   * Callback to invoke when a batch of frames is received
+   * \param frames The frames.
+   */
+  void ReceiveBatchCallback (const FdNetDeviceFdReader::Batch &frames);
+
   /**
    * Forward the frame to the appropriate callback for processing
    */
   void ForwardUp (void);
 
+  /**
+   * Forward a batch of frames
+   * \param n The number of frames to forward.
+   */
+  void ForwardUpBatch (uint32_t n);
+
+  /**
+   * Write the frames queued for transmission with sendmmsg().
+   */
+  void FlushTransmit (void);
+
   /**
    * Start Sending a Packet Down the Wire.
    * @param p packet to send
@@ -311,6 +402,41 @@ private:
    */
   SystemMutex m_pendingReadMutex;
 
+  /**
+   * Maximum number of frames read or written per system call.
+   */
+  uint32_t m_batchSize;
+
+  /**
+   * A frame waiting for FlushTransmit.
+   */
+  struct TxFrame
+  {
+    uint8_t *buf;          //!< malloc()ed frame
+    size_t len;            //!< frame length
+    Ptr<Packet> packet;    //!< packet the frame was built from
+  };
+
+  /**
+   * Frames waiting for FlushTransmit.
+   */
+  std::vector<TxFrame> m_txBatch;
+
+  /**
+   * Whether FlushTransmit writes the frames with sendmmsg().
+   */
+  bool m_batchTx;
+
+  /**
+   * Number of queued frames which failed to be written.
+   */
+  uint64_t m_batchTxDrops;
+
+  /**
+   * Event writing the frames queued for transmission.
+   */
+  EventId m_flushEvent;
+
   /**
    * Time to start spinning up the device
    */
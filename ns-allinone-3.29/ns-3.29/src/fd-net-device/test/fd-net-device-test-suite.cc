@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/fd-net-device.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/config.h"
+
+#include <sstream>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup fd-net-device
+ * \defgroup fd-net-device-test FdNetDevice module tests
+ */
+
+/**
+ * \ingroup fd-net-device-test
+ * \ingroup tests
+ *
+ * \brief Exchange frames with an FdNetDevice over a datagram socketpair.
+ *
+ * Frames written to the peer socket before the simulation starts must be
+ * received in order, and packets sent by the device must reach the peer,
+ * whatever the batch size.
+ */
+class FdNetDeviceSocketPairTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] batchSize The BatchSize of the device.
+   */
+  FdNetDeviceSocketPairTestCase (uint32_t batchSize);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Build the name of the test case.
+   * \param [in] batchSize The BatchSize of the device.
+   * \return The name.
+   */
+  static std::string BuildNameString (uint32_t batchSize);
+
+  /**
+   * Receive callback of the device.
+   * \param [in] device The device.
+   * \param [in] packet The packet.
+   * \param [in] protocol The protocol number.
+   * \param [in] from The source address.
+   * \return true.
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                uint16_t protocol, const Address &from);
+
+  /**
+   * Send packets from the device.
+   * \param [in] device The device.
+   * \param [in] n The number of packets.
+   */
+  void Send (Ptr<FdNetDevice> device, uint32_t n);
+
+  uint32_t m_batchSize;              //!< Batch size of the device
+  std::vector<uint8_t> m_received;   //!< First payload byte of each packet
+};
+
+std::string
+FdNetDeviceSocketPairTestCase::BuildNameString (uint32_t batchSize)
+{
+  std::ostringstream oss;
+  oss << "Check FdNetDevice with a socketpair, BatchSize " << batchSize;
+  return oss.str ();
+}
+
+FdNetDeviceSocketPairTestCase::FdNetDeviceSocketPairTestCase (uint32_t batchSize)
+  : TestCase (BuildNameString (batchSize)),
+    m_batchSize (batchSize)
+{
+}
+
+bool
+FdNetDeviceSocketPairTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                        uint16_t protocol, const Address &from)
+{
+  uint8_t first = 0;
+  packet->CopyData (&first, 1);
+  m_received.push_back (first);
+  return true;
+}
+
+void
+FdNetDeviceSocketPairTestCase::Send (Ptr<FdNetDevice> device, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      device->Send (Create<Packet> (100), Mac48Address ("00:00:00:00:00:02"), 0x0800);
+    }
+}
+
+void
+FdNetDeviceSocketPairTestCase::DoRun (void)
+{
+  const uint32_t nRx = 20;
+  const uint32_t nTx = 10;
+
+  int sv[2];
+  NS_TEST_ASSERT_MSG_EQ (socketpair (AF_UNIX, SOCK_DGRAM, 0, sv), 0, "socketpair() failed");
+
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<FdNetDevice> device = CreateObject<FdNetDevice> ();
+  device->SetAttribute ("BatchSize", UintegerValue (m_batchSize));
+  device->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+  device->SetFileDescriptor (sv[0]);
+  node->AddDevice (device);
+  device->SetReceiveCallback (MakeCallback (&FdNetDeviceSocketPairTestCase::Receive, this));
+
+  for (uint32_t i = 0; i < nRx; ++i)
+    {
+      uint8_t payload[100] = { static_cast<uint8_t> (i) };
+      Ptr<Packet> p = Create<Packet> (payload, sizeof (payload));
+      EthernetHeader header (false);
+      header.SetSource (Mac48Address ("00:00:00:00:00:02"));
+      header.SetDestination (Mac48Address ("00:00:00:00:00:01"));
+      header.SetLengthType (0x0800);
+      p->AddHeader (header);
+      std::vector<uint8_t> frame (p->GetSize ());
+      p->CopyData (&frame[0], frame.size ());
+      NS_TEST_ASSERT_MSG_EQ (write (sv[1], &frame[0], frame.size ()), (ssize_t) frame.size (), "write() failed");
+    }
+
+  Simulator::Schedule (MilliSeconds (100), &FdNetDeviceSocketPairTestCase::Send, this, device, nTx);
+  Simulator::Stop (MilliSeconds (300));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), nRx, "Frames lost");
+  for (uint32_t i = 0; i < m_received.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t) m_received[i], i, "Frames reordered");
+    }
+
+  uint32_t sent = 0;
+  uint8_t buf[2048];
+  ssize_t len;
+  while ((len = recv (sv[1], buf, sizeof (buf), MSG_DONTWAIT)) > 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (len, 114, "Unexpected frame size");
+      ++sent;
+    }
+  NS_TEST_EXPECT_MSG_EQ (sent, nTx, "Frames not sent");
+  NS_TEST_EXPECT_MSG_EQ (device->GetBatchTxDrops (), 0, "Queued frames dropped");
+
+  // Check that batches are read and written with recvmmsg() and
+  // sendmmsg() where the system provides them.
+#ifdef HAVE_RECVMMSG
+  bool batchIo = (m_batchSize > 1);
+#else
+  bool batchIo = false;
+#endif
+  NS_TEST_EXPECT_MSG_EQ (device->IsBatchIo (), batchIo, "Wrong I/O path");
+
+  Simulator::Destroy ();
+  close (sv[1]);
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup fd-net-device-test
+ * \ingroup tests
+ *
+ * \brief FdNetDevice TestSuite
+ */
+class FdNetDeviceTestSuite : public TestSuite
+{
+public:
+  FdNetDeviceTestSuite ();
+};
+
+FdNetDeviceTestSuite::FdNetDeviceTestSuite ()
+  : TestSuite ("fd-net-device", UNIT)
+{
+  AddTestCase (new FdNetDeviceSocketPairTestCase (1), TestCase::QUICK);
+  AddTestCase (new FdNetDeviceSocketPairTestCase (8), TestCase::QUICK);
+}
+
+static FdNetDeviceTestSuite g_fdNetDeviceTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,205 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the classification throughput of the EpcTftClassifier.
+//
+// Each UE has a default bearer and nBearers dedicated bearers, whose TFTs
+// have nFilters packet filters over port ranges and ToS. Downlink UDP
+// packets to random UEs, ports and ToS are classified as in the P-GW:
+// the UE is looked up by its address, then the packet is classified by
+// its TFTs. The same packets are also classified by matching every
+// packet filter of every TFT, as the classifier did before compiling
+// the filters, and both classifications are checked to agree.
+//
+//   ./waf --run "epc-tft-classifier-benchmark --nUes=1000 --nBearers=4
+//                --nPackets=1000000"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/epc-tft.h"
+#include "ns3/epc-tft-classifier.h"
+
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("EpcTftClassifierBenchmark");
+
+/**
+ * Classify a downlink packet by matching every packet filter of every TFT.
+ *
+ * \param tfts the TFTs of the UE, by bearer ID
+ * \param p the IPv4 packet
+ * \return the ID of the first matching TFT, 0 if none
+ */
+static uint32_t
+ClassifyByMatching (const std::map<uint32_t, Ptr<EpcTft> > &tfts, Ptr<Packet> p)
+{
+  Ptr<Packet> pCopy = p->Copy ();
+  Ipv4Header ipv4Header;
+  pCopy->RemoveHeader (ipv4Header);
+  UdpHeader udpHeader;
+  pCopy->RemoveHeader (udpHeader);
+  for (std::map<uint32_t, Ptr<EpcTft> >::const_reverse_iterator it = tfts.rbegin ();
+       it != tfts.rend ();
+       ++it)
+    {
+      if (it->second->Matches (EpcTft::DOWNLINK, ipv4Header.GetSource (), ipv4Header.GetDestination (),
+                               udpHeader.GetSourcePort (), udpHeader.GetDestinationPort (),
+                               ipv4Header.GetTos ()))
+        {
+          return it->first;
+        }
+    }
+  return 0;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nUes = 1000;
+  uint32_t nBearers = 4;
+  uint32_t nFilters = 4;
+  uint32_t nPackets = 1000000;
+  uint32_t nDistinctPackets = 10000;
+
+  CommandLine cmd;
+  cmd.AddValue ("nUes", "number of UEs", nUes);
+  cmd.AddValue ("nBearers", "number of dedicated bearers per UE", nBearers);
+  cmd.AddValue ("nFilters", "number of packet filters per dedicated bearer", nFilters);
+  cmd.AddValue ("nPackets", "number of packets to classify", nPackets);
+  cmd.AddValue ("nDistinctPackets", "number of distinct packets", nDistinctPackets);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (nBearers > 10, "at most 10 dedicated bearers per UE");
+  NS_ABORT_MSG_IF (nFilters > 15, "at most 15 packet filters per TFT");
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+
+  std::vector<Ipv4Address> ueAddresses;
+  std::unordered_map<Ipv4Address, Ptr<EpcTftClassifier>, Ipv4AddressHash> classifiers;
+  std::unordered_map<Ipv4Address, std::map<uint32_t, Ptr<EpcTft> >, Ipv4AddressHash> tfts;
+  for (uint32_t u = 0; u < nUes; ++u)
+    {
+      Ipv4Address ueAddress (0x07000002 + u);
+      ueAddresses.push_back (ueAddress);
+      Ptr<EpcTftClassifier> classifier = Create<EpcTftClassifier> ();
+      classifiers[ueAddress] = classifier;
+
+      classifier->Add (EpcTft::Default (), 1);
+      tfts[ueAddress][1] = EpcTft::Default ();
+      for (uint32_t b = 0; b < nBearers; ++b)
+        {
+          Ptr<EpcTft> tft = Create<EpcTft> ();
+          for (uint32_t f = 0; f < nFilters; ++f)
+            {
+              EpcTft::PacketFilter pf;
+              pf.direction = (f % 2 == 0) ? EpcTft::BIDIRECTIONAL : EpcTft::DOWNLINK;
+              pf.remotePortStart = random->GetInteger (1024, 60000);
+              pf.remotePortEnd = pf.remotePortStart + random->GetInteger (0, 100);
+              pf.localPortStart = random->GetInteger (1024, 60000);
+              pf.localPortEnd = pf.localPortStart + random->GetInteger (0, 1000);
+              if (f % 3 == 0)
+                {
+                  pf.typeOfService = random->GetInteger (0, 63) << 2;
+                  pf.typeOfServiceMask = 0xfc;
+                }
+              tft->Add (pf);
+            }
+          classifier->Add (tft, b + 2);
+          tfts[ueAddress][b + 2] = tft;
+        }
+    }
+
+  // half of the packets match a dedicated bearer
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < nDistinctPackets; ++i)
+    {
+      Ipv4Address ueAddress = ueAddresses[random->GetInteger (0, nUes - 1)];
+      UdpHeader udpHeader;
+      uint8_t tos = random->GetInteger (0, 63) << 2;
+      if (nBearers > 0 && i % 2 == 0)
+        {
+          uint32_t b = random->GetInteger (2, nBearers + 1);
+          EpcTft::PacketFilter pf = tfts[ueAddress][b]->GetPacketFilters ().front ();
+          udpHeader.SetSourcePort (random->GetInteger (pf.remotePortStart, pf.remotePortEnd));
+          udpHeader.SetDestinationPort (random->GetInteger (pf.localPortStart, pf.localPortEnd));
+          tos = (tos & ~pf.typeOfServiceMask) | pf.typeOfService;
+        }
+      else
+        {
+          udpHeader.SetSourcePort (random->GetInteger (1, 65535));
+          udpHeader.SetDestinationPort (random->GetInteger (1, 65535));
+        }
+      Ipv4Header ipv4Header;
+      ipv4Header.SetSource (Ipv4Address ("1.0.0.2"));
+      ipv4Header.SetDestination (ueAddress);
+      ipv4Header.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+      ipv4Header.SetTos (tos);
+      ipv4Header.SetPayloadSize (8 + 100);
+      Ptr<Packet> packet = Create<Packet> (100);
+      packet->AddHeader (udpHeader);
+      packet->AddHeader (ipv4Header);
+      packets.push_back (packet);
+    }
+
+  uint32_t dedicated = 0;
+  uint32_t mismatches = 0;
+  for (uint32_t i = 0; i < nDistinctPackets; ++i)
+    {
+      Ipv4Header ipv4Header;
+      packets[i]->PeekHeader (ipv4Header);
+      uint32_t id = classifiers[ipv4Header.GetDestination ()]->Classify (packets[i], EpcTft::DOWNLINK);
+      dedicated += (id > 1);
+      mismatches += (id != ClassifyByMatching (tfts[ipv4Header.GetDestination ()], packets[i]));
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i < nPackets; ++i)
+    {
+      Ptr<Packet> packet = packets[i % nDistinctPackets];
+      uint8_t buf[20];
+      packet->CopyData (buf, 20);
+      Ipv4Address ueAddress ((buf[16] << 24) | (buf[17] << 16) | (buf[18] << 8) | buf[19]);
+      sum += classifiers[ueAddress]->Classify (packet, EpcTft::DOWNLINK);
+    }
+  int64_t compiledMs = clock.End ();
+
+  clock.Start ();
+  for (uint32_t i = 0; i < nPackets; ++i)
+    {
+      Ptr<Packet> packet = packets[i % nDistinctPackets];
+      Ipv4Header ipv4Header;
+      packet->PeekHeader (ipv4Header);
+      sum -= ClassifyByMatching (tfts[ipv4Header.GetDestination ()], packet);
+    }
+  int64_t matchingMs = clock.End ();
+
+  std::cout << nUes << " UEs, " << nBearers << " dedicated bearers of "
+            << nFilters << " filters each" << std::endl;
+  std::cout << dedicated << " of " << nDistinctPackets << " distinct packets classified to a dedicated bearer, "
+            << mismatches << " mismatches" << std::endl;
+  std::cout << "compiled classifier: " << compiledMs << " ms, "
+            << (compiledMs > 0 ? nPackets * 1000.0 / compiledMs : 0) << " packets/s" << std::endl;
+  std::cout << "matching every filter: " << matchingMs << " ms, "
+            << (matchingMs > 0 ? nPackets * 1000.0 / matchingMs : 0) << " packets/s" << std::endl;
+
+  return (mismatches == 0 && sum == 0) ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Convert and generate fading traces for the TraceFadingLossModel.
+//
+// Convert a text trace to the binary format, which is memory-mapped
+// and shared by all the models using it:
+//
+//   ./waf --run "lena-fading-trace-tool --input=fading_trace_EPA_3kmph.fad
+//                --output=fading_trace_EPA_3kmph.bin"
+//
+// Generate a new trace for one of the 3GPP TS 36.104 Annex B.2 delay
+// profiles (EPA, EVA or ETU), at a given speed and carrier frequency:
+//
+//   ./waf --run "lena-fading-trace-tool --profile=EVA --speed=60
+//                --output=fading_trace_EVA_60kmph.bin"
+//
+// The output is written in the text format if --text is given.
+
+#include "ns3/core-module.h"
+#include "ns3/lte-fading-trace.h"
+
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LenaFadingTraceTool");
+
+int main (int argc, char *argv[])
+{
+  std::string input = "";
+  std::string output = "fading_trace.bin";
+  std::string profile = "EPA";
+  double speed = 3.0; // km/h
+  double frequency = 2160e6; // Hz, DL EARFCN 500
+  double length = 10.0; // s
+  uint32_t samplesNum = 10000;
+  uint32_t rbNum = 100;
+  bool text = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "text trace to convert (generate a new trace if empty)", input);
+  cmd.AddValue ("output", "output trace", output);
+  cmd.AddValue ("profile", "delay profile of a generated trace: EPA, EVA or ETU", profile);
+  cmd.AddValue ("speed", "speed of the UE of a generated trace, in km/h", speed);
+  cmd.AddValue ("frequency", "carrier frequency of a generated trace, in Hz", frequency);
+  cmd.AddValue ("length", "length of a generated trace, in s", length);
+  cmd.AddValue ("samplesNum", "number of samples per RB", samplesNum);
+  cmd.AddValue ("rbNum", "number of RBs", rbNum);
+  cmd.AddValue ("text", "write the output in the text format", text);
+  cmd.Parse (argc, argv);
+
+  Ptr<const LteFadingTrace> trace;
+  if (!input.empty ())
+    {
+      trace = LteFadingTrace::Load (input, rbNum, samplesNum);
+    }
+  else
+    {
+      // excess tap delays and relative powers of 3GPP TS 36.104 Annex B.2
+      std::vector<double> delays;
+      std::vector<double> powers;
+      if (profile == "EPA")
+        {
+          double d[] = { 0, 30e-9, 70e-9, 90e-9, 120e-9, 190e-9, 410e-9 };
+          double p[] = { 0.0, -1.0, -2.0, -3.0, -8.0, -17.2, -20.8 };
+          delays.assign (d, d + 7);
+          powers.assign (p, p + 7);
+        }
+      else if (profile == "EVA")
+        {
+          double d[] = { 0, 30e-9, 150e-9, 310e-9, 370e-9, 710e-9, 1090e-9, 1730e-9, 2510e-9 };
+          double p[] = { 0.0, -1.5, -1.4, -3.6, -0.6, -9.1, -7.0, -12.0, -16.9 };
+          delays.assign (d, d + 9);
+          powers.assign (p, p + 9);
+        }
+      else if (profile == "ETU")
+        {
+          double d[] = { 0, 50e-9, 120e-9, 200e-9, 230e-9, 500e-9, 1600e-9, 2300e-9, 5000e-9 };
+          double p[] = { -1.0, -1.0, -1.0, 0.0, 0.0, 0.0, -3.0, -5.0, -7.0 };
+          delays.assign (d, d + 9);
+          powers.assign (p, p + 9);
+        }
+      else
+        {
+          NS_FATAL_ERROR ("Unknown delay profile " << profile);
+        }
+      double doppler = speed / 3.6 * frequency / 299792458.0;
+      Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+      trace = LteFadingTrace::Generate (delays, powers, doppler, Seconds (length),
+                                        rbNum, samplesNum, random);
+    }
+
+  if (text)
+    {
+      trace->WriteText (output);
+    }
+  else
+    {
+      trace->WriteBinary (output);
+    }
+  std::cout << "wrote " << trace->GetRbNum () << " RBs x " << trace->GetSamplesNum ()
+            << " samples to " << output << std::endl;
+  return 0;
+}
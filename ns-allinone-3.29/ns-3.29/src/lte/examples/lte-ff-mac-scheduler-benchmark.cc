@@ -0,0 +1,377 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the time taken by the FF MAC schedulers to schedule a cell.
+//
+// Each scheduler is driven directly through its SAPs, as the eNB MAC does,
+// for a cell with nUes UEs which have one non-GBR bearer each and always
+// have data to send in both directions. Every TTI, the scheduler receives
+// the DL and UL triggers, the RLC buffer status of the UEs scheduled in
+// the previous TTI, the DL CQIs of one tenth of the UEs, the BSRs of
+// another tenth of the UEs and the UL CQIs of the allocations of
+// UL_PUSCH_TTIS_DELAY TTIs before. HARQ is disabled, so that no HARQ
+// feedback is needed. The program reports the wall-clock time taken per
+// TTI, and the number of DL and UL allocations, for each scheduler and
+// number of UEs.
+//
+//   ./waf --run "lte-ff-mac-scheduler-benchmark --nUes=50,200,500
+//                --schedulers=ns3::PfFfMacScheduler,ns3::PssFfMacScheduler"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/lte-common.h"
+#include "ns3/ff-mac-common.h"
+#include "ns3/ff-mac-csched-sap.h"
+#include "ns3/ff-mac-sched-sap.h"
+#include "ns3/ff-mac-scheduler.h"
+#include "ns3/lte-fr-no-op-algorithm.h"
+
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteFfMacSchedulerBenchmark");
+
+/**
+ * SAP user of the scheduler, which keeps the last DL and UL scheduling
+ * decisions.
+ */
+class BenchmarkSchedSapUser : public FfMacSchedSapUser
+{
+public:
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+  {
+    m_dlConfig = params;
+  }
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+  {
+    m_ulConfig = params;
+  }
+
+  SchedDlConfigIndParameters m_dlConfig; ///< the last DL scheduling decision
+  SchedUlConfigIndParameters m_ulConfig; ///< the last UL scheduling decision
+};
+
+/**
+ * CSCHED SAP user of the scheduler, which ignores the confirmations.
+ */
+class BenchmarkCschedSapUser : public FfMacCschedSapUser
+{
+public:
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+  {
+  }
+};
+
+/// the state of a benchmark run
+struct BenchmarkRun
+{
+  Ptr<FfMacScheduler> scheduler; ///< the scheduler
+  BenchmarkSchedSapUser schedSapUser; ///< the SAP user of the scheduler
+  Ptr<UniformRandomVariable> random; ///< the random variable of the CQIs
+  uint16_t nUes; ///< the number of UEs
+  uint8_t bandwidth; ///< the DL and UL bandwidth in RBs
+  uint32_t nTtis; ///< the number of TTIs to run
+  uint32_t tti; ///< the current TTI
+  std::deque<FfMacSchedSapProvider::SchedUlCqiInfoReqParameters> ulCqis; ///< the pending UL CQIs
+  uint64_t dlAllocations; ///< the number of DL allocations
+  uint64_t ulAllocations; ///< the number of UL allocations
+};
+
+/**
+ * \param tti the TTI
+ * \return the frame and subframe numbers of the TTI, in the FF API format
+ */
+static uint16_t
+SfnSf (uint32_t tti)
+{
+  uint32_t frame = (tti / 10) % 1024 + 1;
+  uint32_t subframe = tti % 10 + 1;
+  return ((0x3FF & frame) << 4) | (0xF & subframe);
+}
+
+/**
+ * \param rnti the RNTI of the UE
+ * \param transmissionQueueSize the size of the RLC transmission queue
+ * \return the RLC buffer status of the bearer of the UE
+ */
+static FfMacSchedSapProvider::SchedDlRlcBufferReqParameters
+RlcBufferStatus (uint16_t rnti, uint32_t transmissionQueueSize)
+{
+  FfMacSchedSapProvider::SchedDlRlcBufferReqParameters params;
+  params.m_rnti = rnti;
+  params.m_logicalChannelIdentity = 3;
+  params.m_rlcTransmissionQueueSize = transmissionQueueSize;
+  params.m_rlcTransmissionQueueHolDelay = 10;
+  params.m_rlcRetransmissionQueueSize = 0;
+  params.m_rlcRetransmissionHolDelay = 0;
+  params.m_rlcStatusPduSize = 0;
+  return params;
+}
+
+/**
+ * Configure the cell and the UEs in the scheduler.
+ *
+ * \param r the run
+ */
+static void
+Configure (BenchmarkRun *r)
+{
+  FfMacCschedSapProvider *csched = r->scheduler->GetFfMacCschedSapProvider ();
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cellParams;
+  cellParams.m_ulBandwidth = r->bandwidth;
+  cellParams.m_dlBandwidth = r->bandwidth;
+  csched->CschedCellConfigReq (cellParams);
+
+  for (uint16_t rnti = 1; rnti <= r->nUes; ++rnti)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ueParams;
+      ueParams.m_rnti = rnti;
+      ueParams.m_reconfigureFlag = false;
+      ueParams.m_transmissionMode = 0;
+      csched->CschedUeConfigReq (ueParams);
+
+      LogicalChannelConfigListElement_s lc;
+      lc.m_logicalChannelIdentity = 3;
+      lc.m_logicalChannelGroup = 0;
+      lc.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lc.m_qci = 9;
+      lc.m_eRabMaximulBitrateUl = 10000000;
+      lc.m_eRabMaximulBitrateDl = 10000000;
+      lc.m_eRabGuaranteedBitrateUl = 1000000;
+      lc.m_eRabGuaranteedBitrateDl = 1000000;
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lcParams;
+      lcParams.m_rnti = rnti;
+      lcParams.m_reconfigureFlag = false;
+      lcParams.m_logicalChannelConfigList.push_back (lc);
+      csched->CschedLcConfigReq (lcParams);
+
+      r->scheduler->GetFfMacSchedSapProvider ()->SchedDlRlcBufferReq (RlcBufferStatus (rnti, 100000));
+    }
+}
+
+/**
+ * Run a TTI, and schedule the next one until all the TTIs are run.
+ *
+ * \param r the run
+ */
+static void
+Tti (BenchmarkRun *r)
+{
+  FfMacSchedSapProvider *sched = r->scheduler->GetFfMacSchedSapProvider ();
+  uint8_t rbgSize = (r->bandwidth <= 10) ? 1 : (r->bandwidth <= 26) ? 2 : (r->bandwidth <= 63) ? 3 : 4;
+  uint8_t nRbgs = (r->bandwidth + rbgSize - 1) / rbgSize;
+
+  // the RLC entities of the UEs scheduled in the previous TTI report
+  // their new buffer status
+  for (uint32_t i = 0; i < r->schedSapUser.m_dlConfig.m_buildDataList.size (); ++i)
+    {
+      sched->SchedDlRlcBufferReq (RlcBufferStatus (r->schedSapUser.m_dlConfig.m_buildDataList.at (i).m_rnti, 100000));
+    }
+
+  // DL CQIs: wideband and subband CQIs of one tenth of the UEs
+  FfMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiParams;
+  cqiParams.m_sfnSf = SfnSf (r->tti);
+  for (uint16_t rnti = r->tti % 10 + 1; rnti <= r->nUes; rnti += 10)
+    {
+      CqiListElement_s p10;
+      p10.m_rnti = rnti;
+      p10.m_ri = 1;
+      p10.m_cqiType = CqiListElement_s::P10;
+      p10.m_wbCqi.push_back (r->random->GetInteger (1, 15));
+      p10.m_wbPmi = 0;
+      cqiParams.m_cqiList.push_back (p10);
+
+      CqiListElement_s a30;
+      a30.m_rnti = rnti;
+      a30.m_ri = 1;
+      a30.m_cqiType = CqiListElement_s::A30;
+      a30.m_wbPmi = 0;
+      for (uint8_t k = 0; k < nRbgs; ++k)
+        {
+          HigherLayerSelected_s hl;
+          hl.m_sbPmi = 0;
+          hl.m_sbCqi.push_back (r->random->GetInteger (1, 15));
+          a30.m_sbMeasResult.m_higherLayerSelected.push_back (hl);
+        }
+      cqiParams.m_cqiList.push_back (a30);
+    }
+  sched->SchedDlCqiInfoReq (cqiParams);
+
+  // BSRs of one tenth of the UEs
+  FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsrParams;
+  bsrParams.m_sfnSf = SfnSf (r->tti);
+  for (uint16_t rnti = (r->tti + 5) % 10 + 1; rnti <= r->nUes; rnti += 10)
+    {
+      MacCeListElement_s bsr;
+      bsr.m_rnti = rnti;
+      bsr.m_macCeType = MacCeListElement_s::BSR;
+      bsr.m_macCeValue.m_bufferStatus.push_back (40);
+      bsr.m_macCeValue.m_bufferStatus.push_back (0);
+      bsr.m_macCeValue.m_bufferStatus.push_back (0);
+      bsr.m_macCeValue.m_bufferStatus.push_back (0);
+      bsrParams.m_macCeList.push_back (bsr);
+    }
+  sched->SchedUlMacCtrlInfoReq (bsrParams);
+
+  // UL CQIs of the allocations received in this TTI
+  while (!r->ulCqis.empty () && r->ulCqis.front ().m_sfnSf == SfnSf (r->tti))
+    {
+      sched->SchedUlCqiInfoReq (r->ulCqis.front ());
+      r->ulCqis.pop_front ();
+    }
+
+  FfMacSchedSapProvider::SchedDlTriggerReqParameters dlParams;
+  dlParams.m_sfnSf = SfnSf (r->tti);
+  r->schedSapUser.m_dlConfig.m_buildDataList.clear ();
+  sched->SchedDlTriggerReq (dlParams);
+  r->dlAllocations += r->schedSapUser.m_dlConfig.m_buildDataList.size ();
+
+  uint32_t ulTti = r->tti + UL_PUSCH_TTIS_DELAY;
+  FfMacSchedSapProvider::SchedUlTriggerReqParameters ulParams;
+  ulParams.m_sfnSf = SfnSf (ulTti);
+  r->schedSapUser.m_ulConfig.m_dciList.clear ();
+  sched->SchedUlTriggerReq (ulParams);
+  r->ulAllocations += r->schedSapUser.m_ulConfig.m_dciList.size ();
+  if (!r->schedSapUser.m_ulConfig.m_dciList.empty ())
+    {
+      FfMacSchedSapProvider::SchedUlCqiInfoReqParameters ulCqiParams;
+      ulCqiParams.m_sfnSf = SfnSf (ulTti);
+      ulCqiParams.m_ulCqi.m_type = UlCqi_s::PUSCH;
+      for (uint8_t rb = 0; rb < r->bandwidth; ++rb)
+        {
+          ulCqiParams.m_ulCqi.m_sinr.push_back (LteFfConverter::double2fpS11dot3 (r->random->GetValue (0.0, 20.0)));
+        }
+      r->ulCqis.push_back (ulCqiParams);
+    }
+
+  if (++r->tti < r->nTtis)
+    {
+      Simulator::Schedule (MilliSeconds (1), &Tti, r);
+    }
+}
+
+/**
+ * \param list a comma separated list
+ * \return the elements of the list
+ */
+static std::vector<std::string>
+Split (std::string list)
+{
+  std::vector<std::string> elements;
+  std::istringstream iss (list);
+  std::string element;
+  while (std::getline (iss, element, ','))
+    {
+      elements.push_back (element);
+    }
+  return elements;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string schedulers = "ns3::RrFfMacScheduler,ns3::PfFfMacScheduler,ns3::FdMtFfMacScheduler,"
+    "ns3::TdMtFfMacScheduler,ns3::TtaFfMacScheduler,ns3::FdBetFfMacScheduler,ns3::TdBetFfMacScheduler,"
+    "ns3::FdTbfqFfMacScheduler,ns3::TdTbfqFfMacScheduler,ns3::PssFfMacScheduler,ns3::CqaFfMacScheduler";
+  std::string nUesList = "50,200,500";
+  uint32_t nTtis = 1000;
+  uint16_t bandwidth = 100;
+
+  CommandLine cmd;
+  cmd.AddValue ("schedulers", "comma separated list of the schedulers", schedulers);
+  cmd.AddValue ("nUes", "comma separated list of the numbers of UEs in the cell", nUesList);
+  cmd.AddValue ("nTtis", "number of TTIs to schedule", nTtis);
+  cmd.AddValue ("bandwidth", "DL and UL bandwidth in RBs", bandwidth);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (24) << std::left << "scheduler" << std::right
+            << std::setw (6) << "UEs" << std::setw (12) << "us/TTI"
+            << std::setw (12) << "DL allocs" << std::setw (12) << "UL allocs" << std::endl;
+
+  std::vector<std::string> schedulerTypes = Split (schedulers);
+  std::vector<std::string> nUesValues = Split (nUesList);
+  for (uint32_t s = 0; s < schedulerTypes.size (); ++s)
+    {
+      for (uint32_t u = 0; u < nUesValues.size (); ++u)
+        {
+          ObjectFactory factory;
+          factory.SetTypeId (schedulerTypes[s]);
+          factory.Set ("HarqEnabled", BooleanValue (false));
+
+          BenchmarkRun r;
+          r.scheduler = factory.Create<FfMacScheduler> ();
+          r.random = CreateObject<UniformRandomVariable> ();
+          r.nUes = std::atoi (nUesValues[u].c_str ());
+          r.bandwidth = bandwidth;
+          r.nTtis = nTtis;
+          r.tti = 0;
+          r.dlAllocations = 0;
+          r.ulAllocations = 0;
+
+          BenchmarkCschedSapUser cschedSapUser;
+          r.scheduler->SetFfMacSchedSapUser (&r.schedSapUser);
+          r.scheduler->SetFfMacCschedSapUser (&cschedSapUser);
+          Ptr<LteFfrAlgorithm> ffrAlgorithm = CreateObject<LteFrNoOpAlgorithm> ();
+          ffrAlgorithm->SetDlBandwidth (bandwidth);
+          ffrAlgorithm->SetUlBandwidth (bandwidth);
+          r.scheduler->SetLteFfrSapProvider (ffrAlgorithm->GetLteFfrSapProvider ());
+          ffrAlgorithm->SetLteFfrSapUser (r.scheduler->GetLteFfrSapUser ());
+
+          Configure (&r);
+          Simulator::Schedule (MilliSeconds (1), &Tti, &r);
+
+          SystemWallClockMs clock;
+          clock.Start ();
+          Simulator::Run ();
+          int64_t ms = clock.End ();
+          Simulator::Destroy ();
+          r.scheduler->Dispose ();
+          ffrAlgorithm->Dispose ();
+
+          std::cout << std::setw (24) << std::left << schedulerTypes[s].substr (5) << std::right
+                    << std::setw (6) << r.nUes
+                    << std::setw (12) << std::fixed << std::setprecision (1) << ms * 1000.0 / nTtis
+                    << std::setw (12) << r.dlAllocations << std::setw (12) << r.ulAllocations << std::endl;
+        }
+    }
+
+  return 0;
+}
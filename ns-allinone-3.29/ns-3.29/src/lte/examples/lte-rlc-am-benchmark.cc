@@ -0,0 +1,224 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the throughput of LteRlcAm with a deep transmission queue.
+//
+// Two RLC AM entities are connected back to back by a loopback MAC, which
+// gives a transmission opportunity of txOpportunity bytes to each of them
+// every TTI, in which they have data, retransmissions or a status PDU to
+// send, and drops a fraction lossRate of the data PDUs.  The transmitter
+// is given nSdus SDUs at once, and the program reports the wall-clock
+// time taken to deliver them.
+//
+//   ./waf --run "lte-rlc-am-benchmark --nSdus=50000 --txOpportunity=10000"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-rlc-sap.h"
+#include "ns3/lte-mac-sap.h"
+
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRlcAmBenchmark");
+
+/**
+ * MAC SAP provider of one of the RLC entities, which delivers the PDUs to
+ * the peer RLC entity and keeps the last buffer status report.
+ */
+class LoopbackMacSapProvider : public LteMacSapProvider
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param random the random variable used to drop the data PDUs
+   * \param lossRate the probability to drop a data PDU
+   */
+  LoopbackMacSapProvider (Ptr<UniformRandomVariable> random, double lossRate)
+    : m_peer (0),
+      m_random (random),
+      m_lossRate (lossRate),
+      m_pendingBytes (0)
+  {
+  }
+
+  /**
+   * \param peer the MAC SAP user of the peer RLC entity
+   */
+  void SetPeer (LteMacSapUser *peer)
+  {
+    m_peer = peer;
+  }
+
+  /**
+   * \return the number of bytes that the RLC entity has to send
+   */
+  uint32_t GetPendingBytes () const
+  {
+    return m_pendingBytes;
+  }
+
+  virtual void TransmitPdu (TransmitPduParameters params)
+  {
+    // the status PDUs are never lost, so that the simulation always ends
+    if (params.pdu->GetSize () > 4 && m_random->GetValue () < m_lossRate)
+      {
+        return;
+      }
+    m_peer->ReceivePdu (params.pdu, params.rnti, params.lcid);
+  }
+
+  virtual void ReportBufferStatus (ReportBufferStatusParameters params)
+  {
+    m_pendingBytes = params.txQueueSize + params.retxQueueSize + params.statusPduSize;
+  }
+
+private:
+  LteMacSapUser *m_peer; ///< the MAC SAP user of the peer RLC entity
+  Ptr<UniformRandomVariable> m_random; ///< the random variable used to drop the data PDUs
+  double m_lossRate; ///< the probability to drop a data PDU
+  uint32_t m_pendingBytes; ///< the bytes to send in the last buffer status report
+};
+
+/**
+ * RLC SAP user of the receiving RLC entity, which counts the SDUs.
+ */
+class CountingRlcSapUser : public LteRlcSapUser
+{
+public:
+  CountingRlcSapUser ()
+    : m_sdus (0),
+      m_bytes (0)
+  {
+  }
+
+  virtual void ReceivePdcpPdu (Ptr<Packet> p)
+  {
+    ++m_sdus;
+    m_bytes += p->GetSize ();
+  }
+
+  uint32_t m_sdus; ///< the number of SDUs received
+  uint64_t m_bytes; ///< the number of bytes received
+};
+
+/// the parameters of the TTIs
+struct TtiParameters
+{
+  Ptr<LteRlc> tx; ///< the transmitting RLC entity
+  Ptr<LteRlc> rx; ///< the receiving RLC entity
+  LoopbackMacSapProvider *txMac; ///< the MAC of the transmitting RLC entity
+  LoopbackMacSapProvider *rxMac; ///< the MAC of the receiving RLC entity
+  CountingRlcSapUser *sink; ///< the SDU counter
+  uint32_t nSdus; ///< the number of SDUs to deliver
+  uint32_t txOpportunity; ///< the size of the transmission opportunities
+};
+
+/**
+ * Give a transmission opportunity to the RLC entities which have something
+ * to send, and schedule the next TTI until all the SDUs are delivered.
+ *
+ * \param p the parameters
+ */
+static void
+Tti (TtiParameters *p)
+{
+  if (p->txMac->GetPendingBytes () > 0)
+    {
+      p->tx->GetLteMacSapUser ()->NotifyTxOpportunity (p->txOpportunity, 0, 0, 0, 1, 3);
+    }
+  if (p->rxMac->GetPendingBytes () > 0)
+    {
+      p->rx->GetLteMacSapUser ()->NotifyTxOpportunity (p->txOpportunity, 0, 0, 0, 1, 3);
+    }
+  if (p->sink->m_sdus < p->nSdus)
+    {
+      Simulator::Schedule (MilliSeconds (1), &Tti, p);
+    }
+  else
+    {
+      Simulator::Stop ();
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nSdus = 50000;
+  uint32_t sduSize = 1400;
+  uint32_t txOpportunity = 10000;
+  double lossRate = 0.01;
+
+  CommandLine cmd;
+  cmd.AddValue ("nSdus", "number of SDUs in the transmission queue", nSdus);
+  cmd.AddValue ("sduSize", "size of the SDUs in bytes", sduSize);
+  cmd.AddValue ("txOpportunity", "size of the transmission opportunities in bytes", txOpportunity);
+  cmd.AddValue ("lossRate", "probability to lose a data PDU", lossRate);
+  cmd.Parse (argc, argv);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  LoopbackMacSapProvider txMac (random, lossRate);
+  LoopbackMacSapProvider rxMac (random, lossRate);
+  CountingRlcSapUser sink;
+
+  Ptr<LteRlc> tx = CreateObject<LteRlcAm> ();
+  Ptr<LteRlc> rx = CreateObject<LteRlcAm> ();
+  tx->SetRnti (1);
+  tx->SetLcId (3);
+  tx->SetLteMacSapProvider (&txMac);
+  rx->SetRnti (1);
+  rx->SetLcId (3);
+  rx->SetLteMacSapProvider (&rxMac);
+  rx->SetLteRlcSapUser (&sink);
+  txMac.SetPeer (rx->GetLteMacSapUser ());
+  rxMac.SetPeer (tx->GetLteMacSapUser ());
+
+  for (uint32_t i = 0; i < nSdus; ++i)
+    {
+      LteRlcSapProvider::TransmitPdcpPduParameters params;
+      params.pdcpPdu = Create<Packet> (sduSize);
+      params.rnti = 1;
+      params.lcid = 3;
+      tx->GetLteRlcSapProvider ()->TransmitPdcpPdu (params);
+    }
+
+  TtiParameters p;
+  p.tx = tx;
+  p.rx = rx;
+  p.txMac = &txMac;
+  p.rxMac = &rxMac;
+  p.sink = &sink;
+  p.nSdus = nSdus;
+  p.txOpportunity = txOpportunity;
+  Simulator::Schedule (MilliSeconds (1), &Tti, &p);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+  Time simulated = Simulator::Now ();
+  Simulator::Destroy ();
+
+  std::cout << sink.m_sdus << " of " << nSdus << " SDUs of " << sduSize << " bytes delivered in "
+            << simulated.GetSeconds () << " s of simulated time ("
+            << sink.m_bytes * 8 / simulated.GetSeconds () / 1e6 << " Mbit/s)" << std::endl;
+  std::cout << "wall-clock time: " << ms << " ms, "
+            << (ms > 0 ? sink.m_sdus * 1000.0 / ms : 0) << " SDUs/s" << std::endl;
+
+  return (sink.m_sdus == nSdus) ? 0 : 1;
+}
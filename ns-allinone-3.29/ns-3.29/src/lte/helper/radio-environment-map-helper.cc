@@ -37,9 +37,22 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/node-list.h>
+#include <ns3/building-list.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/component-carrier-enb.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
 
 #include <fstream>
 #include <limits>
+#include <cmath>
+#include <algorithm>
+#include <thread>
 
 namespace ns3 {
 
@@ -48,6 +61,7 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
+  : m_maxLossDb (std::numeric_limits<double>::max ())
 {
 }
 
@@ -62,6 +76,8 @@ void
 RadioEnvironmentMapHelper::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_transmitters.clear ();
+  m_propagationLoss = 0;
 }
 
 TypeId
@@ -117,7 +133,7 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    DoubleValue (1.4230e-13),
                    MakeDoubleAccessor (&RadioEnvironmentMapHelper::m_noisePower),
                    MakeDoubleChecker<double> ())
-    .AddAttribute ("MaxPointsPerIteration", "Maximum number of REM points to be calculated per iteration. Every point consumes approximately 5KB of memory.",
+    .AddAttribute ("MaxPointsPerIteration", "Maximum number of REM points to be calculated per iteration. Every point consumes approximately 5KB of memory, or 8 bytes with DirectComputation, in which case this is the size of the tiles written to the output file.",
                    UintegerValue (20000),
                    MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_maxPointsPerIteration),
                    MakeUintegerChecker<uint32_t> (1,std::numeric_limits<uint32_t>::max ()))
@@ -144,6 +160,21 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("DirectComputation",
+                   "If true, the REM is computed directly from the pathloss and the antenna gains "
+                   "of the eNBs on the channel, instead of by simulating a listener in each point. "
+                   "All the eNBs are assumed to transmit over their whole bandwidth, and "
+                   "the SpectrumPropagationLossModel of the channel (e.g., fading) is ignored",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_directComputation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NumThreads",
+                   "Number of threads computing the REM when DirectComputation is true. "
+                   "More than one thread requires a PropagationLossModel which can be called "
+                   "concurrently, i.e., without random variables or caches, and no building",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1, 1024))
   ;
   return tid;
 }
@@ -200,6 +231,12 @@ RadioEnvironmentMapHelper::Install ()
       return;
     }
   
+  if (m_directComputation)
+    {
+      Simulator::ScheduleNow (&RadioEnvironmentMapHelper::ComputeDirectly, this);
+      return;
+    }
+
   double startDelay = 0.0026;
 
   if (m_useDataChannel)
@@ -340,6 +377,177 @@ RadioEnvironmentMapHelper::PrintAndReset ()
     }
 }
 
+void
+RadioEnvironmentMapHelper::ComputeDirectly ()
+{
+  NS_LOG_FUNCTION (this);
+  m_xStep = (m_xMax - m_xMin)/(m_xRes-1);
+  m_yStep = (m_yMax - m_yMin)/(m_yRes-1);
+
+  // same coordinates as in the simulated REM
+  m_x.clear ();
+  for (double x = m_xMin; x < m_xMax + 0.5*m_xStep; x += m_xStep)
+    {
+      m_x.push_back (x);
+    }
+  m_y.clear ();
+  for (double y = m_yMin; y < m_yMax + 0.5*m_yStep; y += m_yStep)
+    {
+      m_y.push_back (y);
+    }
+
+  // the eNBs transmitting on the channel, with the power received over
+  // the bandwidth of the REM as it would be by a RemSpectrumPhy
+  Ptr<const SpectrumModel> remModel = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+  m_transmitters.clear ();
+  for (NodeList::Iterator nit = NodeList::Begin (); nit != NodeList::End (); ++nit)
+    {
+      for (uint32_t i = 0; i < (*nit)->GetNDevices (); ++i)
+        {
+          Ptr<LteEnbNetDevice> enbDev = DynamicCast<LteEnbNetDevice> ((*nit)->GetDevice (i));
+          if (enbDev == 0)
+            {
+              continue;
+            }
+          std::map<uint8_t, Ptr<ComponentCarrierEnb> > ccMap = enbDev->GetCcMap ();
+          for (std::map<uint8_t, Ptr<ComponentCarrierEnb> >::iterator it = ccMap.begin ();
+               it != ccMap.end ();
+               ++it)
+            {
+              Ptr<LteEnbPhy> phy = it->second->GetPhy ();
+              Ptr<LteSpectrumPhy> dlPhy = phy->GetDownlinkSpectrumPhy ();
+              if (dlPhy->GetChannel () != m_channel)
+                {
+                  continue;
+                }
+              std::vector<int> dlRb;
+              for (uint8_t rb = 0; rb < it->second->GetDlBandwidth (); ++rb)
+                {
+                  dlRb.push_back (rb);
+                }
+              Ptr<SpectrumValue> psd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (it->second->GetDlEarfcn (),
+                                                                                               it->second->GetDlBandwidth (),
+                                                                                               phy->GetTxPower (),
+                                                                                               dlRb);
+              if (psd->GetSpectrumModel () != remModel)
+                {
+                  SpectrumConverter converter (psd->GetSpectrumModel (), remModel);
+                  psd = converter.Convert (psd);
+                }
+              RemTransmitter tx;
+              tx.position = dlPhy->GetMobility ()->GetPosition ();
+              tx.power = (m_rbId >= 0) ? (*psd)[m_rbId] * 180000 : Integral (*psd);
+              tx.antenna = dlPhy->GetRxAntenna ();
+              m_transmitters.push_back (tx);
+            }
+        }
+    }
+  NS_LOG_LOGIC ("computing the REM of " << m_transmitters.size () << " transmitters");
+
+  m_propagationLoss = m_channel->GetPropagationLossModel ();
+  DoubleValue maxLossDb;
+  m_channel->GetAttribute ("MaxLossDb", maxLossDb);
+  m_maxLossDb = maxLossDb.Get ();
+
+  // locating the points in the buildings walks the building list, which
+  // is not thread safe
+  bool buildings = BuildingList::GetNBuildings () > 0;
+  NS_ABORT_MSG_IF (buildings && m_numThreads > 1, "the REM can be computed by only one thread when there are buildings");
+  std::vector<RemWorker> workers (m_numThreads);
+  for (uint32_t t = 0; t < m_numThreads; ++t)
+    {
+      workers[t].rx = CreateObject<ConstantPositionMobilityModel> ();
+      workers[t].rx->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+      workers[t].makeConsistent = buildings;
+      for (uint32_t i = 0; i < m_transmitters.size (); ++i)
+        {
+          Ptr<MobilityModel> mm = CreateObject<ConstantPositionMobilityModel> ();
+          mm->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+          mm->SetPosition (m_transmitters[i].position);
+          if (buildings)
+            {
+              BuildingsHelper::MakeConsistent (mm);
+            }
+          workers[t].tx.push_back (mm);
+        }
+    }
+
+  uint32_t numPoints = m_x.size () * m_y.size ();
+  std::vector<double> sinr;
+  for (uint32_t tileBegin = 0; tileBegin < numPoints; tileBegin += m_maxPointsPerIteration)
+    {
+      uint32_t tileEnd = std::min (numPoints, tileBegin + m_maxPointsPerIteration);
+      uint32_t chunk = (tileEnd - tileBegin + m_numThreads - 1) / m_numThreads;
+      sinr.assign (tileEnd - tileBegin, 0.0);
+      std::vector<std::thread> threads;
+      for (uint32_t t = 1; t < m_numThreads; ++t)
+        {
+          uint32_t begin = std::min (tileEnd, tileBegin + t * chunk);
+          uint32_t end = std::min (tileEnd, begin + chunk);
+          threads.push_back (std::thread (&RadioEnvironmentMapHelper::ComputePoints, this,
+                                          &workers[t], begin, end, &sinr, tileBegin));
+        }
+      ComputePoints (&workers[0], tileBegin, std::min (tileEnd, tileBegin + chunk), &sinr, tileBegin);
+      for (uint32_t t = 0; t < threads.size (); ++t)
+        {
+          threads[t].join ();
+        }
+
+      for (uint32_t k = tileBegin; k < tileEnd; ++k)
+        {
+          m_outFile << m_x[k / m_y.size ()] << "\t"
+                    << m_y[k % m_y.size ()] << "\t"
+                    << m_z << "\t"
+                    << sinr[k - tileBegin]
+                    << "\n";
+        }
+    }
+
+  Finalize ();
+}
+
+void
+RadioEnvironmentMapHelper::ComputePoints (RemWorker *worker, uint32_t begin, uint32_t end,
+                                          std::vector<double> *sinr, uint32_t tileBegin) const
+{
+  // called concurrently: no logging, and no copy of the Ptrs shared
+  // with the other threads
+  for (uint32_t k = begin; k < end; ++k)
+    {
+      Vector pos (m_x[k / m_y.size ()], m_y[k % m_y.size ()], m_z);
+      worker->rx->SetPosition (pos);
+      if (worker->makeConsistent)
+        {
+          BuildingsHelper::MakeConsistent (worker->rx);
+        }
+      double sumPower = 0;
+      double referenceSignalPower = 0;
+      for (uint32_t i = 0; i < m_transmitters.size (); ++i)
+        {
+          const RemTransmitter &tx = m_transmitters[i];
+          // same as the spectrum channels
+          double pathLossDb = 0;
+          if (tx.antenna != 0)
+            {
+              Angles txAngles (pos, tx.position);
+              pathLossDb -= tx.antenna->GetGainDb (txAngles);
+            }
+          if (m_propagationLoss != 0)
+            {
+              pathLossDb -= m_propagationLoss->CalcRxPower (0, worker->tx[i], worker->rx);
+            }
+          if (pathLossDb > m_maxLossDb)
+            {
+              continue;
+            }
+          double power = tx.power * std::pow (10.0, (-pathLossDb) / 10.0);
+          sumPower += power;
+          referenceSignalPower = std::max (referenceSignalPower, power);
+        }
+      (*sinr)[k - tileBegin] = referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower);
+    }
+}
+
 void 
 RadioEnvironmentMapHelper::Finalize ()
 {
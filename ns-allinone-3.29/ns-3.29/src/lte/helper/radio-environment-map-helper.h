@@ -24,7 +24,9 @@
 
 
 #include <ns3/object.h>
+#include <ns3/vector.h>
 #include <fstream>
+#include <vector>
 
 
 namespace ns3 {
@@ -35,6 +37,8 @@ class NetDevice;
 class SpectrumChannel;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class PropagationLossModel;
+class AntennaModel;
 
 /** 
  * \ingroup lte
@@ -42,6 +46,11 @@ class MobilityModel;
  * Generates a 2D map of the SINR from the strongest transmitter in the
  * downlink of an LTE FDD system. For instructions on usage, please refer to
  * the User Documentation.
+ *
+ * By default, the map is obtained by simulating a listener in each point.
+ * If the `DirectComputation` attribute is set, the SINR is instead
+ * computed from the pathloss and antenna gains of the eNBs on the
+ * channel, possibly with several threads.
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -108,6 +117,52 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /**
+   * Scheduled by Install() instead of DelayedInstall() when the
+   * `DirectComputation` attribute is set: compute the map tile by tile,
+   * each tile being split among `NumThreads` threads, write it and
+   * call Finalize().
+   */
+  void ComputeDirectly ();
+
+  /// A transmitter of the direct computation of the map.
+  struct RemTransmitter
+  {
+    /// Position of the transmitter.
+    Vector position;
+    /// Power transmitted over the bandwidth of the map (or the RB `RbId`), in W.
+    double power;
+    /// Transmit antenna.
+    Ptr<AntennaModel> antenna;
+  };
+
+  /**
+   * The state of a thread of the direct computation.  Each thread has
+   * its own mobility models, so that the propagation loss models do not
+   * share reference counted objects between threads.
+   */
+  struct RemWorker
+  {
+    /// Position of the listening point.
+    Ptr<MobilityModel> rx;
+    /// Positions of the transmitters, in the order of m_transmitters.
+    std::vector<Ptr<MobilityModel> > tx;
+    /// Whether the listening point must be located in the buildings.
+    bool makeConsistent;
+  };
+
+  /**
+   * Compute the SINR of some points of the map.
+   *
+   * \param worker the state of the calling thread
+   * \param begin the index of the first point
+   * \param end the index past the last point
+   * \param sinr the SINR of the points of the current tile
+   * \param tileBegin the index of the first point of the current tile
+   */
+  void ComputePoints (RemWorker *worker, uint32_t begin, uint32_t end,
+                      std::vector<double> *sinr, uint32_t tileBegin) const;
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -152,6 +207,17 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_directComputation;  ///< The `DirectComputation` attribute.
+  uint32_t m_numThreads;     ///< The `NumThreads` attribute.
+
+  std::vector<double> m_x;  ///< X coordinates of the listening points.
+  std::vector<double> m_y;  ///< Y coordinates of the listening points.
+  /// Transmitters of the direct computation.
+  std::vector<RemTransmitter> m_transmitters;
+  /// Propagation loss model of the channel, used by the direct computation.
+  Ptr<PropagationLossModel> m_propagationLoss;
+  double m_maxLossDb;  ///< `MaxLossDb` attribute of the channel.
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
@@ -247,7 +247,7 @@ void
 CqaFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params)
 {
   NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
-  std::map <uint16_t,uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
+  LteRntiMap <uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
   if (it == m_uesTxMode.end ())
     {
       m_uesTxMode.insert (std::pair <uint16_t, uint8_t> (params.m_rnti, params.m_transmissionMode));
@@ -321,7 +321,7 @@ CqaFfMacScheduler::DoCschedLcConfigReq (const struct FfMacCschedSapProvider::Csc
     }
 
 
-  std::map <uint16_t, CqasFlowPerf_t>::iterator it;
+  LteRntiMap <CqasFlowPerf_t>::iterator it;
 
   for (uint16_t i = 0; i < params.m_logicalChannelConfigList.size (); i++)
     {
@@ -386,21 +386,7 @@ CqaFfMacScheduler::DoCschedLcReleaseReq (const struct FfMacCschedSapProvider::Cs
 	
   for (uint16_t i = 0; i < params.m_logicalChannelIdentity.size (); i++)
     {
-      std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
-      std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator temp;
-      while (it!=m_rlcBufferReq.end ())
-        {
-          if (((*it).first.m_rnti == params.m_rnti) && ((*it).first.m_lcId == params.m_logicalChannelIdentity.at (i)))
-            {
-              temp = it;
-              it++;
-              m_rlcBufferReq.erase (temp);
-            }
-          else
-            {
-              it++;
-            }
-        }
+      m_rlcBufferReq.erase (LteFlowId_t (params.m_rnti, params.m_logicalChannelIdentity.at (i)));
     }
   return;
 }
@@ -432,20 +418,10 @@ CqaFfMacScheduler::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::Cs
   m_flowStatsDl.erase  (params.m_rnti);
   m_flowStatsUl.erase  (params.m_rnti);
   m_ceBsrRxed.erase (params.m_rnti);
-  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
-  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator temp;
-  while (it!=m_rlcBufferReq.end ())
+  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.lower_bound (LteFlowId_t (params.m_rnti, 0));
+  while (it != m_rlcBufferReq.end () && (*it).first.m_rnti == params.m_rnti)
     {
-      if ((*it).first.m_rnti == params.m_rnti)
-        {
-          temp = it;
-          it++;
-          m_rlcBufferReq.erase (temp);
-        }
-      else
-        {
-          it++;
-        }
+      m_rlcBufferReq.erase (it++);
     }
   if (m_nextRntiUl == params.m_rnti)
     {
@@ -516,7 +492,7 @@ CqaFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
   std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
   unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
+  for (it = m_rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0)); it != m_rlcBufferReq.end (); it++)
     {
       if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
                                            || ((*it).second.m_rlcRetransmissionQueueSize > 0)
@@ -539,12 +515,12 @@ CqaFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
+  LteRntiMap <uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
   if (it == m_dlHarqCurrentProcessId.end ())
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
+  LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
   if (itStat == m_dlHarqProcessesStatus.end ())
     {
       NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
@@ -578,12 +554,12 @@ CqaFfMacScheduler::UpdateHarqProcessId (uint16_t rnti)
     }
 
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
+  LteRntiMap <uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
   if (it == m_dlHarqCurrentProcessId.end ())
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
+  LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
   if (itStat == m_dlHarqProcessesStatus.end ())
     {
       NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
@@ -613,7 +589,7 @@ CqaFfMacScheduler::RefreshHarqProcesses ()
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itTimers;
+  LteRntiMap <DlHarqProcessesTimer_t>::iterator itTimers;
   for (itTimers = m_dlHarqProcessesTimer.begin (); itTimers != m_dlHarqProcessesTimer.end (); itTimers++)
     {
       for (uint16_t i = 0; i < HARQ_PROC_NUM; i++)
@@ -623,7 +599,7 @@ CqaFfMacScheduler::RefreshHarqProcesses ()
               // reset HARQ process
 
               NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
+              LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
               if (itStat == m_dlHarqProcessesStatus.end ())
                 {
                   NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers).first);
@@ -654,8 +630,8 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
   int rbgSize = GetRbgSize (m_cschedCellConfig.m_dlBandwidth);
   int numberOfRBGs = m_cschedCellConfig.m_dlBandwidth / rbgSize;
-  std::map <uint16_t, std::multimap <uint8_t, qos_rb_and_CQI_assigned_to_lc> > allocationMapPerRntiPerLCId;
-  std::map <uint16_t, std::multimap <uint8_t, qos_rb_and_CQI_assigned_to_lc> >::iterator itMap;
+  LteRntiMap <std::multimap <uint8_t, qos_rb_and_CQI_assigned_to_lc> > allocationMapPerRntiPerLCId;
+  LteRntiMap <std::multimap <uint8_t, qos_rb_and_CQI_assigned_to_lc> >::iterator itMap;
   allocationMapPerRntiPerLCId.clear ();
   bool(*key_function_pointer_groups)(int,int) = CqaGroupDescComparator;
   t_map_HOLgroupToUEs map_GBRHOLgroupToUE (key_function_pointer_groups);
@@ -680,7 +656,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
   FfMacSchedSapUser::SchedDlConfigIndParameters ret;
 
   //   update UL HARQ proc id
-  std::map <uint16_t, uint8_t>::iterator itProcId;
+  LteRntiMap <uint8_t>::iterator itProcId;
   for (itProcId = m_ulHarqCurrentProcessId.begin (); itProcId != m_ulHarqCurrentProcessId.end (); itProcId++)
     {
       (*itProcId).second = ((*itProcId).second + 1) % HARQ_PROC_NUM;
@@ -790,14 +766,14 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
           uldci.m_pdcchPowerOffset = 0; // not used
 
           uint8_t harqId = 0;
-          std::map <uint16_t, uint8_t>::iterator itProcId;
+          LteRntiMap <uint8_t>::iterator itProcId;
           itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
           if (itProcId == m_ulHarqCurrentProcessId.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
             }
           harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
           if (itDci == m_ulHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
@@ -862,7 +838,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
           uint16_t rnti = m_dlInfoListBuffered.at (i).m_rnti;
           uint8_t harqId = m_dlInfoListBuffered.at (i).m_harqProcessId;
           NS_LOG_INFO (this << " HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId);
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itHarq = m_dlHarqProcessesDciBuffer.find (rnti);
+          LteRntiMap <DlHarqProcessesDciBuffer_t>::iterator itHarq = m_dlHarqProcessesDciBuffer.find (rnti);
           if (itHarq == m_dlHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << rnti);
@@ -883,13 +859,13 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
             {
               // maximum number of retx reached -> drop process
               NS_LOG_INFO ("Maximum number of retransmissions reached -> drop process");
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
+              LteRntiMap <DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
               if (it == m_dlHarqProcessesStatus.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << m_dlInfoListBuffered.at (i).m_rnti);
                 }
               (*it).second.at (harqId) = 0;
-              std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
+              LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
               if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                 {
                   NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
@@ -975,7 +951,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
             }
           // retrieve RLC PDU list for retx TBsize and update DCI
           BuildDataListElement_s newEl;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
+          LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << rnti);
@@ -1043,7 +1019,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
           newEl.m_dci = dci;
           (*itHarq).second.at (harqId).m_rv = dci.m_rv;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer = m_dlHarqProcessesTimer.find (rnti);
+          LteRntiMap <DlHarqProcessesTimer_t>::iterator itHarqTimer = m_dlHarqProcessesTimer.find (rnti);
           if (itHarqTimer== m_dlHarqProcessesTimer.end ())
             {
               NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)rnti);
@@ -1056,13 +1032,13 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
         {
           // update HARQ process status
           NS_LOG_INFO (this << " HARQ received ACK for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-          std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
+          LteRntiMap <DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (it == m_dlHarqProcessesStatus.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << m_dlInfoListBuffered.at (i).m_rnti);
             }
           (*it).second.at (m_dlInfoListBuffered.at (i).m_harqProcessId) = 0;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
+          LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
@@ -1164,7 +1140,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
   //Initialize the map per UE, how much resources is already assigned to the user
   std::map<LteFlowId_t, int> UeToAmountOfAssignedResources;
   // prepare values to calculate FF metric, this metric will be the same for all flows(logical channels) that belong to the same RNTI
-  std::map < uint16_t, uint8_t > sbCqiSum;
+  LteRntiMap <uint8_t > sbCqiSum;
 
   for( std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itrbr = m_rlcBufferReq.begin ();
        itrbr!=m_rlcBufferReq.end (); itrbr++)
@@ -1172,9 +1148,9 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
       LteFlowId_t flowId = itrbr->first;                // Prepare data for the scheduling mechanism
       // check first the channel conditions for this UE, if CQI!=0
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
+      LteRntiMap <SbMeasResult_s>::iterator itCqi;
       itCqi = m_a30CqiRxed.find ((*itrbr).first.m_rnti);
-      std::map <uint16_t,uint8_t>::iterator itTxMode;
+      LteRntiMap <uint8_t>::iterator itTxMode;
       itTxMode = m_uesTxMode.find ((*itrbr).first.m_rnti);
       if (itTxMode == m_uesTxMode.end ())
         {
@@ -1214,9 +1190,9 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
       uint8_t sum = 0;
       for (int i = 0; i < numberOfRBGs; i++)
         {
-          std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
+          LteRntiMap <SbMeasResult_s>::iterator itCqi;
           itCqi = m_a30CqiRxed.find ((*itrbr).first.m_rnti);
-          std::map <uint16_t,uint8_t>::iterator itTxMode;
+          LteRntiMap <uint8_t>::iterator itTxMode;
           itTxMode = m_uesTxMode.find ((*itrbr).first.m_rnti);
           if (itTxMode == m_uesTxMode.end ())
             {
@@ -1330,9 +1306,9 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
               uint8_t worstCQIAmongRBGsAllocatedForThisUser = 15;
               int numberOfRBGAllocatedForThisUser = 0;
               LogicalChannelConfigListElement_s lc = m_ueLogicalChannelsConfigList.find (flowId)->second;
-              std::map <uint16_t,SbMeasResult_s>::iterator itRntiCQIsMap = m_a30CqiRxed.find (flowId.m_rnti);
+              LteRntiMap <SbMeasResult_s>::iterator itRntiCQIsMap = m_a30CqiRxed.find (flowId.m_rnti);
 
-              std::map <uint16_t, CqasFlowPerf_t>::iterator itStats;
+              LteRntiMap <CqasFlowPerf_t>::iterator itStats;
 
               if ((m_ffrSapProvider->IsDlRbgAvailableForUe (currentRB, flowId.m_rnti)) == false)
                 {
@@ -1496,7 +1472,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
 
   // reset TTI stats of users
-  std::map <uint16_t, CqasFlowPerf_t>::iterator itStats;
+  LteRntiMap <CqasFlowPerf_t>::iterator itStats;
   for (itStats = m_flowStatsDl.begin (); itStats != m_flowStatsDl.end (); itStats++)
     {
       (*itStats).second.lastTtiBytesTransmitted = 0;
@@ -1506,7 +1482,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
   //FfMacSchedSapUser::SchedDlConfigIndParameters ret;
   itMap = allocationMapPerRntiPerLCId.begin ();
   int counter = 0;
-  std::map<uint16_t, double> m_rnti_per_ratio;
+  LteRntiMap <double> m_rnti_per_ratio;
 
   while (itMap != allocationMapPerRntiPerLCId.end ())
     {
@@ -1528,7 +1504,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
       double doubleRbgNum = numberOfRBGs;
       double rrRatio = doubleRBgPerRnti/doubleRbgNum;
       m_rnti_per_ratio.insert (std::pair<uint16_t,double>((*itMap).first,rrRatio));
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
+      LteRntiMap <SbMeasResult_s>::iterator itCqi;
       itCqi = m_a30CqiRxed.find ((*itMap).first);
       uint8_t worstCqi = 15;
 
@@ -1557,7 +1533,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
       // NOTE: In this first version of CqaFfMacScheduler, it is assumed one flow per user.
       // create the rlc PDUs -> equally divide resources among active LCs
       std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itBufReq;
-      for (itBufReq = m_rlcBufferReq.begin (); itBufReq != m_rlcBufferReq.end (); itBufReq++)
+      for (itBufReq = m_rlcBufferReq.lower_bound (LteFlowId_t ((*itMap).first, 0)); itBufReq != m_rlcBufferReq.end (); itBufReq++)
         {
           if (((*itBufReq).first.m_rnti == (*itMap).first)
               && (((*itBufReq).second.m_rlcTransmissionQueueSize > 0)
@@ -1577,7 +1553,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
               if (m_harqOn == true)
                 {
                   // store RLC PDU list for HARQ
-                  std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find ((*itMap).first);
+                  LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find ((*itMap).first);
                   if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                     {
                       NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << (*itMap).first);
@@ -1606,14 +1582,14 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
       if (m_harqOn == true)
         {
           // store DCI for HARQ
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itDci = m_dlHarqProcessesDciBuffer.find (newEl.m_rnti);
+          LteRntiMap <DlHarqProcessesDciBuffer_t>::iterator itDci = m_dlHarqProcessesDciBuffer.find (newEl.m_rnti);
           if (itDci == m_dlHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in DCI HARQ buffer for RNTI " << newEl.m_rnti);
             }
           (*itDci).second.at (newDci.m_harqProcess) = newDci;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer =  m_dlHarqProcessesTimer.find (newEl.m_rnti);
+          LteRntiMap <DlHarqProcessesTimer_t>::iterator itHarqTimer =  m_dlHarqProcessesTimer.find (newEl.m_rnti);
           if (itHarqTimer== m_dlHarqProcessesTimer.end ())
             {
               NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)newEl.m_rnti);
@@ -1625,7 +1601,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
       ret.m_buildDataList.push_back (newEl);
       // update UE stats
-      std::map <uint16_t, CqasFlowPerf_t>::iterator it;
+      LteRntiMap <CqasFlowPerf_t>::iterator it;
       it = m_flowStatsDl.find ((*itMap).first);
       if (it != m_flowStatsDl.end ())
         {
@@ -1660,7 +1636,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
   m_schedSapUser->SchedDlConfigInd (ret);
 
   int count_allocated_resource_blocks = 0;
-  for (std::map <uint16_t, std::multimap <uint8_t, qos_rb_and_CQI_assigned_to_lc> >::iterator itMap = allocationMapPerRntiPerLCId.begin (); itMap!=allocationMapPerRntiPerLCId.end (); itMap++)
+  for (LteRntiMap <std::multimap <uint8_t, qos_rb_and_CQI_assigned_to_lc> >::iterator itMap = allocationMapPerRntiPerLCId.begin (); itMap!=allocationMapPerRntiPerLCId.end (); itMap++)
     {
       count_allocated_resource_blocks+=itMap->second.size ();
     }
@@ -1690,7 +1666,7 @@ CqaFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
       if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::P10 )
         {
           NS_LOG_LOGIC ("wideband CQI " <<  (uint32_t) params.m_cqiList.at (i).m_wbCqi.at (0) << " reported");
-          std::map <uint16_t,uint8_t>::iterator it;
+          LteRntiMap <uint8_t>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
           it = m_p10CqiRxed.find (rnti);
           if (it == m_p10CqiRxed.end ())
@@ -1705,7 +1681,7 @@ CqaFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
               // update the CQI value and refresh correspondent timer
               (*it).second = params.m_cqiList.at (i).m_wbCqi.at (0);
               // update correspondent timer
-              std::map <uint16_t,uint32_t>::iterator itTimers;
+              LteRntiMap <uint32_t>::iterator itTimers;
               itTimers = m_p10CqiTimers.find (rnti);
               (*itTimers).second = m_cqiTimersThreshold;
             }
@@ -1713,7 +1689,7 @@ CqaFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
       else if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::A30 )
         {
           // subband CQI reporting high layer configured
-          std::map <uint16_t,SbMeasResult_s>::iterator it;
+          LteRntiMap <SbMeasResult_s>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
           it = m_a30CqiRxed.find (rnti);
           if (it == m_a30CqiRxed.end ())
@@ -1726,7 +1702,7 @@ CqaFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
             {
               // update the CQI value and refresh correspondent timer
               (*it).second = params.m_cqiList.at (i).m_sbMeasResult;
-              std::map <uint16_t,uint32_t>::iterator itTimers;
+              LteRntiMap <uint32_t>::iterator itTimers;
               itTimers = m_a30CqiTimers.find (rnti);
               (*itTimers).second = m_cqiTimersThreshold;
             }
@@ -1744,7 +1720,7 @@ CqaFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
 double
 CqaFfMacScheduler::EstimateUlSinr (uint16_t rnti, uint16_t rb)
 {
-  std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find (rnti);
+  LteRntiMap <std::vector <double> >::iterator itCqi = m_ueCqi.find (rnti);
   if (itCqi == m_ueCqi.end ())
     {
       // no cqi info about this UE
@@ -1827,21 +1803,21 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
             {
               // retx correspondent block: retrieve the UL-DCI
               uint16_t rnti = params.m_ulInfoList.at (i).m_rnti;
-              std::map <uint16_t, uint8_t>::iterator itProcId = m_ulHarqCurrentProcessId.find (rnti);
+              LteRntiMap <uint8_t>::iterator itProcId = m_ulHarqCurrentProcessId.find (rnti);
               if (itProcId == m_ulHarqCurrentProcessId.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
                 }
               uint8_t harqId = (uint8_t)((*itProcId).second - HARQ_PERIOD) % HARQ_PROC_NUM;
               NS_LOG_INFO (this << " UL-HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId << " i " << i << " size "  << params.m_ulInfoList.size ());
-              std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itHarq = m_ulHarqProcessesDciBuffer.find (rnti);
+              LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itHarq = m_ulHarqProcessesDciBuffer.find (rnti);
               if (itHarq == m_ulHarqProcessesDciBuffer.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
                   continue;
                 }
               UlDciListElement_s dci = (*itHarq).second.at (harqId);
-              std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
+              LteRntiMap <UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
               if (itStat == m_ulHarqProcessesStatus.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
@@ -1893,7 +1869,7 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
         }
     }
 
-  std::map <uint16_t,uint32_t>::iterator it;
+  LteRntiMap <uint32_t>::iterator it;
   int nflows = 0;
 
   for (it = m_ceBsrRxed.begin (); it != m_ceBsrRxed.end (); it++)
@@ -1928,7 +1904,7 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
     }
   int rbAllocated = 0;
 
-  std::map <uint16_t, CqasFlowPerf_t>::iterator itStats;
+  LteRntiMap <CqasFlowPerf_t>::iterator itStats;
   if (m_nextRntiUl != 0)
     {
       for (it = m_ceBsrRxed.begin (); it != m_ceBsrRxed.end (); it++)
@@ -2041,7 +2017,7 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
 
 
-      std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find ((*it).first);
+      LteRntiMap <std::vector <double> >::iterator itCqi = m_ueCqi.find ((*it).first);
       int cqi = 0;
       if (itCqi == m_ueCqi.end ())
         {
@@ -2112,21 +2088,21 @@ CqaFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sche
       uint8_t harqId = 0;
       if (m_harqOn == true)
         {
-          std::map <uint16_t, uint8_t>::iterator itProcId;
+          LteRntiMap <uint8_t>::iterator itProcId;
           itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
           if (itProcId == m_ulHarqCurrentProcessId.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
             }
           harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
           if (itDci == m_ulHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
             }
           (*itDci).second.at (harqId) = uldci;
           // Update HARQ process status (RV 0)
-          std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (uldci.m_rnti);
           if (itStat == m_ulHarqProcessesStatus.end ())
             {
               NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << uldci.m_rnti);
@@ -2200,7 +2176,7 @@ CqaFfMacScheduler::DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider::
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t,uint32_t>::iterator it;
+  LteRntiMap <uint32_t>::iterator it;
 
   for (unsigned int i = 0; i < params.m_macCeList.size (); i++)
     {
@@ -2275,7 +2251,7 @@ CqaFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
     case UlCqi_s::PUSCH:
       {
         std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
-        std::map <uint16_t, std::vector <double> >::iterator itCqi;
+        LteRntiMap <std::vector <double> >::iterator itCqi;
         NS_LOG_DEBUG (this << " Collect PUSCH CQIs of Frame no. " << (params.m_sfnSf >> 4) << " subframe no. " << (0xF & params.m_sfnSf));
         itMap = m_allocationMaps.find (params.m_sfnSf);
         if (itMap == m_allocationMaps.end ())
@@ -2314,7 +2290,7 @@ CqaFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
                 (*itCqi).second.at (i) = sinr;
                 NS_LOG_DEBUG (this << " RNTI " << (*itMap).second.at (i) << " RB " << i << " SINR " << sinr);
                 // update correspondent timer
-                std::map <uint16_t, uint32_t>::iterator itTimers;
+                LteRntiMap <uint32_t>::iterator itTimers;
                 itTimers = m_ueCqiTimers.find ((*itMap).second.at (i));
                 (*itTimers).second = m_cqiTimersThreshold;
 
@@ -2339,7 +2315,7 @@ CqaFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
                 rnti = vsp->GetRnti ();
               }
           }
-        std::map <uint16_t, std::vector <double> >::iterator itCqi;
+        LteRntiMap <std::vector <double> >::iterator itCqi;
         itCqi = m_ueCqi.find (rnti);
         if (itCqi == m_ueCqi.end ())
           {
@@ -2366,7 +2342,7 @@ CqaFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
                 NS_LOG_INFO (this << " RNTI " << rnti << " update SRS-CQI for RB  " << j << " value " << sinr);
               }
             // update correspondent timer
-            std::map <uint16_t, uint32_t>::iterator itTimers;
+            LteRntiMap <uint32_t>::iterator itTimers;
             itTimers = m_ueCqiTimers.find (rnti);
             (*itTimers).second = m_cqiTimersThreshold;
 
@@ -2392,18 +2368,18 @@ void
 CqaFfMacScheduler::RefreshDlCqiMaps (void)
 {
   // refresh DL CQI P01 Map
-  std::map <uint16_t,uint32_t>::iterator itP10 = m_p10CqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itP10 = m_p10CqiTimers.begin ();
   while (itP10 != m_p10CqiTimers.end ())
     {
       NS_LOG_INFO (this << " P10-CQI for user " << (*itP10).first << " is " << (uint32_t)(*itP10).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itP10).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,uint8_t>::iterator itMap = m_p10CqiRxed.find ((*itP10).first);
+          LteRntiMap <uint8_t>::iterator itMap = m_p10CqiRxed.find ((*itP10).first);
           NS_ASSERT_MSG (itMap != m_p10CqiRxed.end (), " Does not find CQI report for user " << (*itP10).first);
           NS_LOG_INFO (this << " P10-CQI expired for user " << (*itP10).first);
           m_p10CqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itP10;
+          LteRntiMap <uint32_t>::iterator temp = itP10;
           itP10++;
           m_p10CqiTimers.erase (temp);
         }
@@ -2415,18 +2391,18 @@ CqaFfMacScheduler::RefreshDlCqiMaps (void)
     }
 
   // refresh DL CQI A30 Map
-  std::map <uint16_t,uint32_t>::iterator itA30 = m_a30CqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itA30 = m_a30CqiTimers.begin ();
   while (itA30 != m_a30CqiTimers.end ())
     {
       NS_LOG_INFO (this << " A30-CQI for user " << (*itA30).first << " is " << (uint32_t)(*itA30).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itA30).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
+          LteRntiMap <SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
           NS_ASSERT_MSG (itMap != m_a30CqiRxed.end (), " Does not find CQI report for user " << (*itA30).first);
           NS_LOG_INFO (this << " A30-CQI expired for user " << (*itA30).first);
           m_a30CqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itA30;
+          LteRntiMap <uint32_t>::iterator temp = itA30;
           itA30++;
           m_a30CqiTimers.erase (temp);
         }
@@ -2445,19 +2421,19 @@ void
 CqaFfMacScheduler::RefreshUlCqiMaps (void)
 {
   // refresh UL CQI  Map
-  std::map <uint16_t,uint32_t>::iterator itUl = m_ueCqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itUl = m_ueCqiTimers.begin ();
   while (itUl != m_ueCqiTimers.end ())
     {
       NS_LOG_INFO (this << " UL-CQI for user " << (*itUl).first << " is " << (uint32_t)(*itUl).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itUl).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t, std::vector <double> >::iterator itMap = m_ueCqi.find ((*itUl).first);
+          LteRntiMap <std::vector <double> >::iterator itMap = m_ueCqi.find ((*itUl).first);
           NS_ASSERT_MSG (itMap != m_ueCqi.end (), " Does not find CQI report for user " << (*itUl).first);
           NS_LOG_INFO (this << " UL-CQI exired for user " << (*itUl).first);
           (*itMap).second.clear ();
           m_ueCqi.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itUl;
+          LteRntiMap <uint32_t>::iterator temp = itUl;
           itUl++;
           m_ueCqiTimers.erase (temp);
         }
@@ -2528,7 +2504,7 @@ CqaFfMacScheduler::UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size)
 {
 
   size = size - 2; // remove the minimum RLC overhead
-  std::map <uint16_t,uint32_t>::iterator it = m_ceBsrRxed.find (rnti);
+  LteRntiMap <uint32_t>::iterator it = m_ceBsrRxed.find (rnti);
   if (it != m_ceBsrRxed.end ())
     {
       NS_LOG_INFO (this << " UE " << rnti << " size " << size << " BSR " << (*it).second);
@@ -176,7 +176,7 @@ EpcSgwPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
       Ipv4Address ueAddr =  ipv4Header.GetDestination ();
       NS_LOG_LOGIC ("packet addressed to UE " << ueAddr);
       // find corresponding UeInfo address
-      std::map<Ipv4Address, Ptr<UeInfo> >::iterator it = m_ueInfoByAddrMap.find (ueAddr);
+      std::unordered_map<Ipv4Address, Ptr<UeInfo>, Ipv4AddressHash>::iterator it = m_ueInfoByAddrMap.find (ueAddr);
       if (it == m_ueInfoByAddrMap.end ())
         {        
           NS_LOG_WARN ("unknown UE address " << ueAddr);
@@ -202,7 +202,7 @@ EpcSgwPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
       Ipv6Address ueAddr =  ipv6Header.GetDestinationAddress ();
       NS_LOG_LOGIC ("packet addressed to UE " << ueAddr);
       // find corresponding UeInfo address
-      std::map<Ipv6Address, Ptr<UeInfo> >::iterator it = m_ueInfoByAddrMap6.find (ueAddr);
+      std::unordered_map<Ipv6Address, Ptr<UeInfo>, Ipv6AddressHash>::iterator it = m_ueInfoByAddrMap6.find (ueAddr);
       if (it == m_ueInfoByAddrMap6.end ())
         {        
           NS_LOG_WARN ("unknown UE address " << ueAddr);
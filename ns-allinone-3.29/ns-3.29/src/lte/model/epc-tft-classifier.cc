@@ -27,10 +27,7 @@
 #include "epc-tft.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
-#include "ns3/ipv4-header.h"
-#include "ns3/ipv6-header.h"
-#include "ns3/udp-header.h"
-#include "ns3/tcp-header.h"
+#include "ns3/abort.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/tcp-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
@@ -41,6 +38,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("EpcTftClassifier");
 
 EpcTftClassifier::EpcTftClassifier ()
+  : m_compiled (true)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -50,6 +48,7 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
 {
   NS_LOG_FUNCTION (this << tft << id);
   m_tftMap[id] = tft;
+  m_compiled = false;
 
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
@@ -60,6 +59,84 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+  m_compiled = false;
+}
+
+void
+EpcTftClassifier::Compile ()
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t d = 0; d < 2; ++d)
+    {
+      EpcTft::Direction direction = (d == 0) ? EpcTft::DOWNLINK : EpcTft::UPLINK;
+      m_compiledFilters[d].clear ();
+
+      // we use a reverse iterator since filter priority is not implemented properly.
+      // This way, since the default bearer is expected to be added first, it will be evaluated last.
+      bool matchesAll = false;
+      std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
+      for (it = m_tftMap.rbegin (); it != m_tftMap.rend () && !matchesAll; ++it)
+        {
+          std::list<EpcTft::PacketFilter> filters = it->second->GetPacketFilters ();
+          for (std::list<EpcTft::PacketFilter>::const_iterator fit = filters.begin ();
+               fit != filters.end () && !matchesAll;
+               ++fit)
+            {
+              if ((fit->direction & direction) == 0)
+                {
+                  continue;
+                }
+              CompiledFilter f;
+              f.id = it->first;
+              f.remoteMask = fit->remoteMask.Get ();
+              f.remoteAddress = fit->remoteAddress.Get () & f.remoteMask;
+              f.localMask = fit->localMask.Get ();
+              f.localAddress = fit->localAddress.Get () & f.localMask;
+              f.remotePortStart = fit->remotePortStart;
+              f.remotePortEnd = fit->remotePortEnd;
+              f.localPortStart = fit->localPortStart;
+              f.localPortEnd = fit->localPortEnd;
+              f.typeOfServiceMask = fit->typeOfServiceMask;
+              f.typeOfService = fit->typeOfService & f.typeOfServiceMask;
+              m_compiledFilters[d].push_back (f);
+
+              // the filters after one matching any packet (e.g., the one of
+              // the default bearer) are never evaluated
+              matchesAll = (f.remoteMask == 0 && f.localMask == 0
+                            && f.remotePortStart == 0 && f.remotePortEnd == 65535
+                            && f.localPortStart == 0 && f.localPortEnd == 65535
+                            && f.typeOfServiceMask == 0);
+            }
+        }
+      NS_LOG_LOGIC ("compiled " << m_compiledFilters[d].size () << " filters for direction " << direction);
+    }
+  m_compiled = true;
+}
+
+uint32_t
+EpcTftClassifier::Match (EpcTft::Direction direction, bool matchAddresses,
+                         uint32_t remoteAddress, uint32_t localAddress,
+                         uint16_t remotePort, uint16_t localPort, uint8_t tos) const
+{
+  const std::vector<CompiledFilter> &filters = m_compiledFilters[direction == EpcTft::DOWNLINK ? 0 : 1];
+  for (std::vector<CompiledFilter>::const_iterator it = filters.begin (); it != filters.end (); ++it)
+    {
+      if (matchAddresses
+          && ((remoteAddress & it->remoteMask) != it->remoteAddress
+              || (localAddress & it->localMask) != it->localAddress))
+        {
+          continue;
+        }
+      if (remotePort >= it->remotePortStart && remotePort <= it->remotePortEnd
+          && localPort >= it->localPortStart && localPort <= it->localPortEnd
+          && (tos & it->typeOfServiceMask) == it->typeOfService)
+        {
+          NS_LOG_LOGIC ("matches with TFT ID = " << it->id);
+          return it->id; // the id of the matching TFT
+        }
+    }
+  NS_LOG_LOGIC ("no match");
+  return 0;  // no match
 }
 
  
@@ -67,18 +144,20 @@ uint32_t
 EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 {
   NS_LOG_FUNCTION (this << p << p->GetSize () << direction);
+  NS_ASSERT (direction == EpcTft::DOWNLINK || direction == EpcTft::UPLINK);
 
-  Ptr<Packet> pCopy = p->Copy ();
-
-  uint8_t ipType;
-  pCopy->CopyData (&ipType, 1);
-  ipType = (ipType>>4) & 0x0f;
+  if (!m_compiled)
+    {
+      Compile ();
+    }
 
-  Ipv4Address localAddressIpv4;
-  Ipv4Address remoteAddressIpv4;
+  // the headers are read in place: at most 60 bytes of IPv4 header
+  // (40 bytes of IPv6 header) followed by the 4 bytes of the ports
+  uint8_t buf[64];
+  uint32_t size = p->CopyData (buf, 64);
+  NS_ABORT_MSG_IF (size == 0, "EpcTftClassifier::Classify - Empty packet...");
 
-  Ipv6Address localAddressIpv6;
-  Ipv6Address remoteAddressIpv6;
+  uint8_t ipType = (buf[0] >> 4) & 0x0f;
 
   uint8_t protocol;
   uint8_t tos;
@@ -88,85 +167,62 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 
   if (ipType == 0x04)
     {
-      Ipv4Header ipv4Header;
-      pCopy->RemoveHeader (ipv4Header);
-
+      uint32_t headerSize = (buf[0] & 0x0f) * 4;
+      NS_ABORT_MSG_IF (headerSize < 20 || size < headerSize, "EpcTftClassifier::Classify - Truncated IPv4 header...");
+      tos = buf[1];
+      uint16_t payloadSize = ((buf[2] << 8) | buf[3]) - headerSize;
+      uint16_t identification = (buf[4] << 8) | buf[5];
+      uint16_t flagsAndOffset = (buf[6] << 8) | buf[7];
+      uint16_t fragmentOffset = (flagsAndOffset & 0x1fff) << 3;
+      bool isLastFragment = (flagsAndOffset & 0x2000) == 0;
+      protocol = buf[9];
+      uint32_t source = (buf[12] << 24) | (buf[13] << 16) | (buf[14] << 8) | buf[15];
+      uint32_t destination = (buf[16] << 24) | (buf[17] << 16) | (buf[18] << 8) | buf[19];
+      const uint8_t *ports = buf + headerSize;
+
+      uint32_t localAddress;
+      uint32_t remoteAddress;
       if (direction ==  EpcTft::UPLINK)
         {
-          localAddressIpv4 = ipv4Header.GetSource ();
-          remoteAddressIpv4 = ipv4Header.GetDestination ();
+          localAddress = source;
+          remoteAddress = destination;
         }
       else
         {
-          NS_ASSERT (direction ==  EpcTft::DOWNLINK);
-          remoteAddressIpv4 = ipv4Header.GetSource ();
-          localAddressIpv4 = ipv4Header.GetDestination ();
+          remoteAddress = source;
+          localAddress = destination;
         }
-      NS_LOG_INFO ("local address: " << localAddressIpv4 << " remote address: " << remoteAddressIpv4);
-
-      uint16_t payloadSize = ipv4Header.GetPayloadSize ();
-      uint16_t fragmentOffset = ipv4Header.GetFragmentOffset ();
-      bool isLastFragment = ipv4Header.IsLastFragment ();
+      NS_LOG_INFO ("local address: " << Ipv4Address (localAddress) << " remote address: " << Ipv4Address (remoteAddress));
 
       // NS_LOG_DEBUG ("PayloadSize = " << payloadSize);
       // NS_LOG_DEBUG ("fragmentOffset " << fragmentOffset << " isLastFragment " << isLastFragment);
 
-      protocol = ipv4Header.GetProtocol ();
-      tos = ipv4Header.GetTos ();
-
       // Port info only can be get if it is the first fragment and
       // there is enough data in the payload
       // We keep the port info for fragmented packets,
       // i.e. it is the first one but it is not the last one
       if (fragmentOffset == 0)
         {
-          if (protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
-            {
-              UdpHeader udpHeader;
-              pCopy->RemoveHeader (udpHeader);
-              if (direction ==  EpcTft::UPLINK)
-                {
-                  localPort = udpHeader.GetSourcePort ();
-                  remotePort = udpHeader.GetDestinationPort ();
-                }
-              else
-                {
-                  remotePort = udpHeader.GetSourcePort ();
-                  localPort = udpHeader.GetDestinationPort ();
-                }
-              if (!isLastFragment)
-                {
-                  std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
-                      std::make_tuple (ipv4Header.GetSource ().Get (),
-                                       ipv4Header.GetDestination ().Get (),
-                                       protocol,
-                                       ipv4Header.GetIdentification ());
-
-                  m_classifiedIpv4Fragments[fragmentKey] = std::make_pair (localPort, remotePort);
-                }
-            }
-          else if (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20)
+          if ((protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
+              || (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20))
             {
-              TcpHeader tcpHeader;
-              pCopy->RemoveHeader (tcpHeader);
+              NS_ABORT_MSG_IF (size < headerSize + 4, "EpcTftClassifier::Classify - Truncated transport header...");
+              uint16_t sourcePort = (ports[0] << 8) | ports[1];
+              uint16_t destinationPort = (ports[2] << 8) | ports[3];
               if (direction ==  EpcTft::UPLINK)
                 {
-                  localPort = tcpHeader.GetSourcePort ();
-                  remotePort = tcpHeader.GetDestinationPort ();
+                  localPort = sourcePort;
+                  remotePort = destinationPort;
                 }
               else
                 {
-                  remotePort = tcpHeader.GetSourcePort ();
-                  localPort = tcpHeader.GetDestinationPort ();
+                  remotePort = sourcePort;
+                  localPort = destinationPort;
                 }
-
               if (!isLastFragment)
                 {
                   std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
-                      std::make_tuple (ipv4Header.GetSource ().Get (),
-                                       ipv4Header.GetDestination ().Get (),
-                                       protocol,
-                                       ipv4Header.GetIdentification ());
+                      std::make_tuple (source, destination, protocol, identification);
 
                   m_classifiedIpv4Fragments[fragmentKey] = std::make_pair (localPort, remotePort);
                 }
@@ -181,10 +237,7 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
           // Not first fragment, so port info is not available but
           // port info should already be known (if there is not fragment reordering)
           std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
-              std::make_tuple (ipv4Header.GetSource ().Get (),
-                               ipv4Header.GetDestination ().Get (),
-                               protocol,
-                               ipv4Header.GetIdentification ());
+              std::make_tuple (source, destination, protocol, identification);
 
           std::map< std::tuple<uint32_t, uint32_t, uint8_t, uint16_t>,
                     std::pair<uint32_t, uint32_t> >::iterator it =
@@ -197,126 +250,57 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 
               if (isLastFragment)
                 {
-                  m_classifiedIpv4Fragments.erase (fragmentKey);
+                  m_classifiedIpv4Fragments.erase (it);
                 }
             }
         }
+
+      NS_LOG_INFO ("Classifying packet:"
+          << " localAddr="  << Ipv4Address (localAddress)
+          << " remoteAddr=" << Ipv4Address (remoteAddress)
+          << " localPort="  << localPort
+          << " remotePort=" << remotePort
+          << " tos=0x" << (uint16_t) tos );
+
+      return Match (direction, true, remoteAddress, localAddress, remotePort, localPort, tos);
     }
   else if (ipType == 0x06)
     {
-      Ipv6Header ipv6Header;
-      pCopy->RemoveHeader (ipv6Header);
-
-      if (direction ==  EpcTft::UPLINK)
-        {
-          localAddressIpv6 = ipv6Header.GetSourceAddress ();
-          remoteAddressIpv6 = ipv6Header.GetDestinationAddress ();
-        }
-      else
-        {
-          NS_ASSERT (direction ==  EpcTft::DOWNLINK);
-          remoteAddressIpv6 = ipv6Header.GetSourceAddress ();
-          localAddressIpv6 = ipv6Header.GetDestinationAddress ();
-        }
-      NS_LOG_INFO ("local address: " << localAddressIpv6 << " remote address: " << remoteAddressIpv6);
-
-      protocol = ipv6Header.GetNextHeader ();
-      tos = ipv6Header.GetTrafficClass ();
-
-      if (protocol == UdpL4Protocol::PROT_NUMBER)
-        {
-          UdpHeader udpHeader;
-          pCopy->RemoveHeader (udpHeader);
+      NS_ABORT_MSG_IF (size < 40, "EpcTftClassifier::Classify - Truncated IPv6 header...");
+      tos = ((buf[0] & 0x0f) << 4) | (buf[1] >> 4);
+      protocol = buf[6];
+      const uint8_t *ports = buf + 40;
 
-          if (direction ==  EpcTft::UPLINK)
-            {
-              localPort = udpHeader.GetSourcePort ();
-              remotePort = udpHeader.GetDestinationPort ();
-            }
-          else
-            {
-              remotePort = udpHeader.GetSourcePort ();
-              localPort = udpHeader.GetDestinationPort ();
-            }
-        }
-      else if (protocol == TcpL4Protocol::PROT_NUMBER)
+      if (protocol == UdpL4Protocol::PROT_NUMBER || protocol == TcpL4Protocol::PROT_NUMBER)
         {
-          TcpHeader tcpHeader;
-          pCopy->RemoveHeader (tcpHeader);
+          NS_ABORT_MSG_IF (size < 44, "EpcTftClassifier::Classify - Truncated transport header...");
+          uint16_t sourcePort = (ports[0] << 8) | ports[1];
+          uint16_t destinationPort = (ports[2] << 8) | ports[3];
           if (direction ==  EpcTft::UPLINK)
             {
-              localPort = tcpHeader.GetSourcePort ();
-              remotePort = tcpHeader.GetDestinationPort ();
+              localPort = sourcePort;
+              remotePort = destinationPort;
             }
           else
             {
-              remotePort = tcpHeader.GetSourcePort ();
-              localPort = tcpHeader.GetDestinationPort ();
+              remotePort = sourcePort;
+              localPort = destinationPort;
             }
         }
-    }
-  else
-    {
-      NS_ABORT_MSG ("EpcTftClassifier::Classify - Unknown IP type...");
-    }
 
-
-  if (ipType == 0x04)
-    {
       NS_LOG_INFO ("Classifying packet:"
-          << " localAddr="  << localAddressIpv4
-          << " remoteAddr=" << remoteAddressIpv4
+          << " localAddr="  << Ipv6Address (direction == EpcTft::UPLINK ? buf + 8 : buf + 24)
+          << " remoteAddr=" << Ipv6Address (direction == EpcTft::UPLINK ? buf + 24 : buf + 8)
           << " localPort="  << localPort
           << " remotePort=" << remotePort
           << " tos=0x" << (uint16_t) tos );
 
-      // now it is possible to classify the packet!
-      // we use a reverse iterator since filter priority is not implemented properly.
-      // This way, since the default bearer is expected to be added first, it will be evaluated last.
-      std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-      NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
-
-      for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
-        {
-          NS_LOG_LOGIC ("TFT id: " << it->first );
-          NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-          Ptr<EpcTft> tft = it->second;
-          if (tft->Matches (direction, remoteAddressIpv4, localAddressIpv4, remotePort, localPort, tos))
-            {
-              NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-              return it->first; // the id of the matching TFT
-            }
-        }
+      // the addresses are not matched for IPv6, see EpcTft::PacketFilter::Matches
+      return Match (direction, false, 0, 0, remotePort, localPort, tos);
     }
-  else if (ipType == 0x06)
-    {
-      NS_LOG_INFO ("Classifying packet:"
-          << " localAddr="  << localAddressIpv6
-          << " remoteAddr=" << remoteAddressIpv6
-          << " localPort="  << localPort
-          << " remotePort=" << remotePort
-          << " tos=0x" << (uint16_t) tos );
-
-      // now it is possible to classify the packet!
-      // we use a reverse iterator since filter priority is not implemented properly.
-      // This way, since the default bearer is expected to be added first, it will be evaluated last.
-      std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-      NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
 
-      for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
-        {
-          NS_LOG_LOGIC ("TFT id: " << it->first );
-          NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-          Ptr<EpcTft> tft = it->second;
-          if (tft->Matches (direction, remoteAddressIpv6, localAddressIpv6, remotePort, localPort, tos))
-            {
-              NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-              return it->first; // the id of the matching TFT
-            }
-        }
-    }
-  NS_LOG_LOGIC ("no match");
-  return 0;  // no match
+  NS_ABORT_MSG ("EpcTftClassifier::Classify - Unknown IP type...");
+  return 0;
 }
 
 
@@ -28,6 +28,7 @@
 #include "ns3/epc-tft.h"
 
 #include <map>
+#include <vector>
 
 
 namespace ns3 {
@@ -50,6 +51,12 @@ class Packet;
  *
  * When we cannot cache the port info, the TFT of the default bearer is used. This may happen
  * if there is reordering or losses of IP packets.
+ *
+ * The packet filters of all the TFTs are compiled, at the first classification after
+ * a TFT is added or deleted, into one table per direction holding the filters in the
+ * order they are evaluated, with the addresses and masks as integers. The headers of
+ * the packet are parsed in place, without copying the packet. Hence a TFT must have
+ * all its packet filters when it is added to the classifier.
  */
 class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
 {
@@ -85,9 +92,53 @@ public:
   uint32_t Classify (Ptr<Packet> p, EpcTft::Direction direction);
   
 protected:
+
+  /**
+   * Packet filter compiled for the classification in one direction
+   */
+  struct CompiledFilter
+  {
+    uint32_t id;                ///< the identifier of the TFT
+    uint32_t remoteAddress;     ///< the remote IPv4 address, masked
+    uint32_t remoteMask;        ///< the remote IPv4 address mask
+    uint32_t localAddress;      ///< the local IPv4 address, masked
+    uint32_t localMask;         ///< the local IPv4 address mask
+    uint16_t remotePortStart;   ///< the start of the remote port range
+    uint16_t remotePortEnd;     ///< the end of the remote port range
+    uint16_t localPortStart;    ///< the start of the local port range
+    uint16_t localPortEnd;      ///< the end of the local port range
+    uint8_t typeOfService;      ///< the type of service, masked
+    uint8_t typeOfServiceMask;  ///< the type of service mask
+  };
+
+  /**
+   * Compile the packet filters of the TFTs into m_compiledFilters
+   */
+  void Compile ();
+
+  /**
+   * Find the first compiled filter matching a packet
+   *
+   * \param direction the EPC TFT direction (downlink or uplink)
+   * \param matchAddresses whether to match the IPv4 addresses, which are not
+   *        matched for IPv6 packets
+   * \param remoteAddress the remote IPv4 address
+   * \param localAddress the local IPv4 address
+   * \param remotePort the remote port
+   * \param localPort the local port
+   * \param tos the type of service
+   *
+   * \return the identifier of the TFT of the matching filter; 0 if no filter matched.
+   */
+  uint32_t Match (EpcTft::Direction direction, bool matchAddresses,
+                  uint32_t remoteAddress, uint32_t localAddress,
+                  uint16_t remotePort, uint16_t localPort, uint8_t tos) const;
   
   std::map <uint32_t, Ptr<EpcTft> > m_tftMap; ///< TFT map
 
+  std::vector<CompiledFilter> m_compiledFilters[2]; ///< compiled filters of the downlink and of the uplink
+  bool m_compiled; ///< whether m_compiledFilters is up to date with m_tftMap
+
   std::map < std::tuple<uint32_t, uint32_t, uint8_t, uint16_t>,
              std::pair<uint32_t, uint32_t> >
       m_classifiedIpv4Fragments; ///< Map with already classified IPv4 Fragments
@@ -192,6 +192,11 @@ public:
 		  uint8_t typeOfService);
 
 
+  /**
+   * \return the packet filters of the TFT, in the order they are evaluated
+   */
+  std::list<PacketFilter> GetPacketFilters () const;
+
 private:
 
   std::list<PacketFilter> m_filters; ///< packet filter list
@@ -160,7 +160,7 @@ void
 FdBetFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params)
 {
   NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
-  std::map <uint16_t,uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
+  LteRntiMap <uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
   if (it == m_uesTxMode.end ())
     {
       m_uesTxMode.insert (std::pair <uint16_t, double> (params.m_rnti, params.m_transmissionMode));
@@ -200,7 +200,7 @@ FdBetFfMacScheduler::DoCschedLcConfigReq (const struct FfMacCschedSapProvider::C
 {
   NS_LOG_FUNCTION (this << " New LC, rnti: "  << params.m_rnti);
 
-  std::map <uint16_t, fdbetsFlowPerf_t>::iterator it;
+  LteRntiMap <fdbetsFlowPerf_t>::iterator it;
   for (uint16_t i = 0; i < params.m_logicalChannelConfigList.size (); i++)
     {
       it = m_flowStatsDl.find (params.m_rnti);
@@ -231,21 +231,7 @@ FdBetFfMacScheduler::DoCschedLcReleaseReq (const struct FfMacCschedSapProvider::
   NS_LOG_FUNCTION (this);
   for (uint16_t i = 0; i < params.m_logicalChannelIdentity.size (); i++)
     {
-      std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
-      std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator temp;
-      while (it!=m_rlcBufferReq.end ())
-        {
-          if (((*it).first.m_rnti == params.m_rnti) && ((*it).first.m_lcId == params.m_logicalChannelIdentity.at (i)))
-            {
-              temp = it;
-              it++;
-              m_rlcBufferReq.erase (temp);
-            }
-          else
-            {
-              it++;
-            }
-        }
+      m_rlcBufferReq.erase (LteFlowId_t (params.m_rnti, params.m_logicalChannelIdentity.at (i)));
     }
   return;
 }
@@ -267,20 +253,10 @@ FdBetFfMacScheduler::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::
   m_flowStatsDl.erase  (params.m_rnti);
   m_flowStatsUl.erase  (params.m_rnti);
   m_ceBsrRxed.erase (params.m_rnti);
-  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
-  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator temp;
-  while (it!=m_rlcBufferReq.end ())
+  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.lower_bound (LteFlowId_t (params.m_rnti, 0));
+  while (it != m_rlcBufferReq.end () && (*it).first.m_rnti == params.m_rnti)
     {
-      if ((*it).first.m_rnti == params.m_rnti)
-        {
-          temp = it;
-          it++;
-          m_rlcBufferReq.erase (temp);
-        }
-      else
-        {
-          it++;
-        }
+      m_rlcBufferReq.erase (it++);
     }
   if (m_nextRntiUl == params.m_rnti)
     {
@@ -351,7 +327,7 @@ FdBetFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
   std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
   unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
+  for (it = m_rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0)); it != m_rlcBufferReq.end (); it++)
     {
       if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
                                            || ((*it).second.m_rlcRetransmissionQueueSize > 0)
@@ -374,12 +350,12 @@ FdBetFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
+  LteRntiMap <uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
   if (it == m_dlHarqCurrentProcessId.end ())
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
+  LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
   if (itStat == m_dlHarqProcessesStatus.end ())
     {
       NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
@@ -413,12 +389,12 @@ FdBetFfMacScheduler::UpdateHarqProcessId (uint16_t rnti)
     }
 
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
+  LteRntiMap <uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
   if (it == m_dlHarqCurrentProcessId.end ())
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
+  LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
   if (itStat == m_dlHarqProcessesStatus.end ())
     {
       NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
@@ -448,7 +424,7 @@ FdBetFfMacScheduler::RefreshHarqProcesses ()
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itTimers;
+  LteRntiMap <DlHarqProcessesTimer_t>::iterator itTimers;
   for (itTimers = m_dlHarqProcessesTimer.begin (); itTimers != m_dlHarqProcessesTimer.end (); itTimers++)
     {
       for (uint16_t i = 0; i < HARQ_PROC_NUM; i++)
@@ -458,7 +434,7 @@ FdBetFfMacScheduler::RefreshHarqProcesses ()
               // reset HARQ process
 
               NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
+              LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
               if (itStat == m_dlHarqProcessesStatus.end ())
                 {
                   NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers).first);
@@ -491,7 +467,7 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
 
   int rbgSize = GetRbgSize (m_cschedCellConfig.m_dlBandwidth);
   int rbgNum = m_cschedCellConfig.m_dlBandwidth / rbgSize;
-  std::map <uint16_t, std::vector <uint16_t> > allocationMap; // RBs map per RNTI
+  LteRntiMap <std::vector <uint16_t> > allocationMap; // RBs map per RNTI
   std::vector <bool> rbgMap;  // global RBGs map
   uint16_t rbgAllocatedNum = 0;
   std::set <uint16_t> rntiAllocated;
@@ -500,7 +476,7 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
 
 
   //   update UL HARQ proc id
-  std::map <uint16_t, uint8_t>::iterator itProcId;
+  LteRntiMap <uint8_t>::iterator itProcId;
   for (itProcId = m_ulHarqCurrentProcessId.begin (); itProcId != m_ulHarqCurrentProcessId.end (); itProcId++)
     {
       (*itProcId).second = ((*itProcId).second + 1) % HARQ_PROC_NUM;
@@ -569,14 +545,14 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
           uldci.m_pdcchPowerOffset = 0; // not used
 
           uint8_t harqId = 0;
-          std::map <uint16_t, uint8_t>::iterator itProcId;
+          LteRntiMap <uint8_t>::iterator itProcId;
           itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
           if (itProcId == m_ulHarqCurrentProcessId.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
             }
           harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
           if (itDci == m_ulHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
@@ -641,7 +617,7 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
           uint16_t rnti = m_dlInfoListBuffered.at (i).m_rnti;
           uint8_t harqId = m_dlInfoListBuffered.at (i).m_harqProcessId;
           NS_LOG_INFO (this << " HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId);
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itHarq = m_dlHarqProcessesDciBuffer.find (rnti);
+          LteRntiMap <DlHarqProcessesDciBuffer_t>::iterator itHarq = m_dlHarqProcessesDciBuffer.find (rnti);
           if (itHarq == m_dlHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << rnti);
@@ -662,13 +638,13 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
             {
               // maximum number of retx reached -> drop process
               NS_LOG_INFO ("Maximum number of retransmissions reached -> drop process");
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
+              LteRntiMap <DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
               if (it == m_dlHarqProcessesStatus.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << m_dlInfoListBuffered.at (i).m_rnti);
                 }
               (*it).second.at (harqId) = 0;
-              std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
+              LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
               if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                 {
                   NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
@@ -754,7 +730,7 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
             }
           // retrieve RLC PDU list for retx TBsize and update DCI
           BuildDataListElement_s newEl;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
+          LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << rnti);
@@ -822,7 +798,7 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
           newEl.m_dci = dci;
           (*itHarq).second.at (harqId).m_rv = dci.m_rv;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer = m_dlHarqProcessesTimer.find (rnti);
+          LteRntiMap <DlHarqProcessesTimer_t>::iterator itHarqTimer = m_dlHarqProcessesTimer.find (rnti);
           if (itHarqTimer== m_dlHarqProcessesTimer.end ())
             {
               NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)rnti);
@@ -835,13 +811,13 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
         {
           // update HARQ process status
           NS_LOG_INFO (this << " HARQ received ACK for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-          std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
+          LteRntiMap <DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (it == m_dlHarqProcessesStatus.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << m_dlInfoListBuffered.at (i).m_rnti);
             }
           (*it).second.at (m_dlInfoListBuffered.at (i).m_harqProcessId) = 0;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
+          LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
@@ -865,11 +841,11 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
       return;
     }
 
-  std::map <uint16_t, fdbetsFlowPerf_t>::iterator itFlow;
-  std::map <uint16_t, double> estAveThr;                                // store expected average throughput for UE
-  std::map <uint16_t, double>::iterator itMax = estAveThr.end ();
-  std::map <uint16_t, double>::iterator it;
-  std::map <uint16_t, int> rbgPerRntiLog;                               // record the number of RBG assigned to UE
+  LteRntiMap <fdbetsFlowPerf_t>::iterator itFlow;
+  LteRntiMap <double> estAveThr;                                // store expected average throughput for UE
+  LteRntiMap <double>::iterator itMax = estAveThr.end ();
+  LteRntiMap <double>::iterator it;
+  LteRntiMap <int> rbgPerRntiLog;                               // record the number of RBG assigned to UE
   double metricMax = 0.0;
   for (itFlow = m_flowStatsDl.begin (); itFlow != m_flowStatsDl.end (); itFlow++)
     {
@@ -889,9 +865,9 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
         }
 
       // check first what are channel conditions for this UE, if CQI!=0
-      std::map <uint16_t,uint8_t>::iterator itCqi;
+      LteRntiMap <uint8_t>::iterator itCqi;
       itCqi = m_p10CqiRxed.find ((*itFlow).first);
-      std::map <uint16_t,uint8_t>::iterator itTxMode;
+      LteRntiMap <uint8_t>::iterator itTxMode;
       itTxMode = m_uesTxMode.find ((*itFlow).first);
       if (itTxMode == m_uesTxMode.end ())
         {
@@ -944,7 +920,7 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
           if (rbgMap.at (i) == false)
             {
               // allocate one RBG to current UE
-              std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
+              LteRntiMap <std::vector <uint16_t> >::iterator itMap;
               std::vector <uint16_t> tempMap;
               itMap = allocationMap.find ((*itMax).first);
               if (itMap == allocationMap.end ())
@@ -958,9 +934,9 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
                 }
 
               // calculate expected throughput for current UE
-              std::map <uint16_t,uint8_t>::iterator itCqi;
+              LteRntiMap <uint8_t>::iterator itCqi;
               itCqi = m_p10CqiRxed.find ((*itMax).first);
-              std::map <uint16_t,uint8_t>::iterator itTxMode;
+              LteRntiMap <uint8_t>::iterator itTxMode;
               itTxMode = m_uesTxMode.find ((*itMax).first);
               if (itTxMode == m_uesTxMode.end ())
                 {
@@ -980,9 +956,9 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
                     }
                 }
 
-              std::map <uint16_t,int>::iterator itRbgPerRntiLog;
+              LteRntiMap <int>::iterator itRbgPerRntiLog;
               itRbgPerRntiLog = rbgPerRntiLog.find ((*itMax).first);
-              std::map <uint16_t, fdbetsFlowPerf_t>::iterator itPastAveThr;
+              LteRntiMap <fdbetsFlowPerf_t>::iterator itPastAveThr;
               itPastAveThr = m_flowStatsDl.find ((*itMax).first);
               uint32_t bytesTxed = 0;
               for (uint8_t j = 0; j < nLayer; j++)
@@ -1021,7 +997,7 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
     } // end if estAveThr
 
   // reset TTI stats of users
-  std::map <uint16_t, fdbetsFlowPerf_t>::iterator itStats;
+  LteRntiMap <fdbetsFlowPerf_t>::iterator itStats;
   for (itStats = m_flowStatsDl.begin (); itStats != m_flowStatsDl.end (); itStats++)
     {
       (*itStats).second.lastTtiBytesTrasmitted = 0;
@@ -1029,7 +1005,7 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
 
   // generate the transmission opportunities by grouping the RBGs of the same RNTI and
   // creating the correspondent DCIs
-  std::map <uint16_t, std::vector <uint16_t> >::iterator itMap = allocationMap.begin ();
+  LteRntiMap <std::vector <uint16_t> >::iterator itMap = allocationMap.begin ();
   while (itMap != allocationMap.end ())
     {
       // create new BuildDataListElement_s for this LC
@@ -1048,9 +1024,9 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
           lcActives = (uint16_t)65535; // UINT16_MAX;
         }
       uint16_t RgbPerRnti = (*itMap).second.size ();
-      std::map <uint16_t,uint8_t>::iterator itCqi;
+      LteRntiMap <uint8_t>::iterator itCqi;
       itCqi = m_p10CqiRxed.find ((*itMap).first);
-      std::map <uint16_t,uint8_t>::iterator itTxMode;
+      LteRntiMap <uint8_t>::iterator itTxMode;
       itTxMode = m_uesTxMode.find ((*itMap).first);
       if (itTxMode == m_uesTxMode.end ())
         {
@@ -1087,7 +1063,7 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
 
       // create the rlc PDUs -> equally divide resources among actives LCs
       std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itBufReq;
-      for (itBufReq = m_rlcBufferReq.begin (); itBufReq != m_rlcBufferReq.end (); itBufReq++)
+      for (itBufReq = m_rlcBufferReq.lower_bound (LteFlowId_t ((*itMap).first, 0)); itBufReq != m_rlcBufferReq.end (); itBufReq++)
         {
           if (((*itBufReq).first.m_rnti == (*itMap).first)
               && (((*itBufReq).second.m_rlcTransmissionQueueSize > 0)
@@ -1106,7 +1082,7 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
                   if (m_harqOn == true)
                     {
                       // store RLC PDU list for HARQ
-                      std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find ((*itMap).first);
+                      LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find ((*itMap).first);
                       if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                         {
                           NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << (*itMap).first);
@@ -1134,14 +1110,14 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
       if (m_harqOn == true)
         {
           // store DCI for HARQ
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itDci = m_dlHarqProcessesDciBuffer.find (newEl.m_rnti);
+          LteRntiMap <DlHarqProcessesDciBuffer_t>::iterator itDci = m_dlHarqProcessesDciBuffer.find (newEl.m_rnti);
           if (itDci == m_dlHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in DCI HARQ buffer for RNTI " << newEl.m_rnti);
             }
           (*itDci).second.at (newDci.m_harqProcess) = newDci;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer =  m_dlHarqProcessesTimer.find (newEl.m_rnti);
+          LteRntiMap <DlHarqProcessesTimer_t>::iterator itHarqTimer =  m_dlHarqProcessesTimer.find (newEl.m_rnti);
           if (itHarqTimer== m_dlHarqProcessesTimer.end ())
             {
               NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)newEl.m_rnti);
@@ -1153,7 +1129,7 @@ FdBetFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sc
 
       ret.m_buildDataList.push_back (newEl);
       // update UE stats
-      std::map <uint16_t, fdbetsFlowPerf_t>::iterator it;
+      LteRntiMap <fdbetsFlowPerf_t>::iterator it;
       it = m_flowStatsDl.find ((*itMap).first);
       if (it != m_flowStatsDl.end ())
         {
@@ -1210,7 +1186,7 @@ FdBetFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sc
       if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::P10 )
         {
           NS_LOG_LOGIC ("wideband CQI " <<  (uint32_t) params.m_cqiList.at (i).m_wbCqi.at (0) << " reported");
-          std::map <uint16_t,uint8_t>::iterator it;
+          LteRntiMap <uint8_t>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
           it = m_p10CqiRxed.find (rnti);
           if (it == m_p10CqiRxed.end ())
@@ -1225,7 +1201,7 @@ FdBetFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sc
               // update the CQI value and refresh correspondent timer
               (*it).second = params.m_cqiList.at (i).m_wbCqi.at (0);
               // update correspondent timer
-              std::map <uint16_t,uint32_t>::iterator itTimers;
+              LteRntiMap <uint32_t>::iterator itTimers;
               itTimers = m_p10CqiTimers.find (rnti);
               (*itTimers).second = m_cqiTimersThreshold;
             }
@@ -1233,7 +1209,7 @@ FdBetFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sc
       else if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::A30 )
         {
           // subband CQI reporting high layer configured
-          std::map <uint16_t,SbMeasResult_s>::iterator it;
+          LteRntiMap <SbMeasResult_s>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
           it = m_a30CqiRxed.find (rnti);
           if (it == m_a30CqiRxed.end ())
@@ -1246,7 +1222,7 @@ FdBetFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sc
             {
               // update the CQI value and refresh correspondent timer
               (*it).second = params.m_cqiList.at (i).m_sbMeasResult;
-              std::map <uint16_t,uint32_t>::iterator itTimers;
+              LteRntiMap <uint32_t>::iterator itTimers;
               itTimers = m_a30CqiTimers.find (rnti);
               (*itTimers).second = m_cqiTimersThreshold;
             }
@@ -1264,7 +1240,7 @@ FdBetFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sc
 double
 FdBetFfMacScheduler::EstimateUlSinr (uint16_t rnti, uint16_t rb)
 {
-  std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find (rnti);
+  LteRntiMap <std::vector <double> >::iterator itCqi = m_ueCqi.find (rnti);
   if (itCqi == m_ueCqi.end ())
     {
       // no cqi info about this UE
@@ -1332,21 +1308,21 @@ FdBetFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sc
             {
               // retx correspondent block: retrieve the UL-DCI
               uint16_t rnti = params.m_ulInfoList.at (i).m_rnti;
-              std::map <uint16_t, uint8_t>::iterator itProcId = m_ulHarqCurrentProcessId.find (rnti);
+              LteRntiMap <uint8_t>::iterator itProcId = m_ulHarqCurrentProcessId.find (rnti);
               if (itProcId == m_ulHarqCurrentProcessId.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
                 }
               uint8_t harqId = (uint8_t)((*itProcId).second - HARQ_PERIOD) % HARQ_PROC_NUM;
               NS_LOG_INFO (this << " UL-HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId << " i " << i << " size "  << params.m_ulInfoList.size ());
-              std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itHarq = m_ulHarqProcessesDciBuffer.find (rnti);
+              LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itHarq = m_ulHarqProcessesDciBuffer.find (rnti);
               if (itHarq == m_ulHarqProcessesDciBuffer.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
                   continue;
                 }
               UlDciListElement_s dci = (*itHarq).second.at (harqId);
-              std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
+              LteRntiMap <UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
               if (itStat == m_ulHarqProcessesStatus.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
@@ -1397,7 +1373,7 @@ FdBetFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sc
         }
     }
 
-  std::map <uint16_t,uint32_t>::iterator it;
+  LteRntiMap <uint32_t>::iterator it;
   int nflows = 0;
 
   for (it = m_ceBsrRxed.begin (); it != m_ceBsrRxed.end (); it++)
@@ -1430,7 +1406,7 @@ FdBetFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sc
     }
   int rbAllocated = 0;
 
-  std::map <uint16_t, fdbetsFlowPerf_t>::iterator itStats;
+  LteRntiMap <fdbetsFlowPerf_t>::iterator itStats;
   if (m_nextRntiUl != 0)
     {
       for (it = m_ceBsrRxed.begin (); it != m_ceBsrRxed.end (); it++)
@@ -1535,7 +1511,7 @@ FdBetFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sc
 
 
 
-      std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find ((*it).first);
+      LteRntiMap <std::vector <double> >::iterator itCqi = m_ueCqi.find ((*it).first);
       int cqi = 0;
       if (itCqi == m_ueCqi.end ())
         {
@@ -1606,21 +1582,21 @@ FdBetFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sc
       uint8_t harqId = 0;
       if (m_harqOn == true)
         {
-          std::map <uint16_t, uint8_t>::iterator itProcId;
+          LteRntiMap <uint8_t>::iterator itProcId;
           itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
           if (itProcId == m_ulHarqCurrentProcessId.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
             }
           harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
           if (itDci == m_ulHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
             }
           (*itDci).second.at (harqId) = uldci;
           // Update HARQ process status (RV 0)
-          std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (uldci.m_rnti);
           if (itStat == m_ulHarqProcessesStatus.end ())
             {
               NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << uldci.m_rnti);
@@ -1694,7 +1670,7 @@ FdBetFfMacScheduler::DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t,uint32_t>::iterator it;
+  LteRntiMap <uint32_t>::iterator it;
 
   for (unsigned int i = 0; i < params.m_macCeList.size (); i++)
     {
@@ -1769,7 +1745,7 @@ FdBetFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sc
     case UlCqi_s::PUSCH:
       {
         std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
-        std::map <uint16_t, std::vector <double> >::iterator itCqi;
+        LteRntiMap <std::vector <double> >::iterator itCqi;
         NS_LOG_DEBUG (this << " Collect PUSCH CQIs of Frame no. " << (params.m_sfnSf >> 4) << " subframe no. " << (0xF & params.m_sfnSf));
         itMap = m_allocationMaps.find (params.m_sfnSf);
         if (itMap == m_allocationMaps.end ())
@@ -1808,7 +1784,7 @@ FdBetFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sc
                 (*itCqi).second.at (i) = sinr;
                 NS_LOG_DEBUG (this << " RNTI " << (*itMap).second.at (i) << " RB " << i << " SINR " << sinr);
                 // update correspondent timer
-                std::map <uint16_t, uint32_t>::iterator itTimers;
+                LteRntiMap <uint32_t>::iterator itTimers;
                 itTimers = m_ueCqiTimers.find ((*itMap).second.at (i));
                 (*itTimers).second = m_cqiTimersThreshold;
 
@@ -1832,7 +1808,7 @@ FdBetFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sc
                 rnti = vsp->GetRnti ();
               }
           }
-        std::map <uint16_t, std::vector <double> >::iterator itCqi;
+        LteRntiMap <std::vector <double> >::iterator itCqi;
         itCqi = m_ueCqi.find (rnti);
         if (itCqi == m_ueCqi.end ())
           {
@@ -1859,7 +1835,7 @@ FdBetFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sc
                 NS_LOG_INFO (this << " RNTI " << rnti << " update SRS-CQI for RB  " << j << " value " << sinr);
               }
             // update correspondent timer
-            std::map <uint16_t, uint32_t>::iterator itTimers;
+            LteRntiMap <uint32_t>::iterator itTimers;
             itTimers = m_ueCqiTimers.find (rnti);
             (*itTimers).second = m_cqiTimersThreshold;
 
@@ -1885,18 +1861,18 @@ void
 FdBetFfMacScheduler::RefreshDlCqiMaps (void)
 {
   // refresh DL CQI P01 Map
-  std::map <uint16_t,uint32_t>::iterator itP10 = m_p10CqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itP10 = m_p10CqiTimers.begin ();
   while (itP10 != m_p10CqiTimers.end ())
     {
       NS_LOG_INFO (this << " P10-CQI for user " << (*itP10).first << " is " << (uint32_t)(*itP10).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itP10).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,uint8_t>::iterator itMap = m_p10CqiRxed.find ((*itP10).first);
+          LteRntiMap <uint8_t>::iterator itMap = m_p10CqiRxed.find ((*itP10).first);
           NS_ASSERT_MSG (itMap != m_p10CqiRxed.end (), " Does not find CQI report for user " << (*itP10).first);
           NS_LOG_INFO (this << " P10-CQI expired for user " << (*itP10).first);
           m_p10CqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itP10;
+          LteRntiMap <uint32_t>::iterator temp = itP10;
           itP10++;
           m_p10CqiTimers.erase (temp);
         }
@@ -1908,18 +1884,18 @@ FdBetFfMacScheduler::RefreshDlCqiMaps (void)
     }
 
   // refresh DL CQI A30 Map
-  std::map <uint16_t,uint32_t>::iterator itA30 = m_a30CqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itA30 = m_a30CqiTimers.begin ();
   while (itA30 != m_a30CqiTimers.end ())
     {
       NS_LOG_INFO (this << " A30-CQI for user " << (*itA30).first << " is " << (uint32_t)(*itA30).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itA30).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
+          LteRntiMap <SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
           NS_ASSERT_MSG (itMap != m_a30CqiRxed.end (), " Does not find CQI report for user " << (*itA30).first);
           NS_LOG_INFO (this << " A30-CQI expired for user " << (*itA30).first);
           m_a30CqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itA30;
+          LteRntiMap <uint32_t>::iterator temp = itA30;
           itA30++;
           m_a30CqiTimers.erase (temp);
         }
@@ -1938,19 +1914,19 @@ void
 FdBetFfMacScheduler::RefreshUlCqiMaps (void)
 {
   // refresh UL CQI  Map
-  std::map <uint16_t,uint32_t>::iterator itUl = m_ueCqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itUl = m_ueCqiTimers.begin ();
   while (itUl != m_ueCqiTimers.end ())
     {
       NS_LOG_INFO (this << " UL-CQI for user " << (*itUl).first << " is " << (uint32_t)(*itUl).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itUl).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t, std::vector <double> >::iterator itMap = m_ueCqi.find ((*itUl).first);
+          LteRntiMap <std::vector <double> >::iterator itMap = m_ueCqi.find ((*itUl).first);
           NS_ASSERT_MSG (itMap != m_ueCqi.end (), " Does not find CQI report for user " << (*itUl).first);
           NS_LOG_INFO (this << " UL-CQI exired for user " << (*itUl).first);
           (*itMap).second.clear ();
           m_ueCqi.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itUl;
+          LteRntiMap <uint32_t>::iterator temp = itUl;
           itUl++;
           m_ueCqiTimers.erase (temp);
         }
@@ -2021,7 +1997,7 @@ FdBetFfMacScheduler::UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size)
 {
 
   size = size - 2; // remove the minimum RLC overhead
-  std::map <uint16_t,uint32_t>::iterator it = m_ceBsrRxed.find (rnti);
+  LteRntiMap <uint32_t>::iterator it = m_ceBsrRxed.find (rnti);
   if (it != m_ceBsrRxed.end ())
     {
       NS_LOG_INFO (this << " UE " << rnti << " size " << size << " BSR " << (*it).second);
@@ -159,7 +159,7 @@ void
 FdMtFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params)
 {
   NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
-  std::map <uint16_t,uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
+  LteRntiMap <uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
   if (it == m_uesTxMode.end ())
     {
       m_uesTxMode.insert (std::pair <uint16_t, double> (params.m_rnti, params.m_transmissionMode));
@@ -220,21 +220,7 @@ FdMtFfMacScheduler::DoCschedLcReleaseReq (const struct FfMacCschedSapProvider::C
   NS_LOG_FUNCTION (this);
   for (uint16_t i = 0; i < params.m_logicalChannelIdentity.size (); i++)
     {
-      std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
-      std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator temp;
-      while (it!=m_rlcBufferReq.end ())
-        {
-          if (((*it).first.m_rnti == params.m_rnti) && ((*it).first.m_lcId == params.m_logicalChannelIdentity.at (i)))
-            {
-              temp = it;
-              it++;
-              m_rlcBufferReq.erase (temp);
-            }
-          else
-            {
-              it++;
-            }
-        }
+      m_rlcBufferReq.erase (LteFlowId_t (params.m_rnti, params.m_logicalChannelIdentity.at (i)));
     }
   return;
 }
@@ -256,20 +242,10 @@ FdMtFfMacScheduler::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::C
   m_flowStatsDl.erase  (params.m_rnti);
   m_flowStatsUl.erase  (params.m_rnti);
   m_ceBsrRxed.erase (params.m_rnti);
-  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
-  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator temp;
-  while (it!=m_rlcBufferReq.end ())
+  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.lower_bound (LteFlowId_t (params.m_rnti, 0));
+  while (it != m_rlcBufferReq.end () && (*it).first.m_rnti == params.m_rnti)
     {
-      if ((*it).first.m_rnti == params.m_rnti)
-        {
-          temp = it;
-          it++;
-          m_rlcBufferReq.erase (temp);
-        }
-      else
-        {
-          it++;
-        }
+      m_rlcBufferReq.erase (it++);
     }
   if (m_nextRntiUl == params.m_rnti)
     {
@@ -340,7 +316,7 @@ FdMtFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
   std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
   unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
+  for (it = m_rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0)); it != m_rlcBufferReq.end (); it++)
     {
       if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
                                            || ((*it).second.m_rlcRetransmissionQueueSize > 0)
@@ -363,12 +339,12 @@ FdMtFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
+  LteRntiMap <uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
   if (it == m_dlHarqCurrentProcessId.end ())
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
+  LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
   if (itStat == m_dlHarqProcessesStatus.end ())
     {
       NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
@@ -402,12 +378,12 @@ FdMtFfMacScheduler::UpdateHarqProcessId (uint16_t rnti)
     }
 
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
+  LteRntiMap <uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
   if (it == m_dlHarqCurrentProcessId.end ())
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
+  LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
   if (itStat == m_dlHarqProcessesStatus.end ())
     {
       NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
@@ -437,7 +413,7 @@ FdMtFfMacScheduler::RefreshHarqProcesses ()
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itTimers;
+  LteRntiMap <DlHarqProcessesTimer_t>::iterator itTimers;
   for (itTimers = m_dlHarqProcessesTimer.begin (); itTimers != m_dlHarqProcessesTimer.end (); itTimers ++)
     {
       for (uint16_t i = 0; i < HARQ_PROC_NUM; i++)
@@ -447,7 +423,7 @@ FdMtFfMacScheduler::RefreshHarqProcesses ()
               // reset HARQ process
               
               NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
+              LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
               if (itStat == m_dlHarqProcessesStatus.end ())
                 {
                   NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers).first);
@@ -480,7 +456,7 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
 
   int rbgSize = GetRbgSize (m_cschedCellConfig.m_dlBandwidth);
   int rbgNum = m_cschedCellConfig.m_dlBandwidth / rbgSize;
-  std::map <uint16_t, std::vector <uint16_t> > allocationMap; // RBs map per RNTI
+  LteRntiMap <std::vector <uint16_t> > allocationMap; // RBs map per RNTI
   std::vector <bool> rbgMap;  // global RBGs map
   uint16_t rbgAllocatedNum = 0;
   std::set <uint16_t> rntiAllocated;
@@ -488,7 +464,7 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
   FfMacSchedSapUser::SchedDlConfigIndParameters ret;
 
   //   update UL HARQ proc id
-  std::map <uint16_t, uint8_t>::iterator itProcId;
+  LteRntiMap <uint8_t>::iterator itProcId;
   for (itProcId = m_ulHarqCurrentProcessId.begin (); itProcId != m_ulHarqCurrentProcessId.end (); itProcId++)
     {
       (*itProcId).second = ((*itProcId).second + 1) % HARQ_PROC_NUM;
@@ -557,14 +533,14 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
           uldci.m_pdcchPowerOffset = 0; // not used
 
           uint8_t harqId = 0;
-          std::map <uint16_t, uint8_t>::iterator itProcId;
+          LteRntiMap <uint8_t>::iterator itProcId;
           itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
           if (itProcId == m_ulHarqCurrentProcessId.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
             }
           harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
           if (itDci == m_ulHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
@@ -629,7 +605,7 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
           uint16_t rnti = m_dlInfoListBuffered.at (i).m_rnti;
           uint8_t harqId = m_dlInfoListBuffered.at (i).m_harqProcessId;
           NS_LOG_INFO (this << " HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId);
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itHarq = m_dlHarqProcessesDciBuffer.find (rnti);
+          LteRntiMap <DlHarqProcessesDciBuffer_t>::iterator itHarq = m_dlHarqProcessesDciBuffer.find (rnti);
           if (itHarq == m_dlHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << rnti);
@@ -650,13 +626,13 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
             {
               // maximum number of retx reached -> drop process
               NS_LOG_INFO ("Maximum number of retransmissions reached -> drop process");
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
+              LteRntiMap <DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
               if (it == m_dlHarqProcessesStatus.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << m_dlInfoListBuffered.at (i).m_rnti);
                 }
               (*it).second.at (harqId) = 0;
-              std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
+              LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
               if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                 {
                   NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
@@ -742,7 +718,7 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
             }
           // retrieve RLC PDU list for retx TBsize and update DCI
           BuildDataListElement_s newEl;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
+          LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << rnti);
@@ -810,7 +786,7 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
           newEl.m_dci = dci;
           (*itHarq).second.at (harqId).m_rv = dci.m_rv;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer = m_dlHarqProcessesTimer.find (rnti);
+          LteRntiMap <DlHarqProcessesTimer_t>::iterator itHarqTimer = m_dlHarqProcessesTimer.find (rnti);
           if (itHarqTimer== m_dlHarqProcessesTimer.end ())
             {
               NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)rnti);
@@ -823,13 +799,13 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
         {
           // update HARQ process status
           NS_LOG_INFO (this << " HARQ received ACK for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-          std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
+          LteRntiMap <DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (it == m_dlHarqProcessesStatus.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << m_dlInfoListBuffered.at (i).m_rnti);
             }
           (*it).second.at (m_dlInfoListBuffered.at (i).m_harqProcessId) = 0;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
+          LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
@@ -880,9 +856,9 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
                   continue;
                 }
 
-              std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
+              LteRntiMap <SbMeasResult_s>::iterator itCqi;
               itCqi = m_a30CqiRxed.find ((*it));
-              std::map <uint16_t,uint8_t>::iterator itTxMode;
+              LteRntiMap <uint8_t>::iterator itTxMode;
               itTxMode = m_uesTxMode.find ((*it));
               if (itTxMode == m_uesTxMode.end ())
                 {
@@ -949,7 +925,7 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
           else
             {
               rbgMap.at (i) = true;
-              std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
+              LteRntiMap <std::vector <uint16_t> >::iterator itMap;
               itMap = allocationMap.find ((*itMax));
               if (itMap == allocationMap.end ())
                 {
@@ -969,7 +945,7 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
 
   // generate the transmission opportunities by grouping the RBGs of the same RNTI and
   // creating the correspondent DCIs
-  std::map <uint16_t, std::vector <uint16_t> >::iterator itMap = allocationMap.begin ();
+  LteRntiMap <std::vector <uint16_t> >::iterator itMap = allocationMap.begin ();
   while (itMap != allocationMap.end ())
     {
       // create new BuildDataListElement_s for this LC
@@ -988,9 +964,9 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
           lcActives = (uint16_t)65535; // UINT16_MAX;
         }
       uint16_t RgbPerRnti = (*itMap).second.size ();
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
+      LteRntiMap <SbMeasResult_s>::iterator itCqi;
       itCqi = m_a30CqiRxed.find ((*itMap).first);
-      std::map <uint16_t,uint8_t>::iterator itTxMode;
+      LteRntiMap <uint8_t>::iterator itTxMode;
       itTxMode = m_uesTxMode.find ((*itMap).first);
       if (itTxMode == m_uesTxMode.end ())
         {
@@ -1063,7 +1039,7 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
 
       // create the rlc PDUs -> equally divide resources among actives LCs
       std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itBufReq;
-      for (itBufReq = m_rlcBufferReq.begin (); itBufReq != m_rlcBufferReq.end (); itBufReq++)
+      for (itBufReq = m_rlcBufferReq.lower_bound (LteFlowId_t ((*itMap).first, 0)); itBufReq != m_rlcBufferReq.end (); itBufReq++)
         {
           if (((*itBufReq).first.m_rnti == (*itMap).first)
               && (((*itBufReq).second.m_rlcTransmissionQueueSize > 0)
@@ -1082,7 +1058,7 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
                   if (m_harqOn == true)
                     {
                       // store RLC PDU list for HARQ
-                      std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find ((*itMap).first);
+                      LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find ((*itMap).first);
                       if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                         {
                           NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << (*itMap).first);
@@ -1110,14 +1086,14 @@ FdMtFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sch
       if (m_harqOn == true)
         {
           // store DCI for HARQ
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itDci = m_dlHarqProcessesDciBuffer.find (newEl.m_rnti);
+          LteRntiMap <DlHarqProcessesDciBuffer_t>::iterator itDci = m_dlHarqProcessesDciBuffer.find (newEl.m_rnti);
           if (itDci == m_dlHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in DCI HARQ buffer for RNTI " << newEl.m_rnti);
             }
           (*itDci).second.at (newDci.m_harqProcess) = newDci;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer =  m_dlHarqProcessesTimer.find (newEl.m_rnti);
+          LteRntiMap <DlHarqProcessesTimer_t>::iterator itHarqTimer =  m_dlHarqProcessesTimer.find (newEl.m_rnti);
           if (itHarqTimer== m_dlHarqProcessesTimer.end ())
             {
               NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)newEl.m_rnti);
@@ -1159,7 +1135,7 @@ FdMtFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sch
       if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::P10 )
         {
           NS_LOG_LOGIC ("wideband CQI " <<  (uint32_t) params.m_cqiList.at (i).m_wbCqi.at (0) << " reported");
-          std::map <uint16_t,uint8_t>::iterator it;
+          LteRntiMap <uint8_t>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
           it = m_p10CqiRxed.find (rnti);
           if (it == m_p10CqiRxed.end ())
@@ -1174,7 +1150,7 @@ FdMtFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sch
               // update the CQI value and refresh correspondent timer
               (*it).second = params.m_cqiList.at (i).m_wbCqi.at (0);
               // update correspondent timer
-              std::map <uint16_t,uint32_t>::iterator itTimers;
+              LteRntiMap <uint32_t>::iterator itTimers;
               itTimers = m_p10CqiTimers.find (rnti);
               (*itTimers).second = m_cqiTimersThreshold;
             }
@@ -1182,7 +1158,7 @@ FdMtFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sch
       else if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::A30 )
         {
           // subband CQI reporting high layer configured
-          std::map <uint16_t,SbMeasResult_s>::iterator it;
+          LteRntiMap <SbMeasResult_s>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
           it = m_a30CqiRxed.find (rnti);
           if (it == m_a30CqiRxed.end ())
@@ -1195,7 +1171,7 @@ FdMtFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sch
             {
               // update the CQI value and refresh correspondent timer
               (*it).second = params.m_cqiList.at (i).m_sbMeasResult;
-              std::map <uint16_t,uint32_t>::iterator itTimers;
+              LteRntiMap <uint32_t>::iterator itTimers;
               itTimers = m_a30CqiTimers.find (rnti);
               (*itTimers).second = m_cqiTimersThreshold;
             }
@@ -1213,7 +1189,7 @@ FdMtFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sch
 double
 FdMtFfMacScheduler::EstimateUlSinr (uint16_t rnti, uint16_t rb)
 {
-  std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find (rnti);
+  LteRntiMap <std::vector <double> >::iterator itCqi = m_ueCqi.find (rnti);
   if (itCqi == m_ueCqi.end ())
     {
       // no cqi info about this UE
@@ -1281,21 +1257,21 @@ FdMtFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sch
             {
               // retx correspondent block: retrieve the UL-DCI
               uint16_t rnti = params.m_ulInfoList.at (i).m_rnti;
-              std::map <uint16_t, uint8_t>::iterator itProcId = m_ulHarqCurrentProcessId.find (rnti);
+              LteRntiMap <uint8_t>::iterator itProcId = m_ulHarqCurrentProcessId.find (rnti);
               if (itProcId == m_ulHarqCurrentProcessId.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
                 }
               uint8_t harqId = (uint8_t)((*itProcId).second - HARQ_PERIOD) % HARQ_PROC_NUM;
               NS_LOG_INFO (this << " UL-HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId << " i " << i << " size "  << params.m_ulInfoList.size ());
-              std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itHarq = m_ulHarqProcessesDciBuffer.find (rnti);
+              LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itHarq = m_ulHarqProcessesDciBuffer.find (rnti);
               if (itHarq == m_ulHarqProcessesDciBuffer.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
                   continue;
                 }
               UlDciListElement_s dci = (*itHarq).second.at (harqId);
-              std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
+              LteRntiMap <UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
               if (itStat == m_ulHarqProcessesStatus.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
@@ -1346,7 +1322,7 @@ FdMtFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sch
         }
     }
 
-  std::map <uint16_t,uint32_t>::iterator it;
+  LteRntiMap <uint32_t>::iterator it;
   int nflows = 0;
 
   for (it = m_ceBsrRxed.begin (); it != m_ceBsrRxed.end (); it++)
@@ -1483,7 +1459,7 @@ FdMtFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sch
 
 
 
-      std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find ((*it).first);
+      LteRntiMap <std::vector <double> >::iterator itCqi = m_ueCqi.find ((*it).first);
       int cqi = 0;
       if (itCqi == m_ueCqi.end ())
         {
@@ -1554,21 +1530,21 @@ FdMtFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::Sch
       uint8_t harqId = 0;
       if (m_harqOn == true)
         {
-          std::map <uint16_t, uint8_t>::iterator itProcId;
+          LteRntiMap <uint8_t>::iterator itProcId;
           itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
           if (itProcId == m_ulHarqCurrentProcessId.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
             }
           harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
           if (itDci == m_ulHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
             }
           (*itDci).second.at (harqId) = uldci;
           // Update HARQ process status (RV 0)
-          std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (uldci.m_rnti);
           if (itStat == m_ulHarqProcessesStatus.end ())
             {
               NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << uldci.m_rnti);
@@ -1620,7 +1596,7 @@ FdMtFfMacScheduler::DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider:
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t,uint32_t>::iterator it;
+  LteRntiMap <uint32_t>::iterator it;
 
   for (unsigned int i = 0; i < params.m_macCeList.size (); i++)
     {
@@ -1695,7 +1671,7 @@ FdMtFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sch
     case UlCqi_s::PUSCH:
       {
         std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
-        std::map <uint16_t, std::vector <double> >::iterator itCqi;
+        LteRntiMap <std::vector <double> >::iterator itCqi;
         NS_LOG_DEBUG (this << " Collect PUSCH CQIs of Frame no. " << (params.m_sfnSf >> 4) << " subframe no. " << (0xF & params.m_sfnSf));
         itMap = m_allocationMaps.find (params.m_sfnSf);
         if (itMap == m_allocationMaps.end ())
@@ -1734,7 +1710,7 @@ FdMtFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sch
                 (*itCqi).second.at (i) = sinr;
                 NS_LOG_DEBUG (this << " RNTI " << (*itMap).second.at (i) << " RB " << i << " SINR " << sinr);
                 // update correspondent timer
-                std::map <uint16_t, uint32_t>::iterator itTimers;
+                LteRntiMap <uint32_t>::iterator itTimers;
                 itTimers = m_ueCqiTimers.find ((*itMap).second.at (i));
                 (*itTimers).second = m_cqiTimersThreshold;
 
@@ -1758,7 +1734,7 @@ FdMtFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sch
                 rnti = vsp->GetRnti ();
               }
           }
-        std::map <uint16_t, std::vector <double> >::iterator itCqi;
+        LteRntiMap <std::vector <double> >::iterator itCqi;
         itCqi = m_ueCqi.find (rnti);
         if (itCqi == m_ueCqi.end ())
           {
@@ -1785,7 +1761,7 @@ FdMtFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::Sch
                 NS_LOG_INFO (this << " RNTI " << rnti << " update SRS-CQI for RB  " << j << " value " << sinr);
               }
             // update correspondent timer
-            std::map <uint16_t, uint32_t>::iterator itTimers;
+            LteRntiMap <uint32_t>::iterator itTimers;
             itTimers = m_ueCqiTimers.find (rnti);
             (*itTimers).second = m_cqiTimersThreshold;
 
@@ -1811,18 +1787,18 @@ void
 FdMtFfMacScheduler::RefreshDlCqiMaps (void)
 {
   // refresh DL CQI P01 Map
-  std::map <uint16_t,uint32_t>::iterator itP10 = m_p10CqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itP10 = m_p10CqiTimers.begin ();
   while (itP10 != m_p10CqiTimers.end ())
     {
       NS_LOG_INFO (this << " P10-CQI for user " << (*itP10).first << " is " << (uint32_t)(*itP10).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itP10).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,uint8_t>::iterator itMap = m_p10CqiRxed.find ((*itP10).first);
+          LteRntiMap <uint8_t>::iterator itMap = m_p10CqiRxed.find ((*itP10).first);
           NS_ASSERT_MSG (itMap != m_p10CqiRxed.end (), " Does not find CQI report for user " << (*itP10).first);
           NS_LOG_INFO (this << " P10-CQI expired for user " << (*itP10).first);
           m_p10CqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itP10;
+          LteRntiMap <uint32_t>::iterator temp = itP10;
           itP10++;
           m_p10CqiTimers.erase (temp);
         }
@@ -1834,18 +1810,18 @@ FdMtFfMacScheduler::RefreshDlCqiMaps (void)
     }
 
   // refresh DL CQI A30 Map
-  std::map <uint16_t,uint32_t>::iterator itA30 = m_a30CqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itA30 = m_a30CqiTimers.begin ();
   while (itA30 != m_a30CqiTimers.end ())
     {
       NS_LOG_INFO (this << " A30-CQI for user " << (*itA30).first << " is " << (uint32_t)(*itA30).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itA30).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
+          LteRntiMap <SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
           NS_ASSERT_MSG (itMap != m_a30CqiRxed.end (), " Does not find CQI report for user " << (*itA30).first);
           NS_LOG_INFO (this << " A30-CQI expired for user " << (*itA30).first);
           m_a30CqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itA30;
+          LteRntiMap <uint32_t>::iterator temp = itA30;
           itA30++;
           m_a30CqiTimers.erase (temp);
         }
@@ -1864,19 +1840,19 @@ void
 FdMtFfMacScheduler::RefreshUlCqiMaps (void)
 {
   // refresh UL CQI  Map
-  std::map <uint16_t,uint32_t>::iterator itUl = m_ueCqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itUl = m_ueCqiTimers.begin ();
   while (itUl != m_ueCqiTimers.end ())
     {
       NS_LOG_INFO (this << " UL-CQI for user " << (*itUl).first << " is " << (uint32_t)(*itUl).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itUl).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t, std::vector <double> >::iterator itMap = m_ueCqi.find ((*itUl).first);
+          LteRntiMap <std::vector <double> >::iterator itMap = m_ueCqi.find ((*itUl).first);
           NS_ASSERT_MSG (itMap != m_ueCqi.end (), " Does not find CQI report for user " << (*itUl).first);
           NS_LOG_INFO (this << " UL-CQI exired for user " << (*itUl).first);
           (*itMap).second.clear ();
           m_ueCqi.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itUl;
+          LteRntiMap <uint32_t>::iterator temp = itUl;
           itUl++;
           m_ueCqiTimers.erase (temp);
         }
@@ -1947,7 +1923,7 @@ FdMtFfMacScheduler::UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size)
 {
 
   size = size - 2; // remove the minimum RLC overhead
-  std::map <uint16_t,uint32_t>::iterator it = m_ceBsrRxed.find (rnti);
+  LteRntiMap <uint32_t>::iterator it = m_ceBsrRxed.find (rnti);
   if (it != m_ceBsrRxed.end ())
     {
       NS_LOG_INFO (this << " UE " << rnti << " size " << size << " BSR " << (*it).second);
@@ -23,6 +23,7 @@
 #define FDMT_FF_MAC_SCHEDULER_H
 
 #include <ns3/lte-common.h>
+#include <ns3/lte-rnti-map.h>
 #include <ns3/ff-mac-csched-sap.h>
 #include <ns3/ff-mac-sched-sap.h>
 #include <ns3/ff-mac-scheduler.h>
@@ -303,22 +304,22 @@ private:
   /**
   * Map of UE's DL CQI P01 received
   */
-  std::map <uint16_t,uint8_t> m_p10CqiRxed;
+  LteRntiMap <uint8_t> m_p10CqiRxed;
 
   /**
   * Map of UE's timers on DL CQI P01 received
   */
-  std::map <uint16_t,uint32_t> m_p10CqiTimers;
+  LteRntiMap <uint32_t> m_p10CqiTimers;
 
   /**
   * Map of UE's DL CQI A30 received
   */
-  std::map <uint16_t,SbMeasResult_s> m_a30CqiRxed;
+  LteRntiMap <SbMeasResult_s> m_a30CqiRxed;
 
   /**
   * Map of UE's timers on DL CQI A30 received
   */
-  std::map <uint16_t,uint32_t> m_a30CqiTimers;
+  LteRntiMap <uint32_t> m_a30CqiTimers;
 
   /**
   * Map of previous allocated UE per RBG
@@ -329,17 +330,17 @@ private:
   /**
   * Map of UEs' UL-CQI per RBG
   */
-  std::map <uint16_t, std::vector <double> > m_ueCqi;
+  LteRntiMap <std::vector <double> > m_ueCqi;
 
   /**
   * Map of UEs' timers on UL-CQI per RBG
   */
-  std::map <uint16_t, uint32_t> m_ueCqiTimers;
+  LteRntiMap <uint32_t> m_ueCqiTimers;
 
   /**
   * Map of UE's buffer status reports received
   */
-  std::map <uint16_t,uint32_t> m_ceBsrRxed;
+  LteRntiMap <uint32_t> m_ceBsrRxed;
 
   // MAC SAPs
   FfMacCschedSapUser* m_cschedSapUser; ///< csched SAP user
@@ -359,26 +360,26 @@ private:
 
   uint32_t m_cqiTimersThreshold; ///< # of TTIs for which a CQI can be considered valid
 
-  std::map <uint16_t,uint8_t> m_uesTxMode; ///< txMode of the UEs
+  LteRntiMap <uint8_t> m_uesTxMode; ///< txMode of the UEs
 
   // HARQ attributes
   bool m_harqOn; ///< m_harqOn when false inhibit tte HARQ mechanisms (by default active)
-  std::map <uint16_t, uint8_t> m_dlHarqCurrentProcessId; ///< DL HARQ current process ID
+  LteRntiMap <uint8_t> m_dlHarqCurrentProcessId; ///< DL HARQ current process ID
   //HARQ status
   // 0: process Id available
   // x>0: process Id equal to `x` transmission count
-  std::map <uint16_t, DlHarqProcessesStatus_t> m_dlHarqProcessesStatus; ///< DL HARQ process status
-  std::map <uint16_t, DlHarqProcessesTimer_t> m_dlHarqProcessesTimer; ///< DL HARDQ process timer
-  std::map <uint16_t, DlHarqProcessesDciBuffer_t> m_dlHarqProcessesDciBuffer; ///< DL HARQ process DCI buffer
-  std::map <uint16_t, DlHarqRlcPduListBuffer_t> m_dlHarqProcessesRlcPduListBuffer; ///< DL HARQ process RLC PDU list buffer
+  LteRntiMap <DlHarqProcessesStatus_t> m_dlHarqProcessesStatus; ///< DL HARQ process status
+  LteRntiMap <DlHarqProcessesTimer_t> m_dlHarqProcessesTimer; ///< DL HARDQ process timer
+  LteRntiMap <DlHarqProcessesDciBuffer_t> m_dlHarqProcessesDciBuffer; ///< DL HARQ process DCI buffer
+  LteRntiMap <DlHarqRlcPduListBuffer_t> m_dlHarqProcessesRlcPduListBuffer; ///< DL HARQ process RLC PDU list buffer
   std::vector <DlInfoListElement_s> m_dlInfoListBuffered; ///< HARQ retx buffered
 
-  std::map <uint16_t, uint8_t> m_ulHarqCurrentProcessId; ///< UL HARQ current process ID
+  LteRntiMap <uint8_t> m_ulHarqCurrentProcessId; ///< UL HARQ current process ID
   //HARQ status
   // 0: process Id available
   // x>0: process Id equal to `x` transmission count
-  std::map <uint16_t, UlHarqProcessesStatus_t> m_ulHarqProcessesStatus; ///< UL HARQ process status
-  std::map <uint16_t, UlHarqProcessesDciBuffer_t> m_ulHarqProcessesDciBuffer; ///< UL HARQ process DCI buffer
+  LteRntiMap <UlHarqProcessesStatus_t> m_ulHarqProcessesStatus; ///< UL HARQ process status
+  LteRntiMap <UlHarqProcessesDciBuffer_t> m_ulHarqProcessesDciBuffer; ///< UL HARQ process DCI buffer
 
 
   // RACH attributes
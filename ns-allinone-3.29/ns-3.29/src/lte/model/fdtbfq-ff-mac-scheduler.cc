@@ -185,7 +185,7 @@ void
 FdTbfqFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params)
 {
   NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
-  std::map <uint16_t,uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
+  LteRntiMap <uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
   if (it == m_uesTxMode.end ())
     {
       m_uesTxMode.insert (std::pair <uint16_t, double> (params.m_rnti, params.m_transmissionMode));
@@ -225,7 +225,7 @@ FdTbfqFfMacScheduler::DoCschedLcConfigReq (const struct FfMacCschedSapProvider::
 {
   NS_LOG_FUNCTION (this << " New LC, rnti: "  << params.m_rnti);
 
-  std::map <uint16_t, fdtbfqsFlowPerf_t>::iterator it;
+  LteRntiMap <fdtbfqsFlowPerf_t>::iterator it;
   for (uint16_t i = 0; i < params.m_logicalChannelConfigList.size (); i++)
     {
       it = m_flowStatsDl.find (params.m_rnti);
@@ -278,21 +278,7 @@ FdTbfqFfMacScheduler::DoCschedLcReleaseReq (const struct FfMacCschedSapProvider:
   NS_LOG_FUNCTION (this);
   for (uint16_t i = 0; i < params.m_logicalChannelIdentity.size (); i++)
     {
-      std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
-      std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator temp;
-      while (it!=m_rlcBufferReq.end ())
-        {
-          if (((*it).first.m_rnti == params.m_rnti) && ((*it).first.m_lcId == params.m_logicalChannelIdentity.at (i)))
-            {
-              temp = it;
-              it++;
-              m_rlcBufferReq.erase (temp);
-            }
-          else
-            {
-              it++;
-            }
-        }
+      m_rlcBufferReq.erase (LteFlowId_t (params.m_rnti, params.m_logicalChannelIdentity.at (i)));
     }
   return;
 }
@@ -314,20 +300,10 @@ FdTbfqFfMacScheduler::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider:
   m_flowStatsDl.erase  (params.m_rnti);
   m_flowStatsUl.erase  (params.m_rnti);
   m_ceBsrRxed.erase (params.m_rnti);
-  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
-  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator temp;
-  while (it!=m_rlcBufferReq.end ())
+  std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.lower_bound (LteFlowId_t (params.m_rnti, 0));
+  while (it != m_rlcBufferReq.end () && (*it).first.m_rnti == params.m_rnti)
     {
-      if ((*it).first.m_rnti == params.m_rnti)
-        {
-          temp = it;
-          it++;
-          m_rlcBufferReq.erase (temp);
-        }
-      else
-        {
-          it++;
-        }
+      m_rlcBufferReq.erase (it++);
     }
   if (m_nextRntiUl == params.m_rnti)
     {
@@ -398,7 +374,7 @@ FdTbfqFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
   std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
   unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
+  for (it = m_rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0)); it != m_rlcBufferReq.end (); it++)
     {
       if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
                                            || ((*it).second.m_rlcRetransmissionQueueSize > 0)
@@ -421,12 +397,12 @@ FdTbfqFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
+  LteRntiMap <uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
   if (it == m_dlHarqCurrentProcessId.end ())
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
+  LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
   if (itStat == m_dlHarqProcessesStatus.end ())
     {
       NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
@@ -460,12 +436,12 @@ FdTbfqFfMacScheduler::UpdateHarqProcessId (uint16_t rnti)
     }
 
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
+  LteRntiMap <uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
   if (it == m_dlHarqCurrentProcessId.end ())
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
+  LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
   if (itStat == m_dlHarqProcessesStatus.end ())
     {
       NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
@@ -495,7 +471,7 @@ FdTbfqFfMacScheduler::RefreshHarqProcesses ()
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itTimers;
+  LteRntiMap <DlHarqProcessesTimer_t>::iterator itTimers;
   for (itTimers = m_dlHarqProcessesTimer.begin (); itTimers != m_dlHarqProcessesTimer.end (); itTimers ++)
     {
       for (uint16_t i = 0; i < HARQ_PROC_NUM; i++)
@@ -505,7 +481,7 @@ FdTbfqFfMacScheduler::RefreshHarqProcesses ()
               // reset HARQ process
               
               NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
+              LteRntiMap <DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
               if (itStat == m_dlHarqProcessesStatus.end ())
                 {
                   NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers).first);
@@ -538,7 +514,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
 
   int rbgSize = GetRbgSize (m_cschedCellConfig.m_dlBandwidth);
   int rbgNum = m_cschedCellConfig.m_dlBandwidth / rbgSize;
-  std::map <uint16_t, std::vector <uint16_t> > allocationMap; // RBs map per RNTI
+  LteRntiMap <std::vector <uint16_t> > allocationMap; // RBs map per RNTI
   std::vector <bool> rbgMap;  // global RBGs map
   uint16_t rbgAllocatedNum = 0;
   std::set <uint16_t> rntiAllocated;
@@ -556,7 +532,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
   FfMacSchedSapUser::SchedDlConfigIndParameters ret;
 
   //   update UL HARQ proc id
-  std::map <uint16_t, uint8_t>::iterator itProcId;
+  LteRntiMap <uint8_t>::iterator itProcId;
   for (itProcId = m_ulHarqCurrentProcessId.begin (); itProcId != m_ulHarqCurrentProcessId.end (); itProcId++)
     {
       (*itProcId).second = ((*itProcId).second + 1) % HARQ_PROC_NUM;
@@ -665,14 +641,14 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
           uldci.m_pdcchPowerOffset = 0; // not used
 
           uint8_t harqId = 0;
-          std::map <uint16_t, uint8_t>::iterator itProcId;
+          LteRntiMap <uint8_t>::iterator itProcId;
           itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
           if (itProcId == m_ulHarqCurrentProcessId.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
             }
           harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
           if (itDci == m_ulHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
@@ -737,7 +713,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
           uint16_t rnti = m_dlInfoListBuffered.at (i).m_rnti;
           uint8_t harqId = m_dlInfoListBuffered.at (i).m_harqProcessId;
           NS_LOG_INFO (this << " HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId);
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itHarq = m_dlHarqProcessesDciBuffer.find (rnti);
+          LteRntiMap <DlHarqProcessesDciBuffer_t>::iterator itHarq = m_dlHarqProcessesDciBuffer.find (rnti);
           if (itHarq == m_dlHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << rnti);
@@ -758,13 +734,13 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
             {
               // maximum number of retx reached -> drop process
               NS_LOG_INFO ("Maximum number of retransmissions reached -> drop process");
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
+              LteRntiMap <DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
               if (it == m_dlHarqProcessesStatus.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << m_dlInfoListBuffered.at (i).m_rnti);
                 }
               (*it).second.at (harqId) = 0;
-              std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
+              LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
               if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                 {
                   NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
@@ -850,7 +826,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
             }
           // retrieve RLC PDU list for retx TBsize and update DCI
           BuildDataListElement_s newEl;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
+          LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << rnti);
@@ -918,7 +894,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
           newEl.m_dci = dci;
           (*itHarq).second.at (harqId).m_rv = dci.m_rv;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer = m_dlHarqProcessesTimer.find (rnti);
+          LteRntiMap <DlHarqProcessesTimer_t>::iterator itHarqTimer = m_dlHarqProcessesTimer.find (rnti);
           if (itHarqTimer== m_dlHarqProcessesTimer.end ())
             {
               NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)rnti);
@@ -931,13 +907,13 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
         {
           // update HARQ process status
           NS_LOG_INFO (this << " HARQ received ACK for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-          std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
+          LteRntiMap <DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (it == m_dlHarqProcessesStatus.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << m_dlInfoListBuffered.at (i).m_rnti);
             }
           (*it).second.at (m_dlInfoListBuffered.at (i).m_harqProcessId) = 0;
-          std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
+          LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlInfoListBuffered.at (i).m_rnti);
@@ -962,7 +938,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
     }
 
   // update token pool, counter and bank size
-  std::map <uint16_t, fdtbfqsFlowPerf_t>::iterator itStats;
+  LteRntiMap <fdtbfqsFlowPerf_t>::iterator itStats;
   for (itStats = m_flowStatsDl.begin (); itStats != m_flowStatsDl.end (); itStats++)
     {
       if ( (*itStats).second.tokenGenerationRate / 1000 +  (*itStats).second.tokenPoolSize > (*itStats).second.maxTokenPoolSize )     
@@ -984,8 +960,8 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
   while (totalRbg < rbgNum)
     {
       // select UE with largest metric
-      std::map <uint16_t, fdtbfqsFlowPerf_t>::iterator it;
-      std::map <uint16_t, fdtbfqsFlowPerf_t>::iterator itMax = m_flowStatsDl.end ();
+      LteRntiMap <fdtbfqsFlowPerf_t>::iterator it;
+      LteRntiMap <fdtbfqsFlowPerf_t>::iterator itMax = m_flowStatsDl.end ();
       double metricMax = 0.0;
       bool firstRnti = true;
       for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
@@ -1005,9 +981,9 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
               continue;
            }
           // check first the channel conditions for this UE, if CQI!=0
-          std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
+          LteRntiMap <SbMeasResult_s>::iterator itCqi;
           itCqi = m_a30CqiRxed.find ((*it).first);
-          std::map <uint16_t,uint8_t>::iterator itTxMode;
+          LteRntiMap <uint8_t>::iterator itTxMode;
           itTxMode = m_uesTxMode.find ((*it).first);
           if (itTxMode == m_uesTxMode.end ())
             {
@@ -1098,10 +1074,10 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
           uint32_t rlcBufSize = 0;
           uint8_t lcid = 0;
           std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itRlcBuf;
-          for (itRlcBuf = m_rlcBufferReq.begin (); itRlcBuf != m_rlcBufferReq.end (); itRlcBuf++)
+          for (itRlcBuf = m_rlcBufferReq.lower_bound (LteFlowId_t ((*itMax).first, 0));
+               itRlcBuf != m_rlcBufferReq.end () && (*itRlcBuf).first.m_rnti == (*itMax).first; itRlcBuf++)
             {
-              if ( (*itRlcBuf).first.m_rnti == (*itMax).first )
-                lcid = (*itRlcBuf).first.m_lcId;
+              lcid = (*itRlcBuf).first.m_lcId;
             }
           LteFlowId_t flow ((*itMax).first, lcid);
           itRlcBuf = m_rlcBufferReq.find (flow);
@@ -1119,9 +1095,9 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
         {
           totalRbg++;
 
-          std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
+          LteRntiMap <SbMeasResult_s>::iterator itCqi;
           itCqi = m_a30CqiRxed.find ((*itMax).first);
-          std::map <uint16_t,uint8_t>::iterator itTxMode;
+          LteRntiMap <uint8_t>::iterator itTxMode;
           itTxMode = m_uesTxMode.find ((*itMax).first);
           if (itTxMode == m_uesTxMode.end ())
             {
@@ -1207,7 +1183,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
             }
 
           // assign this RBG to UE
-          std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
+          LteRntiMap <std::vector <uint16_t> >::iterator itMap;
           itMap = allocationMap.find ((*itMax).first);
           uint16_t RbgPerRnti;
           if (itMap == allocationMap.end ())
@@ -1280,7 +1256,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
         // remove and unmark last RBG assigned to UE
       if ( bytesTxed > budget )
         {
-          std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
+          LteRntiMap <std::vector <uint16_t> >::iterator itMap;
           itMap = allocationMap.find ((*itMax).first);
           (*itMap).second.pop_back ();
           allocatedRbg.erase (rbgIndex);
@@ -1307,7 +1283,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
 
   // generate the transmission opportunities by grouping the RBGs of the same RNTI and
   // creating the correspondent DCIs
-  std::map <uint16_t, std::vector <uint16_t> >::iterator itMap = allocationMap.begin ();
+  LteRntiMap <std::vector <uint16_t> >::iterator itMap = allocationMap.begin ();
   while (itMap != allocationMap.end ())
     {
       // create new BuildDataListElement_s for this LC
@@ -1326,9 +1302,9 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
           lcActives = (uint16_t)65535; // UINT16_MAX;
         }
       uint16_t RgbPerRnti = (*itMap).second.size ();
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
+      LteRntiMap <SbMeasResult_s>::iterator itCqi;
       itCqi = m_a30CqiRxed.find ((*itMap).first);
-      std::map <uint16_t,uint8_t>::iterator itTxMode;
+      LteRntiMap <uint8_t>::iterator itTxMode;
       itTxMode = m_uesTxMode.find ((*itMap).first);
       if (itTxMode == m_uesTxMode.end ())
         {
@@ -1401,7 +1377,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
 
       // create the rlc PDUs -> equally divide resources among actives LCs
       std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itBufReq;
-      for (itBufReq = m_rlcBufferReq.begin (); itBufReq != m_rlcBufferReq.end (); itBufReq++)
+      for (itBufReq = m_rlcBufferReq.lower_bound (LteFlowId_t ((*itMap).first, 0)); itBufReq != m_rlcBufferReq.end (); itBufReq++)
         {
           if (((*itBufReq).first.m_rnti == (*itMap).first)
               && (((*itBufReq).second.m_rlcTransmissionQueueSize > 0)
@@ -1420,7 +1396,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
                   if (m_harqOn == true)
                     {
                       // store RLC PDU list for HARQ
-                      std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find ((*itMap).first);
+                      LteRntiMap <DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find ((*itMap).first);
                       if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                         {
                           NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << (*itMap).first);
@@ -1448,14 +1424,14 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
       if (m_harqOn == true)
         {
           // store DCI for HARQ
-          std::map <uint16_t, DlHarqProcessesDciBuffer_t>::iterator itDci = m_dlHarqProcessesDciBuffer.find (newEl.m_rnti);
+          LteRntiMap <DlHarqProcessesDciBuffer_t>::iterator itDci = m_dlHarqProcessesDciBuffer.find (newEl.m_rnti);
           if (itDci == m_dlHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in DCI HARQ buffer for RNTI " << newEl.m_rnti);
             }
           (*itDci).second.at (newDci.m_harqProcess) = newDci;
           // refresh timer
-          std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer =  m_dlHarqProcessesTimer.find (newEl.m_rnti);
+          LteRntiMap <DlHarqProcessesTimer_t>::iterator itHarqTimer =  m_dlHarqProcessesTimer.find (newEl.m_rnti);
           if (itHarqTimer== m_dlHarqProcessesTimer.end ())
             {
               NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)newEl.m_rnti);
@@ -1498,7 +1474,7 @@ FdTbfqFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::S
       if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::P10 )
         {
           NS_LOG_LOGIC ("wideband CQI " <<  (uint32_t) params.m_cqiList.at (i).m_wbCqi.at (0) << " reported");
-          std::map <uint16_t,uint8_t>::iterator it;
+          LteRntiMap <uint8_t>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
           it = m_p10CqiRxed.find (rnti);
           if (it == m_p10CqiRxed.end ())
@@ -1513,7 +1489,7 @@ FdTbfqFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::S
               // update the CQI value and refresh correspondent timer
               (*it).second = params.m_cqiList.at (i).m_wbCqi.at (0);
               // update correspondent timer
-              std::map <uint16_t,uint32_t>::iterator itTimers;
+              LteRntiMap <uint32_t>::iterator itTimers;
               itTimers = m_p10CqiTimers.find (rnti);
               (*itTimers).second = m_cqiTimersThreshold;
             }
@@ -1521,7 +1497,7 @@ FdTbfqFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::S
       else if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::A30 )
         {
           // subband CQI reporting high layer configured
-          std::map <uint16_t,SbMeasResult_s>::iterator it;
+          LteRntiMap <SbMeasResult_s>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
           it = m_a30CqiRxed.find (rnti);
           if (it == m_a30CqiRxed.end ())
@@ -1534,7 +1510,7 @@ FdTbfqFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::S
             {
               // update the CQI value and refresh correspondent timer
               (*it).second = params.m_cqiList.at (i).m_sbMeasResult;
-              std::map <uint16_t,uint32_t>::iterator itTimers;
+              LteRntiMap <uint32_t>::iterator itTimers;
               itTimers = m_a30CqiTimers.find (rnti);
               (*itTimers).second = m_cqiTimersThreshold;
             }
@@ -1552,7 +1528,7 @@ FdTbfqFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::S
 double
 FdTbfqFfMacScheduler::EstimateUlSinr (uint16_t rnti, uint16_t rb)
 {
-  std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find (rnti);
+  LteRntiMap <std::vector <double> >::iterator itCqi = m_ueCqi.find (rnti);
   if (itCqi == m_ueCqi.end ())
     {
       // no cqi info about this UE
@@ -1635,21 +1611,21 @@ FdTbfqFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::S
             {
               // retx correspondent block: retrieve the UL-DCI
               uint16_t rnti = params.m_ulInfoList.at (i).m_rnti;
-              std::map <uint16_t, uint8_t>::iterator itProcId = m_ulHarqCurrentProcessId.find (rnti);
+              LteRntiMap <uint8_t>::iterator itProcId = m_ulHarqCurrentProcessId.find (rnti);
               if (itProcId == m_ulHarqCurrentProcessId.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
                 }
               uint8_t harqId = (uint8_t)((*itProcId).second - HARQ_PERIOD) % HARQ_PROC_NUM;
               NS_LOG_INFO (this << " UL-HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId << " i " << i << " size "  << params.m_ulInfoList.size ());
-              std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itHarq = m_ulHarqProcessesDciBuffer.find (rnti);
+              LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itHarq = m_ulHarqProcessesDciBuffer.find (rnti);
               if (itHarq == m_ulHarqProcessesDciBuffer.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
                   continue;
                 }
               UlDciListElement_s dci = (*itHarq).second.at (harqId);
-              std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
+              LteRntiMap <UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
               if (itStat == m_ulHarqProcessesStatus.end ())
                 {
                   NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
@@ -1700,7 +1676,7 @@ FdTbfqFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::S
         }
     }
 
-  std::map <uint16_t,uint32_t>::iterator it;
+  LteRntiMap <uint32_t>::iterator it;
   int nflows = 0;
 
   for (it = m_ceBsrRxed.begin (); it != m_ceBsrRxed.end (); it++)
@@ -1735,7 +1711,7 @@ FdTbfqFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::S
     }
   int rbAllocated = 0;
 
-  std::map <uint16_t, fdtbfqsFlowPerf_t>::iterator itStats;
+  LteRntiMap <fdtbfqsFlowPerf_t>::iterator itStats;
   if (m_nextRntiUl != 0)
     {
       for (it = m_ceBsrRxed.begin (); it != m_ceBsrRxed.end (); it++)
@@ -1848,7 +1824,7 @@ FdTbfqFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::S
 
 
 
-      std::map <uint16_t, std::vector <double> >::iterator itCqi = m_ueCqi.find ((*it).first);
+      LteRntiMap <std::vector <double> >::iterator itCqi = m_ueCqi.find ((*it).first);
       int cqi = 0;
       if (itCqi == m_ueCqi.end ())
         {
@@ -1919,21 +1895,21 @@ FdTbfqFfMacScheduler::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::S
       uint8_t harqId = 0;
       if (m_harqOn == true)
         {
-          std::map <uint16_t, uint8_t>::iterator itProcId;
+          LteRntiMap <uint8_t>::iterator itProcId;
           itProcId = m_ulHarqCurrentProcessId.find (uldci.m_rnti);
           if (itProcId == m_ulHarqCurrentProcessId.end ())
             {
               NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << uldci.m_rnti);
             }
           harqId = (*itProcId).second;
-          std::map <uint16_t, UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesDciBuffer_t>::iterator itDci = m_ulHarqProcessesDciBuffer.find (uldci.m_rnti);
           if (itDci == m_ulHarqProcessesDciBuffer.end ())
             {
               NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << uldci.m_rnti);
             }
           (*itDci).second.at (harqId) = uldci;
           // Update HARQ process status (RV 0)
-          std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (uldci.m_rnti);
+          LteRntiMap <UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (uldci.m_rnti);
           if (itStat == m_ulHarqProcessesStatus.end ())
             {
               NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << uldci.m_rnti);
@@ -1984,7 +1960,7 @@ FdTbfqFfMacScheduler::DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvide
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t,uint32_t>::iterator it;
+  LteRntiMap <uint32_t>::iterator it;
 
   for (unsigned int i = 0; i < params.m_macCeList.size (); i++)
     {
@@ -2059,7 +2035,7 @@ FdTbfqFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::S
     case UlCqi_s::PUSCH:
       {
         std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
-        std::map <uint16_t, std::vector <double> >::iterator itCqi;
+        LteRntiMap <std::vector <double> >::iterator itCqi;
         NS_LOG_DEBUG (this << " Collect PUSCH CQIs of Frame no. " << (params.m_sfnSf >> 4) << " subframe no. " << (0xF & params.m_sfnSf));
         itMap = m_allocationMaps.find (params.m_sfnSf);
         if (itMap == m_allocationMaps.end ())
@@ -2098,7 +2074,7 @@ FdTbfqFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::S
                 (*itCqi).second.at (i) = sinr;
                 NS_LOG_DEBUG (this << " RNTI " << (*itMap).second.at (i) << " RB " << i << " SINR " << sinr);
                 // update correspondent timer
-                std::map <uint16_t, uint32_t>::iterator itTimers;
+                LteRntiMap <uint32_t>::iterator itTimers;
                 itTimers = m_ueCqiTimers.find ((*itMap).second.at (i));
                 (*itTimers).second = m_cqiTimersThreshold;
 
@@ -2122,7 +2098,7 @@ FdTbfqFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::S
                 rnti = vsp->GetRnti ();
               }
           }
-        std::map <uint16_t, std::vector <double> >::iterator itCqi;
+        LteRntiMap <std::vector <double> >::iterator itCqi;
         itCqi = m_ueCqi.find (rnti);
         if (itCqi == m_ueCqi.end ())
           {
@@ -2149,7 +2125,7 @@ FdTbfqFfMacScheduler::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::S
                 NS_LOG_INFO (this << " RNTI " << rnti << " update SRS-CQI for RB  " << j << " value " << sinr);
               }
             // update correspondent timer
-            std::map <uint16_t, uint32_t>::iterator itTimers;
+            LteRntiMap <uint32_t>::iterator itTimers;
             itTimers = m_ueCqiTimers.find (rnti);
             (*itTimers).second = m_cqiTimersThreshold;
 
@@ -2175,18 +2151,18 @@ void
 FdTbfqFfMacScheduler::RefreshDlCqiMaps (void)
 {
   // refresh DL CQI P01 Map
-  std::map <uint16_t,uint32_t>::iterator itP10 = m_p10CqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itP10 = m_p10CqiTimers.begin ();
   while (itP10 != m_p10CqiTimers.end ())
     {
       NS_LOG_INFO (this << " P10-CQI for user " << (*itP10).first << " is " << (uint32_t)(*itP10).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itP10).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,uint8_t>::iterator itMap = m_p10CqiRxed.find ((*itP10).first);
+          LteRntiMap <uint8_t>::iterator itMap = m_p10CqiRxed.find ((*itP10).first);
           NS_ASSERT_MSG (itMap != m_p10CqiRxed.end (), " Does not find CQI report for user " << (*itP10).first);
           NS_LOG_INFO (this << " P10-CQI expired for user " << (*itP10).first);
           m_p10CqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itP10;
+          LteRntiMap <uint32_t>::iterator temp = itP10;
           itP10++;
           m_p10CqiTimers.erase (temp);
         }
@@ -2198,18 +2174,18 @@ FdTbfqFfMacScheduler::RefreshDlCqiMaps (void)
     }
 
   // refresh DL CQI A30 Map
-  std::map <uint16_t,uint32_t>::iterator itA30 = m_a30CqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itA30 = m_a30CqiTimers.begin ();
   while (itA30 != m_a30CqiTimers.end ())
     {
       NS_LOG_INFO (this << " A30-CQI for user " << (*itA30).first << " is " << (uint32_t)(*itA30).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itA30).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
+          LteRntiMap <SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
           NS_ASSERT_MSG (itMap != m_a30CqiRxed.end (), " Does not find CQI report for user " << (*itA30).first);
           NS_LOG_INFO (this << " A30-CQI expired for user " << (*itA30).first);
           m_a30CqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itA30;
+          LteRntiMap <uint32_t>::iterator temp = itA30;
           itA30++;
           m_a30CqiTimers.erase (temp);
         }
@@ -2228,19 +2204,19 @@ void
 FdTbfqFfMacScheduler::RefreshUlCqiMaps (void)
 {
   // refresh UL CQI  Map
-  std::map <uint16_t,uint32_t>::iterator itUl = m_ueCqiTimers.begin ();
+  LteRntiMap <uint32_t>::iterator itUl = m_ueCqiTimers.begin ();
   while (itUl != m_ueCqiTimers.end ())
     {
       NS_LOG_INFO (this << " UL-CQI for user " << (*itUl).first << " is " << (uint32_t)(*itUl).second << " thr " << (uint32_t)m_cqiTimersThreshold);
       if ((*itUl).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t, std::vector <double> >::iterator itMap = m_ueCqi.find ((*itUl).first);
+          LteRntiMap <std::vector <double> >::iterator itMap = m_ueCqi.find ((*itUl).first);
           NS_ASSERT_MSG (itMap != m_ueCqi.end (), " Does not find CQI report for user " << (*itUl).first);
           NS_LOG_INFO (this << " UL-CQI exired for user " << (*itUl).first);
           (*itMap).second.clear ();
           m_ueCqi.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itUl;
+          LteRntiMap <uint32_t>::iterator temp = itUl;
           itUl++;
           m_ueCqiTimers.erase (temp);
         }
@@ -2311,7 +2287,7 @@ FdTbfqFfMacScheduler::UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size)
 {
 
   size = size - 2; // remove the minimum RLC overhead
-  std::map <uint16_t,uint32_t>::iterator it = m_ceBsrRxed.find (rnti);
+  LteRntiMap <uint32_t>::iterator it = m_ceBsrRxed.find (rnti);
   if (it != m_ceBsrRxed.end ())
     {
       NS_LOG_INFO (this << " UE " << rnti << " size " << size << " BSR " << (*it).second);
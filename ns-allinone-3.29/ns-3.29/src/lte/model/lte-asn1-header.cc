@@ -52,6 +52,8 @@ Asn1Header::Asn1Header ()
   m_serializationPendingBits = 0x00;
   m_numSerializationPendingBits = 0;
   m_isDataSerialized = false;
+  m_recordedTemplate = 0;
+  m_isTemplateFieldMarked = false;
 }
 
 Asn1Header::~Asn1Header ()
@@ -79,94 +81,49 @@ void Asn1Header::Serialize (Buffer::Iterator bIterator) const
 
 void Asn1Header::WriteOctet (uint8_t octet) const
 {
-  m_serializationResult.AddAtEnd (1);
-  Buffer::Iterator bIterator = m_serializationResult.End ();
-  bIterator.Prev ();
-  bIterator.WriteU8 (octet);
+  m_serializationOctets.push_back (octet);
 }
 
-template <int N>
-void Asn1Header::SerializeBitset (std::bitset<N> data) const
+void Asn1Header::SerializeBits (uint32_t value, uint8_t numBits) const
 {
+  NS_ASSERT (numBits <= 32);
 
-  size_t dataSize = data.size ();
-  uint8_t pendingBits = dataSize;
-  uint8_t mask = 1;
-  int j;
-
-  // No extension marker (Clause 16.7 ITU-T X.691),
-  // as 3GPP TS 36.331 does not use it in its IE's.
-
-  // Clause 16.8 ITU-T X.691
-  if (dataSize == 0)
+  if (m_isTemplateFieldMarked)
     {
-      return;
+      m_recordedTemplate->fieldOffsets.push_back (m_serializationOctets.size () * 8 + m_numSerializationPendingBits);
+      m_recordedTemplate->fieldSizes.push_back (numBits);
+      m_isTemplateFieldMarked = false;
     }
 
-  // Clause 16.9 ITU-T X.691
-  // Clause 16.10 ITU-T X.691
-  if (dataSize <= 65536)
+  // Append the bits to the pending ones, and write every completed octet
+  while (numBits > 0)
     {
-      // If there are bits pending to be processed,
-      // append first bits in data to complete an octet.
-      if (m_numSerializationPendingBits > 0)
-        {
-          mask = 0x80 >> m_numSerializationPendingBits;
-          while (pendingBits > 0 && m_numSerializationPendingBits < 8)
-            {
-              m_serializationPendingBits |= (data[pendingBits - 1]) ? mask : 0;
-              pendingBits--;
-              m_numSerializationPendingBits++;
-              mask = (mask >> 1) & (~mask);
-            }
-
-          if (m_numSerializationPendingBits >= 8)
-            {
-              WriteOctet (m_serializationPendingBits);
-              m_numSerializationPendingBits = 0;
-              m_serializationPendingBits = 0;
-            }
-        }
-
-      while (pendingBits > 0)
+      uint8_t freeBits = 8 - m_numSerializationPendingBits;
+      uint8_t n = (numBits < freeBits) ? numBits : freeBits;
+      numBits -= n;
+      uint8_t bits = (value >> numBits) & ((1 << n) - 1);
+      m_serializationPendingBits |= bits << (freeBits - n);
+      m_numSerializationPendingBits += n;
+      if (m_numSerializationPendingBits == 8)
         {
-          mask = 1;
-          j = 8;
-
-          // If there are less than 8 remaining bits,
-          // store it to m_serializationPendingBits.
-          if (pendingBits < 8)
-            {
-              mask = 0x80;
-              m_numSerializationPendingBits = pendingBits;
-              while (pendingBits > 0)
-                {
-                  m_serializationPendingBits |= (data[pendingBits - 1]) ? mask : 0;
-                  mask = (mask >> 1) & (~mask);
-                  pendingBits--;
-                }
-            }
-
-          // Write the data to buffer
-          else
-            {
-              uint8_t octetToWrite = 0;
-              for (; j > 0; j--)
-                {
-                  octetToWrite |= (data[pendingBits - j]) ? mask : 0;
-                  mask = (mask << 1) & (~mask);
-                }
-              WriteOctet (octetToWrite);
-              pendingBits -= 8;
-            }
+          WriteOctet (m_serializationPendingBits);
+          m_numSerializationPendingBits = 0;
+          m_serializationPendingBits = 0;
         }
     }
+}
 
-  // Clause 16.11 ITU-T X.691
-  else
-    {
-      printf ("FRAGMENTATION NEEDED!\n");
-    }
+template <int N>
+void Asn1Header::SerializeBitset (std::bitset<N> data) const
+{
+  // No extension marker (Clause 16.7 ITU-T X.691),
+  // as 3GPP TS 36.331 does not use it in its IE's.
+
+  // Clause 16.8 ITU-T X.691
+  // Clause 16.9 ITU-T X.691
+  // Clause 16.10 ITU-T X.691
+  // The bits are written from the most significant one, data[N - 1].
+  SerializeBits (data.to_ulong (), N);
 }
 
 template <int N>
@@ -336,76 +293,19 @@ void Asn1Header::SerializeInteger (int n, int nmin, int nmax) const
     }
 
   // Clause 11.5.6 ITU-T X.691
-  int requiredBits = std::ceil (std::log (range) / std::log (2.0));
+  // the number of bits of range - 1, i.e., ceil (log2 (range))
+  int requiredBits = 0;
+  while ((range - 1) >> requiredBits)
+    {
+      requiredBits++;
+    }
 
-  switch (requiredBits)
+  if (requiredBits > 20)
     {
-    case 1:
-      SerializeBitset<1> (std::bitset<1> (n));
-      break;
-    case 2:
-      SerializeBitset<2> (std::bitset<2> (n));
-      break;
-    case 3:
-      SerializeBitset<3> (std::bitset<3> (n));
-      break;
-    case 4:
-      SerializeBitset<4> (std::bitset<4> (n));
-      break;
-    case 5:
-      SerializeBitset<5> (std::bitset<5> (n));
-      break;
-    case 6:
-      SerializeBitset<6> (std::bitset<6> (n));
-      break;
-    case 7:
-      SerializeBitset<7> (std::bitset<7> (n));
-      break;
-    case 8:
-      SerializeBitset<8> (std::bitset<8> (n));
-      break;
-    case 9:
-      SerializeBitset<9> (std::bitset<9> (n));
-      break;
-    case 10:
-      SerializeBitset<10> (std::bitset<10> (n));
-      break;
-    case 11:
-      SerializeBitset<11> (std::bitset<11> (n));
-      break;
-    case 12:
-      SerializeBitset<12> (std::bitset<12> (n));
-      break;
-    case 13:
-      SerializeBitset<13> (std::bitset<13> (n));
-      break;
-    case 14:
-      SerializeBitset<14> (std::bitset<14> (n));
-      break;
-    case 15:
-      SerializeBitset<15> (std::bitset<15> (n));
-      break;
-    case 16:
-      SerializeBitset<16> (std::bitset<16> (n));
-      break;
-    case 17:
-      SerializeBitset<17> (std::bitset<17> (n));
-      break;
-    case 18:
-      SerializeBitset<18> (std::bitset<18> (n));
-      break;
-    case 19:
-      SerializeBitset<19> (std::bitset<19> (n));
-      break;
-    case 20:
-      SerializeBitset<20> (std::bitset<20> (n));
-      break;
-    default:
-      {
-        std::cout << "SerializeInteger " << requiredBits << " Out of range!!" << std::endl;
-        exit (1);
-      }
+      std::cout << "SerializeInteger " << requiredBits << " Out of range!!" << std::endl;
+      exit (1);
     }
+  SerializeBits (n, requiredBits);
 }
 
 void Asn1Header::SerializeNull () const
@@ -421,9 +321,67 @@ void Asn1Header::FinalizeSerialization () const
       m_numSerializationPendingBits = 0;
       SerializeBitset<8> (std::bitset<8> (m_serializationPendingBits));
     }
+
+  uint32_t size = m_serializationOctets.size ();
+  if (size > 0)
+    {
+      m_serializationResult.AddAtEnd (size);
+      Buffer::Iterator bIterator = m_serializationResult.End ();
+      bIterator.Prev (size);
+      bIterator.Write (&m_serializationOctets[0], size);
+    }
+  if (m_recordedTemplate != 0)
+    {
+      m_recordedTemplate->octets = m_serializationOctets;
+      m_recordedTemplate = 0;
+    }
+  m_serializationOctets.clear ();
   m_isDataSerialized = true;
 }
 
+bool Asn1Header::SerializeFromTemplate (Template *t, const uint32_t *fieldValues,
+                                        uint32_t numFields) const
+{
+  if (t->octets.empty ())
+    {
+      // record the template while serializing this message, without the
+      // bits left by the deserialization of this header, if any
+      m_serializationPendingBits = 0;
+      m_numSerializationPendingBits = 0;
+      m_recordedTemplate = t;
+      return false;
+    }
+  NS_ASSERT_MSG (numFields == t->fieldOffsets.size (), "Wrong number of template fields");
+
+  m_serializationOctets = t->octets;
+  for (uint32_t i = 0; i < t->fieldOffsets.size (); ++i)
+    {
+      // overwrite the bits of the field, most significant first
+      uint32_t offset = t->fieldOffsets[i];
+      uint8_t numBits = t->fieldSizes[i];
+      while (numBits > 0)
+        {
+          uint8_t *octet = &m_serializationOctets[offset / 8];
+          uint8_t freeBits = 8 - offset % 8;
+          uint8_t n = (numBits < freeBits) ? numBits : freeBits;
+          numBits -= n;
+          uint8_t mask = ((1 << n) - 1) << (freeBits - n);
+          uint8_t bits = ((fieldValues[i] >> numBits) << (freeBits - n)) & mask;
+          *octet = (*octet & ~mask) | bits;
+          offset += n;
+        }
+    }
+  m_serializationPendingBits = 0;
+  m_numSerializationPendingBits = 0;
+  FinalizeSerialization ();
+  return true;
+}
+
+void Asn1Header::MarkTemplateField () const
+{
+  m_isTemplateFieldMarked = (m_recordedTemplate != 0);
+}
+
 template <int N>
 Buffer::Iterator Asn1Header::DeserializeBitset (std::bitset<N> *data, Buffer::Iterator bIterator)
 {
@@ -25,6 +25,7 @@
 
 #include <bitset>
 #include <string>
+#include <vector>
 
 namespace ns3 {
 
@@ -65,17 +66,60 @@ public:
   virtual void PreSerialize (void) const = 0;
 
 protected:
+  /**
+   * Pre-encoded message, whose fields are patched to encode the other
+   * messages with the same layout. The fields are the ones marked with
+   * MarkTemplateField when the template was recorded.
+   */
+  struct Template
+  {
+    std::vector<uint8_t> octets; //!< encoded message
+    std::vector<uint32_t> fieldOffsets; //!< offset in bits of each field
+    std::vector<uint8_t> fieldSizes; //!< size in bits of each field
+  };
+
   mutable uint8_t m_serializationPendingBits; //!< pending bits
   mutable uint8_t m_numSerializationPendingBits; //!< number of pending bits
   mutable bool m_isDataSerialized; //!< true if data is serialized
   mutable Buffer m_serializationResult; //!< serialization result
+  mutable std::vector<uint8_t> m_serializationOctets; //!< octets serialized so far
+  mutable Template *m_recordedTemplate; //!< template being recorded, if any
+  mutable bool m_isTemplateFieldMarked; //!< true if the next serialized bits are a template field
 
   /**
-   * Function to write in m_serializationResult, after resizing its size
+   * Function to write in m_serializationOctets
    * \param octet bits to write
    */
   void WriteOctet (uint8_t octet) const;
 
+  /**
+   * Serialize the least significant bits of a value, most significant first
+   * \param value value to serialize
+   * \param numBits number of bits to serialize, at most 32
+   */
+  void SerializeBits (uint32_t value, uint8_t numBits) const;
+
+  /**
+   * Serialize a message from a template.  If the template was not
+   * recorded yet, it is recorded by the serialization that follows,
+   * which must mark its fields with MarkTemplateField and end with
+   * FinalizeSerialization.
+   * \param t the template
+   * \param fieldValues the value of each field, as serialized (e.g., the
+   *        offset from the lower bound of an integer)
+   * \param numFields the number of fields
+   * \returns true if the message was serialized from the template, false
+   *          if it must be serialized to record the template
+   */
+  bool SerializeFromTemplate (Template *t, const uint32_t *fieldValues,
+                              uint32_t numFields) const;
+
+  /**
+   * Mark the next serialized integer, enum or bitstring as a field of the
+   * template being recorded, if any
+   */
+  void MarkTemplateField () const;
+
   // Serialization functions
 
   /**
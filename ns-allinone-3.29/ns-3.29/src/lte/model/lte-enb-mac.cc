@@ -328,6 +328,42 @@ EnbMacMemberLteEnbPhySapUser::DlInfoListElementHarqFeeback (DlInfoListElement_s
 }
 
 
+/// ---------- scheduler job
+class EnbMacSchedulerJob : public LteSchedulerExecutor::Job
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param mac the MAC
+   */
+  EnbMacSchedulerJob (LteEnbMac* mac);
+
+  // inherited from LteSchedulerExecutor::Job
+  virtual void Run (void);
+  virtual void Merge (void);
+
+private:
+  LteEnbMac* m_mac; ///< the MAC
+};
+
+EnbMacSchedulerJob::EnbMacSchedulerJob (LteEnbMac* mac) : m_mac (mac)
+{
+}
+
+void
+EnbMacSchedulerJob::Run (void)
+{
+  m_mac->DoTriggerScheduler (m_mac->m_schedulerJobDlParams);
+}
+
+void
+EnbMacSchedulerJob::Merge (void)
+{
+  m_mac->DoMergeScheduler ();
+}
+
+
 // //////////////////////////////////////
 // generic LteEnbMac methods
 // //////////////////////////////////////
@@ -375,7 +411,8 @@ LteEnbMac::GetTypeId (void)
 
 
 LteEnbMac::LteEnbMac ():
-m_ccmMacSapUser (0)
+m_ccmMacSapUser (0),
+m_deferConfigInd (false)
 {
   NS_LOG_FUNCTION (this);
   m_macSapProvider = new EnbMacMemberLteMacSapProvider<LteEnbMac> (this);
@@ -384,6 +421,7 @@ m_ccmMacSapUser (0)
   m_cschedSapUser = new EnbMacMemberFfMacCschedSapUser (this);
   m_enbPhySapUser = new EnbMacMemberLteEnbPhySapUser (this);
   m_ccmMacSapProvider = new MemberLteCcmMacSapProvider<LteEnbMac> (this);
+  m_schedulerJob = new EnbMacSchedulerJob (this);
 }
 
 
@@ -408,6 +446,9 @@ LteEnbMac::DoDispose ()
   delete m_cschedSapUser;
   delete m_enbPhySapUser;
   delete m_ccmMacSapProvider;
+  delete m_schedulerJob;
+  m_deferredDlConfigInd.clear ();
+  m_deferredUlConfigInd.clear ();
 }
 
 void
@@ -580,6 +621,27 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
       m_dlInfoListReceived.clear ();
     }
 
+  if (LteSchedulerExecutor::IsEnabled ())
+    {
+      // run the scheduler together with the ones of the other cells,
+      // the decisions are applied by DoMergeScheduler
+      m_schedulerJobDlParams = dlparams;
+      m_deferConfigInd = true;
+      LteSchedulerExecutor::Submit (m_schedulerJob);
+    }
+  else
+    {
+      DoTriggerScheduler (dlparams);
+    }
+}
+
+void
+LteEnbMac::DoTriggerScheduler (FfMacSchedSapProvider::SchedDlTriggerReqParameters dlparams)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t frameNo = m_frameNo;
+  uint32_t subframeNo = m_subframeNo;
+
   m_schedSapProvider->SchedDlTriggerReq (dlparams);
 
 
@@ -638,6 +700,26 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
 
 }
 
+void
+LteEnbMac::DoMergeScheduler (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_deferConfigInd = false;
+  std::vector <FfMacSchedSapUser::SchedDlConfigIndParameters> dlConfigInd;
+  std::vector <FfMacSchedSapUser::SchedUlConfigIndParameters> ulConfigInd;
+  dlConfigInd.swap (m_deferredDlConfigInd);
+  ulConfigInd.swap (m_deferredUlConfigInd);
+  // the scheduler issues all the DL decisions before the UL ones
+  for (uint32_t i = 0; i < dlConfigInd.size (); i++)
+    {
+      DoSchedDlConfigInd (dlConfigInd.at (i));
+    }
+  for (uint32_t i = 0; i < ulConfigInd.size (); i++)
+    {
+      DoSchedUlConfigInd (ulConfigInd.at (i));
+    }
+}
+
 
 void
 LteEnbMac::DoReceiveLteControlMessage  (Ptr<LteControlMessage> msg)
@@ -1020,6 +1102,11 @@ void
 LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind)
 {
   NS_LOG_FUNCTION (this);
+  if (m_deferConfigInd)
+    {
+      m_deferredDlConfigInd.push_back (ind);
+      return;
+    }
   // Create DL PHY PDU
   Ptr<PacketBurst> pb = CreateObject<PacketBurst> ();
   std::map <LteFlowId_t, LteMacSapUser* >::iterator it;
@@ -1155,6 +1242,11 @@ void
 LteEnbMac::DoSchedUlConfigInd (FfMacSchedSapUser::SchedUlConfigIndParameters ind)
 {
   NS_LOG_FUNCTION (this);
+  if (m_deferConfigInd)
+    {
+      m_deferredUlConfigInd.push_back (ind);
+      return;
+    }
 
   for (unsigned int i = 0; i < ind.m_dciList.size (); i++)
     {
@@ -39,6 +39,7 @@
 #include <ns3/packet.h>
 #include <ns3/packet-burst.h>
 #include <ns3/lte-ccm-mac-sap.h>
+#include <ns3/lte-scheduler-executor.h>
 
 namespace ns3 {
 
@@ -66,6 +67,8 @@ class LteEnbMac :   public Object
   friend class EnbMacMemberLteEnbPhySapUser;
   /// allow MemberLteCcmMacSapProvider<LteEnbMac> class friend access
   friend class MemberLteCcmMacSapProvider<LteEnbMac>;
+  /// allow EnbMacSchedulerJob class friend access
+  friend class EnbMacSchedulerJob;
 
 public:
   /**
@@ -332,6 +335,16 @@ private:
   */
   void DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo);
   /**
+  * \brief Trigger the DL and UL scheduling of the current subframe
+  * \param dlparams the DL trigger parameters
+  */
+  void DoTriggerScheduler (FfMacSchedSapProvider::SchedDlTriggerReqParameters dlparams);
+  /**
+  * \brief Apply the scheduling decisions deferred while the scheduler
+  * was run by the LteSchedulerExecutor
+  */
+  void DoMergeScheduler (void);
+  /**
   * \brief Receive RACH Preamble function
   * \param prachId PRACH ID number
   */
@@ -454,6 +467,12 @@ private:
 
   /// component carrier Id used to address sap
   uint8_t m_componentCarrierId;
+
+  LteSchedulerExecutor::Job* m_schedulerJob; ///< the scheduling job submitted to the LteSchedulerExecutor
+  FfMacSchedSapProvider::SchedDlTriggerReqParameters m_schedulerJobDlParams; ///< DL trigger parameters of the submitted job
+  bool m_deferConfigInd; ///< whether the scheduler decisions are recorded for DoMergeScheduler
+  std::vector <FfMacSchedSapUser::SchedDlConfigIndParameters> m_deferredDlConfigInd; ///< recorded DL scheduler decisions
+  std::vector <FfMacSchedSapUser::SchedUlConfigIndParameters> m_deferredUlConfigInd; ///< recorded UL scheduler decisions
  
 };
 
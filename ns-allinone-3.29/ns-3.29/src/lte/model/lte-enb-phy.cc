@@ -26,6 +26,7 @@
 #include <ns3/simulator.h>
 #include <ns3/attribute-accessor-helper.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 
 
 #include "lte-enb-phy.h"
@@ -161,6 +162,7 @@ LteEnbPhy::LteEnbPhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
     m_srsPeriodicity (0),
     m_srsStartTime (Seconds (0)),
     m_currentSrsOffset (0),
+    m_idleSubframeSkipping (false),
     m_interferenceSampleCounter (0)
 {
   m_enbPhySapProvider = new EnbMemberLteEnbPhySapProvider (this);
@@ -207,6 +209,16 @@ LteEnbPhy::GetTypeId (void)
                    MakeUintegerAccessor (&LteEnbPhy::SetMacChDelay, 
                                          &LteEnbPhy::GetMacChDelay),
                    MakeUintegerChecker<uint8_t> ())
+    .AddAttribute ("IdleSubframeSkipping",
+                   "If true, the sub frames which carry no PSS (all but "
+                   "the 1st and 6th of each frame) are skipped while no UE "
+                   "is attached and nothing is queued for transmission, "
+                   "instead of transmitting an empty control frame.  Frame "
+                   "and sub frame numbers are preserved, and any activity "
+                   "resumes the sub frames at the next sub frame boundary.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteEnbPhy::m_idleSubframeSkipping),
+                   MakeBooleanChecker ())
     .AddTraceSource ("ReportUeSinr",
                      "Report UEs' averaged linear SINR",
                      MakeTraceSourceAccessor (&LteEnbPhy::m_reportUeSinr),
@@ -256,6 +268,7 @@ LteEnbPhy::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_ueAttached.clear ();
   m_srsUeOffset.clear ();
+  m_idleEvent.Cancel ();
   delete m_enbPhySapProvider;
   delete m_enbCphySapProvider;
   LtePhy::DoDispose ();
@@ -433,6 +446,7 @@ LteEnbPhy::DoSendMacPdu (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this);
   SetMacPdu (p);
+  WakeUp ();
 }
 
 uint8_t
@@ -523,6 +537,7 @@ LteEnbPhy::DoSendLteControlMessage (Ptr<LteControlMessage> msg)
   NS_LOG_FUNCTION (this << msg);
   // queues the message (wait for MAC-PHY delay)
   SetControlMessages (msg);
+  WakeUp ();
 }
 
 
@@ -539,6 +554,8 @@ void
 LteEnbPhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgList)
 {
   NS_LOG_FUNCTION (this);
+  // the MAC processes the messages at the next sub frame
+  WakeUp ();
   std::list<Ptr<LteControlMessage> >::iterator it;
   for (it = msgList.begin (); it != msgList.end (); it++)
     {
@@ -819,6 +836,20 @@ void
 LteEnbPhy::EndSubFrame (void)
 {
   NS_LOG_FUNCTION (this << Simulator::Now ().GetSeconds ());
+  if (m_idleSubframeSkipping && IsIdle ())
+    {
+      // skip to the next sub frame carrying the PSS (and MIB or SIB1)
+      uint32_t skipped = (m_nrSubFrames < 6 ? 5 : 10) - m_nrSubFrames;
+      if (skipped > 0)
+        {
+          NS_LOG_LOGIC (this << " eNB " << m_cellId << " skipping " << skipped << " idle sub frames");
+          m_idleStart = Simulator::Now ();
+          m_idleEvent = Simulator::Schedule (TimeStep (Seconds (GetTti ()).GetTimeStep () * skipped),
+                                             &LteEnbPhy::EndIdleSubFrames,
+                                             this, skipped);
+          return;
+        }
+    }
   if (m_nrSubFrames == 10)
     {
       Simulator::ScheduleNow (&LteEnbPhy::EndFrame, this);
@@ -838,6 +869,67 @@ LteEnbPhy::EndFrame (void)
 }
 
 
+bool
+LteEnbPhy::IsIdle (void) const
+{
+  if (!m_ueAttached.empty ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < m_controlMessagesQueue.size (); i++)
+    {
+      if (!m_controlMessagesQueue.at (i).empty () || m_packetBurstQueue.at (i)->GetNPackets () > 0)
+        {
+          return false;
+        }
+    }
+  for (uint32_t i = 0; i < m_ulDciQueue.size (); i++)
+    {
+      if (!m_ulDciQueue.at (i).empty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+
+void
+LteEnbPhy::EndIdleSubFrames (uint32_t skipped)
+{
+  NS_LOG_FUNCTION (this << skipped);
+  m_nrSubFrames += skipped;
+  NS_ASSERT (m_nrSubFrames <= 10);
+  if (m_nrSubFrames == 10)
+    {
+      Simulator::ScheduleNow (&LteEnbPhy::EndFrame, this);
+    }
+  else
+    {
+      Simulator::ScheduleNow (&LteEnbPhy::StartSubFrame, this);
+    }
+}
+
+
+void
+LteEnbPhy::WakeUp (void)
+{
+  if (!m_idleEvent.IsRunning ())
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  // resume at the first sub frame boundary from now on
+  int64_t tti = Seconds (GetTti ()).GetTimeStep ();
+  int64_t elapsed = (Simulator::Now () - m_idleStart).GetTimeStep ();
+  uint32_t skipped = static_cast<uint32_t> ((elapsed + tti - 1) / tti);
+  m_idleEvent.Cancel ();
+  m_idleEvent = Simulator::Schedule (m_idleStart + TimeStep (skipped * tti) - Simulator::Now (),
+                                     &LteEnbPhy::EndIdleSubFrames,
+                                     this, skipped);
+}
+
+
 void 
 LteEnbPhy::GenerateCtrlCqiReport (const SpectrumValue& sinr)
 {
@@ -940,6 +1032,7 @@ LteEnbPhy::DoAddUe (uint16_t rnti)
  
   bool success = AddUePhy (rnti);
   NS_ASSERT_MSG (success, "AddUePhy() failed");
+  WakeUp ();
 
   // add default P_A value
   DoSetPa (rnti, 0);
@@ -28,6 +28,7 @@
 #include <ns3/lte-enb-cphy-sap.h>
 #include <ns3/lte-phy.h>
 #include <ns3/lte-harq-phy.h>
+#include <ns3/event-id.h>
 
 #include <map>
 #include <set>
@@ -265,6 +266,24 @@ public:
    * \brief End a LTE frame
    */
   void EndFrame (void);
+  /**
+   * \brief Check whether the next sub frames can be skipped
+   *
+   * \return true if no UE is attached and no control message, MAC PDU
+   * or UL-DCI is queued
+   */
+  bool IsIdle (void) const;
+  /**
+   * \brief End a run of idle sub frames skipped by EndSubFrame
+   *
+   * \param skipped the number of sub frames skipped
+   */
+  void EndIdleSubFrames (uint32_t skipped);
+  /**
+   * \brief Resume the sub frames at the next sub frame boundary, if idle
+   * sub frames are being skipped
+   */
+  void WakeUp (void);
 
   /**
    * \brief PhySpectrum received a new PHY-PDU
@@ -468,6 +487,14 @@ private:
   std::vector <uint16_t> m_srsUeOffset; ///< SRS UE offset
   uint16_t m_currentSrsOffset; ///< current SRS offset
 
+  /**
+   * The `IdleSubframeSkipping` attribute. Skip the sub frames without
+   * PSS while the eNB is idle.
+   */
+  bool m_idleSubframeSkipping;
+  EventId m_idleEvent; ///< end of the idle sub frames being skipped
+  Time m_idleStart; ///< start of the first idle sub frame skipped
+
   /**
    * The Master Information Block message to be broadcasted every frame.
    * The message content is specified by the upper layer through the RRC SAP.
@@ -0,0 +1,341 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-fading-trace.h"
+
+#include <ns3/log.h>
+#include <ns3/fatal-error.h>
+#include <ns3/random-variable-stream.h>
+
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <complex>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteFadingTrace");
+
+namespace {
+
+/// Magic number of the binary traces
+const char BINARY_MAGIC[8] = { 'N', 'S', '3', 'F', 'A', 'D', 'T', 'R' };
+
+/// Header of the binary traces
+struct BinaryHeader
+{
+  char magic[8]; ///< BINARY_MAGIC
+  uint32_t version; ///< the format version, 1
+  uint32_t rbNum; ///< the number of RBs
+  uint32_t samplesNum; ///< the number of samples per RB
+  uint32_t sampleSize; ///< the size of a sample, 4
+};
+
+/// Number of sinusoids per tap of Generate ()
+const uint32_t OSCILLATORS_NUM = 16;
+
+/// Bandwidth of a RB, in Hz
+const double RB_BANDWIDTH = 180000.0;
+
+} // unnamed namespace
+
+
+LteFadingTrace::LteFadingTrace (uint32_t rbNum, uint32_t samplesNum)
+  : m_rbNum (rbNum),
+    m_samplesNum (samplesNum),
+    m_samples (rbNum * samplesNum, 0.0),
+    m_mapped (0),
+    m_map (0),
+    m_mapSize (0)
+{
+  NS_LOG_FUNCTION (this << rbNum << samplesNum);
+}
+
+LteFadingTrace::LteFadingTrace (std::string fileName, uint32_t rbNum, uint32_t samplesNum)
+  : m_fileName (fileName),
+    m_rbNum (rbNum),
+    m_samplesNum (samplesNum),
+    m_mapped (0),
+    m_map (0),
+    m_mapSize (0)
+{
+  NS_LOG_FUNCTION (this << fileName << rbNum << samplesNum);
+  int fd = open (fileName.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_FATAL_ERROR ("Fading trace file " << fileName << " not found");
+    }
+  bool binary = MapBinary (fd);
+  close (fd);
+  if (!binary)
+    {
+      ParseText ();
+    }
+}
+
+LteFadingTrace::~LteFadingTrace ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_map != 0)
+    {
+      munmap (m_map, m_mapSize);
+    }
+  if (!m_fileName.empty ())
+    {
+      GetLoaded ().erase (Key (m_fileName, std::make_pair (m_rbNum, m_samplesNum)));
+    }
+}
+
+std::map<LteFadingTrace::Key, LteFadingTrace *> &
+LteFadingTrace::GetLoaded (void)
+{
+  static std::map<Key, LteFadingTrace *> loaded;
+  return loaded;
+}
+
+Ptr<const LteFadingTrace>
+LteFadingTrace::Load (std::string fileName, uint32_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (fileName << rbNum << samplesNum);
+  Key key (fileName, std::make_pair (rbNum, samplesNum));
+  std::map<Key, LteFadingTrace *>::iterator it = GetLoaded ().find (key);
+  if (it != GetLoaded ().end ())
+    {
+      NS_LOG_LOGIC ("sharing the trace already loaded from " << fileName);
+      return Ptr<const LteFadingTrace> (it->second);
+    }
+  Ptr<LteFadingTrace> trace (new LteFadingTrace (fileName, rbNum, samplesNum), false);
+  GetLoaded ()[key] = PeekPointer (trace);
+  return trace;
+}
+
+bool
+LteFadingTrace::MapBinary (int fd)
+{
+  NS_LOG_FUNCTION (this << fd);
+  BinaryHeader header;
+  ssize_t len = read (fd, &header, sizeof (header));
+  if (len != sizeof (header) || std::memcmp (header.magic, BINARY_MAGIC, sizeof (BINARY_MAGIC)) != 0)
+    {
+      return false;
+    }
+  if (header.version != 1 || header.sampleSize != sizeof (float))
+    {
+      NS_FATAL_ERROR ("Fading trace file " << m_fileName << " has an unsupported format");
+    }
+  if (header.rbNum < m_rbNum || header.samplesNum != m_samplesNum)
+    {
+      NS_FATAL_ERROR ("Fading trace file " << m_fileName << " has " << header.rbNum
+                      << " RBs and " << header.samplesNum << " samples, expected "
+                      << m_rbNum << " RBs and " << m_samplesNum << " samples");
+    }
+
+  struct stat st;
+  std::size_t size = sizeof (header) + static_cast<std::size_t> (header.rbNum) * header.samplesNum * sizeof (float);
+  if (fstat (fd, &st) != 0 || static_cast<std::size_t> (st.st_size) < size)
+    {
+      NS_FATAL_ERROR ("Fading trace file " << m_fileName << " is truncated");
+    }
+  void *map = mmap (0, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED)
+    {
+      NS_FATAL_ERROR ("Cannot map fading trace file " << m_fileName << ": " << std::strerror (errno));
+    }
+  m_map = map;
+  m_mapSize = size;
+  m_mapped = reinterpret_cast<const float *> (static_cast<const char *> (map) + sizeof (header));
+  NS_LOG_INFO ("mapped binary fading trace " << m_fileName);
+  return true;
+}
+
+void
+LteFadingTrace::ParseText (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::ifstream ifTraceFile;
+  ifTraceFile.open (m_fileName.c_str (), std::ifstream::in);
+  m_samples.clear ();
+  m_samples.reserve (m_rbNum * m_samplesNum);
+  for (uint32_t i = 0; i < m_rbNum * m_samplesNum; i++)
+    {
+      double sample;
+      ifTraceFile >> sample;
+      m_samples.push_back (sample);
+    }
+  NS_LOG_INFO ("parsed text fading trace " << m_fileName);
+}
+
+Ptr<LteFadingTrace>
+LteFadingTrace::Generate (const std::vector<double> &delays,
+                          const std::vector<double> &powers,
+                          double doppler, Time length,
+                          uint32_t rbNum, uint32_t samplesNum,
+                          Ptr<RandomVariableStream> random)
+{
+  NS_LOG_FUNCTION (doppler << length << rbNum << samplesNum);
+  NS_ASSERT (delays.size () == powers.size () && !delays.empty ());
+  uint32_t tapsNum = delays.size ();
+
+  // normalize the tap powers to a total of 1
+  std::vector<double> amplitudes (tapsNum);
+  double total = 0;
+  for (uint32_t l = 0; l < tapsNum; l++)
+    {
+      total += std::pow (10.0, powers[l] / 10.0);
+    }
+  for (uint32_t l = 0; l < tapsNum; l++)
+    {
+      amplitudes[l] = std::sqrt (std::pow (10.0, powers[l] / 10.0) / total);
+    }
+
+  // random angles of arrival and phases of the sinusoids of each tap
+  const uint32_t m = OSCILLATORS_NUM;
+  std::vector<double> cosAlpha (tapsNum * m);
+  std::vector<double> sinAlpha (tapsNum * m);
+  std::vector<double> phiI (tapsNum * m);
+  std::vector<double> phiQ (tapsNum * m);
+  for (uint32_t l = 0; l < tapsNum; l++)
+    {
+      double theta = 2 * M_PI * random->GetValue () - M_PI;
+      for (uint32_t n = 0; n < m; n++)
+        {
+          double alpha = (2 * M_PI * (n + 1) - M_PI + theta) / (4 * m);
+          cosAlpha[l * m + n] = std::cos (alpha);
+          sinAlpha[l * m + n] = std::sin (alpha);
+          phiI[l * m + n] = 2 * M_PI * random->GetValue () - M_PI;
+          phiQ[l * m + n] = 2 * M_PI * random->GetValue () - M_PI;
+        }
+    }
+
+  // phase rotation of each tap at the center of each RB
+  std::vector<std::complex<double> > rotation (rbNum * tapsNum);
+  for (uint32_t rb = 0; rb < rbNum; rb++)
+    {
+      double f = (rb + 0.5) * RB_BANDWIDTH;
+      for (uint32_t l = 0; l < tapsNum; l++)
+        {
+          rotation[rb * tapsNum + l] = std::polar (amplitudes[l], -2 * M_PI * f * delays[l]);
+        }
+    }
+
+  Ptr<LteFadingTrace> trace = Create<LteFadingTrace> (rbNum, samplesNum);
+  double wd = 2 * M_PI * doppler;
+  double scale = std::sqrt (1.0 / m);
+  std::vector<std::complex<double> > gains (tapsNum);
+  for (uint32_t s = 0; s < samplesNum; s++)
+    {
+      double t = length.GetSeconds () * s / samplesNum;
+      for (uint32_t l = 0; l < tapsNum; l++)
+        {
+          double i = 0;
+          double q = 0;
+          for (uint32_t n = 0; n < m; n++)
+            {
+              i += std::cos (wd * t * cosAlpha[l * m + n] + phiI[l * m + n]);
+              q += std::sin (wd * t * sinAlpha[l * m + n] + phiQ[l * m + n]);
+            }
+          gains[l] = std::complex<double> (i * scale, q * scale);
+        }
+      for (uint32_t rb = 0; rb < rbNum; rb++)
+        {
+          std::complex<double> h = 0;
+          for (uint32_t l = 0; l < tapsNum; l++)
+            {
+              h += gains[l] * rotation[rb * tapsNum + l];
+            }
+          trace->SetValue (rb, s, 10 * std::log10 (std::norm (h)));
+        }
+    }
+  return trace;
+}
+
+uint32_t
+LteFadingTrace::GetRbNum (void) const
+{
+  return m_rbNum;
+}
+
+uint32_t
+LteFadingTrace::GetSamplesNum (void) const
+{
+  return m_samplesNum;
+}
+
+void
+LteFadingTrace::SetValue (uint32_t rb, uint32_t sample, double value)
+{
+  NS_ASSERT_MSG (m_fileName.empty (), "cannot modify a trace loaded from a file");
+  NS_ASSERT (rb < m_rbNum && sample < m_samplesNum);
+  m_samples[rb * m_samplesNum + sample] = value;
+}
+
+void
+LteFadingTrace::WriteText (std::string fileName) const
+{
+  NS_LOG_FUNCTION (this << fileName);
+  std::ofstream out (fileName.c_str ());
+  if (!out.good ())
+    {
+      NS_FATAL_ERROR ("Cannot open fading trace file " << fileName);
+    }
+  out.precision (8);
+  for (uint32_t rb = 0; rb < m_rbNum; rb++)
+    {
+      for (uint32_t s = 0; s < m_samplesNum; s++)
+        {
+          out << GetValue (rb, s) << " ";
+        }
+      out << std::endl;
+    }
+}
+
+void
+LteFadingTrace::WriteBinary (std::string fileName) const
+{
+  NS_LOG_FUNCTION (this << fileName);
+  std::ofstream out (fileName.c_str (), std::ios::binary);
+  if (!out.good ())
+    {
+      NS_FATAL_ERROR ("Cannot open fading trace file " << fileName);
+    }
+  BinaryHeader header;
+  std::memcpy (header.magic, BINARY_MAGIC, sizeof (BINARY_MAGIC));
+  header.version = 1;
+  header.rbNum = m_rbNum;
+  header.samplesNum = m_samplesNum;
+  header.sampleSize = sizeof (float);
+  out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  std::vector<float> row (m_samplesNum);
+  for (uint32_t rb = 0; rb < m_rbNum; rb++)
+    {
+      for (uint32_t s = 0; s < m_samplesNum; s++)
+        {
+          row[s] = static_cast<float> (GetValue (rb, s));
+        }
+      out.write (reinterpret_cast<const char *> (&row[0]), row.size () * sizeof (float));
+    }
+  if (!out.good ())
+    {
+      NS_FATAL_ERROR ("Cannot write fading trace file " << fileName);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,198 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_FADING_TRACE_H
+#define LTE_FADING_TRACE_H
+
+#include <ns3/simple-ref-count.h>
+#include <ns3/ptr.h>
+#include <ns3/nstime.h>
+#include <ns3/assert.h>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+class RandomVariableStream;
+
+/**
+ * \ingroup lte
+ *
+ * \brief The samples of a fading trace, in dB, for each RB and each
+ * time sample.
+ *
+ * Traces are loaded with Load (), which returns the same instance to
+ * all the callers asking for the same file as long as one of them holds
+ * it, so that all the TraceFadingLossModel instances of a simulation
+ * share a single copy of each trace.
+ *
+ * Two file formats are supported:
+ *
+ *  - the text format produced by fading_trace_generator.m, with one
+ *    line of samples per RB;
+ *
+ *  - a binary format, written by WriteBinary (), which is mapped in
+ *    memory instead of being parsed, and is then also shared between
+ *    the processes using the same file.
+ *
+ * The binary format is, in host byte order:
+ *
+ *     char[8]  magic "NS3FADTR"
+ *     uint32_t version (1)
+ *     uint32_t number of RBs
+ *     uint32_t number of samples per RB
+ *     uint32_t size of a sample in bytes (4)
+ *     float[]  the samples of RB 0, then those of RB 1, and so on
+ *
+ * Traces can also be generated with Generate (), and converted from one
+ * format to the other with the lena-fading-trace-tool example.
+ */
+class LteFadingTrace : public SimpleRefCount<LteFadingTrace>
+{
+public:
+  /**
+   * Create an empty trace, with all samples set to 0 dB.
+   *
+   * \param rbNum the number of RBs
+   * \param samplesNum the number of samples per RB
+   */
+  LteFadingTrace (uint32_t rbNum, uint32_t samplesNum);
+  ~LteFadingTrace ();
+
+  /**
+   * Load a trace file, or get the trace already loaded from it.
+   *
+   * \param fileName the name of the text or binary trace file
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB
+   * \return the trace
+   */
+  static Ptr<const LteFadingTrace> Load (std::string fileName, uint32_t rbNum, uint32_t samplesNum);
+
+  /**
+   * Generate a Rayleigh fading trace for a tapped delay line channel.
+   *
+   * Each tap fades independently with a Jakes Doppler spectrum, using
+   * the sum of sinusoids model of Zheng and Xiao, and the frequency
+   * response of the channel is sampled at the center of each RB.  The
+   * tap powers are normalized, so that the average gain is 0 dB.
+   *
+   * \param delays the delays of the taps, in seconds
+   * \param powers the relative powers of the taps, in dB
+   * \param doppler the maximum Doppler shift, in Hz
+   * \param length the length of the trace
+   * \param rbNum the number of RBs
+   * \param samplesNum the number of samples per RB
+   * \param random the source of the random phases, uniform in [0, 1)
+   * \return the trace
+   */
+  static Ptr<LteFadingTrace> Generate (const std::vector<double> &delays,
+                                       const std::vector<double> &powers,
+                                       double doppler, Time length,
+                                       uint32_t rbNum, uint32_t samplesNum,
+                                       Ptr<RandomVariableStream> random);
+
+  /**
+   * \return the number of RBs
+   */
+  uint32_t GetRbNum (void) const;
+
+  /**
+   * \return the number of samples per RB
+   */
+  uint32_t GetSamplesNum (void) const;
+
+  /**
+   * \param rb the RB index
+   * \param sample the sample index
+   * \return the fading sample, in dB
+   */
+  double GetValue (uint32_t rb, uint32_t sample) const
+  {
+    NS_ASSERT (rb < m_rbNum && sample < m_samplesNum);
+    uint32_t i = rb * m_samplesNum + sample;
+    return m_mapped ? m_mapped[i] : m_samples[i];
+  }
+
+  /**
+   * Set a sample of a trace which is not loaded from a file.
+   *
+   * \param rb the RB index
+   * \param sample the sample index
+   * \param value the fading sample, in dB
+   */
+  void SetValue (uint32_t rb, uint32_t sample, double value);
+
+  /**
+   * Write the trace in the text format.
+   *
+   * \param fileName the file name
+   */
+  void WriteText (std::string fileName) const;
+
+  /**
+   * Write the trace in the binary format.
+   *
+   * \param fileName the file name
+   */
+  void WriteBinary (std::string fileName) const;
+
+private:
+  /**
+   * Create a trace loaded from a file.
+   *
+   * \param fileName the file name
+   * \param rbNum the number of RBs
+   * \param samplesNum the number of samples per RB
+   */
+  LteFadingTrace (std::string fileName, uint32_t rbNum, uint32_t samplesNum);
+
+  /**
+   * Map a binary trace file.
+   *
+   * \param fd the file descriptor
+   * \return true if the file is a binary trace
+   */
+  bool MapBinary (int fd);
+
+  /**
+   * Parse a text trace file.
+   */
+  void ParseText (void);
+
+  /// Key of the loaded traces: file name, number of RBs and of samples
+  typedef std::pair<std::string, std::pair<uint32_t, uint32_t> > Key;
+
+  /**
+   * \return the traces currently loaded
+   */
+  static std::map<Key, LteFadingTrace *> &GetLoaded (void);
+
+  std::string m_fileName; ///< the file name, if loaded from a file
+  uint32_t m_rbNum; ///< the number of RBs
+  uint32_t m_samplesNum; ///< the number of samples per RB
+  std::vector<double> m_samples; ///< the samples, unless mapped
+  const float *m_mapped; ///< the samples of a mapped binary trace, or 0
+  void *m_map; ///< the mapped file
+  std::size_t m_mapSize; ///< the size of the mapped file
+};
+
+} // namespace ns3
+
+#endif /* LTE_FADING_TRACE_H */
@@ -757,7 +757,7 @@ LteFfrEnhancedAlgorithm::DoReportUlCqiInfo (const struct FfMacSchedSapProvider::
 }
 
 void
-LteFfrEnhancedAlgorithm::DoReportUlCqiInfo ( std::map <uint16_t, std::vector <double> > ulCqiMap )
+LteFfrEnhancedAlgorithm::DoReportUlCqiInfo (const LteRntiMap <std::vector <double> >& ulCqiMap)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_WARN ("Method should not be called, because it is empty");
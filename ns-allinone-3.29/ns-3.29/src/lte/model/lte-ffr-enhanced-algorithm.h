@@ -78,7 +78,7 @@ protected:
   virtual bool DoIsUlRbgAvailableForUe (int i, uint16_t rnti);
   virtual void DoReportDlCqiInfo (const struct FfMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
   virtual void DoReportUlCqiInfo (const struct FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
-  virtual void DoReportUlCqiInfo ( std::map <uint16_t, std::vector <double> > ulCqiMap );
+  virtual void DoReportUlCqiInfo (const LteRntiMap <std::vector <double> >& ulCqiMap);
   virtual uint8_t DoGetTpc (uint16_t rnti);
   virtual uint8_t DoGetMinContinuousUlBandwidth ();
 
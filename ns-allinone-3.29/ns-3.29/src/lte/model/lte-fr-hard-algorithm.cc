@@ -346,7 +346,7 @@ LteFrHardAlgorithm::DoReportUlCqiInfo (const struct FfMacSchedSapProvider::Sched
 }
 
 void
-LteFrHardAlgorithm::DoReportUlCqiInfo (std::map <uint16_t, std::vector <double> > ulCqiMap)
+LteFrHardAlgorithm::DoReportUlCqiInfo (const LteRntiMap <std::vector <double> >& ulCqiMap)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_WARN ("Method should not be called, because it is empty");
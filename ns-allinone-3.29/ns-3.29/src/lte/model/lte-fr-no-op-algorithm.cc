@@ -157,7 +157,7 @@ LteFrNoOpAlgorithm::DoReportUlCqiInfo (const struct FfMacSchedSapProvider::Sched
 }
 
 void
-LteFrNoOpAlgorithm::DoReportUlCqiInfo (std::map <uint16_t, std::vector <double> > ulCqiMap)
+LteFrNoOpAlgorithm::DoReportUlCqiInfo (const LteRntiMap <std::vector <double> >& ulCqiMap)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_WARN ("Method should not be called, because it is empty");
@@ -448,7 +448,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId,
   Ptr<Packet> firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
   m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
   NS_LOG_LOGIC ("txBufferSize      = " << m_txonBufferSize );
-  m_txonBuffer.erase (m_txonBuffer.begin ());
+  m_txonBuffer.pop_front ();
 
   while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
     {
@@ -496,7 +496,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId,
             {
               firstSegment->AddPacketTag (oldTag);
 
-              m_txonBuffer.insert (m_txonBuffer.begin (), firstSegment);
+              m_txonBuffer.push_front (firstSegment);
               m_txonBufferSize += (*(m_txonBuffer.begin()))->GetSize ();
 
               NS_LOG_LOGIC ("    Txon buffer: Give back the remaining segment");
@@ -602,7 +602,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId,
           // (more segments)
           firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
           m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
-          m_txonBuffer.erase (m_txonBuffer.begin ());
+          m_txonBuffer.pop_front ();
           NS_LOG_LOGIC ("        txBufferSize = " << m_txonBufferSize );
         }
 
@@ -25,6 +25,7 @@
 #include <ns3/lte-rlc-sequence-number.h>
 #include <ns3/lte-rlc.h>
 
+#include <deque>
 #include <vector>
 #include <map>
 
@@ -112,7 +113,7 @@ private:
   void DoReportBufferStatus ();
 
 private:
-    std::vector < Ptr<Packet> > m_txonBuffer; ///< Transmission buffer
+    std::deque < Ptr<Packet> > m_txonBuffer; ///< Transmission buffer
 
     /// RetxPdu structure
     struct RetxPdu
@@ -25,6 +25,7 @@
 #include "ns3/lte-rlc.h"
 
 #include <ns3/event-id.h>
+#include <deque>
 #include <map>
 
 namespace ns3 {
@@ -102,7 +103,7 @@ private:
 private:
   uint32_t m_maxTxBufferSize; ///< maximum transmit buffer status
   uint32_t m_txBufferSize; ///< transmit buffer size
-  std::vector < Ptr<Packet> > m_txBuffer;       ///< Transmission buffer
+  std::deque < Ptr<Packet> > m_txBuffer;        ///< Transmission buffer
   std::map <uint16_t, Ptr<Packet> > m_rxBuffer; ///< Reception buffer
   std::vector < Ptr<Packet> > m_reasBuffer;     ///< Reassembling buffer
 
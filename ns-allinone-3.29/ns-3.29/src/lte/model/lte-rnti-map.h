@@ -0,0 +1,414 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_RNTI_MAP_H
+#define LTE_RNTI_MAP_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * \brief Dense store of per-UE state, indexed by RNTI.
+ *
+ * LteRntiMap offers the subset of the std::map<uint16_t, T> interface used
+ * by the FF MAC schedulers, and iterates over the UEs in increasing RNTI
+ * order as std::map does. The entries are kept in a vector sorted by RNTI,
+ * so that the per-TTI loops over all the UEs scan contiguous memory, and a
+ * table indexed by RNTI gives the position of each entry, so that finding
+ * a UE takes constant time. Since the eNB allocates the RNTIs sequentially,
+ * the table stays small.
+ *
+ * Erasing an entry only marks its position as free, so that the iterators
+ * to the other entries stay valid, as with std::map; the free positions
+ * are reused when the same RNTI is inserted again, and removed when an
+ * entry is inserted out of order, or appended while more positions are
+ * free than in use, so that UEs attaching and detaching with new RNTIs do
+ * not grow the vector. Unlike std::map, inserting a new RNTI may
+ * invalidate the iterators to the other entries.
+ */
+template <class T>
+class LteRntiMap
+{
+public:
+  typedef uint16_t key_type; ///< the RNTI
+  typedef T mapped_type; ///< the per-UE state
+  typedef std::pair<uint16_t, T> value_type; ///< an entry
+  typedef std::size_t size_type; ///< size type
+
+private:
+  /// value of an iterator which is past the last entry
+  static const std::size_t END = static_cast<std::size_t> (-1);
+
+  /**
+   * Iterator over the entries.
+   *
+   * \tparam M the (const) map type
+   * \tparam V the (const) value type
+   */
+  template <class M, class V>
+  class Iterator : public std::iterator<std::forward_iterator_tag, V>
+  {
+public:
+    Iterator ()
+      : m_map (0),
+        m_pos (END)
+    {
+    }
+    /**
+     * Constructor
+     *
+     * \param map the map
+     * \param pos the position of the entry, END if past the last entry
+     */
+    Iterator (M *map, std::size_t pos)
+      : m_map (map),
+        m_pos (pos)
+    {
+    }
+    /**
+     * Conversion from a non-const iterator.
+     *
+     * \param o the iterator
+     */
+    template <class M2, class V2>
+    Iterator (const Iterator<M2, V2> &o)
+      : m_map (o.m_map),
+        m_pos (o.m_pos)
+    {
+    }
+    /// \return the entry
+    V & operator* () const
+    {
+      return m_map->m_entries[m_pos];
+    }
+    /// \return a pointer to the entry
+    V * operator-> () const
+    {
+      return &m_map->m_entries[m_pos];
+    }
+    /// \return this iterator, moved to the next entry
+    Iterator & operator++ ()
+    {
+      m_pos = m_map->NextUsed (m_pos + 1);
+      return *this;
+    }
+    /// \return a copy of this iterator, before moving to the next entry
+    Iterator operator++ (int)
+    {
+      Iterator ret = *this;
+      ++*this;
+      return ret;
+    }
+    /**
+     * \param o the other iterator
+     * \return true if both iterators point to the same entry
+     */
+    template <class M2, class V2>
+    bool operator== (const Iterator<M2, V2> &o) const
+    {
+      return m_pos == o.m_pos;
+    }
+    /**
+     * \param o the other iterator
+     * \return true if the iterators point to different entries
+     */
+    template <class M2, class V2>
+    bool operator!= (const Iterator<M2, V2> &o) const
+    {
+      return m_pos != o.m_pos;
+    }
+
+    M *m_map; ///< the map
+    std::size_t m_pos; ///< the position of the entry
+  };
+
+public:
+  typedef Iterator<LteRntiMap, value_type> iterator; ///< iterator
+  typedef Iterator<const LteRntiMap, const value_type> const_iterator; ///< const iterator
+
+  LteRntiMap ()
+    : m_size (0),
+      m_free (0)
+  {
+  }
+
+  /// \return an iterator to the entry with the lowest RNTI
+  iterator begin ()
+  {
+    return iterator (this, NextUsed (0));
+  }
+  /// \return a const iterator to the entry with the lowest RNTI
+  const_iterator begin () const
+  {
+    return const_iterator (this, NextUsed (0));
+  }
+  /// \return the iterator past the last entry
+  iterator end ()
+  {
+    return iterator (this, END);
+  }
+  /// \return the const iterator past the last entry
+  const_iterator end () const
+  {
+    return const_iterator (this, END);
+  }
+  /// \return the number of entries
+  size_type size () const
+  {
+    return m_size;
+  }
+  /// \return true if there are no entries
+  bool empty () const
+  {
+    return m_size == 0;
+  }
+  /// \return the number of positions, in use or free
+  std::size_t GetStorageSize () const
+  {
+    return m_entries.size ();
+  }
+
+  /**
+   * \param rnti the RNTI
+   * \return an iterator to the entry of the UE, end () if there is none
+   */
+  iterator find (uint16_t rnti)
+  {
+    return iterator (this, Position (rnti));
+  }
+  /**
+   * \param rnti the RNTI
+   * \return a const iterator to the entry of the UE, end () if there is none
+   */
+  const_iterator find (uint16_t rnti) const
+  {
+    return const_iterator (this, Position (rnti));
+  }
+  /**
+   * \param rnti the RNTI
+   * \return 1 if there is an entry for the UE, 0 otherwise
+   */
+  size_type count (uint16_t rnti) const
+  {
+    return (Position (rnti) == END) ? 0 : 1;
+  }
+
+  /**
+   * Insert an entry, if there is none for the same UE.
+   *
+   * \param value the entry
+   * \return an iterator to the entry of the UE, and true if it was inserted
+   */
+  std::pair<iterator, bool> insert (const value_type &value)
+  {
+    std::size_t pos = Position (value.first);
+    if (pos != END)
+      {
+        return std::make_pair (iterator (this, pos), false);
+      }
+    if (m_entries.empty () || m_entries.back ().first < value.first)
+      {
+        if (m_free > m_size)
+          {
+            Compact ();
+          }
+        pos = m_entries.size ();
+        m_entries.push_back (value);
+        m_used.push_back (true);
+      }
+    else
+      {
+        pos = LowerBound (value.first);
+        if (m_entries[pos].first == value.first)
+          {
+            // reuse the free position of the same RNTI
+            m_entries[pos].second = value.second;
+            m_used[pos] = true;
+            --m_free;
+          }
+        else
+          {
+            if (m_free > 0)
+              {
+                Compact ();
+                pos = LowerBound (value.first);
+              }
+            m_entries.insert (m_entries.begin () + pos, value);
+            m_used.insert (m_used.begin () + pos, true);
+            for (std::size_t i = pos + 1; i < m_entries.size (); ++i)
+              {
+                m_index[m_entries[i].first] = i + 1;
+              }
+          }
+      }
+    if (m_index.size () <= value.first)
+      {
+        m_index.resize (value.first + 1, 0);
+      }
+    m_index[value.first] = pos + 1;
+    ++m_size;
+    return std::make_pair (iterator (this, pos), true);
+  }
+
+  /**
+   * \param rnti the RNTI
+   * \return the state of the UE, inserted with its default value if there
+   * was none
+   */
+  T & operator[] (uint16_t rnti)
+  {
+    std::size_t pos = Position (rnti);
+    if (pos == END)
+      {
+        pos = insert (value_type (rnti, T ())).first.m_pos;
+      }
+    return m_entries[pos].second;
+  }
+
+  /**
+   * Erase an entry. The iterators to the other entries stay valid.
+   *
+   * \param it an iterator to the entry
+   */
+  void erase (iterator it)
+  {
+    std::size_t pos = it.m_pos;
+    m_index[m_entries[pos].first] = 0;
+    m_entries[pos].second = T ();
+    m_used[pos] = false;
+    --m_size;
+    ++m_free;
+  }
+  /**
+   * Erase the entry of a UE, if any.
+   *
+   * \param rnti the RNTI
+   * \return the number of entries erased
+   */
+  size_type erase (uint16_t rnti)
+  {
+    std::size_t pos = Position (rnti);
+    if (pos == END)
+      {
+        return 0;
+      }
+    erase (iterator (this, pos));
+    return 1;
+  }
+
+  /// Erase all the entries.
+  void clear ()
+  {
+    m_entries.clear ();
+    m_used.clear ();
+    m_index.clear ();
+    m_size = 0;
+    m_free = 0;
+  }
+
+private:
+  /**
+   * \param rnti the RNTI
+   * \return the position of the entry of the UE, END if there is none
+   */
+  std::size_t Position (uint16_t rnti) const
+  {
+    return (rnti < m_index.size () && m_index[rnti] > 0) ? m_index[rnti] - 1 : END;
+  }
+
+  /**
+   * \param pos a position
+   * \return the position of the first entry in use from pos, END if none
+   */
+  std::size_t NextUsed (std::size_t pos) const
+  {
+    while (pos < m_used.size ())
+      {
+        if (m_used[pos])
+          {
+            return pos;
+          }
+        ++pos;
+      }
+    return END;
+  }
+
+  /**
+   * \param rnti the RNTI
+   * \return the position of the first entry, in use or free, whose RNTI is
+   * not lower than rnti
+   */
+  std::size_t LowerBound (uint16_t rnti) const
+  {
+    std::size_t lo = 0;
+    std::size_t hi = m_entries.size ();
+    while (lo < hi)
+      {
+        std::size_t mid = (lo + hi) / 2;
+        if (m_entries[mid].first < rnti)
+          {
+            lo = mid + 1;
+          }
+        else
+          {
+            hi = mid;
+          }
+      }
+    return lo;
+  }
+
+  /// Remove the free positions.
+  void Compact ()
+  {
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < m_entries.size (); ++i)
+      {
+        if (m_used[i])
+          {
+            if (i != j)
+              {
+                m_entries[j] = m_entries[i];
+              }
+            m_index[m_entries[j].first] = j + 1;
+            ++j;
+          }
+      }
+    m_entries.resize (j);
+    m_used.assign (j, true);
+    m_free = 0;
+  }
+
+  std::vector<value_type> m_entries; ///< the entries, in use or free, sorted by RNTI
+  std::vector<bool> m_used; ///< whether each position is in use
+  std::vector<uint32_t> m_index; ///< the position of the entry of each RNTI, plus one, 0 if none
+  std::size_t m_size; ///< the number of entries in use
+  std::size_t m_free; ///< the number of free positions
+};
+
+template <class T>
+const std::size_t LteRntiMap<T>::END;
+
+} // namespace ns3
+
+#endif /* LTE_RNTI_MAP_H */
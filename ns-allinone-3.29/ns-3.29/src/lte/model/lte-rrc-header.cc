@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include <sstream>
+#include <map>
 
 #define MAX_DRB 11 // According to section 6.4 3GPP TS 36.331
 #define MAX_EARFCN 262143
@@ -642,34 +643,35 @@ RrcAsn1Header::SerializeSystemInformationBlockType2 (LteRrcSap::SystemInformatio
 }
 
 void
-RrcAsn1Header::SerializeMeasResults (LteRrcSap::MeasResults measResults) const
+RrcAsn1Header::SerializeMeasResults (const LteRrcSap::MeasResults &measResults) const
 {
   // Watchdog: if list has 0 elements, set boolean to false
-  if (measResults.measResultListEutra.empty ())
-    {
-      measResults.haveMeasResultNeighCells = false;
-    }
+  bool haveMeasResultNeighCells = measResults.haveMeasResultNeighCells
+    && !measResults.measResultListEutra.empty ();
 
     std::bitset<4> measResultOptional;
     measResultOptional.set (3,  measResults.haveScellsMeas);
     measResultOptional.set (2, false); //LocationInfo-r10
     measResultOptional.set (1, false); // MeasResultForECID-r9
-    measResultOptional.set (0, measResults.haveMeasResultNeighCells);
+    measResultOptional.set (0, haveMeasResultNeighCells);
     SerializeSequence(measResultOptional,true);
 
   // Serialize measId
+  MarkTemplateField ();
   SerializeInteger (measResults.measId,1,MAX_MEAS_ID);
 
   // Serialize measResultServCell sequence
   SerializeSequence (std::bitset<0> (0),false);
 
   // Serialize rsrpResult
+  MarkTemplateField ();
   SerializeInteger (measResults.rsrpResult,0,97);
 
   // Serialize rsrqResult
+  MarkTemplateField ();
   SerializeInteger (measResults.rsrqResult,0,34);
 
-  if (measResults.haveMeasResultNeighCells)
+  if (haveMeasResultNeighCells)
     {
       // Serialize Choice = 0 (MeasResultListEUTRA)
       SerializeChoice (4,0,false);
@@ -678,12 +680,13 @@ RrcAsn1Header::SerializeMeasResults (LteRrcSap::MeasResults measResults) const
       SerializeSequenceOf (measResults.measResultListEutra.size (),MAX_CELL_REPORT,1);
 
       // serialize MeasResultEutra elements in the list
-      std::list<LteRrcSap::MeasResultEutra>::iterator it;
+      std::list<LteRrcSap::MeasResultEutra>::const_iterator it;
       for (it = measResults.measResultListEutra.begin (); it != measResults.measResultListEutra.end (); it++)
         {
           SerializeSequence (std::bitset<1> (it->haveCgiInfo),false);
 
           // Serialize PhysCellId
+          MarkTemplateField ();
           SerializeInteger (it->physCellId, 0, 503);
 
           // Serialize CgiInfo
@@ -703,7 +706,7 @@ RrcAsn1Header::SerializeMeasResults (LteRrcSap::MeasResults measResults) const
               if (!it->cgiInfo.plmnIdentityList.empty ())
                 {
                   SerializeSequenceOf (it->cgiInfo.plmnIdentityList.size (),5,1);
-                  std::list<uint32_t>::iterator it2;
+                  std::list<uint32_t>::const_iterator it2;
                   for (it2 = it->cgiInfo.plmnIdentityList.begin (); it2 != it->cgiInfo.plmnIdentityList.end (); it2++)
                     {
                       SerializePlmnIdentity (*it2);
@@ -719,11 +722,13 @@ RrcAsn1Header::SerializeMeasResults (LteRrcSap::MeasResults measResults) const
 
           if (it->haveRsrpResult)
             {
+              MarkTemplateField ();
               SerializeInteger (it->rsrpResult,0,97);
             }
 
           if (it->haveRsrqResult)
             {
+              MarkTemplateField ();
               SerializeInteger (it->rsrqResult,0,34);
             }
         }
@@ -733,10 +738,11 @@ RrcAsn1Header::SerializeMeasResults (LteRrcSap::MeasResults measResults) const
         // Serialize measResultNeighCells
         SerializeSequenceOf (measResults.measScellResultList.measResultScell.size (),MAX_SCELL_REPORT,1);
         // serialize MeasResultServFreqList-r10 elements in the list
-        std::list<LteRrcSap::MeasResultScell>::iterator it;
+        std::list<LteRrcSap::MeasResultScell>::const_iterator it;
         for (it = measResults.measScellResultList.measResultScell.begin (); it != measResults.measScellResultList.measResultScell.end (); it++)
           {
             // Serialize measId
+            MarkTemplateField ();
             SerializeInteger (it->servFreqId,0,MAX_MEAS_ID); // ToDo: change with FreqId, currently is the componentCarrierId
              // Serialize MeasResultServFreqList
             std::bitset<2> measResultScellPresent;
@@ -752,11 +758,13 @@ RrcAsn1Header::SerializeMeasResults (LteRrcSap::MeasResults measResults) const
 
             if (it->haveRsrpResult)
               {
+                MarkTemplateField ();
                 SerializeInteger (it->rsrpResult,0,97);
               }
 
             if (it->haveRsrqResult)
               {
+                MarkTemplateField ();
                 SerializeInteger (it->rsrqResult,0,34);
               }
             
@@ -3634,7 +3642,7 @@ RrcAsn1Header::DeserializeMeasResults (LteRrcSap::MeasResults *measResults, Buff
             LteRrcSap::MeasResultScell measResultScell;
             int measScellId;
             // Deserialize measId
-            bIterator = DeserializeInteger (&measScellId, 1,MAX_SCELL_REPORT,bIterator);
+            bIterator = DeserializeInteger (&measScellId,0,MAX_MEAS_ID,bIterator);
             measResultScell.servFreqId = measScellId;
             std::bitset<2> measResultScellPresent;
             bIterator = DeserializeSequence (&measResultScellPresent,true,bIterator);
@@ -4559,6 +4567,14 @@ RrcConnectionRequestHeader::PreSerialize () const
 {
   m_serializationResult = Buffer ();
 
+  // The layout of the message is constant: serialize it from its template
+  static Template t;
+  uint32_t fields[] = { (uint32_t) m_mmec.to_ulong (), (uint32_t) m_mTmsi.to_ulong (), m_establishmentCause };
+  if (SerializeFromTemplate (&t, fields, sizeof (fields) / sizeof (fields[0])))
+    {
+      return;
+    }
+
   SerializeUlCcchMessage (1);
 
   // Serialize RRCConnectionRequest sequence:
@@ -4582,12 +4598,15 @@ RrcConnectionRequestHeader::PreSerialize () const
   SerializeSequence (std::bitset<0> (),false);
 
   // Serialize mmec : MMEC ::= BIT STRING (SIZE (8))
+  MarkTemplateField ();
   SerializeBitstring (m_mmec);
 
   // Serialize m-TMSI ::= BIT STRING (SIZE (32))
+  MarkTemplateField ();
   SerializeBitstring (m_mTmsi);
 
   // Serialize establishmentCause : EstablishmentCause ::= ENUMERATED
+  MarkTemplateField ();
   SerializeEnum (8,m_establishmentCause);
 
   // Serialize spare : BIT STRING (SIZE (1))
@@ -4859,6 +4878,14 @@ RrcConnectionSetupCompleteHeader::PreSerialize () const
 {
   m_serializationResult = Buffer ();
 
+  // The layout of the message is constant: serialize it from its template
+  static Template t;
+  uint32_t fields[] = { m_rrcTransactionIdentifier };
+  if (SerializeFromTemplate (&t, fields, sizeof (fields) / sizeof (fields[0])))
+    {
+      return;
+    }
+
   // Serialize DCCH message
   SerializeUlDcchMessage (4);
 
@@ -4867,6 +4894,7 @@ RrcConnectionSetupCompleteHeader::PreSerialize () const
   SerializeSequence (std::bitset<0> (),false);
 
   // Serialize rrc-TransactionIdentifier
+  MarkTemplateField ();
   SerializeInteger (m_rrcTransactionIdentifier,0,3);
 
   // Serialize criticalExtensions choice
@@ -4965,6 +4993,14 @@ RrcConnectionReconfigurationCompleteHeader::PreSerialize () const
 {
   m_serializationResult = Buffer ();
 
+  // The layout of the message is constant: serialize it from its template
+  static Template t;
+  uint32_t fields[] = { m_rrcTransactionIdentifier };
+  if (SerializeFromTemplate (&t, fields, sizeof (fields) / sizeof (fields[0])))
+    {
+      return;
+    }
+
   // Serialize DCCH message
   SerializeUlDcchMessage (2);
 
@@ -4973,6 +5009,7 @@ RrcConnectionReconfigurationCompleteHeader::PreSerialize () const
   SerializeSequence (std::bitset<0> (),false);
 
   // Serialize rrc-TransactionIdentifier
+  MarkTemplateField ();
   SerializeInteger (m_rrcTransactionIdentifier,0,3);
 
   // Serialize criticalExtensions choice
@@ -6217,6 +6254,14 @@ RrcConnectionReestablishmentCompleteHeader::PreSerialize () const
 {
   m_serializationResult = Buffer ();
 
+  // The layout of the message is constant: serialize it from its template
+  static Template t;
+  uint32_t fields[] = { m_rrcTransactionIdentifier };
+  if (SerializeFromTemplate (&t, fields, sizeof (fields) / sizeof (fields[0])))
+    {
+      return;
+    }
+
   // Serialize DCCH message
   SerializeUlDcchMessage (3);
 
@@ -6225,6 +6270,7 @@ RrcConnectionReestablishmentCompleteHeader::PreSerialize () const
   SerializeSequence (std::bitset<0> (),false);
 
   // Serialize rrc-TransactionIdentifier
+  MarkTemplateField ();
   SerializeInteger (m_rrcTransactionIdentifier,0,3);
 
   // Serialize criticalExtensions choice
@@ -6404,6 +6450,14 @@ RrcConnectionReleaseHeader::PreSerialize () const
 {
   m_serializationResult = Buffer ();
 
+  // The layout of the message is constant: serialize it from its template
+  static Template t;
+  uint32_t fields[] = { m_rrcConnectionRelease.rrcTransactionIdentifier };
+  if (SerializeFromTemplate (&t, fields, sizeof (fields) / sizeof (fields[0])))
+    {
+      return;
+    }
+
   // Serialize DCCH message
   SerializeDlDcchMessage (5);
 
@@ -6412,6 +6466,7 @@ RrcConnectionReleaseHeader::PreSerialize () const
   SerializeSequence (std::bitset<0> (),false);
 
   // Serialize rrc-TransactionIdentifier
+  MarkTemplateField ();
   SerializeInteger (m_rrcConnectionRelease.rrcTransactionIdentifier,0,3);
 
   // Serialize criticalExtensions choice
@@ -6529,6 +6584,14 @@ RrcConnectionRejectHeader::PreSerialize () const
 {
   m_serializationResult = Buffer ();
 
+  // The layout of the message is constant: serialize it from its template
+  static Template t;
+  uint32_t fields[] = { m_rrcConnectionReject.waitTime - 1u };
+  if (SerializeFromTemplate (&t, fields, sizeof (fields) / sizeof (fields[0])))
+    {
+      return;
+    }
+
   // Serialize CCCH message
   SerializeDlCcchMessage (2);
 
@@ -6547,6 +6610,7 @@ RrcConnectionRejectHeader::PreSerialize () const
   SerializeSequence (std::bitset<1> (0),false);
 
   // Serialize waitTime
+  MarkTemplateField ();
   SerializeInteger (m_rrcConnectionReject.waitTime, 1, 16);
 
   // Finish serialization
@@ -6637,6 +6701,71 @@ MeasurementReportHeader::PreSerialize () const
 {
   m_serializationResult = Buffer ();
 
+  // The layout of a report depends on which results it has: serialize it
+  // from the template of its layout, unless it has CGI info, whose size
+  // varies.  The layout is packed in a key of up to 1 + 4 + 2 * MAX_CELL_REPORT
+  // bits for the neighbour cells and 1 + 3 + 2 + 2 * MAX_SCELL_REPORT bits
+  // for the secondary cells, after a leading 1 bit.
+  static std::map<uint64_t, Template> templates;
+  const LteRrcSap::MeasResults &measResults = m_measurementReport.measResults;
+  uint64_t layout = 1;
+  uint32_t fields[3 + 3 * MAX_CELL_REPORT + 3 * MAX_SCELL_REPORT];
+  uint32_t numFields = 0;
+  bool useTemplate = true;
+  fields[numFields++] = measResults.measId - 1;
+  fields[numFields++] = measResults.rsrpResult;
+  fields[numFields++] = measResults.rsrqResult;
+  bool haveMeasResultNeighCells = measResults.haveMeasResultNeighCells
+    && !measResults.measResultListEutra.empty ();
+  layout = (layout << 1) | haveMeasResultNeighCells;
+  if (haveMeasResultNeighCells)
+    {
+      useTemplate &= (measResults.measResultListEutra.size () <= MAX_CELL_REPORT);
+      layout = (layout << 4) | measResults.measResultListEutra.size ();
+      std::list<LteRrcSap::MeasResultEutra>::const_iterator it;
+      for (it = measResults.measResultListEutra.begin ();
+           it != measResults.measResultListEutra.end () && useTemplate; it++)
+        {
+          useTemplate &= !it->haveCgiInfo;
+          layout = (layout << 2) | (it->haveRsrpResult * 2 + it->haveRsrqResult);
+          fields[numFields++] = it->physCellId;
+          if (it->haveRsrpResult)
+            {
+              fields[numFields++] = it->rsrpResult;
+            }
+          if (it->haveRsrqResult)
+            {
+              fields[numFields++] = it->rsrqResult;
+            }
+        }
+    }
+  layout = (layout << 1) | measResults.haveScellsMeas;
+  if (measResults.haveScellsMeas && useTemplate)
+    {
+      const LteRrcSap::MeasResultServFreqList &scells = measResults.measScellResultList;
+      useTemplate &= (scells.measResultScell.size () <= MAX_SCELL_REPORT);
+      layout = (layout << 3) | scells.measResultScell.size ();
+      layout = (layout << 2) | (scells.haveMeasurementResultsServingSCells * 2 + scells.haveMeasurementResultsNeighCell);
+      std::list<LteRrcSap::MeasResultScell>::const_iterator it;
+      for (it = scells.measResultScell.begin (); it != scells.measResultScell.end () && useTemplate; it++)
+        {
+          layout = (layout << 2) | (it->haveRsrpResult * 2 + it->haveRsrqResult);
+          fields[numFields++] = it->servFreqId;
+          if (it->haveRsrpResult)
+            {
+              fields[numFields++] = it->rsrpResult;
+            }
+          if (it->haveRsrqResult)
+            {
+              fields[numFields++] = it->rsrqResult;
+            }
+        }
+    }
+  if (useTemplate && SerializeFromTemplate (&templates[layout], fields, numFields))
+    {
+      return;
+    }
+
   // Serialize DCCH message
   SerializeUlDcchMessage (1);
 
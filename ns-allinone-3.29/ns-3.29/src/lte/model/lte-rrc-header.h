@@ -148,7 +148,7 @@ protected:
    *
    * \param measResults LteRrcSap::MeasResults
    */
-  void SerializeMeasResults (LteRrcSap::MeasResults measResults) const;
+  void SerializeMeasResults (const LteRrcSap::MeasResults &measResults) const;
   /**
    * Serialize PLMN identity function
    *
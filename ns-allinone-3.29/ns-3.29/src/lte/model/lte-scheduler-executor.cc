@@ -0,0 +1,276 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-scheduler-executor.h"
+
+#include <ns3/global-value.h>
+#include <ns3/uinteger.h>
+#include <ns3/simulator.h>
+#include <ns3/log.h>
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteSchedulerExecutor");
+
+/**
+ * \ingroup lte
+ * \brief Number of threads running the MAC schedulers besides the
+ * simulation thread.
+ */
+static GlobalValue g_lteSchedulerThreads =
+  GlobalValue ("LteSchedulerThreads",
+               "The number of worker threads which run the eNB MAC "
+               "schedulers of the same TTI together with the simulation "
+               "thread.  0 runs each scheduler in its subframe event.",
+               UintegerValue (0),
+               MakeUintegerChecker<uint32_t> ());
+
+namespace {
+
+/**
+ * \ingroup lte
+ * \brief The pool of threads of LteSchedulerExecutor, which exists
+ * from the first submitted job until Simulator::Destroy.
+ */
+class SchedulerThreadPool
+{
+public:
+  /**
+   * Start the worker threads.
+   *
+   * \param nThreads the number of worker threads
+   */
+  SchedulerThreadPool (uint32_t nThreads);
+  /// Stop and join the worker threads.
+  ~SchedulerThreadPool ();
+
+  /**
+   * Queue a job, scheduling the execution of the queue if it was empty.
+   *
+   * \param job the job
+   */
+  void Submit (LteSchedulerExecutor::Job *job);
+
+private:
+  /// A queued job.
+  struct Entry
+  {
+    LteSchedulerExecutor::Job *job; ///< the job
+    uint32_t context; ///< the context it was submitted from
+  };
+
+  /**
+   * Run the queued jobs, then schedule their merges, in the order of
+   * submission and in their original contexts.
+   */
+  void Execute (void);
+
+  /**
+   * Run the jobs of the current execution until there is none left.
+   */
+  void RunJobs (void);
+
+  /**
+   * Body of the worker threads.
+   */
+  void Work (void);
+
+  std::vector<Entry> m_queue; ///< the jobs submitted at the current time
+  std::vector<Entry> m_running; ///< the jobs of the current execution
+
+  std::vector<std::thread> m_workers; ///< the worker threads
+  std::mutex m_mutex; ///< protects the members below
+  std::condition_variable m_start; ///< notified when a generation starts
+  std::condition_variable m_done; ///< notified when the workers are done
+  uint64_t m_generation; ///< number of executions run by the workers
+  uint32_t m_next; ///< index of the next job to run
+  uint32_t m_active; ///< number of workers still running jobs
+  bool m_stop; ///< whether the workers should exit
+};
+
+SchedulerThreadPool::SchedulerThreadPool (uint32_t nThreads)
+  : m_generation (0),
+    m_next (0),
+    m_active (0),
+    m_stop (false)
+{
+  NS_LOG_FUNCTION (this << nThreads);
+  for (uint32_t i = 0; i < nThreads; ++i)
+    {
+      m_workers.push_back (std::thread (&SchedulerThreadPool::Work, this));
+    }
+}
+
+SchedulerThreadPool::~SchedulerThreadPool ()
+{
+  NS_LOG_FUNCTION (this);
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_start.notify_all ();
+  for (std::vector<std::thread>::iterator it = m_workers.begin (); it != m_workers.end (); ++it)
+    {
+      it->join ();
+    }
+}
+
+void
+SchedulerThreadPool::Submit (LteSchedulerExecutor::Job *job)
+{
+  NS_LOG_FUNCTION (this << job);
+  if (m_queue.empty ())
+    {
+      Simulator::ScheduleNow (&SchedulerThreadPool::Execute, this);
+    }
+  Entry entry;
+  entry.job = job;
+  entry.context = Simulator::GetContext ();
+  m_queue.push_back (entry);
+}
+
+void
+SchedulerThreadPool::Execute (void)
+{
+  NS_LOG_FUNCTION (this << m_queue.size ());
+  m_running.swap (m_queue);
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_next = 0;
+  }
+  if (m_workers.empty () || m_running.size () < 2)
+    {
+      RunJobs ();
+    }
+  else
+    {
+      {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_active = m_workers.size ();
+        ++m_generation;
+      }
+      m_start.notify_all ();
+      RunJobs ();
+      std::unique_lock<std::mutex> lock (m_mutex);
+      while (m_active > 0)
+        {
+          m_done.wait (lock);
+        }
+    }
+
+  for (std::vector<Entry>::const_iterator it = m_running.begin (); it != m_running.end (); ++it)
+    {
+      Simulator::ScheduleWithContext (it->context, Seconds (0),
+                                      &LteSchedulerExecutor::Job::Merge, it->job);
+    }
+  m_running.clear ();
+}
+
+void
+SchedulerThreadPool::RunJobs (void)
+{
+  while (true)
+    {
+      uint32_t i;
+      {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        i = m_next++;
+      }
+      if (i >= m_running.size ())
+        {
+          break;
+        }
+      m_running[i].job->Run ();
+    }
+}
+
+void
+SchedulerThreadPool::Work (void)
+{
+  uint64_t generation = 0;
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        while (!m_stop && m_generation == generation)
+          {
+            m_start.wait (lock);
+          }
+        if (m_stop)
+          {
+            return;
+          }
+        generation = m_generation;
+      }
+      RunJobs ();
+      std::lock_guard<std::mutex> lock (m_mutex);
+      if (--m_active == 0)
+        {
+          m_done.notify_one ();
+        }
+    }
+}
+
+/// The thread pool, if any.
+SchedulerThreadPool *g_pool = 0;
+
+/// Destroy the thread pool at Simulator::Destroy.
+void
+DestroyPool (void)
+{
+  delete g_pool;
+  g_pool = 0;
+}
+
+} // unnamed namespace
+
+
+LteSchedulerExecutor::Job::~Job ()
+{
+}
+
+bool
+LteSchedulerExecutor::IsEnabled (void)
+{
+  return GetNThreads () > 0;
+}
+
+uint32_t
+LteSchedulerExecutor::GetNThreads (void)
+{
+  UintegerValue nThreads;
+  g_lteSchedulerThreads.GetValue (nThreads);
+  return nThreads.Get ();
+}
+
+void
+LteSchedulerExecutor::Submit (Job *job)
+{
+  NS_LOG_FUNCTION (job);
+  if (g_pool == 0)
+    {
+      g_pool = new SchedulerThreadPool (GetNThreads ());
+      Simulator::ScheduleDestroy (&DestroyPool);
+    }
+  g_pool->Submit (job);
+}
+
+} // namespace ns3
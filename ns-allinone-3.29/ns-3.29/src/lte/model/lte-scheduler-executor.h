@@ -0,0 +1,86 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_SCHEDULER_EXECUTOR_H
+#define LTE_SCHEDULER_EXECUTOR_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * \brief Runs the MAC schedulers of all the cells of a TTI on a pool of
+ * threads.
+ *
+ * When the \c LteSchedulerThreads global value is not zero, each
+ * LteEnbMac submits the work of its scheduler for the current subframe
+ * as a Job instead of running it.  The first job submitted at a given
+ * time schedules an event, at the same time, which runs all the
+ * pending jobs concurrently on the calling thread and
+ * \c LteSchedulerThreads worker threads, then merges them one after
+ * the other, in the order in which they were submitted.
+ *
+ * Run () must only touch the state of its own cell, while Merge () is
+ * called from the simulation thread and may interact with the rest of
+ * the simulation.  Since the merge order only depends on the order of
+ * the subframe events, the results do not depend on the number of
+ * threads.
+ */
+class LteSchedulerExecutor
+{
+public:
+  /**
+   * \brief The work of one cell for one TTI.
+   */
+  class Job
+  {
+  public:
+    virtual ~Job ();
+
+    /**
+     * Do the work of the cell; called from any thread.
+     */
+    virtual void Run (void) = 0;
+
+    /**
+     * Apply the results of Run (); called from the simulation thread.
+     */
+    virtual void Merge (void) = 0;
+  };
+
+  /**
+   * \return true if the jobs should be submitted rather than run
+   */
+  static bool IsEnabled (void);
+
+  /**
+   * Submit a job, to be run and merged later at the current time.
+   *
+   * \param job the job, which must stay valid until merged
+   */
+  static void Submit (Job *job);
+
+  /**
+   * \return the number of worker threads
+   */
+  static uint32_t GetNThreads (void);
+};
+
+} // namespace ns3
+
+#endif /* LTE_SCHEDULER_EXECUTOR_H */
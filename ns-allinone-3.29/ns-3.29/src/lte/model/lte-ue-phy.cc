@@ -25,8 +25,11 @@
 #include <ns3/node.h>
 #include <cfloat>
 #include <cmath>
+#include <algorithm>
+#include <vector>
 #include <ns3/simulator.h>
 #include <ns3/double.h>
+#include <ns3/uinteger.h>
 #include "lte-ue-phy.h"
 #include "lte-enb-phy.h"
 #include "lte-net-device.h"
@@ -158,7 +161,12 @@ LteUePhy::LteUePhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
     m_pssReceived (false),
     m_ueMeasurementsFilterPeriod (MilliSeconds (200)),
     m_ueMeasurementsFilterLast (MilliSeconds (0)),
-    m_rsrpSinrSampleCounter (0)
+    m_numNeighbourCandidates (0),
+    m_measureAllCells (true),
+    m_rsrpSinrSampleCounter (0),
+    m_idleSubframeSkipping (false),
+    m_idleFrameNo (0),
+    m_idleSubframeNo (0)
 {
   m_amc = CreateObject <LteAmc> ();
   m_powerControl = CreateObject <LteUePowerControl> ();
@@ -183,6 +191,7 @@ void
 LteUePhy::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_idleEvent.Cancel ();
   delete m_uePhySapProvider;
   delete m_ueCphySapProvider;
   LtePhy::DoDispose ();
@@ -286,6 +295,22 @@ LteUePhy::GetTypeId (void)
                    TimeValue (MilliSeconds (200)),
                    MakeTimeAccessor (&LteUePhy::m_ueMeasurementsFilterPeriod),
                    MakeTimeChecker ())
+    .AddAttribute ("NeighbourCellCandidates",
+                   "The number of neighbour cells measured between two "
+                   "refreshes of the candidates, which are the strongest "
+                   "cells measured in the first layer-1 filtering period "
+                   "after each NeighbourCandidatesRefreshPeriod.  The other "
+                   "cells are neither measured nor reported.  If 0, all "
+                   "the cells are always measured.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&LteUePhy::m_numNeighbourCandidates),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("NeighbourCandidatesRefreshPeriod",
+                   "Time period between two measurements of all the cells "
+                   "to refresh the neighbour cell candidates.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&LteUePhy::m_neighbourCandidatesRefreshPeriod),
+                   MakeTimeChecker ())
     .AddTraceSource ("ReportUeMeasurements",
                      "Report UE measurements RSRP (dBm) and RSRQ (dB).",
                      MakeTraceSourceAccessor (&LteUePhy::m_reportUeMeasurements),
@@ -299,6 +324,15 @@ LteUePhy::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&LteUePhy::m_enableUplinkPowerControl),
                    MakeBooleanChecker ())
+    .AddAttribute ("IdleSubframeSkipping",
+                   "If true, the subframes which carry no PSS (all but the "
+                   "1st and 6th of each frame) are skipped while the UE has "
+                   "no RNTI and nothing is queued for transmission.  Frame "
+                   "and subframe numbers are preserved, and any activity "
+                   "resumes the subframes at the next subframe boundary.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteUePhy::m_idleSubframeSkipping),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -418,6 +452,7 @@ LteUePhy::DoSendMacPdu (Ptr<Packet> p)
   NS_LOG_FUNCTION (this);
 
   SetMacPdu (p);
+  WakeUp ();
 }
 
 
@@ -554,25 +589,26 @@ LteUePhy::GenerateCqiRsrpRsrq (const SpectrumValue& sinr)
       // measure instantaneous RSRQ now
       NS_ASSERT_MSG (m_rsInterferencePowerUpdated, " RS interference power info obsolete");
 
+      // the RSSI is the same for all the cells
+      uint16_t rbNum = 0;
+      double rssiSum = 0.0;
+
+      Values::const_iterator itIntN = m_rsInterferencePower.ConstValuesBegin ();
+      Values::const_iterator itPj = m_rsReceivedPower.ConstValuesBegin ();
+      for (itPj = m_rsReceivedPower.ConstValuesBegin ();
+           itPj != m_rsReceivedPower.ConstValuesEnd ();
+           itIntN++, itPj++)
+        {
+          rbNum++;
+          // convert PSD [W/Hz] to linear power [W] for the single RE
+          double interfPlusNoisePowerTxW = ((*itIntN) * 180000.0) / 12.0;
+          double signalPowerTxW = ((*itPj) * 180000.0) / 12.0;
+          rssiSum += (2 * (interfPlusNoisePowerTxW + signalPowerTxW));
+        }
+
       std::list <PssElement>::iterator itPss = m_pssList.begin ();
       while (itPss != m_pssList.end ())
         {
-          uint16_t rbNum = 0;
-          double rssiSum = 0.0;
-
-          Values::const_iterator itIntN = m_rsInterferencePower.ConstValuesBegin ();
-          Values::const_iterator itPj = m_rsReceivedPower.ConstValuesBegin ();
-          for (itPj = m_rsReceivedPower.ConstValuesBegin ();
-               itPj != m_rsReceivedPower.ConstValuesEnd ();
-               itIntN++, itPj++)
-            {
-              rbNum++;
-              // convert PSD [W/Hz] to linear power [W] for the single RE
-              double interfPlusNoisePowerTxW = ((*itIntN) * 180000.0) / 12.0;
-              double signalPowerTxW = ((*itPj) * 180000.0) / 12.0;
-              rssiSum += (2 * (interfPlusNoisePowerTxW + signalPowerTxW));
-            }
-
           NS_ASSERT (rbNum == (*itPss).nRB);
           double rsrq_dB = 10 * log10 ((*itPss).pssPsdSum / rssiSum);
 
@@ -809,8 +845,36 @@ LteUePhy::ReportUeMeasurements ()
   LteUeCphySapUser::UeMeasurementsParameters ret;
 
   std::map <uint16_t, UeMeasurementsElement>::iterator it;
+  if (m_numNeighbourCandidates > 0 && m_measureAllCells)
+    {
+      // refresh the candidates with the strongest neighbour cells
+      std::vector<std::pair<double, uint16_t> > neighbours;
+      for (it = m_ueMeasurementsMap.begin (); it != m_ueMeasurementsMap.end (); it++)
+        {
+          if ((*it).first != m_cellId)
+            {
+              double avg_rsrp = (*it).second.rsrpSum / (double)(*it).second.rsrpNum;
+              neighbours.push_back (std::make_pair (-avg_rsrp, (*it).first));
+            }
+        }
+      uint32_t numCandidates = std::min<uint32_t> (m_numNeighbourCandidates, neighbours.size ());
+      std::partial_sort (neighbours.begin (), neighbours.begin () + numCandidates, neighbours.end ());
+      m_neighbourCandidates.clear ();
+      for (uint32_t i = 0; i < numCandidates; i++)
+        {
+          m_neighbourCandidates.insert (neighbours[i].second);
+        }
+      m_neighbourCandidatesLastRefresh = Simulator::Now ();
+      NS_LOG_DEBUG (this << " refreshed " << numCandidates << " neighbour cell candidates among "
+                         << neighbours.size () << " cells");
+    }
+
   for (it = m_ueMeasurementsMap.begin (); it != m_ueMeasurementsMap.end (); it++)
     {
+      if (!IsMeasuredCell ((*it).first))
+        {
+          continue;
+        }
       double avg_rsrp = (*it).second.rsrpSum / (double)(*it).second.rsrpNum;
       double avg_rsrq = (*it).second.rsrqSum / (double)(*it).second.rsrqNum;
       /*
@@ -840,15 +904,26 @@ LteUePhy::ReportUeMeasurements ()
   m_ueCphySapUser->ReportUeMeasurements (ret);
 
   m_ueMeasurementsMap.clear ();
+  m_measureAllCells = (m_numNeighbourCandidates == 0)
+    || (Simulator::Now () - m_neighbourCandidatesLastRefresh >= m_neighbourCandidatesRefreshPeriod);
   Simulator::Schedule (m_ueMeasurementsFilterPeriod, &LteUePhy::ReportUeMeasurements, this);
 }
 
+bool
+LteUePhy::IsMeasuredCell (uint16_t cellId) const
+{
+  return m_numNeighbourCandidates == 0
+         || cellId == m_cellId
+         || m_neighbourCandidates.find (cellId) != m_neighbourCandidates.end ();
+}
+
 void
 LteUePhy::DoSendLteControlMessage (Ptr<LteControlMessage> msg)
 {
   NS_LOG_FUNCTION (this << msg);
 
   SetControlMessages (msg);
+  WakeUp ();
 }
 
 void 
@@ -862,6 +937,7 @@ LteUePhy::DoSendRachPreamble (uint32_t raPreambleId, uint32_t raRnti)
   m_raPreambleId = raPreambleId;
   m_raRnti = raRnti;
   m_controlMessagesQueue.at (0).push_back (msg);
+  WakeUp ();
 }
 
 
@@ -1024,6 +1100,12 @@ LteUePhy::ReceivePss (uint16_t cellId, Ptr<SpectrumValue> p)
 {
   NS_LOG_FUNCTION (this << cellId << (*p));
 
+  if (!m_measureAllCells && !IsMeasuredCell (cellId))
+    {
+      // not a neighbour cell candidate
+      return;
+    }
+
   double sum = 0.0;
   uint16_t nRB = 0;
   Values::const_iterator itPi;
@@ -1167,10 +1249,83 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     }
 
   // schedule next subframe indication
+  if (m_idleSubframeSkipping && IsIdle ())
+    {
+      // skip to the next subframe carrying the PSS, but not before the
+      // receptions of the current one end, since they may wake us up
+      // (e.g., the SIB1 triggering the random access)
+      uint32_t skipped = (subframeNo == 1 || subframeNo == 2 || subframeNo == 7) ? 0 : ((subframeNo <= 6 ? 6 : 11) - subframeNo);
+      if (skipped > 0)
+        {
+          NS_LOG_LOGIC (this << " UE skipping " << skipped << " idle subframes");
+          int64_t tti = Seconds (GetTti ()).GetTimeStep ();
+          m_idleStart = Simulator::Now () + TimeStep (tti);
+          m_idleFrameNo = frameNo;
+          m_idleSubframeNo = subframeNo;
+          m_idleEvent = Simulator::Schedule (TimeStep (tti * (skipped + 1)),
+                                             &LteUePhy::EndIdleSubframes,
+                                             this, skipped);
+          return;
+        }
+    }
   Simulator::Schedule (Seconds (GetTti ()), &LteUePhy::SubframeIndication, this, frameNo, subframeNo);
 }
 
 
+bool
+LteUePhy::IsIdle (void) const
+{
+  if (m_rnti > 0 || m_raRnti != 11)
+    {
+      // connected, or waiting for a RAR whose RA-RNTI depends on the
+      // subframe numbers seen by the MAC
+      return false;
+    }
+  for (uint32_t i = 0; i < m_controlMessagesQueue.size (); i++)
+    {
+      if (!m_controlMessagesQueue.at (i).empty () || m_packetBurstQueue.at (i)->GetNPackets () > 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+
+void
+LteUePhy::EndIdleSubframes (uint32_t skipped)
+{
+  NS_LOG_FUNCTION (this << skipped);
+  uint32_t frameNo = m_idleFrameNo;
+  uint32_t subframeNo = m_idleSubframeNo + skipped;
+  if (subframeNo > 10)
+    {
+      ++frameNo;
+      subframeNo -= 10;
+    }
+  SubframeIndication (frameNo, subframeNo);
+}
+
+
+void
+LteUePhy::WakeUp (void)
+{
+  if (!m_idleEvent.IsRunning ())
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  // resume at the first subframe boundary from now on
+  int64_t tti = Seconds (GetTti ()).GetTimeStep ();
+  int64_t elapsed = (Simulator::Now () - m_idleStart).GetTimeStep ();
+  uint32_t skipped = (elapsed > 0) ? static_cast<uint32_t> ((elapsed + tti - 1) / tti) : 0;
+  m_idleEvent.Cancel ();
+  m_idleEvent = Simulator::Schedule (m_idleStart + TimeStep (skipped * tti) - Simulator::Now (),
+                                     &LteUePhy::EndIdleSubframes,
+                                     this, skipped);
+}
+
+
 void
 LteUePhy::SendSrs ()
 {
@@ -1237,6 +1392,10 @@ LteUePhy::DoStartCellSearch (uint32_t dlEarfcn)
   m_dlEarfcn = dlEarfcn;
   DoSetDlBandwidth (6); // configure DL for receiving PSS
   SwitchToState (CELL_SEARCH);
+
+  // search all the cells until the next refresh of the candidates
+  m_neighbourCandidates.clear ();
+  m_measureAllCells = true;
 }
 
 void
@@ -1257,6 +1416,11 @@ LteUePhy::DoSynchronizeWithEnb (uint16_t cellId)
       NS_FATAL_ERROR ("Cell ID shall not be zero");
     }
 
+  if (m_cellId != 0 && m_numNeighbourCandidates > 0)
+    {
+      // keep measuring the previous serving cell, e.g., after a handover
+      m_neighbourCandidates.insert (m_cellId);
+    }
   m_cellId = cellId;
   m_downlinkSpectrumPhy->SetCellId (cellId);
   m_uplinkSpectrumPhy->SetCellId (cellId);
@@ -1321,6 +1485,7 @@ LteUePhy::DoSetRnti (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
   m_rnti = rnti;
+  WakeUp ();
 
   m_powerControl->SetCellId (m_cellId);
   m_powerControl->SetRnti (m_rnti);
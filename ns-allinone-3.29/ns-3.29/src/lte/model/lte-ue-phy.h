@@ -242,6 +242,27 @@ public:
   */
   void SubframeIndication (uint32_t frameNo, uint32_t subframeNo);
 
+  /**
+   * \brief Check whether the next subframes can be skipped
+   *
+   * \return true if the UE has no RNTI, is not performing a random
+   * access and no control message or MAC PDU is queued
+   */
+  bool IsIdle (void) const;
+
+  /**
+   * \brief End a run of idle subframes skipped by SubframeIndication
+   *
+   * \param skipped the number of subframes skipped
+   */
+  void EndIdleSubframes (uint32_t skipped);
+
+  /**
+   * \brief Resume the subframes at the next subframe boundary, if idle
+   * subframes are being skipped
+   */
+  void WakeUp (void);
+
 
   /**
    * \brief Send the SRS signal in the last symbols of the frame
@@ -381,6 +402,13 @@ private:
    */
   void ReportUeMeasurements ();
 
+  /**
+   * \param cellId the cell ID
+   * \return true if the cell is measured, i.e., if it is the serving cell
+   *         or a neighbour cell candidate, or if all the cells are measured
+   */
+  bool IsMeasuredCell (uint16_t cellId) const;
+
   /**
    * Switch the UE PHY to the given state.
    * \param s the destination state
@@ -566,6 +594,24 @@ private:
   /// \todo Can be removed.
   Time m_ueMeasurementsFilterLast;
 
+  /**
+   * The `NeighbourCellCandidates` attribute. The number of neighbour cells
+   * measured between two refreshes of the candidates, 0 to measure all the
+   * cells.
+   */
+  uint16_t m_numNeighbourCandidates;
+  /**
+   * The `NeighbourCandidatesRefreshPeriod` attribute. Time period between
+   * two measurements of all the cells to refresh the candidates.
+   */
+  Time m_neighbourCandidatesRefreshPeriod;
+  /// The neighbour cells measured until the next refresh.
+  std::set<uint16_t> m_neighbourCandidates;
+  /// Whether all the cells are measured in the current filtering period.
+  bool m_measureAllCells;
+  /// The time of the last refresh of the neighbour cell candidates.
+  Time m_neighbourCandidatesLastRefresh;
+
   Ptr<LteHarqPhy> m_harqPhyModule; ///< HARQ phy module
 
   uint32_t m_raPreambleId; ///< RA preamble ID
@@ -598,6 +644,16 @@ private:
 
   EventId m_sendSrsEvent; ///< send SRS event
 
+  /**
+   * The `IdleSubframeSkipping` attribute. Skip the subframes without PSS
+   * while the UE is idle.
+   */
+  bool m_idleSubframeSkipping;
+  EventId m_idleEvent; ///< end of the idle subframes being skipped
+  Time m_idleStart; ///< start of the first idle subframe skipped
+  uint32_t m_idleFrameNo; ///< frame number of the first idle subframe skipped
+  uint32_t m_idleSubframeNo; ///< number of the first idle subframe skipped
+
   /**
    * The `UlPhyTransmission` trace source. Contains trace information regarding
    * PHY stats from UL Tx perspective. Exporting a structure with type
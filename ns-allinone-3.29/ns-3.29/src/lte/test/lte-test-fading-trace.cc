@@ -0,0 +1,120 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/lte-fading-trace.h"
+
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestFadingTrace");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test the generation of a fading trace, its conversion to the
+ * text and binary formats, and the sharing of the loaded traces.
+ */
+class LteFadingTraceTestCase : public TestCase
+{
+public:
+  LteFadingTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteFadingTraceTestCase::LteFadingTraceTestCase ()
+  : TestCase ("Generate, write and load fading traces")
+{
+}
+
+void
+LteFadingTraceTestCase::DoRun (void)
+{
+  const uint32_t rbNum = 25;
+  const uint32_t samplesNum = 2000;
+
+  // EPA profile at 50 km/h and 2.16 GHz
+  double d[] = { 0, 30e-9, 70e-9, 90e-9, 120e-9, 190e-9, 410e-9 };
+  double p[] = { 0.0, -1.0, -2.0, -3.0, -8.0, -17.2, -20.8 };
+  std::vector<double> delays (d, d + 7);
+  std::vector<double> powers (p, p + 7);
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  Ptr<LteFadingTrace> generated = LteFadingTrace::Generate (delays, powers, 100.0, Seconds (2),
+                                                            rbNum, samplesNum, random);
+
+  // the average gain is 0 dB
+  double sum = 0;
+  for (uint32_t rb = 0; rb < rbNum; rb++)
+    {
+      for (uint32_t s = 0; s < samplesNum; s++)
+        {
+          sum += std::pow (10, generated->GetValue (rb, s) / 10);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (sum / (rbNum * samplesNum), 1.0, 0.3, "Wrong average gain");
+
+  std::string textFile = CreateTempDirFilename ("fading-trace.fad");
+  std::string binaryFile = CreateTempDirFilename ("fading-trace.bin");
+  generated->WriteText (textFile);
+  generated->WriteBinary (binaryFile);
+
+  Ptr<const LteFadingTrace> text = LteFadingTrace::Load (textFile, rbNum, samplesNum);
+  Ptr<const LteFadingTrace> binary = LteFadingTrace::Load (binaryFile, rbNum, samplesNum);
+  NS_TEST_ASSERT_MSG_EQ (binary->GetRbNum (), rbNum, "Wrong number of RBs");
+  NS_TEST_ASSERT_MSG_EQ (binary->GetSamplesNum (), samplesNum, "Wrong number of samples");
+  for (uint32_t rb = 0; rb < rbNum; rb++)
+    {
+      for (uint32_t s = 0; s < samplesNum; s++)
+        {
+          double value = generated->GetValue (rb, s);
+          NS_TEST_ASSERT_MSG_EQ_TOL (text->GetValue (rb, s), value, 1e-4, "Wrong text sample");
+          NS_TEST_ASSERT_MSG_EQ_TOL (binary->GetValue (rb, s), value, 1e-4, "Wrong binary sample");
+        }
+    }
+
+  // the traces are shared while loaded
+  NS_TEST_ASSERT_MSG_EQ (LteFadingTrace::Load (binaryFile, rbNum, samplesNum), binary,
+                         "Binary trace loaded twice");
+  NS_TEST_ASSERT_MSG_EQ (LteFadingTrace::Load (textFile, rbNum, samplesNum), text,
+                         "Text trace loaded twice");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Fading trace test suite
+ */
+class LteFadingTraceTestSuite : public TestSuite
+{
+public:
+  LteFadingTraceTestSuite ();
+};
+
+LteFadingTraceTestSuite::LteFadingTraceTestSuite ()
+  : TestSuite ("lte-fading-trace", UNIT)
+{
+  AddTestCase (new LteFadingTraceTestCase, TestCase::QUICK);
+}
+
+static LteFadingTraceTestSuite g_lteFadingTraceTestSuite; ///< the test suite
@@ -0,0 +1,157 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestIdleSubframeSkipping");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that skipping the idle subframes of the eNB and UE PHYs
+ * does not change when a UE attaching in the middle of a frame gets
+ * connected, nor the subframe in which the eNB MAC sees it.
+ */
+class LteIdleSubframeSkippingTestCase : public TestCase
+{
+public:
+  LteIdleSubframeSkippingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario.
+   *
+   * \param skipping whether idle subframes are skipped
+   * \return the time the connection was established
+   */
+  Time RunScenario (bool skipping);
+
+  /**
+   * Connection established callback.
+   *
+   * \param context the context
+   * \param imsi the IMSI
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   */
+  void ConnectionEstablished (std::string context, uint64_t imsi,
+                              uint16_t cellId, uint16_t rnti);
+
+  Time m_established; ///< the time the connection was established
+};
+
+LteIdleSubframeSkippingTestCase::LteIdleSubframeSkippingTestCase ()
+  : TestCase ("Idle subframe skipping preserves the RRC connection timing")
+{
+}
+
+void
+LteIdleSubframeSkippingTestCase::ConnectionEstablished (std::string context, uint64_t imsi,
+                                                        uint16_t cellId, uint16_t rnti)
+{
+  m_established = Simulator::Now ();
+}
+
+Time
+LteIdleSubframeSkippingTestCase::RunScenario (bool skipping)
+{
+  Config::SetDefault ("ns3::LteEnbPhy::IdleSubframeSkipping", BooleanValue (skipping));
+  Config::SetDefault ("ns3::LteUePhy::IdleSubframeSkipping", BooleanValue (skipping));
+  m_established = Seconds (0);
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("UseIdealRrc", BooleanValue (false));
+
+  // the second eNB stays idle for the whole run
+  NodeContainer enbNodes;
+  enbNodes.Create (2);
+  NodeContainer ueNodes;
+  ueNodes.Create (1);
+
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0, 0, 0));
+  positionAlloc->Add (Vector (1000, 0, 0));
+  positionAlloc->Add (Vector (10, 0, 0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, 100);
+
+  // attach in the middle of a frame, while both sides skip subframes
+  void (LteHelper::*attach) (Ptr<NetDevice>, Ptr<NetDevice>) = &LteHelper::Attach;
+  Simulator::Schedule (MilliSeconds (123) + MicroSeconds (400), attach, lteHelper,
+                       ueDevs.Get (0), enbDevs.Get (0));
+
+  Config::Connect ("/NodeList/*/DeviceList/*/LteUeRrc/ConnectionEstablished",
+                   MakeCallback (&LteIdleSubframeSkippingTestCase::ConnectionEstablished, this));
+
+  Simulator::Stop (MilliSeconds (500));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_established;
+}
+
+void
+LteIdleSubframeSkippingTestCase::DoRun (void)
+{
+  Time reference = RunScenario (false);
+  Time skipping = RunScenario (true);
+
+  NS_TEST_ASSERT_MSG_GT (reference, MilliSeconds (123), "Connection not established");
+  NS_TEST_ASSERT_MSG_EQ (skipping, reference, "Connection established at another time");
+
+  Config::SetDefault ("ns3::LteEnbPhy::IdleSubframeSkipping", BooleanValue (false));
+  Config::SetDefault ("ns3::LteUePhy::IdleSubframeSkipping", BooleanValue (false));
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Idle subframe skipping test suite
+ */
+class LteIdleSubframeSkippingTestSuite : public TestSuite
+{
+public:
+  LteIdleSubframeSkippingTestSuite ();
+};
+
+LteIdleSubframeSkippingTestSuite::LteIdleSubframeSkippingTestSuite ()
+  : TestSuite ("lte-idle-subframe-skipping", SYSTEM)
+{
+  AddTestCase (new LteIdleSubframeSkippingTestCase, TestCase::QUICK);
+}
+
+static LteIdleSubframeSkippingTestSuite g_lteIdleSubframeSkippingTestSuite; ///< the test suite
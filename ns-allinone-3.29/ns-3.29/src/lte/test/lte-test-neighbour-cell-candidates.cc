@@ -0,0 +1,182 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/callback.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-ue-net-device.h"
+#include "ns3/lte-ue-phy.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+
+#include <map>
+#include <set>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestNeighbourCellCandidates");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that a UE measures and reports only its serving cell and the
+ * strongest neighbour cells when the number of neighbour cell candidates
+ * is limited.
+ */
+class LteNeighbourCellCandidatesTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param numCandidates the number of neighbour cell candidates, 0 for all
+   */
+  LteNeighbourCellCandidatesTestCase (uint16_t numCandidates);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Build the name of the test case.
+   *
+   * \param numCandidates the number of neighbour cell candidates
+   * \return the name
+   */
+  static std::string BuildNameString (uint16_t numCandidates);
+
+  /**
+   * Callback of the ReportUeMeasurements trace of the UE PHY.
+   *
+   * \param rnti the RNTI of the UE
+   * \param cellId the measured cell
+   * \param rsrp the RSRP [dBm]
+   * \param rsrq the RSRQ [dB]
+   * \param isServingCell whether the cell is the serving cell
+   * \param componentCarrierId the component carrier ID
+   */
+  void ReportUeMeasurements (uint16_t rnti, uint16_t cellId, double rsrp, double rsrq,
+                             bool isServingCell, uint8_t componentCarrierId);
+
+  uint16_t m_numCandidates; ///< the number of neighbour cell candidates
+  std::map<int64_t, std::set<uint16_t> > m_reportedCells; ///< the reported cells, by time of the report
+};
+
+std::string
+LteNeighbourCellCandidatesTestCase::BuildNameString (uint16_t numCandidates)
+{
+  std::ostringstream oss;
+  oss << "Neighbour cell candidates: " << numCandidates;
+  return oss.str ();
+}
+
+LteNeighbourCellCandidatesTestCase::LteNeighbourCellCandidatesTestCase (uint16_t numCandidates)
+  : TestCase (BuildNameString (numCandidates)),
+    m_numCandidates (numCandidates)
+{
+}
+
+void
+LteNeighbourCellCandidatesTestCase::ReportUeMeasurements (uint16_t rnti, uint16_t cellId,
+                                                          double rsrp, double rsrq,
+                                                          bool isServingCell,
+                                                          uint8_t componentCarrierId)
+{
+  m_reportedCells[Simulator::Now ().GetMilliSeconds ()].insert (cellId);
+}
+
+void
+LteNeighbourCellCandidatesTestCase::DoRun (void)
+{
+  const uint32_t numEnbs = 7;
+  Config::SetDefault ("ns3::LteUePhy::NeighbourCellCandidates", UintegerValue (m_numCandidates));
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+
+  // the eNBs are on a line, increasingly far from the UE
+  NodeContainer enbNodes;
+  enbNodes.Create (numEnbs);
+  NodeContainer ueNodes;
+  ueNodes.Create (1);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < numEnbs; ++i)
+    {
+      positionAlloc->Add (Vector (100.0 * (i + 1), 0.0, 0.0));
+    }
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->Attach (ueDevs.Get (0), enbDevs.Get (0));
+
+  Ptr<LteUePhy> uePhy = ueDevs.Get (0)->GetObject<LteUeNetDevice> ()->GetPhy ();
+  uePhy->TraceConnectWithoutContext ("ReportUeMeasurements",
+                                     MakeCallback (&LteNeighbourCellCandidatesTestCase::ReportUeMeasurements,
+                                                   this));
+
+  Simulator::Stop (Seconds (2.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  Config::SetDefault ("ns3::LteUePhy::NeighbourCellCandidates", UintegerValue (0));
+
+  // the serving cell is the closest one, and the cell IDs increase with
+  // the distance
+  uint32_t numReportedCells = (m_numCandidates > 0) ? m_numCandidates + 1 : numEnbs;
+  NS_TEST_ASSERT_MSG_GT (m_reportedCells.size (), 10, "Too few measurement reports");
+  std::map<int64_t, std::set<uint16_t> >::const_iterator it;
+  for (it = m_reportedCells.begin (); it != m_reportedCells.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (it->second.size (), numReportedCells,
+                             "Wrong number of cells reported at " << it->first << " ms");
+      NS_TEST_ASSERT_MSG_EQ (*it->second.begin (), 1,
+                             "Wrong strongest cell reported at " << it->first << " ms");
+      NS_TEST_ASSERT_MSG_EQ (*it->second.rbegin (), numReportedCells,
+                             "Wrong weakest cell reported at " << it->first << " ms");
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Neighbour cell candidates test suite
+ */
+class LteNeighbourCellCandidatesTestSuite : public TestSuite
+{
+public:
+  LteNeighbourCellCandidatesTestSuite ();
+};
+
+LteNeighbourCellCandidatesTestSuite::LteNeighbourCellCandidatesTestSuite ()
+  : TestSuite ("lte-neighbour-cell-candidates", SYSTEM)
+{
+  AddTestCase (new LteNeighbourCellCandidatesTestCase (0), TestCase::QUICK);
+  AddTestCase (new LteNeighbourCellCandidatesTestCase (2), TestCase::QUICK);
+}
+
+static LteNeighbourCellCandidatesTestSuite g_lteNeighbourCellCandidatesTestSuite; ///< the test suite
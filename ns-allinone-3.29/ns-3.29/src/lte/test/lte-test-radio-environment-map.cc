@@ -0,0 +1,189 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/radio-environment-map-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestRadioEnvironmentMap");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that the direct computation of a REM gives the same map as
+ * its simulation.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param numThreads the number of threads of the direct computation
+   * \param tileSize the number of points per tile of the direct computation
+   */
+  LteRadioEnvironmentMapTestCase (uint32_t numThreads, uint32_t tileSize);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Build the name of the test case.
+   *
+   * \param numThreads the number of threads of the direct computation
+   * \param tileSize the number of points per tile of the direct computation
+   * \return the name
+   */
+  static std::string BuildNameString (uint32_t numThreads, uint32_t tileSize);
+
+  /**
+   * Generate a REM of three sectors.
+   *
+   * \param direct whether to compute the REM directly
+   * \param fileName the output file
+   * \return the lines of the output file
+   */
+  std::vector<std::string> GenerateRem (bool direct, std::string fileName);
+
+  uint32_t m_numThreads; ///< the number of threads of the direct computation
+  uint32_t m_tileSize; ///< the number of points per tile of the direct computation
+};
+
+std::string
+LteRadioEnvironmentMapTestCase::BuildNameString (uint32_t numThreads, uint32_t tileSize)
+{
+  std::ostringstream oss;
+  oss << "Direct REM computation, " << numThreads << " threads, tiles of " << tileSize << " points";
+  return oss.str ();
+}
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase (uint32_t numThreads, uint32_t tileSize)
+  : TestCase (BuildNameString (numThreads, tileSize)),
+    m_numThreads (numThreads),
+    m_tileSize (tileSize)
+{
+}
+
+std::vector<std::string>
+LteRadioEnvironmentMapTestCase::GenerateRem (bool direct, std::string fileName)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetEnbAntennaModelType ("ns3::CosineAntennaModel");
+  lteHelper->SetEnbAntennaModelAttribute ("Beamwidth", DoubleValue (65));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+
+  NetDeviceContainer enbDevs;
+  for (uint32_t i = 0; i < enbNodes.GetN (); ++i)
+    {
+      lteHelper->SetEnbAntennaModelAttribute ("Orientation", DoubleValue (120.0 * i));
+      enbDevs.Add (lteHelper->InstallEnbDevice (enbNodes.Get (i)));
+    }
+
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue ("/ChannelList/0"));
+  remHelper->SetAttribute ("OutputFile", StringValue (fileName));
+  remHelper->SetAttribute ("XMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (200.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (21));
+  remHelper->SetAttribute ("YMin", DoubleValue (-150.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (150.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (16));
+  remHelper->SetAttribute ("Z", DoubleValue (1.5));
+  if (direct)
+    {
+      remHelper->SetAttribute ("DirectComputation", BooleanValue (true));
+      remHelper->SetAttribute ("NumThreads", UintegerValue (m_numThreads));
+      remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (m_tileSize));
+    }
+  remHelper->Install ();
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::vector<std::string> lines;
+  std::ifstream in (fileName.c_str ());
+  std::string line;
+  while (std::getline (in, line))
+    {
+      lines.push_back (line);
+    }
+  return lines;
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun (void)
+{
+  std::vector<std::string> simulated = GenerateRem (false, CreateTempDirFilename ("rem-simulated.out"));
+  std::vector<std::string> computed = GenerateRem (true, CreateTempDirFilename ("rem-computed.out"));
+
+  NS_TEST_ASSERT_MSG_EQ (simulated.size (), 21 * 16, "Wrong number of simulated points");
+  NS_TEST_ASSERT_MSG_EQ (computed.size (), simulated.size (), "Wrong number of computed points");
+  for (uint32_t i = 0; i < simulated.size () && i < computed.size (); ++i)
+    {
+      std::istringstream s (simulated[i]);
+      std::istringstream c (computed[i]);
+      double sx, sy, sz, ssinr;
+      double cx, cy, cz, csinr;
+      s >> sx >> sy >> sz >> ssinr;
+      c >> cx >> cy >> cz >> csinr;
+      NS_TEST_ASSERT_MSG_EQ (cx, sx, "Wrong x at line " << i);
+      NS_TEST_ASSERT_MSG_EQ (cy, sy, "Wrong y at line " << i);
+      NS_TEST_ASSERT_MSG_EQ (cz, sz, "Wrong z at line " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (csinr, ssinr, ssinr * 1e-4, "Wrong SINR at line " << i);
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Radio environment map test suite
+ */
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+public:
+  LteRadioEnvironmentMapTestSuite ();
+};
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite ()
+  : TestSuite ("lte-radio-environment-map", SYSTEM)
+{
+  AddTestCase (new LteRadioEnvironmentMapTestCase (1, 20000), TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase (3, 50), TestCase::QUICK);
+}
+
+static LteRadioEnvironmentMapTestSuite g_lteRadioEnvironmentMapTestSuite; ///< the test suite
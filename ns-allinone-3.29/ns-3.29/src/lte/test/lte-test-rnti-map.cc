@@ -0,0 +1,238 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/lte-rnti-map.h"
+
+#include <map>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestRntiMap");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that an LteRntiMap behaves as a std::map keyed by RNTI, when
+ * erasing entries while iterating over the map.
+ */
+class LteRntiMapEraseTestCase : public TestCase
+{
+public:
+  LteRntiMapEraseTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteRntiMapEraseTestCase::LteRntiMapEraseTestCase ()
+  : TestCase ("Erase while iterating")
+{
+}
+
+void
+LteRntiMapEraseTestCase::DoRun (void)
+{
+  LteRntiMap<uint32_t> map;
+  for (uint16_t rnti = 1; rnti <= 10; ++rnti)
+    {
+      map.insert (std::pair<uint16_t, uint32_t> (rnti, rnti * 100));
+    }
+
+  // erase the even RNTIs as the schedulers do
+  LteRntiMap<uint32_t>::iterator it = map.begin ();
+  while (it != map.end ())
+    {
+      if ((*it).first % 2 == 0)
+        {
+          LteRntiMap<uint32_t>::iterator temp = it;
+          it++;
+          map.erase (temp);
+        }
+      else
+        {
+          it++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (map.size (), 5, "Wrong size after erasing");
+  uint16_t expected = 1;
+  for (it = map.begin (); it != map.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (it->first, expected, "Wrong RNTI");
+      NS_TEST_ASSERT_MSG_EQ (it->second, expected * 100u, "Wrong value");
+      expected += 2;
+    }
+  NS_TEST_ASSERT_MSG_EQ ((map.find (4) == map.end ()), true, "Erased RNTI found");
+
+  // inserting an erased RNTI again reuses its position, out of order
+  // insertions keep the RNTIs sorted
+  map.insert (std::pair<uint16_t, uint32_t> (4, 4));
+  map[12] = 12;
+  map[2] = 2;
+  map.insert (std::pair<uint16_t, uint32_t> (3, 0));
+  uint16_t rntis[] = {1, 2, 3, 4, 5, 7, 9, 12};
+  uint32_t values[] = {100, 2, 300, 4, 500, 700, 900, 12};
+  uint32_t i = 0;
+  for (it = map.begin (); it != map.end (); ++it, ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (it->first, rntis[i], "Wrong RNTI after insertion");
+      NS_TEST_ASSERT_MSG_EQ (it->second, values[i], "Wrong value after insertion");
+      NS_TEST_ASSERT_MSG_EQ ((map.find (rntis[i]) == it), true, "Wrong position after insertion");
+    }
+  NS_TEST_ASSERT_MSG_EQ (i, 8, "Wrong number of entries after insertion");
+  NS_TEST_ASSERT_MSG_EQ (map.erase (6), 0, "Erased a missing RNTI");
+  NS_TEST_ASSERT_MSG_EQ (map.erase (7), 1, "Did not erase an RNTI");
+  NS_TEST_ASSERT_MSG_EQ (map.count (7), 0, "Erased RNTI counted");
+  map.clear ();
+  NS_TEST_ASSERT_MSG_EQ (map.empty (), true, "Map not empty after clear");
+  NS_TEST_ASSERT_MSG_EQ ((map.begin () == map.end ()), true, "Iterating over an empty map");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that an LteRntiMap holds the same entries as a std::map keyed
+ * by RNTI after a random sequence of insertions and erasures.
+ */
+class LteRntiMapRandomTestCase : public TestCase
+{
+public:
+  LteRntiMapRandomTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteRntiMapRandomTestCase::LteRntiMapRandomTestCase ()
+  : TestCase ("Random insertions and erasures")
+{
+}
+
+void
+LteRntiMapRandomTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+
+  LteRntiMap<std::vector<double> > map;
+  std::map<uint16_t, std::vector<double> > reference;
+  for (uint32_t op = 0; op < 5000; ++op)
+    {
+      uint16_t rnti = random->GetInteger (1, 200);
+      uint32_t action = random->GetInteger (0, 2);
+      if (action == 0)
+        {
+          std::vector<double> value (3, op);
+          bool inserted = map.insert (std::pair<uint16_t, std::vector<double> > (rnti, value)).second;
+          bool refInserted = reference.insert (std::pair<uint16_t, std::vector<double> > (rnti, value)).second;
+          NS_TEST_ASSERT_MSG_EQ (inserted, refInserted, "Wrong insertion of RNTI " << rnti);
+        }
+      else if (action == 1)
+        {
+          NS_TEST_ASSERT_MSG_EQ (map.erase (rnti), reference.erase (rnti), "Wrong erasure of RNTI " << rnti);
+        }
+      else
+        {
+          map[rnti].push_back (op);
+          reference[rnti].push_back (op);
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (map.size (), reference.size (), "Wrong size");
+      LteRntiMap<std::vector<double> >::const_iterator it = map.begin ();
+      std::map<uint16_t, std::vector<double> >::const_iterator refIt = reference.begin ();
+      for (; refIt != reference.end (); ++it, ++refIt)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((it == map.end ()), false, "Missing entries");
+          NS_TEST_ASSERT_MSG_EQ (it->first, refIt->first, "Wrong RNTI");
+          NS_TEST_ASSERT_MSG_EQ ((it->second == refIt->second), true, "Wrong value of RNTI " << refIt->first);
+        }
+      NS_TEST_ASSERT_MSG_EQ ((it == map.end ()), true, "Extra entries");
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that the free positions of an LteRntiMap are reclaimed when
+ * UEs keep attaching with new RNTIs and detaching, which never inserts out
+ * of order.
+ */
+class LteRntiMapChurnTestCase : public TestCase
+{
+public:
+  LteRntiMapChurnTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteRntiMapChurnTestCase::LteRntiMapChurnTestCase ()
+  : TestCase ("Attach and detach with new RNTIs")
+{
+}
+
+void
+LteRntiMapChurnTestCase::DoRun (void)
+{
+  const uint16_t nUes = 10;
+  LteRntiMap<uint32_t> map;
+  for (uint16_t rnti = 1; rnti < 20000; ++rnti)
+    {
+      map[rnti] = rnti;
+      if (rnti > nUes)
+        {
+          NS_TEST_ASSERT_MSG_EQ (map.erase (rnti - nUes), 1, "Did not erase RNTI " << rnti - nUes);
+        }
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (map.GetStorageSize (), 2 * map.size () + 1u,
+                                   "Free positions not reclaimed after RNTI " << rnti);
+    }
+  NS_TEST_ASSERT_MSG_EQ (map.size (), nUes, "Wrong size");
+  uint16_t expected = 20000 - nUes;
+  for (LteRntiMap<uint32_t>::const_iterator it = map.begin (); it != map.end (); ++it, ++expected)
+    {
+      NS_TEST_ASSERT_MSG_EQ (it->first, expected, "Wrong RNTI");
+      NS_TEST_ASSERT_MSG_EQ (it->second, expected, "Wrong value");
+      NS_TEST_ASSERT_MSG_EQ ((map.find (expected) == it), true, "Wrong position of RNTI " << expected);
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief LteRntiMap test suite
+ */
+class LteRntiMapTestSuite : public TestSuite
+{
+public:
+  LteRntiMapTestSuite ();
+};
+
+LteRntiMapTestSuite::LteRntiMapTestSuite ()
+  : TestSuite ("lte-rnti-map", UNIT)
+{
+  AddTestCase (new LteRntiMapEraseTestCase (), TestCase::QUICK);
+  AddTestCase (new LteRntiMapRandomTestCase (), TestCase::QUICK);
+  AddTestCase (new LteRntiMapChurnTestCase (), TestCase::QUICK);
+}
+
+static LteRntiMapTestSuite g_lteRntiMapTestSuite; ///< the test suite
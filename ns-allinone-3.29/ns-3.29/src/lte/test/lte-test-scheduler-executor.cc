@@ -0,0 +1,227 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/global-value.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-common.h"
+#include "ns3/eps-bearer.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestSchedulerExecutor");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that running the MAC schedulers of several cells on
+ * worker threads gives the same DL and UL allocations as running them
+ * in the subframe events.
+ */
+class LteSchedulerExecutorTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param nThreads the number of worker threads
+   */
+  LteSchedulerExecutorTestCase (uint32_t nThreads);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Build the name of the test case.
+   *
+   * \param nThreads the number of worker threads
+   * \return the name
+   */
+  static std::string BuildNameString (uint32_t nThreads);
+
+  /**
+   * Run the scenario.
+   *
+   * \param nThreads the number of worker threads
+   * \return the DL and UL allocations, one per line
+   */
+  std::vector<std::string> RunScenario (uint32_t nThreads);
+
+  /**
+   * DL scheduling callback.
+   *
+   * \param context the context
+   * \param info the scheduling information
+   */
+  void DlScheduling (std::string context, DlSchedulingCallbackInfo info);
+
+  /**
+   * UL scheduling callback.
+   *
+   * \param context the context
+   * \param frameNo the frame number
+   * \param subframeNo the subframe number
+   * \param rnti the RNTI
+   * \param mcs the MCS
+   * \param size the TB size
+   * \param componentCarrierId the component carrier ID
+   */
+  void UlScheduling (std::string context, uint32_t frameNo, uint32_t subframeNo,
+                     uint16_t rnti, uint8_t mcs, uint16_t size, uint8_t componentCarrierId);
+
+  uint32_t m_nThreads; ///< the number of worker threads
+  std::vector<std::string> m_allocations; ///< the allocations of the current run
+};
+
+std::string
+LteSchedulerExecutorTestCase::BuildNameString (uint32_t nThreads)
+{
+  std::ostringstream oss;
+  oss << "Schedulers run by " << nThreads << " worker threads";
+  return oss.str ();
+}
+
+LteSchedulerExecutorTestCase::LteSchedulerExecutorTestCase (uint32_t nThreads)
+  : TestCase (BuildNameString (nThreads)),
+    m_nThreads (nThreads)
+{
+}
+
+void
+LteSchedulerExecutorTestCase::DlScheduling (std::string context, DlSchedulingCallbackInfo info)
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetTimeStep () << " " << context
+      << " DL " << info.frameNo << " " << info.subframeNo << " " << info.rnti
+      << " " << (uint16_t) info.mcsTb1 << " " << info.sizeTb1
+      << " " << (uint16_t) info.mcsTb2 << " " << info.sizeTb2;
+  m_allocations.push_back (oss.str ());
+}
+
+void
+LteSchedulerExecutorTestCase::UlScheduling (std::string context, uint32_t frameNo, uint32_t subframeNo,
+                                            uint16_t rnti, uint8_t mcs, uint16_t size, uint8_t componentCarrierId)
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetTimeStep () << " " << context
+      << " UL " << frameNo << " " << subframeNo << " " << rnti
+      << " " << (uint16_t) mcs << " " << size;
+  m_allocations.push_back (oss.str ());
+}
+
+std::vector<std::string>
+LteSchedulerExecutorTestCase::RunScenario (uint32_t nThreads)
+{
+  Config::SetGlobal ("LteSchedulerThreads", UintegerValue (nThreads));
+  Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
+  m_allocations.clear ();
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetSchedulerType ("ns3::PfFfMacScheduler");
+
+  // three interfering cells with two UEs each
+  const uint32_t nEnbs = 3;
+  const uint32_t nUesPerEnb = 2;
+  NodeContainer enbNodes;
+  enbNodes.Create (nEnbs);
+  NodeContainer ueNodes;
+  ueNodes.Create (nEnbs * nUesPerEnb);
+
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < nEnbs; ++i)
+    {
+      positionAlloc->Add (Vector (500.0 * i, 0, 0));
+    }
+  for (uint32_t i = 0; i < nEnbs * nUesPerEnb; ++i)
+    {
+      positionAlloc->Add (Vector (500.0 * (i / nUesPerEnb) + 50.0 + 100.0 * (i % nUesPerEnb), 20, 0));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, 100);
+
+  for (uint32_t i = 0; i < ueDevs.GetN (); ++i)
+    {
+      lteHelper->Attach (ueDevs.Get (i), enbDevs.Get (i / nUesPerEnb));
+    }
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  Config::Connect ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbMac/DlScheduling",
+                   MakeCallback (&LteSchedulerExecutorTestCase::DlScheduling, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbMac/UlScheduling",
+                   MakeCallback (&LteSchedulerExecutorTestCase::UlScheduling, this));
+
+  Simulator::Stop (MilliSeconds (200));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_allocations;
+}
+
+void
+LteSchedulerExecutorTestCase::DoRun (void)
+{
+  std::vector<std::string> reference = RunScenario (0);
+  std::vector<std::string> parallel = RunScenario (m_nThreads);
+  Config::SetGlobal ("LteSchedulerThreads", UintegerValue (0));
+
+  NS_TEST_ASSERT_MSG_GT (reference.size (), 1000, "Too few allocations");
+  NS_TEST_ASSERT_MSG_EQ (parallel.size (), reference.size (), "Different number of allocations");
+  for (uint32_t i = 0; i < reference.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (parallel[i], reference[i], "Different allocation");
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief LteSchedulerExecutor test suite
+ */
+class LteSchedulerExecutorTestSuite : public TestSuite
+{
+public:
+  LteSchedulerExecutorTestSuite ();
+};
+
+LteSchedulerExecutorTestSuite::LteSchedulerExecutorTestSuite ()
+  : TestSuite ("lte-scheduler-executor", SYSTEM)
+{
+  AddTestCase (new LteSchedulerExecutorTestCase (1), TestCase::QUICK);
+  AddTestCase (new LteSchedulerExecutorTestCase (4), TestCase::QUICK);
+}
+
+static LteSchedulerExecutorTestSuite g_lteSchedulerExecutorTestSuite; ///< the test suite
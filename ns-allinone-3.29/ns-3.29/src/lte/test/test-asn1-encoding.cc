@@ -1115,6 +1115,125 @@ MeasurementReportTestCase::DoRun (void)
   packet = 0;
 }
 
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that the messages serialized from the templates of their
+ * layout, i.e., all but the first ones of each layout, are decoded
+ * correctly
+ */
+class Asn1TemplateTestCase : public RrcHeaderTestCase
+{
+public:
+  Asn1TemplateTestCase ();
+  virtual void DoRun (void);
+};
+
+Asn1TemplateTestCase::Asn1TemplateTestCase () : RrcHeaderTestCase ("Testing Asn1TemplateTestCase")
+{
+}
+
+void
+Asn1TemplateTestCase::DoRun (void)
+{
+  NS_LOG_DEBUG ("============= Asn1TemplateTestCase ===========");
+
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      LteRrcSap::RrcConnectionReject reject;
+      reject.waitTime = 1 + i % 16;
+      RrcConnectionRejectHeader rejectSource;
+      rejectSource.SetMessage (reject);
+      packet = Create<Packet> ();
+      packet->AddHeader (rejectSource);
+      RrcConnectionRejectHeader rejectDestination;
+      packet->RemoveHeader (rejectDestination);
+      NS_TEST_ASSERT_MSG_EQ (rejectDestination.GetMessage ().waitTime, reject.waitTime, "Different waitTime!");
+
+      LteRrcSap::RrcConnectionRequest request;
+      request.ueIdentity = (uint64_t (i % 256) << 32) | (0x9e3779b9 * (i + 1));
+      RrcConnectionRequestHeader requestSource;
+      requestSource.SetMessage (request);
+      packet = Create<Packet> ();
+      packet->AddHeader (requestSource);
+      RrcConnectionRequestHeader requestDestination;
+      packet->RemoveHeader (requestDestination);
+      NS_TEST_ASSERT_MSG_EQ (requestDestination.GetMmec (), requestSource.GetMmec (), "Different mmec!");
+      NS_TEST_ASSERT_MSG_EQ (requestDestination.GetMtmsi (), requestSource.GetMtmsi (), "Different mTmsi!");
+
+      // four layouts of measurement reports, with and without the RSRQ of
+      // the neighbour cells
+      LteRrcSap::MeasurementReport report;
+      report.measResults.measId = 1 + i % 32;
+      report.measResults.rsrpResult = (i * 7) % 98;
+      report.measResults.rsrqResult = (i * 5) % 35;
+      report.measResults.haveMeasResultNeighCells = true;
+      // and a secondary cell with either of its results
+      report.measResults.haveScellsMeas = true;
+      report.measResults.measScellResultList.haveMeasurementResultsServingSCells = true;
+      report.measResults.measScellResultList.haveMeasurementResultsNeighCell = false;
+      LteRrcSap::MeasResultScell scell;
+      scell.servFreqId = i % 5;
+      scell.haveRsrpResult = (i % 4 < 2);
+      scell.rsrpResult = (i * 3) % 98;
+      scell.haveRsrqResult = !scell.haveRsrpResult;
+      scell.rsrqResult = (i * 11) % 35;
+      report.measResults.measScellResultList.measResultScell.push_back (scell);
+      for (uint32_t j = 0; j < 3; j++)
+        {
+          LteRrcSap::MeasResultEutra neighbour;
+          neighbour.physCellId = (i * 13 + j * 101) % 504;
+          neighbour.haveCgiInfo = false;
+          neighbour.haveRsrpResult = true;
+          neighbour.rsrpResult = (i + j * 31) % 98;
+          neighbour.haveRsrqResult = (i % 2 == 0);
+          neighbour.rsrqResult = (i + j * 11) % 35;
+          report.measResults.measResultListEutra.push_back (neighbour);
+        }
+      MeasurementReportHeader reportSource;
+      reportSource.SetMessage (report);
+      packet = Create<Packet> ();
+      packet->AddHeader (reportSource);
+      MeasurementReportHeader reportDestination;
+      packet->RemoveHeader (reportDestination);
+
+      LteRrcSap::MeasResults srcMeas = report.measResults;
+      LteRrcSap::MeasResults dstMeas = reportDestination.GetMessage ().measResults;
+      NS_TEST_ASSERT_MSG_EQ (dstMeas.measId, srcMeas.measId, "Different measId!");
+      NS_TEST_ASSERT_MSG_EQ (dstMeas.rsrpResult, srcMeas.rsrpResult, "Different rsrpResult!");
+      NS_TEST_ASSERT_MSG_EQ (dstMeas.rsrqResult, srcMeas.rsrqResult, "Different rsrqResult!");
+      NS_TEST_ASSERT_MSG_EQ (dstMeas.measResultListEutra.size (), srcMeas.measResultListEutra.size (), "Different number of neighbours!");
+      std::list<LteRrcSap::MeasResultEutra>::iterator itsrc = srcMeas.measResultListEutra.begin ();
+      std::list<LteRrcSap::MeasResultEutra>::iterator itdst = dstMeas.measResultListEutra.begin ();
+      for (; itsrc != srcMeas.measResultListEutra.end () && itdst != dstMeas.measResultListEutra.end (); itsrc++, itdst++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (itdst->physCellId, itsrc->physCellId, "Different physCellId!");
+          NS_TEST_ASSERT_MSG_EQ (itdst->haveRsrpResult, itsrc->haveRsrpResult, "Different haveRsrpResult!");
+          NS_TEST_ASSERT_MSG_EQ (itdst->rsrpResult, itsrc->rsrpResult, "Different rsrpResult!");
+          NS_TEST_ASSERT_MSG_EQ (itdst->haveRsrqResult, itsrc->haveRsrqResult, "Different haveRsrqResult!");
+          if (itsrc->haveRsrqResult)
+            {
+              NS_TEST_ASSERT_MSG_EQ (itdst->rsrqResult, itsrc->rsrqResult, "Different rsrqResult!");
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (dstMeas.haveScellsMeas, true, "Different haveScellsMeas!");
+      NS_TEST_ASSERT_MSG_EQ (dstMeas.measScellResultList.measResultScell.size (), 1u, "Different number of secondary cells!");
+      LteRrcSap::MeasResultScell dstScell = dstMeas.measScellResultList.measResultScell.front ();
+      NS_TEST_ASSERT_MSG_EQ (dstScell.servFreqId, scell.servFreqId, "Different servFreqId!");
+      if (scell.haveRsrpResult)
+        {
+          NS_TEST_ASSERT_MSG_EQ (dstScell.rsrpResult, scell.rsrpResult, "Different scell rsrpResult!");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (dstScell.rsrqResult, scell.rsrqResult, "Different scell rsrqResult!");
+        }
+    }
+
+  packet = 0;
+}
+
 /**
  * \ingroup lte-test
  * \ingroup tests
@@ -1142,6 +1261,7 @@ Asn1EncodingSuite::Asn1EncodingSuite ()
   AddTestCase (new RrcConnectionReestablishmentCompleteTestCase (), TestCase::QUICK);
   AddTestCase (new RrcConnectionRejectTestCase (), TestCase::QUICK);
   AddTestCase (new MeasurementReportTestCase (), TestCase::QUICK);
+  AddTestCase (new Asn1TemplateTestCase (), TestCase::QUICK);
 }
 
 Asn1EncodingSuite asn1EncodingSuite;
@@ -368,4 +368,27 @@ EpcTftClassifierTestSuite::EpcTftClassifierTestSuite ()
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     5897,     0,    2), TestCase::QUICK);
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  5897,       10,     0,    2), TestCase::QUICK);
 
+
+
+  ///////////////////////////////////////////
+  // check ToS and a deleted TFT
+  ///////////////////////////////////////////
+
+  Ptr<EpcTftClassifier> c5 = Create<EpcTftClassifier> ();
+  c5->Add (EpcTft::Default (), 1);
+  Ptr<EpcTft> tft5_2 = Create<EpcTft> ();
+  EpcTft::PacketFilter pf5_2_1;
+  pf5_2_1.direction = EpcTft::DOWNLINK;
+  pf5_2_1.typeOfService = 0xb8;
+  pf5_2_1.typeOfServiceMask = 0xfc;
+  tft5_2->Add (pf5_2_1);
+  c5->Add (tft5_2, 2);
+  c5->Add (tft4_1, 3);
+  c5->Delete (3);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     3489,  0xb8,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     3489,  0xbb,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     3489,  0xb4,    1), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     3489,  0xb8,    1), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     7895,     0,    1), TestCase::QUICK);
+
 }
@@ -0,0 +1,395 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "partition-helper.h"
+
+#include "ns3/node.h"
+#include "ns3/uinteger.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+/**
+ * \file
+ * \ingroup mpi
+ * ns3::PartitionHelper implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PartitionHelper");
+
+PartitionHelper::PartitionHelper ()
+  : m_tolerance (0.05),
+    m_systems (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PartitionHelper::Add (NodeContainer nodes)
+{
+  NS_LOG_FUNCTION (this);
+  for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+    {
+      uint32_t id = (*i)->GetId ();
+      if (m_index.find (id) == m_index.end ())
+        {
+          m_index[id] = m_nodes.GetN ();
+          m_nodes.Add (*i);
+          m_weights.push_back (-1);
+        }
+    }
+}
+
+uint32_t
+PartitionHelper::GetIndex (Ptr<Node> node) const
+{
+  std::map<uint32_t, uint32_t>::const_iterator i = m_index.find (node->GetId ());
+  NS_ABORT_MSG_IF (i == m_index.end (), "Node " << node->GetId () << " was not added to the PartitionHelper");
+  return i->second;
+}
+
+void
+PartitionHelper::SetWeight (Ptr<Node> node, double weight)
+{
+  NS_LOG_FUNCTION (this << node << weight);
+  NS_ABORT_MSG_IF (weight < 0, "Node weights must not be negative");
+  m_weights[GetIndex (node)] = weight;
+}
+
+void
+PartitionHelper::AddLink (Ptr<Node> a, Ptr<Node> b, Time delay)
+{
+  NS_LOG_FUNCTION (this << a << b << delay);
+  Link link;
+  link.a = GetIndex (a);
+  link.b = GetIndex (b);
+  link.delay = delay;
+  m_links.push_back (link);
+}
+
+void
+PartitionHelper::SetTolerance (double tolerance)
+{
+  NS_LOG_FUNCTION (this << tolerance);
+  m_tolerance = tolerance;
+}
+
+void
+PartitionHelper::Partition (uint32_t systems)
+{
+  NS_LOG_FUNCTION (this << systems);
+  NS_ABORT_MSG_IF (systems == 0, "Cannot partition over 0 systems");
+  m_systems = systems;
+  uint32_t n = m_nodes.GetN ();
+
+  // Cutting a link costs 1 for the longest links, and more as the delay,
+  // hence the lookahead it allows, gets shorter.
+  Time maxDelay (0);
+  for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      maxDelay = Max (maxDelay, i->delay);
+    }
+  m_adjacency.assign (n, std::vector<std::pair<uint32_t, double> > ());
+  for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      if (i->a == i->b)
+        {
+          continue;
+        }
+      double cost = 1;
+      if (maxDelay.IsStrictlyPositive ())
+        {
+          cost = maxDelay.GetDouble () / std::max (i->delay.GetDouble (), maxDelay.GetDouble () * 1e-3);
+        }
+      m_adjacency[i->a].push_back (std::make_pair (i->b, cost));
+      m_adjacency[i->b].push_back (std::make_pair (i->a, cost));
+    }
+
+  m_load.resize (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      m_load[i] = m_weights[i] >= 0 ? m_weights[i] : 1 + m_adjacency[i].size ();
+    }
+
+  m_assignment.assign (n, systems);
+  m_systemLoad.assign (systems, 0);
+  Grow ();
+  Refine ();
+
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      m_nodes.Get (i)->SetAttribute ("SystemId", UintegerValue (m_assignment[i]));
+    }
+  NS_LOG_INFO ("Partitioned " << n << " nodes over " << systems << " systems, imbalance "
+               << GetImbalance () << ", " << GetCutLinks () << " cut links");
+}
+
+void
+PartitionHelper::Grow (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t n = m_nodes.GetN ();
+  double remaining = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      remaining += m_load[i];
+    }
+
+  // Connection of the unassigned nodes to the system being grown
+  std::vector<double> connection (n, 0);
+  std::vector<uint32_t> touched;
+  uint32_t nextSeed = 0;
+  for (uint32_t system = 0; system < m_systems; ++system)
+    {
+      if (system == m_systems - 1)
+        {
+          for (uint32_t i = 0; i < n; ++i)
+            {
+              if (m_assignment[i] == m_systems)
+                {
+                  m_assignment[i] = system;
+                  m_systemLoad[system] += m_load[i];
+                }
+            }
+          break;
+        }
+
+      double target = remaining / (m_systems - system);
+      std::priority_queue<std::pair<double, uint32_t> > candidates;
+      double &load = m_systemLoad[system];
+      while (load < target)
+        {
+          uint32_t node = n;
+          while (!candidates.empty ())
+            {
+              std::pair<double, uint32_t> top = candidates.top ();
+              candidates.pop ();
+              if (m_assignment[top.second] == m_systems && top.first == connection[top.second])
+                {
+                  node = top.second;
+                  break;
+                }
+            }
+          if (node == n)
+            {
+              // Start from, or jump to, another connected component
+              while (nextSeed < n && m_assignment[nextSeed] != m_systems)
+                {
+                  ++nextSeed;
+                }
+              if (nextSeed == n)
+                {
+                  break;
+                }
+              node = nextSeed;
+            }
+          if (load > 0 && load + m_load[node] - target > target - load)
+            {
+              break;
+            }
+
+          m_assignment[node] = system;
+          load += m_load[node];
+          for (std::vector<std::pair<uint32_t, double> >::const_iterator i = m_adjacency[node].begin ();
+               i != m_adjacency[node].end (); ++i)
+            {
+              if (m_assignment[i->first] == m_systems)
+                {
+                  connection[i->first] += i->second;
+                  touched.push_back (i->first);
+                  candidates.push (std::make_pair (connection[i->first], i->first));
+                }
+            }
+        }
+      remaining -= load;
+      for (std::vector<uint32_t>::const_iterator i = touched.begin (); i != touched.end (); ++i)
+        {
+          connection[*i] = 0;
+        }
+      touched.clear ();
+    }
+}
+
+void
+PartitionHelper::Refine (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t n = m_nodes.GetN ();
+  double total = 0;
+  for (uint32_t s = 0; s < m_systems; ++s)
+    {
+      total += m_systemLoad[s];
+    }
+  double maxLoad = total / m_systems * (1 + m_tolerance);
+
+  // Connection of the node being considered to each system
+  std::vector<double> connection (m_systems, 0);
+  std::vector<uint32_t> neighbours;
+  const uint32_t maxPasses = 20;
+  for (uint32_t pass = 0; pass < maxPasses; ++pass)
+    {
+      bool moved = false;
+      for (uint32_t node = 0; node < n; ++node)
+        {
+          uint32_t from = m_assignment[node];
+          for (std::vector<std::pair<uint32_t, double> >::const_iterator i = m_adjacency[node].begin ();
+               i != m_adjacency[node].end (); ++i)
+            {
+              uint32_t s = m_assignment[i->first];
+              if (connection[s] == 0)
+                {
+                  neighbours.push_back (s);
+                }
+              connection[s] += i->second;
+            }
+
+          // An overloaded system gives nodes away to the lightest system
+          // if no neighbouring system can take them.
+          bool overloaded = m_systemLoad[from] > maxLoad;
+          if (overloaded)
+            {
+              uint32_t lightest = std::min_element (m_systemLoad.begin (), m_systemLoad.end ()) - m_systemLoad.begin ();
+              if (connection[lightest] == 0)
+                {
+                  neighbours.push_back (lightest);
+                }
+            }
+
+          uint32_t best = from;
+          double bestGain = overloaded ? -std::numeric_limits<double>::infinity () : 0;
+          for (std::vector<uint32_t>::const_iterator i = neighbours.begin (); i != neighbours.end (); ++i)
+            {
+              uint32_t to = *i;
+              if (to == from || m_systemLoad[to] + m_load[node] > maxLoad)
+                {
+                  continue;
+                }
+              double gain = connection[to] - connection[from];
+              // Moves which do not change the cost must improve the balance
+              bool balances = m_systemLoad[to] + m_load[node] < m_systemLoad[from];
+              if (gain > bestGain || (gain == bestGain && best == from && balances))
+                {
+                  best = to;
+                  bestGain = gain;
+                }
+            }
+
+          for (std::vector<uint32_t>::const_iterator i = neighbours.begin (); i != neighbours.end (); ++i)
+            {
+              connection[*i] = 0;
+            }
+          connection[from] = 0;
+          neighbours.clear ();
+
+          if (best != from)
+            {
+              m_assignment[node] = best;
+              m_systemLoad[from] -= m_load[node];
+              m_systemLoad[best] += m_load[node];
+              moved = true;
+            }
+        }
+      if (!moved)
+        {
+          break;
+        }
+    }
+}
+
+uint32_t
+PartitionHelper::GetSystemId (Ptr<Node> node) const
+{
+  NS_ASSERT_MSG (m_systems > 0, "Partition() was not called");
+  return m_assignment[GetIndex (node)];
+}
+
+double
+PartitionHelper::GetImbalance (void) const
+{
+  NS_ASSERT_MSG (m_systems > 0, "Partition() was not called");
+  double total = 0;
+  double heaviest = 0;
+  for (uint32_t s = 0; s < m_systems; ++s)
+    {
+      total += m_systemLoad[s];
+      heaviest = std::max (heaviest, m_systemLoad[s]);
+    }
+  return total > 0 ? heaviest / (total / m_systems) - 1 : 0;
+}
+
+uint32_t
+PartitionHelper::GetCutLinks (void) const
+{
+  NS_ASSERT_MSG (m_systems > 0, "Partition() was not called");
+  uint32_t cut = 0;
+  for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      if (m_assignment[i->a] != m_assignment[i->b])
+        {
+          ++cut;
+        }
+    }
+  return cut;
+}
+
+Time
+PartitionHelper::GetLookahead (void) const
+{
+  NS_ASSERT_MSG (m_systems > 0, "Partition() was not called");
+  Time lookahead = Time::Max ();
+  for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      if (m_assignment[i->a] != m_assignment[i->b])
+        {
+          lookahead = Min (lookahead, i->delay);
+        }
+    }
+  return lookahead;
+}
+
+void
+PartitionHelper::Report (std::ostream &os) const
+{
+  NS_ASSERT_MSG (m_systems > 0, "Partition() was not called");
+  std::vector<uint32_t> count (m_systems, 0);
+  for (uint32_t i = 0; i < m_assignment.size (); ++i)
+    {
+      count[m_assignment[i]]++;
+    }
+  for (uint32_t s = 0; s < m_systems; ++s)
+    {
+      os << "system " << s << ": " << count[s] << " nodes, weight " << m_systemLoad[s] << std::endl;
+    }
+  os << "imbalance " << GetImbalance () * 100 << "%, "
+     << GetCutLinks () << " of " << m_links.size () << " links cut, lookahead ";
+  Time lookahead = GetLookahead ();
+  if (lookahead == Time::Max ())
+    {
+      os << "unbounded";
+    }
+  else
+    {
+      os << lookahead.GetSeconds () << "s";
+    }
+  os << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PARTITION_HELPER_H
+#define PARTITION_HELPER_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+
+#include <map>
+#include <ostream>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mpi
+ * ns3::PartitionHelper declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Assign the nodes of a topology to the systems of a
+ * distributed simulation.
+ *
+ * The nodes are Add()ed with a weight, their expected event load
+ * (by default, one plus their number of links), and the links which
+ * will connect them with AddLink(), before the links are installed:
+ * the PointToPointHelper creates remote channels between nodes whose
+ * SystemId differ when the link is installed.
+ *
+ * Partition() then sets the SystemId attribute of each node.  The
+ * partition balances the weight of the systems within the tolerance
+ * given to SetTolerance(), and keeps links internal to the systems,
+ * all the more so as their delay is short: every cut link costs
+ * communication, and the shortest cut link bounds the lookahead of
+ * the null message algorithm.
+ *
+ * The nodes are first assigned by growing each system from a seed
+ * along its most strongly connected links, then moved one at a time
+ * between neighbouring systems as long as this lowers the cost of the
+ * cut links or fixes an overloaded system.
+ *
+ * \code
+ *   NodeContainer nodes;
+ *   nodes.Create (n);
+ *   PartitionHelper partition;
+ *   partition.Add (nodes);
+ *   partition.AddLink (nodes.Get (0), nodes.Get (1), MilliSeconds (5));
+ *   ...
+ *   partition.Partition (MpiInterface::GetSize ());
+ *   partition.Report (std::cout);
+ *   // Install the point-to-point links
+ * \endcode
+ */
+class PartitionHelper
+{
+public:
+  PartitionHelper ();
+
+  /**
+   * Add nodes to partition.
+   * \param [in] nodes The nodes.
+   */
+  void Add (NodeContainer nodes);
+
+  /**
+   * Set the expected event load of a node.
+   * \param [in] node The node.
+   * \param [in] weight The load, in any unit.
+   */
+  void SetWeight (Ptr<Node> node, double weight);
+
+  /**
+   * Declare a link between two nodes.
+   * \param [in] a The first node.
+   * \param [in] b The second node.
+   * \param [in] delay The propagation delay of the link.
+   */
+  void AddLink (Ptr<Node> a, Ptr<Node> b, Time delay);
+
+  /**
+   * \param [in] tolerance The allowed excess of the weight of a
+   * system over the average, as a fraction of the average (0.05 by
+   * default).
+   */
+  void SetTolerance (double tolerance);
+
+  /**
+   * Assign the nodes to systems, and set their SystemId attribute.
+   * \param [in] systems The number of systems.
+   */
+  void Partition (uint32_t systems);
+
+  /**
+   * \param [in] node A node.
+   * \return The system assigned to \p node by Partition().
+   */
+  uint32_t GetSystemId (Ptr<Node> node) const;
+
+  /**
+   * \return The weight of the heaviest system over the average
+   * weight, minus one.
+   */
+  double GetImbalance (void) const;
+
+  /**
+   * \return The number of links between different systems.
+   */
+  uint32_t GetCutLinks (void) const;
+
+  /**
+   * \return The shortest delay of the links between different systems,
+   * or Time::Max if there is none.
+   */
+  Time GetLookahead (void) const;
+
+  /**
+   * Print the weight of each system and the figures of merit of the
+   * partition.
+   * \param [in,out] os The output stream.
+   */
+  void Report (std::ostream &os) const;
+
+private:
+  /** A link. */
+  struct Link
+  {
+    uint32_t a;      //!< Index of the first node
+    uint32_t b;      //!< Index of the second node
+    Time delay;      //!< Propagation delay
+  };
+
+  /**
+   * \param [in] node A node.
+   * \return The index of \p node.
+   */
+  uint32_t GetIndex (Ptr<Node> node) const;
+
+  /** Assign the nodes by growing each system from a seed. */
+  void Grow (void);
+
+  /** Move nodes between systems while this lowers the cost. */
+  void Refine (void);
+
+  NodeContainer m_nodes;                   //!< The nodes
+  std::map<uint32_t, uint32_t> m_index;    //!< Index of each node, by node id
+  std::vector<double> m_weights;           //!< Weight of each node, or negative for the default
+  std::vector<Link> m_links;               //!< The links
+  double m_tolerance;                      //!< Allowed imbalance
+
+  uint32_t m_systems;                      //!< Number of systems
+  /** Neighbours of each node, with the cost of cutting the link. */
+  std::vector<std::vector<std::pair<uint32_t, double> > > m_adjacency;
+  std::vector<double> m_load;              //!< Effective weight of each node
+  std::vector<uint32_t> m_assignment;      //!< System of each node
+  std::vector<double> m_systemLoad;        //!< Weight of each system
+};
+
+} // namespace ns3
+
+#endif /* PARTITION_HELPER_H */
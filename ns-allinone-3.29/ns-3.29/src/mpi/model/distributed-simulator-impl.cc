@@ -386,7 +386,10 @@ DistributedSimulatorImpl::Run (void)
       if (nextTime > m_grantedTime || IsLocalFinished () )
         {
           // Can't process next event, calculate a new LBTS
-          // First receive any pending messages
+          // First send the packets batched during this window, so
+          // that they are accounted for in the LBTS
+          GrantedTimeWindowMpiInterface::FlushMessages ();
+          // Then receive any pending messages
           GrantedTimeWindowMpiInterface::ReceiveMessages ();
           // reset next time
           nextTime = Next ();
@@ -82,11 +82,8 @@ bool                  GrantedTimeWindowMpiInterface::m_enabled = false;
 uint32_t              GrantedTimeWindowMpiInterface::m_rxCount = 0;
 uint32_t              GrantedTimeWindowMpiInterface::m_txCount = 0;
 std::list<SentBuffer> GrantedTimeWindowMpiInterface::m_pendingTx;
-
-#ifdef NS3_MPI
-MPI_Request* GrantedTimeWindowMpiInterface::m_requests;
-char**       GrantedTimeWindowMpiInterface::m_pRxBuffers;
-#endif
+RemotePacketBatcher   GrantedTimeWindowMpiInterface::m_batcher;
+std::vector<uint8_t>  GrantedTimeWindowMpiInterface::m_rxBuffer;
 
 TypeId 
 GrantedTimeWindowMpiInterface::GetTypeId (void)
@@ -104,13 +101,7 @@ GrantedTimeWindowMpiInterface::Destroy ()
   NS_LOG_FUNCTION (this);
 
 #ifdef NS3_MPI
-  for (uint32_t i = 0; i < GetSize (); ++i)
-    {
-      delete [] m_pRxBuffers[i];
-    }
-  delete [] m_pRxBuffers;
-  delete [] m_requests;
-
+  m_rxBuffer.clear ();
   m_pendingTx.clear ();
 #endif
 }
@@ -173,15 +164,7 @@ GrantedTimeWindowMpiInterface::Enable (int* pargc, char*** pargv)
   MPI_Comm_size (MPI_COMM_WORLD, reinterpret_cast <int *> (&m_size));
   m_enabled = true;
   m_initialized = true;
-  // Post a non-blocking receive for all peers
-  m_pRxBuffers = new char*[m_size];
-  m_requests = new MPI_Request[m_size];
-  for (uint32_t i = 0; i < GetSize (); ++i)
-    {
-      m_pRxBuffers[i] = new char[MAX_MPI_MSG_SIZE];
-      MPI_Irecv (m_pRxBuffers[i], MAX_MPI_MSG_SIZE, MPI_CHAR, MPI_ANY_SOURCE, 0,
-                 MPI_COMM_WORLD, &m_requests[i]);
-    }
+  m_batcher.Initialize (m_size);
 #else
   NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
 #endif
@@ -192,31 +175,51 @@ GrantedTimeWindowMpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, ui
 {
   NS_LOG_FUNCTION (this << p << rxTime.GetTimeStep () << node << dev);
 
+#ifdef NS3_MPI
+  // Find the system id for the destination node
+  Ptr<Node> destNode = NodeList::GetNode (node);
+  uint32_t nodeSysId = destNode->GetSystemId ();
+
+  m_txCount++;
+  if (m_batcher.Add (nodeSysId, p, rxTime, node, dev))
+    {
+      Flush (nodeSysId);
+    }
+#else
+  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
+#endif
+}
+
+void
+GrantedTimeWindowMpiInterface::Flush (uint32_t sid)
+{
+  NS_LOG_FUNCTION (sid);
+
 #ifdef NS3_MPI
   SentBuffer sendBuf;
   m_pendingTx.push_back (sendBuf);
   std::list<SentBuffer>::reverse_iterator i = m_pendingTx.rbegin (); // Points to the last element
 
-  uint32_t serializedSize = p->GetSerializedSize ();
-  uint8_t* buffer =  new uint8_t[serializedSize + 16];
-  i->SetBuffer (buffer);
-  // Add the time, dest node and dest device
-  uint64_t t = rxTime.GetInteger ();
-  uint64_t* pTime = reinterpret_cast <uint64_t *> (buffer);
-  *pTime++ = t;
-  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = node;
-  *pData++ = dev;
-  // Serialize the packet
-  p->Serialize (reinterpret_cast<uint8_t *> (pData), serializedSize);
+  uint32_t size;
+  i->SetBuffer (m_batcher.Take (sid, 0, size));
+  MPI_Isend (reinterpret_cast<void *> (i->GetBuffer ()), size, MPI_CHAR, sid,
+             0, MPI_COMM_WORLD, (i->GetRequest ()));
+#endif
+}
 
-  // Find the system id for the destination node
-  Ptr<Node> destNode = NodeList::GetNode (node);
-  uint32_t nodeSysId = destNode->GetSystemId ();
+void
+GrantedTimeWindowMpiInterface::FlushMessages ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
 
-  MPI_Isend (reinterpret_cast<void *> (i->GetBuffer ()), serializedSize + 16, MPI_CHAR, nodeSysId,
-             0, MPI_COMM_WORLD, (i->GetRequest ()));
-  m_txCount++;
+#ifdef NS3_MPI
+  for (uint32_t sid = 0; sid < m_size; ++sid)
+    {
+      if (m_batcher.GetPending (sid) > 0)
+        {
+          Flush (sid);
+        }
+    }
 #else
   NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
 #endif
@@ -228,58 +231,30 @@ GrantedTimeWindowMpiInterface::ReceiveMessages ()
   NS_LOG_FUNCTION_NOARGS ();
 
 #ifdef NS3_MPI
-  // Poll the non-block reads to see if data arrived
+  // Probe for messages which arrived, and receive each of them in a
+  // buffer of its size
   while (true)
     {
       int flag = 0;
-      int index = 0;
       MPI_Status status;
 
-      MPI_Testany (MpiInterface::GetSize (), m_requests, &index, &flag, &status);
+      MPI_Iprobe (MPI_ANY_SOURCE, 0, MPI_COMM_WORLD, &flag, &status);
       if (!flag)
         {
           break;        // No more messages
         }
       int count;
       MPI_Get_count (&status, MPI_CHAR, &count);
-      m_rxCount++; // Count this receive
-
-      // Get the meta data first
-      uint64_t* pTime = reinterpret_cast<uint64_t *> (m_pRxBuffers[index]);
-      uint64_t time = *pTime++;
-      uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-      uint32_t node = *pData++;
-      uint32_t dev  = *pData++;
-
-      Time rxTime (time);
-
-      count -= sizeof (time) + sizeof (node) + sizeof (dev);
-
-      Ptr<Packet> p = Create<Packet> (reinterpret_cast<uint8_t *> (pData), count, true);
-
-      // Find the correct node/device to schedule receive event
-      Ptr<Node> pNode = NodeList::GetNode (node);
-      Ptr<MpiReceiver> pMpiRec = 0;
-      uint32_t nDevices = pNode->GetNDevices ();
-      for (uint32_t i = 0; i < nDevices; ++i)
+      if (m_rxBuffer.size () < static_cast<std::size_t> (count))
         {
-          Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
-          if (pThisDev->GetIfIndex () == dev)
-            {
-              pMpiRec = pThisDev->GetObject<MpiReceiver> ();
-              break;
-            }
+          m_rxBuffer.resize (count);
         }
+      MPI_Recv (&m_rxBuffer[0], count, MPI_CHAR, status.MPI_SOURCE, 0,
+                MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
-      NS_ASSERT (pNode && pMpiRec);
-
-      // Schedule the rx event
-      Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
-                                      &MpiReceiver::Receive, pMpiRec, p);
-
-      // Re-queue the next read
-      MPI_Irecv (m_pRxBuffers[index], MAX_MPI_MSG_SIZE, MPI_CHAR, MPI_ANY_SOURCE, 0,
-                 MPI_COMM_WORLD, &m_requests[index]);
+      uint64_t guarantee;
+      uint64_t request;
+      m_rxCount += RemotePacketBatcher::Deliver (&m_rxBuffer[0], count, guarantee, request);
     }
 #else
   NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
@@ -25,11 +25,13 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
 
 #include "ns3/nstime.h"
 #include "ns3/buffer.h"
 
 #include "parallel-communication-interface.h"
+#include "remote-packet-batcher.h"
 
 #ifdef NS3_MPI
 #include "mpi.h"
@@ -39,12 +41,6 @@ typedef void* MPI_Request;
 
 namespace ns3 {
 
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-const uint32_t MAX_MPI_MSG_SIZE = 2000;
-
 /**
  * \ingroup mpi
  *
@@ -128,11 +124,17 @@ public:
    * \param node destination node
    * \param dev destination device
    *
-   * Serialize and send a packet to the specified node and net device
+   * Add a packet for the specified node and net device to the batch
+   * of its system, and send the batch if it is full.
    */
   virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
   /**
-   * Check for received messages complete
+   * Send the packets batched for all systems.  Must be called before
+   * the granted time window is recomputed.
+   */
+  static void FlushMessages ();
+  /**
+   * Receive and deliver all the messages which have arrived
    */
   static void ReceiveMessages ();
   /**
@@ -149,6 +151,12 @@ public:
   static uint32_t GetTxCount ();
 
 private:
+  /**
+   * Send the packets batched for a system.
+   * \param sid The system id.
+   */
+  static void Flush (uint32_t sid);
+
   static uint32_t m_sid;
   static uint32_t m_size;
 
@@ -160,11 +168,11 @@ private:
   static bool     m_initialized;
   static bool     m_enabled;
 
-  // Pending non-blocking receives
-  static MPI_Request* m_requests;
+  // Packets waiting to be sent, per system
+  static RemotePacketBatcher m_batcher;
 
-  // Data buffers for non-blocking reads
-  static char**   m_pRxBuffers;
+  // Receive buffer, grown to the largest message received
+  static std::vector<uint8_t> m_rxBuffer;
 
   // List of pending non-blocking sends
   static std::list<SentBuffer> m_pendingTx;
@@ -23,10 +23,13 @@
 
 #include <ns3/global-value.h>
 #include <ns3/string.h>
+#include <ns3/uinteger.h>
 #include <ns3/log.h>
+#include <ns3/abort.h>
 
 #include "null-message-mpi-interface.h"
 #include "granted-time-window-mpi-interface.h"
+#include "shared-memory-interface.h"
 
 namespace ns3 {
 
@@ -78,6 +81,10 @@ MpiInterface::Enable (int* pargc, char*** pargv)
   StringValue simulationTypeValue;
   bool useDefault = true;
 
+  UintegerValue sharedMemoryRanks;
+  GlobalValue::GetValueByName ("SharedMemoryRanks", sharedMemoryRanks);
+  bool sharedMemory = sharedMemoryRanks.Get () > 0;
+
   if (GlobalValue::GetValueByNameFailSafe ("SimulatorImplementationType", simulationTypeValue))
     {
       std::string simulationType = simulationTypeValue.Get ();
@@ -86,16 +93,34 @@ MpiInterface::Enable (int* pargc, char*** pargv)
       // Defaults to synchronous.
       if (simulationType.compare ("ns3::NullMessageSimulatorImpl") == 0)
         {
-          g_parallelCommunicationInterface = new NullMessageMpiInterface ();
+          if (sharedMemory)
+            {
+              g_parallelCommunicationInterface = new SharedMemoryInterface ();
+            }
+          else
+            {
+              g_parallelCommunicationInterface = new NullMessageMpiInterface ();
+            }
           useDefault = false;
         }
       else if (simulationType.compare ("ns3::DistributedSimulatorImpl") == 0)
         {
+          NS_ABORT_MSG_IF (sharedMemory, "SharedMemoryRanks requires ns3::NullMessageSimulatorImpl");
           g_parallelCommunicationInterface = new GrantedTimeWindowMpiInterface ();
           useDefault = false;
         }
     }
 
+  // The granted time window algorithm needs MPI collectives.
+  if (useDefault && sharedMemory)
+    {
+      g_parallelCommunicationInterface = new SharedMemoryInterface ();
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::NullMessageSimulatorImpl"));
+      NS_LOG_WARN ("SimulatorImplementationType was set to non-parallel simulator; setting type to ns3::NullMessageSimulatorImpl");
+      useDefault = false;
+    }
+
   // User did not specify a valid parallel simulator; use the default.
   if (useDefault)
     {
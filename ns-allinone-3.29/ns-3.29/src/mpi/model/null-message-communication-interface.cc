@@ -0,0 +1,49 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "null-message-communication-interface.h"
+
+#include "ns3/assert.h"
+
+/**
+ * \file
+ * \ingroup mpi
+ * ns3::NullMessageCommunicationInterface implementation.
+ */
+
+namespace ns3 {
+
+NullMessageCommunicationInterface* NullMessageCommunicationInterface::g_instance = 0;
+
+NullMessageCommunicationInterface::NullMessageCommunicationInterface ()
+{
+  NS_ASSERT (g_instance == 0);
+  g_instance = this;
+}
+
+NullMessageCommunicationInterface::~NullMessageCommunicationInterface ()
+{
+  g_instance = 0;
+}
+
+NullMessageCommunicationInterface *
+NullMessageCommunicationInterface::GetInstance (void)
+{
+  NS_ASSERT (g_instance != 0);
+  return g_instance;
+}
+
+} // namespace ns3
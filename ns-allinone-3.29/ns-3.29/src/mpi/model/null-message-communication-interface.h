@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_NULLMESSAGE_COMMUNICATION_INTERFACE_H
+#define NS3_NULLMESSAGE_COMMUNICATION_INTERFACE_H
+
+#include "parallel-communication-interface.h"
+
+#include <ns3/nstime.h>
+#include <ns3/ptr.h>
+
+/**
+ * \file
+ * \ingroup mpi
+ * ns3::NullMessageCommunicationInterface declaration.
+ */
+
+namespace ns3 {
+
+class RemoteChannelBundle;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Pure virtual base class for the communication layers usable
+ * by the Null Message distributed simulation implementation.
+ *
+ * In addition to the ParallelCommunicationInterface, the
+ * NullMessageSimulatorImpl needs to send Null Messages and to poll or
+ * wait for received messages.  It reaches the layer in use, MPI or
+ * shared memory, through GetInstance().
+ */
+class NullMessageCommunicationInterface : public ParallelCommunicationInterface
+{
+public:
+  NullMessageCommunicationInterface ();
+  virtual ~NullMessageCommunicationInterface ();
+
+  /**
+   * \return The communication interface in use.
+   */
+  static NullMessageCommunicationInterface * GetInstance (void);
+
+  /**
+   * \brief Initialize send and receive buffers.
+   *
+   * This method should be called after all links have been added to the RemoteChannelBundle
+   * manager to setup any required send and receive buffers.
+   */
+  virtual void InitializeSendReceiveBuffers (void) = 0;
+  /**
+   * \param guaranteeUpdate guarantee update time for the Null Message
+   * \param bundle the destination bundle for the Null Message.
+   * \param request guarantee time to ask the remote task for in
+   * return, or 0.
+   *
+   * \brief Send a Null Message across the specified bundle.
+   *
+   * Guarantee update time is the lower bound time on the next
+   * possible event from this task to the remote task across
+   * the bundle.  Remote task may execute events up to time.
+   */
+  virtual void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle, const Time& request) = 0;
+  /**
+   * Send the packets batched for all systems.  Must be called before
+   * blocking for messages, and when simulation time advances.
+   */
+  virtual void FlushMessages (void) = 0;
+  /**
+   * Non-blocking check for received messages complete.  Will
+   * receive all messages that are queued up locally.
+   */
+  virtual void ReceiveMessagesNonBlocking (void) = 0;
+  /**
+   * Blocking message receive.  Will block until at least one message
+   * has been received.
+   */
+  virtual void ReceiveMessagesBlocking (void) = 0;
+  /**
+   * Check for completed sends
+   */
+  virtual void TestSendComplete (void) = 0;
+
+private:
+  /** The communication interface in use. */
+  static NullMessageCommunicationInterface* g_instance;
+};
+
+} // namespace ns3
+
+#endif /* NS3_NULLMESSAGE_COMMUNICATION_INTERFACE_H */
@@ -45,14 +45,6 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("NullMessageMpiInterface");
 
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-#ifdef NS3_MPI
-const uint32_t NULL_MESSAGE_MAX_MPI_MSG_SIZE = 2000;
-#endif
-
 NullMessageSentBuffer::NullMessageSentBuffer ()
 {
   m_buffer = 0;
@@ -89,8 +81,8 @@ bool                  NullMessageMpiInterface::g_initialized = false;
 bool                  NullMessageMpiInterface::g_enabled = false;
 std::list<NullMessageSentBuffer> NullMessageMpiInterface::g_pendingTx;
 
-MPI_Request* NullMessageMpiInterface::g_requests;
-char**       NullMessageMpiInterface::g_pRxBuffers;
+RemotePacketBatcher   NullMessageMpiInterface::g_batcher;
+std::vector<uint8_t>  NullMessageMpiInterface::g_rxBuffer;
 
 NullMessageMpiInterface::NullMessageMpiInterface ()
 {
@@ -172,27 +164,12 @@ NullMessageMpiInterface::Enable (int* pargc, char*** pargv)
 void 
 NullMessageMpiInterface::InitializeSendReceiveBuffers(void)
 {
-  NS_LOG_FUNCTION_NOARGS ();
+  NS_LOG_FUNCTION (this);
 #ifdef NS3_MPI
   NS_ASSERT (g_enabled);
 
   g_numNeighbors = RemoteChannelBundleManager::Size();
-
-  // Post a non-blocking receive for all peers
-  g_requests = new MPI_Request[g_numNeighbors];
-  g_pRxBuffers = new char*[g_numNeighbors];
-  int index = 0;
-  for (uint32_t rank = 0; rank < g_size; ++rank)
-    {
-      Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(rank);
-      if (bundle) 
-        {
-          g_pRxBuffers[index] = new char[NULL_MESSAGE_MAX_MPI_MSG_SIZE];
-          MPI_Irecv (g_pRxBuffers[index], NULL_MESSAGE_MAX_MPI_MSG_SIZE, MPI_CHAR, rank, 0,
-                     MPI_COMM_WORLD, &g_requests[index]);
-          ++index;
-        }
-    }
+  g_batcher.Initialize (g_size);
 #endif
 }
 
@@ -209,72 +186,79 @@ NullMessageMpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t
   Ptr<Node> destNode = NodeList::GetNode (node);
   uint32_t nodeSysId = destNode->GetSystemId ();
 
-  NullMessageSentBuffer sendBuf;
-  g_pendingTx.push_back (sendBuf);
-  std::list<NullMessageSentBuffer>::reverse_iterator iter = g_pendingTx.rbegin (); // Points to the last element
-
-  uint32_t serializedSize = p->GetSerializedSize ();
-  uint32_t bufferSize = serializedSize + ( 2 * sizeof (uint64_t) ) + ( 2 * sizeof (uint32_t) );
-  uint8_t* buffer =  new uint8_t[bufferSize];
-  iter->SetBuffer (buffer);
-  // Add the time, dest node and dest device
-  uint64_t t = rxTime.GetInteger ();
-  uint64_t* pTime = reinterpret_cast <uint64_t *> (buffer);
-  *pTime++ = t;
-
-  Time guarantee_update = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId);
-  *pTime++ = guarantee_update.GetTimeStep ();
-
-  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = node;
-  *pData++ = dev;
-  // Serialize the packet
-  p->Serialize (reinterpret_cast<uint8_t *> (pData), serializedSize);
-
-  MPI_Isend (reinterpret_cast<void *> (iter->GetBuffer ()), bufferSize, MPI_CHAR, nodeSysId,
-             0, MPI_COMM_WORLD, (iter->GetRequest ()));
+  Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (nodeSysId);
+  NS_ASSERT (bundle);
+  bundle->NotifyPacketSent (node, dev, rxTime);
 
-  NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (nodeSysId);
+  if (g_batcher.Add (nodeSysId, p, rxTime, node, dev))
+    {
+      Time guarantee_update = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId);
+      Flush (nodeSysId, guarantee_update);
+      NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (nodeSysId);
+    }
 
 #endif
 }
 
 void
-NullMessageMpiInterface::SendNullMessage (const Time& guarantee_update, Ptr<RemoteChannelBundle> bundle)
+NullMessageMpiInterface::FlushMessages ()
 {
-  NS_LOG_FUNCTION (guarantee_update.GetTimeStep () << bundle);
+  NS_LOG_FUNCTION (this);
 
   NS_ASSERT (g_enabled);
 
 #ifdef NS3_MPI
+  for (uint32_t sid = 0; sid < g_size; ++sid)
+    {
+      if (g_batcher.GetPending (sid) > 0)
+        {
+          Time guarantee_update = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (sid);
+          Flush (sid, guarantee_update);
+          NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (sid);
+        }
+    }
+#endif
+}
 
+void
+NullMessageMpiInterface::Flush (uint32_t sid, const Time &guaranteeUpdate)
+{
+  NS_LOG_FUNCTION (sid << guaranteeUpdate.GetTimeStep ());
+
+#ifdef NS3_MPI
   NullMessageSentBuffer sendBuf;
   g_pendingTx.push_back (sendBuf);
   std::list<NullMessageSentBuffer>::reverse_iterator iter = g_pendingTx.rbegin (); // Points to the last element
 
-  uint32_t bufferSize = 2 * sizeof (uint64_t) + 2 * sizeof (uint32_t);
-  uint8_t* buffer =  new uint8_t[bufferSize];
-  iter->SetBuffer (buffer);
-  // Add the time, dest node and dest device
-  uint64_t* pTime = reinterpret_cast <uint64_t *> (buffer);
-  *pTime++ = 0;
-  *pTime++ = guarantee_update.GetInteger ();
-  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = 0;
-  *pData++ = 0;
-
-  // Find the system id for the destination MPI rank
-  uint32_t nodeSysId = bundle->GetSystemId ();
-
-  MPI_Isend (reinterpret_cast<void *> (iter->GetBuffer ()), bufferSize, MPI_CHAR, nodeSysId,
+  NullMessageSimulatorImpl::GetInstance ()->NotifyMessageSent (sid, guaranteeUpdate, g_batcher.GetPending (sid));
+  uint32_t bufferSize;
+  iter->SetBuffer (g_batcher.Take (sid, guaranteeUpdate.GetInteger (), bufferSize));
+
+  MPI_Isend (reinterpret_cast<void *> (iter->GetBuffer ()), bufferSize, MPI_CHAR, sid,
              0, MPI_COMM_WORLD, (iter->GetRequest ()));
 #endif
 }
 
+void
+NullMessageMpiInterface::SendNullMessage (const Time& guarantee_update, Ptr<RemoteChannelBundle> bundle, const Time& request)
+{
+  NS_LOG_FUNCTION (this << guarantee_update.GetTimeStep () << bundle << request.GetTimeStep ());
+
+  NS_ASSERT (g_enabled);
+
+#ifdef NS3_MPI
+  if (request.IsStrictlyPositive ())
+    {
+      g_batcher.SetRequest (bundle->GetSystemId (), request.GetInteger ());
+    }
+  Flush (bundle->GetSystemId (), guarantee_update);
+#endif
+}
+
 void
 NullMessageMpiInterface::ReceiveMessagesBlocking ()
 {
-  NS_LOG_FUNCTION_NOARGS ();
+  NS_LOG_FUNCTION (this);
 
   ReceiveMessages(true);
 }
@@ -283,7 +267,7 @@ NullMessageMpiInterface::ReceiveMessagesBlocking ()
 void
 NullMessageMpiInterface::ReceiveMessagesNonBlocking ()
 {
-  NS_LOG_FUNCTION_NOARGS ();
+  NS_LOG_FUNCTION (this);
 
   ReceiveMessages(false);
 }
@@ -311,74 +295,32 @@ NullMessageMpiInterface::ReceiveMessages (bool blocking)
   do
     {
       int messageReceived = 0;
-      int index = 0;
       MPI_Status status;
 
       if (blocking)
         {
-          MPI_Waitany (g_numNeighbors, g_requests, &index, &status);
-          messageReceived = 1; /* Wait always implies message was received */
+          MPI_Probe (MPI_ANY_SOURCE, 0, MPI_COMM_WORLD, &status);
+          messageReceived = 1; /* Probe always implies message was received */
           stop = true;
         }
       else
         {
-          MPI_Testany (g_numNeighbors, g_requests, &index, &messageReceived, &status);
+          MPI_Iprobe (MPI_ANY_SOURCE, 0, MPI_COMM_WORLD, &messageReceived, &status);
         }
 
       if (messageReceived)
         {
           int count;
           MPI_Get_count (&status, MPI_CHAR, &count);
-
-          // Get the meta data first
-          uint64_t* pTime = reinterpret_cast<uint64_t *> (g_pRxBuffers[index]);
-          uint64_t time = *pTime++;
-          uint64_t guaranteeUpdate = *pTime++;
-
-          uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-          uint32_t node = *pData++;
-          uint32_t dev  = *pData++;
-
-          Time rxTime (time);
-
-          // rxtime == 0 means this is a Null Message
-          if (rxTime > Time (0))
+          if (g_rxBuffer.size () < static_cast<std::size_t> (count))
             {
-              count -= sizeof (time) + sizeof (guaranteeUpdate) + sizeof (node) + sizeof (dev);
-
-              Ptr<Packet> p = Create<Packet> (reinterpret_cast<uint8_t *> (pData), count, true);
-
-              // Find the correct node/device to schedule receive event
-              Ptr<Node> pNode = NodeList::GetNode (node);
-              Ptr<MpiReceiver> pMpiRec = 0;
-              uint32_t nDevices = pNode->GetNDevices ();
-              for (uint32_t i = 0; i < nDevices; ++i)
-                {
-                  Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
-                  if (pThisDev->GetIfIndex () == dev)
-                    {
-                      pMpiRec = pThisDev->GetObject<MpiReceiver> ();
-                      break;
-                    }
-                }
-              NS_ASSERT (pNode && pMpiRec);
-
-              // Schedule the rx event
-              Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
-                                              &MpiReceiver::Receive, pMpiRec, p);
-
+              g_rxBuffer.resize (count);
             }
+          MPI_Recv (&g_rxBuffer[0], count, MPI_CHAR, status.MPI_SOURCE, 0,
+                    MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
-          // Update guarantee time for both packet receives and Null Messages.
-          Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (status.MPI_SOURCE);
-          NS_ASSERT (bundle);
-
-          bundle->SetGuaranteeTime (Time (guaranteeUpdate));
-
-          // Re-queue the next read
-          MPI_Irecv (g_pRxBuffers[index], NULL_MESSAGE_MAX_MPI_MSG_SIZE, MPI_CHAR, status.MPI_SOURCE, 0,
-                     MPI_COMM_WORLD, &g_requests[index]);
-
+          // Schedule the packets, and update the guarantee time
+          NullMessageSimulatorImpl::GetInstance ()->HandleMessage (status.MPI_SOURCE, &g_rxBuffer[0], count);
         }
       else
         {
@@ -393,7 +335,7 @@ NullMessageMpiInterface::ReceiveMessages (bool blocking)
 void
 NullMessageMpiInterface::TestSendComplete ()
 {
-  NS_LOG_FUNCTION_NOARGS ();
+  NS_LOG_FUNCTION (this);
 
   NS_ASSERT (g_enabled);
 
@@ -433,21 +375,9 @@ NullMessageMpiInterface::Disable ()
           MPI_Request_free (iter->GetRequest ());
         }
 
-      for (uint32_t i = 0; i < g_numNeighbors; ++i)
-        {
-          MPI_Cancel (&g_requests[i]);
-          MPI_Request_free (&g_requests[i]);
-        }
-
       MPI_Finalize ();
 
-      for (uint32_t i = 0; i < g_numNeighbors; ++i)
-        {
-          delete [] g_pRxBuffers[i];
-        }
-      delete [] g_pRxBuffers;
-      delete [] g_requests;
-
+      g_rxBuffer.clear ();
       g_pendingTx.clear ();
 
       g_enabled = false;
@@ -22,7 +22,8 @@
 #ifndef NS3_NULLMESSAGE_MPI_INTERFACE_H
 #define NS3_NULLMESSAGE_MPI_INTERFACE_H
 
-#include "parallel-communication-interface.h"
+#include "null-message-communication-interface.h"
+#include "remote-packet-batcher.h"
 
 #include <ns3/nstime.h>
 #include <ns3/buffer.h>
@@ -34,6 +35,7 @@ typedef void* MPI_Request;
 #endif
 
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -85,7 +87,7 @@ private:
  * \brief Interface between ns-3 and MPI for the Null Message
  * distributed simulation implementation.
  */
-class NullMessageMpiInterface : public ParallelCommunicationInterface
+class NullMessageMpiInterface : public NullMessageCommunicationInterface
 {
 public:
 
@@ -128,21 +130,24 @@ public:
    * \param node destination node
    * \param dev destination device
    *
-   * Serialize and send a packet to the specified node and net device.
+   * Add a packet for the specified node and net device to the batch
+   * of its system, and send the batch if it is full.
    *
    * \internal
-   * The MPI buffer format packs a delivery information and the serialized packet.
-   *
-   * uint64_t time the packed should be delivered
-   * uint64_t guarantee time for the Null Message algorithm.
-   * uint32_t node id of destination
-   * unit32_t dev id on destination
-   * uint8_t[] serialized packet
+   * The MPI buffer format is the one of RemotePacketBatcher, carrying
+   * the guarantee time for the Null Message algorithm.
    */
   virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+  /**
+   * Send the packets batched for all systems.  Must be called before
+   * blocking for messages, and when simulation time advances.
+   */
+  virtual void FlushMessages ();
   /**
    * \param guaranteeUpdate guarantee update time for the Null Message
-   * \bundle the destination bundle for the Null Message.
+   * \param bundle the destination bundle for the Null Message.
+   * \param request guarantee time to ask the remote task for in
+   * return, or 0.
    *
    * \brief Send a Null Message to across the specified bundle.  
    *
@@ -155,30 +160,25 @@ public:
    * MPI task.
    *
    * \internal
-   * The Null Message MPI buffer format is based on the format for sending a packet with
-   * several fields set to 0 to signal that it is a Null Message.  Overloading the normal packet
-   * format simplifies receive logic.
-   *
-   * uint64_t 0 must be zero for Null Message
-   * uint64_t guarantee time
-   * uint32_t 0 must be zero for Null Message
-   * uint32_t 0 must be zero for Null Message
+   * A Null Message is a message of the packet format carrying the
+   * packets batched for the remote task, if any, so it also flushes
+   * them in order.
    */
-  static void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle);
+  virtual void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle, const Time& request);
   /**
    * Non-blocking check for received messages complete.  Will
    * receive all messages that are queued up locally.
    */
-  static void ReceiveMessagesNonBlocking ();
+  virtual void ReceiveMessagesNonBlocking ();
   /**
    * Blocking message receive.  Will block until at least one message
    * has been received.
    */
-  static void ReceiveMessagesBlocking ();
+  virtual void ReceiveMessagesBlocking ();
   /**
    * Check for completed sends
    */
-  static void TestSendComplete ();
+  virtual void TestSendComplete ();
 
   /**
    * \brief Initialize send and receive buffers.
@@ -186,7 +186,7 @@ public:
    * This method should be called after all links have been added to the RemoteChannelBundle
    * manager to setup any required send and receive buffers.
    */
-  static void InitializeSendReceiveBuffers (void);
+  virtual void InitializeSendReceiveBuffers (void);
 
 private:
 
@@ -199,6 +199,13 @@ private:
    */
   static void ReceiveMessages (bool blocking = false);
 
+  /**
+   * Send the packets batched for a system, with a guarantee time.
+   * \param sid The system id.
+   * \param guaranteeUpdate The guarantee time.
+   */
+  static void Flush (uint32_t sid, const Time &guaranteeUpdate);
+
   // System ID (rank) for this task
   static uint32_t g_sid;
 
@@ -211,11 +218,11 @@ private:
   static bool     g_initialized;
   static bool     g_enabled;
 
-  // Pending non-blocking receives
-  static MPI_Request* g_requests;
+  // Packets waiting to be sent, per system
+  static RemotePacketBatcher g_batcher;
 
-  // Data buffers for non-blocking receives
-  static char**   g_pRxBuffers;
+  // Receive buffer, grown to the largest message received
+  static std::vector<uint8_t> g_rxBuffer;
 
   // List of pending non-blocking sends
   static std::list<NullMessageSentBuffer> g_pendingTx;
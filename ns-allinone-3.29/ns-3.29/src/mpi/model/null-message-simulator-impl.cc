@@ -21,7 +21,8 @@
 
 #include "null-message-simulator-impl.h"
 
-#include "null-message-mpi-interface.h"
+#include "null-message-communication-interface.h"
+#include "remote-packet-batcher.h"
 #include "remote-channel-bundle-manager.h"
 #include "remote-channel-bundle.h"
 #include "mpi-interface.h"
@@ -32,6 +33,8 @@
 #include <ns3/channel.h>
 #include <ns3/node-container.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
 #include <ns3/ptr.h>
 #include <ns3/pointer.h>
 #include <ns3/assert.h>
@@ -61,6 +64,33 @@ NullMessageSimulatorImpl::GetTypeId (void)
                    DoubleValue (1.0),
                    MakeDoubleAccessor (&NullMessageSimulatorImpl::m_schedulerTune),
                    MakeDoubleChecker<double> (0.01,1.0))
+    .AddAttribute ("DemandDriven",
+                   "Send Null Messages only when this task blocks, or when a "
+                   "remote task blocked on it asks for them, instead of "
+                   "periodically on each remote channel bundle.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NullMessageSimulatorImpl::m_demandDriven),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NullMessagesSent", "The number of messages without packets sent.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&NullMessageSimulatorImpl::m_nullMessagesSent),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("PacketMessagesSent", "The number of messages with packets sent.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&NullMessageSimulatorImpl::m_packetMessagesSent),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("NullMessagesReceived", "The number of messages without packets received.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&NullMessageSimulatorImpl::m_nullMessagesReceived),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("PacketMessagesReceived", "The number of messages with packets received.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&NullMessageSimulatorImpl::m_packetMessagesReceived),
+                   MakeUintegerChecker<uint64_t> ())
   ;
   return tid;
 }
@@ -88,6 +118,11 @@ NullMessageSimulatorImpl::NullMessageSimulatorImpl ()
 
   m_safeTime = Seconds (0);
 
+  m_nullMessagesSent = 0;
+  m_packetMessagesSent = 0;
+  m_nullMessagesReceived = 0;
+  m_packetMessagesReceived = 0;
+
   NS_ASSERT (g_instance == 0);
   g_instance = this;
 
@@ -194,15 +229,17 @@ NullMessageSimulatorImpl::CalculateLookAhead (void)
                   remoteChannelBundle = RemoteChannelBundleManager::Add (remoteNode->GetSystemId ());
                 }
 
+              Ptr<NetDevice> remoteNetDevice = channel->GetDevice (0) == localNetDevice ?
+                channel->GetDevice (1) : channel->GetDevice (0);
               TimeValue delay;
               channel->GetAttribute ("Delay", delay);
-              remoteChannelBundle->AddChannel (channel, delay.Get () );
+              remoteChannelBundle->AddChannel (channel, delay.Get (), remoteNetDevice);
             }
         }
     }
 
   // Completed setup of remote channel bundles.  Setup send and receive buffers.
-  NullMessageMpiInterface::InitializeSendReceiveBuffers ();
+  NullMessageCommunicationInterface::GetInstance ()->InitializeSendReceiveBuffers ();
 
   // Initialized to 0 as we don't have a simulation start time.
   m_safeTime = Time (0);
@@ -266,6 +303,11 @@ NullMessageSimulatorImpl::ScheduleNullMessageEvent (Ptr<RemoteChannelBundle> bun
 {
   NS_LOG_FUNCTION (this << bundle);
 
+  if (m_demandDriven)
+    {
+      return;
+    }
+
   Time delay (m_schedulerTune * bundle->GetDelay ().GetTimeStep ());
 
   bundle->SetEventId (Simulator::Schedule (delay, &NullMessageSimulatorImpl::NullMessageEventHandler, 
@@ -277,6 +319,11 @@ NullMessageSimulatorImpl::RescheduleNullMessageEvent (Ptr<RemoteChannelBundle> b
 {
   NS_LOG_FUNCTION (this << bundle);
 
+  if (m_demandDriven)
+    {
+      return;
+    }
+
   Simulator::Cancel (bundle->GetEventId ());
 
   Time delay (m_schedulerTune * bundle->GetDelay ().GetTimeStep ());
@@ -314,14 +361,137 @@ NullMessageSimulatorImpl::Run (void)
       if ( nextTime <= GetSafeTime () )
         {
           ProcessOneEvent ();
+          // Send the packets batched at this time once it is over
+          if (!IsFinished () && Next () > nextTime)
+            {
+              NullMessageCommunicationInterface::GetInstance ()->FlushMessages ();
+              if (m_demandDriven)
+                {
+                  SendNullMessages (false);
+                }
+            }
           HandleArrivingMessagesNonBlocking ();
         }
       else
         {
           // Block until packet or Null Message has been received.
+          NullMessageCommunicationInterface::GetInstance ()->FlushMessages ();
+          if (m_demandDriven)
+            {
+              SendNullMessages (true);
+            }
           HandleArrivingMessagesBlocking ();
         }
     }
+
+  if (m_demandDriven)
+    {
+      // No packet sent from now on can arrive before the lookahead.
+      for (uint32_t sid = 0; sid < m_systemCount; ++sid)
+        {
+          Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (sid);
+          if (bundle)
+            {
+              Time guarantee = bundle->GetEarliestArrival (Now ());
+              if (guarantee > bundle->GetSentGuaranteeTime ())
+                {
+                  NullMessageCommunicationInterface::GetInstance ()->SendNullMessage (guarantee, bundle, Time (0));
+                }
+            }
+        }
+    }
+
+  NS_LOG_INFO ("Rank " << m_myId << " sent " << m_nullMessagesSent << " null and "
+               << m_packetMessagesSent << " packet messages, received "
+               << m_nullMessagesReceived << " null and " << m_packetMessagesReceived
+               << " packet messages");
+}
+
+void
+NullMessageSimulatorImpl::SendNullMessages (bool blocking)
+{
+  NS_LOG_FUNCTION (this << blocking);
+
+  for (uint32_t sid = 0; sid < m_systemCount; ++sid)
+    {
+      Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (sid);
+      if (!bundle)
+        {
+          continue;
+        }
+      Time guarantee = CalculateGuaranteeTime (sid);
+      bool advanced = guarantee > bundle->GetSentGuaranteeTime ();
+      // Answer a request once the guarantee time requested is reached,
+      // and with the progress made so far before blocking
+      bool demanded = bundle->GetDemand ().IsStrictlyPositive ();
+      bool answer = demanded && (blocking || guarantee >= bundle->GetDemand ());
+      // Ask the bundles holding this task back for the time of its next
+      // event, once per message received from them.
+      Time request (0);
+      if (blocking && bundle->GetGuaranteeTime () < Next () && !bundle->IsRequested ())
+        {
+          request = Next ();
+          bundle->SetRequested (true);
+        }
+      if ((advanced && answer) || request.IsStrictlyPositive ())
+        {
+          NullMessageCommunicationInterface::GetInstance ()->SendNullMessage (guarantee, bundle, request);
+        }
+    }
+}
+
+void
+NullMessageSimulatorImpl::HandleMessage (uint32_t sid, const uint8_t *buffer, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << sid << size);
+
+  // Schedule the packets, if any
+  uint64_t guarantee;
+  uint64_t request;
+  if (RemotePacketBatcher::Deliver (buffer, size, guarantee, request) > 0)
+    {
+      m_packetMessagesReceived++;
+    }
+  else
+    {
+      m_nullMessagesReceived++;
+    }
+
+  // Update guarantee time for both packet receives and Null Messages.
+  Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (sid);
+  NS_ASSERT (bundle);
+  bundle->SetGuaranteeTime (Time (guarantee));
+  bundle->SetRequested (false);
+  if (request > 0)
+    {
+      bundle->SetDemand (Max (bundle->GetDemand (), Time (request)));
+    }
+}
+
+void
+NullMessageSimulatorImpl::NotifyMessageSent (uint32_t sid, const Time &guarantee, uint32_t packets)
+{
+  NS_LOG_FUNCTION (this << sid << guarantee << packets);
+
+  if (packets > 0)
+    {
+      m_packetMessagesSent++;
+    }
+  else
+    {
+      m_nullMessagesSent++;
+    }
+
+  Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (sid);
+  NS_ASSERT (bundle);
+  if (guarantee > bundle->GetSentGuaranteeTime ())
+    {
+      bundle->SetSentGuaranteeTime (guarantee);
+    }
+  if (guarantee >= bundle->GetDemand ())
+    {
+      bundle->SetDemand (Time (0));
+    }
 }
 
 void
@@ -329,12 +499,12 @@ NullMessageSimulatorImpl::HandleArrivingMessagesNonBlocking (void)
 {
   NS_LOG_FUNCTION (this);
 
-  NullMessageMpiInterface::ReceiveMessagesNonBlocking ();
+  NullMessageCommunicationInterface::GetInstance ()->ReceiveMessagesNonBlocking ();
 
   CalculateSafeTime ();
 
   // Check for send completes
-  NullMessageMpiInterface::TestSendComplete ();
+  NullMessageCommunicationInterface::GetInstance ()->TestSendComplete ();
 }
 
 void
@@ -342,12 +512,12 @@ NullMessageSimulatorImpl::HandleArrivingMessagesBlocking (void)
 {
   NS_LOG_FUNCTION (this);
 
-  NullMessageMpiInterface::ReceiveMessagesBlocking ();
+  NullMessageCommunicationInterface::GetInstance ()->ReceiveMessagesBlocking ();
 
   CalculateSafeTime ();
 
   // Check for send completes
-  NullMessageMpiInterface::TestSendComplete ();
+  NullMessageCommunicationInterface::GetInstance ()->TestSendComplete ();
 }
 
 void
@@ -580,15 +750,18 @@ Time NullMessageSimulatorImpl::CalculateGuaranteeTime (uint32_t nodeSysId)
   Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (nodeSysId);
   NS_ASSERT (bundle);
 
-  return Min (NullMessageSimulatorImpl::GetInstance ()->Next (), GetSafeTime ()) + bundle->GetDelay ();
+  return bundle->GetEarliestArrival (Min (NullMessageSimulatorImpl::GetInstance ()->Next (), GetSafeTime ()));
 }
 
 void NullMessageSimulatorImpl::NullMessageEventHandler(RemoteChannelBundle* bundle)
 {
   NS_LOG_FUNCTION (this << bundle);
 
-  Time time = Min (Next (), GetSafeTime ()) + bundle->GetDelay ();
-  NullMessageMpiInterface::SendNullMessage (time, bundle);
+  Time time = CalculateGuaranteeTime (bundle->GetSystemId ());
+  if (time > bundle->GetSentGuaranteeTime ())
+    {
+      NullMessageCommunicationInterface::GetInstance ()->SendNullMessage (time, bundle, Time (0));
+    }
 
   ScheduleNullMessageEvent (bundle);
 }
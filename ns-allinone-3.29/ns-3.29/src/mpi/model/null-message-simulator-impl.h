@@ -35,6 +35,7 @@ namespace ns3 {
 
 class NullMessageEvent;
 class NullMessageMpiInterface;
+class SharedMemoryInterface;
 class RemoteChannelBundle;
 
 /**
@@ -82,6 +83,7 @@ public:
 private:
   friend class NullMessageEvent;
   friend class NullMessageMpiInterface;
+  friend class SharedMemoryInterface;
   friend class RemoteChannelBundleManager;
 
   /**
@@ -158,6 +160,36 @@ private:
    */
   Time CalculateGuaranteeTime (uint32_t systemId);
 
+  /**
+   * \param blocking whether this task is about to block
+   *
+   * Send the Null Messages required by the demand driven mode: when
+   * blocking, to every bundle whose guarantee time advanced, asking
+   * the bundles which hold this task back for the time of its next
+   * event in return; otherwise, to the bundles whose request can now
+   * be answered.
+   */
+  void SendNullMessages (bool blocking);
+
+  /**
+   * \param sid system id of the sender
+   * \param buffer the message
+   * \param size the size of the message
+   *
+   * Schedule the packets of a message received from a remote task,
+   * and update the guarantee time of its bundle.
+   */
+  void HandleMessage (uint32_t sid, const uint8_t *buffer, uint32_t size);
+
+  /**
+   * \param sid system id of the destination
+   * \param guarantee guarantee time sent
+   * \param packets number of packets in the message
+   *
+   * Record a message sent to a remote task.
+   */
+  void NotifyMessageSent (uint32_t sid, const Time &guarantee, uint32_t packets);
+
   /**
    * \param bundle remote channel bundle to schedule an event for.
    *
@@ -201,6 +233,19 @@ private:
    */
   double m_schedulerTune;
 
+  /*
+   * Send Null Messages on demand rather than periodically.
+   */
+  bool m_demandDriven;
+
+  /*
+   * Messages sent and received, with and without packets.
+   */
+  uint64_t m_nullMessagesSent;
+  uint64_t m_packetMessagesSent;
+  uint64_t m_nullMessagesReceived;
+  uint64_t m_packetMessagesReceived;
+
   /*
    * Singleton instance.
    */
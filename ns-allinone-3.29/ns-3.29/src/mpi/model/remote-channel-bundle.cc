@@ -21,10 +21,11 @@
 
 #include "remote-channel-bundle.h"
 
-#include "null-message-mpi-interface.h"
+#include "null-message-communication-interface.h"
 #include "null-message-simulator-impl.h"
 
 #include <ns3/simulator.h>
+#include <ns3/node.h>
 
 namespace ns3 {
 
@@ -42,22 +43,94 @@ TypeId RemoteChannelBundle::GetTypeId (void)
 RemoteChannelBundle::RemoteChannelBundle ()
   : m_remoteSystemId (UINT32_MAX),
     m_guaranteeTime (0),
-    m_delay (NS_TIME_INFINITY)
+    m_delay (NS_TIME_INFINITY),
+    m_sentGuaranteeTime (0),
+    m_demand (0),
+    m_requested (false)
 {
 }
 
 RemoteChannelBundle::RemoteChannelBundle (const uint32_t remoteSystemId)
   : m_remoteSystemId (remoteSystemId),
     m_guaranteeTime (0),
-    m_delay (NS_TIME_INFINITY)
+    m_delay (NS_TIME_INFINITY),
+    m_sentGuaranteeTime (0),
+    m_demand (0),
+    m_requested (false)
 {
 }
 
 void
-RemoteChannelBundle::AddChannel (Ptr<Channel> channel, Time delay)
+RemoteChannelBundle::AddChannel (Ptr<Channel> channel, Time delay, Ptr<NetDevice> remoteDevice)
 {
   m_channels[channel->GetId ()] = channel;
   m_delay = ns3::Min (m_delay, delay);
+  std::pair<uint32_t, uint32_t> destination (remoteDevice->GetNode ()->GetId (), remoteDevice->GetIfIndex ());
+  m_arrivals[destination] = std::make_pair (delay, Time (0));
+}
+
+Time
+RemoteChannelBundle::GetEarliestArrival (Time time) const
+{
+  if (m_arrivals.empty ())
+    {
+      return time + m_delay;
+    }
+  Time earliest = NS_TIME_INFINITY;
+  for (std::map < std::pair < uint32_t, uint32_t >, std::pair < Time, Time > >::const_iterator i = m_arrivals.begin ();
+       i != m_arrivals.end ();
+       ++i)
+    {
+      earliest = ns3::Min (earliest, ns3::Max (time + i->second.first, i->second.second));
+    }
+  return earliest;
+}
+
+void
+RemoteChannelBundle::NotifyPacketSent (uint32_t node, uint32_t dev, Time rxTime)
+{
+  std::map < std::pair < uint32_t, uint32_t >, std::pair < Time, Time > >::iterator i =
+    m_arrivals.find (std::make_pair (node, dev));
+  if (i != m_arrivals.end ())
+    {
+      i->second.second = ns3::Max (i->second.second, rxTime);
+    }
+}
+
+Time
+RemoteChannelBundle::GetSentGuaranteeTime (void) const
+{
+  return m_sentGuaranteeTime;
+}
+
+void
+RemoteChannelBundle::SetSentGuaranteeTime (Time time)
+{
+  m_sentGuaranteeTime = time;
+}
+
+Time
+RemoteChannelBundle::GetDemand (void) const
+{
+  return m_demand;
+}
+
+void
+RemoteChannelBundle::SetDemand (Time demand)
+{
+  m_demand = demand;
+}
+
+bool
+RemoteChannelBundle::IsRequested (void) const
+{
+  return m_requested;
+}
+
+void
+RemoteChannelBundle::SetRequested (bool requested)
+{
+  m_requested = requested;
 }
 
 uint32_t
@@ -107,7 +180,7 @@ RemoteChannelBundle::GetSize (void) const
 void 
 RemoteChannelBundle::Send(Time time)
 {
-  NullMessageMpiInterface::SendNullMessage (time, this);  
+  NullMessageCommunicationInterface::GetInstance ()->SendNullMessage (time, this, Time (0));
 }
 
 std::ostream& operator<< (std::ostream& out, ns3::RemoteChannelBundle& bundle )
@@ -25,6 +25,7 @@
 #include "null-message-simulator-impl.h"
 
 #include <ns3/channel.h>
+#include <ns3/net-device.h>
 #include <ns3/ptr.h>
 #include <ns3/pointer.h>
 
@@ -58,8 +59,9 @@ public:
   /**
    * \param channel to add to the bundle
    * \param delay time for the channel (usually the latency)
+   * \param remoteDevice the device of the channel on the remote side
    */
-  void AddChannel (Ptr<Channel> channel, Time delay);
+  void AddChannel (Ptr<Channel> channel, Time delay, Ptr<NetDevice> remoteDevice);
 
   /**
    * \return SystemID for remote side of this bundle
@@ -84,6 +86,56 @@ public:
    */
   Time GetDelay (void) const;
 
+  /**
+   * \param time time from which this task may send packets
+   * \return the earliest receive time of these packets
+   *
+   * The lookahead of each channel is its delay, but a packet cannot
+   * arrive before the ones already in flight on the same channel.
+   */
+  Time GetEarliestArrival (Time time) const;
+
+  /**
+   * \param node destination node
+   * \param dev destination device
+   * \param rxTime receive time of the packet
+   *
+   * Record a packet sent across this bundle.
+   */
+  void NotifyPacketSent (uint32_t node, uint32_t dev, Time rxTime);
+
+  /**
+   * \return the last guarantee time sent across this bundle
+   */
+  Time GetSentGuaranteeTime (void) const;
+
+  /**
+   * \param time guarantee time sent across this bundle
+   */
+  void SetSentGuaranteeTime (Time time);
+
+  /**
+   * \return the guarantee time the remote task waits for, or 0.
+   */
+  Time GetDemand (void) const;
+
+  /**
+   * \param demand the guarantee time the remote task waits for, or 0.
+   */
+  void SetDemand (Time demand);
+
+  /**
+   * \return true if this task requested a guarantee time update and
+   * did not receive a message since.
+   */
+  bool IsRequested (void) const;
+
+  /**
+   * \param requested whether this task waits for a guarantee time
+   * update.
+   */
+  void SetRequested (bool requested);
+
   /**
    * Set the event ID of the Null Message send event current scheduled
    * for this channel.
@@ -144,6 +196,27 @@ private:
    */
   EventId m_nullEventId;
 
+  /*
+   * Delay and receive time of the last packet sent, for each channel,
+   * by destination node and device.
+   */
+  std::map < std::pair < uint32_t, uint32_t >, std::pair < Time, Time > > m_arrivals;
+
+  /*
+   * Last guarantee time sent to the remote task.
+   */
+  Time m_sentGuaranteeTime;
+
+  /*
+   * Guarantee time the remote task waits for, or 0.
+   */
+  Time m_demand;
+
+  /*
+   * This task waits for a guarantee time update.
+   */
+  bool m_requested;
+
 };
 
 }
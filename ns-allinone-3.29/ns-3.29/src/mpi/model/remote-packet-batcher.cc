@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "remote-packet-batcher.h"
+#include "mpi-receiver.h"
+
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+#include <cstring>
+
+/**
+ * \file
+ * \ingroup mpi
+ * ns3::RemotePacketBatcher implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RemotePacketBatcher");
+
+/**
+ * \ingroup mpi
+ * \brief Message size above which the packets aggregated for a system
+ * are sent.
+ */
+static GlobalValue g_aggregationSize =
+  GlobalValue ("MpiAggregationSize",
+               "The size, in bytes, above which the packets aggregated "
+               "for a remote system are sent.  0 sends each packet "
+               "in its own message.",
+               UintegerValue (16384),
+               MakeUintegerChecker<uint32_t> ());
+
+namespace {
+
+/**
+ * Append a value to a message.
+ * \param [in,out] data The message.
+ * \param [in] v The value.
+ */
+template <typename T>
+void
+Append (std::vector<uint8_t> &data, T v)
+{
+  std::size_t offset = data.size ();
+  data.resize (offset + sizeof (v));
+  std::memcpy (&data[offset], &v, sizeof (v));
+}
+
+/**
+ * Read a value from a message.
+ * \param [in,out] p The read position.
+ * \return The value.
+ */
+template <typename T>
+T
+Read (const uint8_t *&p)
+{
+  T v;
+  std::memcpy (&v, p, sizeof (v));
+  p += sizeof (v);
+  return v;
+}
+
+} // unnamed namespace
+
+RemotePacketBatcher::RemotePacketBatcher ()
+  : m_maxSize (0)
+{
+}
+
+void
+RemotePacketBatcher::Initialize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  UintegerValue maxSize;
+  g_aggregationSize.GetValue (maxSize);
+  m_maxSize = maxSize.Get ();
+  m_batches.resize (size);
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      m_batches[i].data.resize (HEADER_SIZE);
+      m_batches[i].count = 0;
+      m_batches[i].request = 0;
+    }
+}
+
+bool
+RemotePacketBatcher::Add (uint32_t sid, Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev)
+{
+  NS_LOG_FUNCTION (this << sid << p << rxTime.GetTimeStep () << node << dev);
+  NS_ASSERT (sid < m_batches.size ());
+  Batch &batch = m_batches[sid];
+
+  bool raw = !p->BeginItem ().HasNext ()
+    && !p->GetPacketTagIterator ().HasNext ()
+    && !p->GetByteTagIterator ().HasNext ()
+    && p->GetNixVector () == 0;
+  uint32_t size = raw ? p->GetSize () : p->GetSerializedSize ();
+
+  Append<uint64_t> (batch.data, rxTime.GetInteger ());
+  Append<uint32_t> (batch.data, node);
+  Append<uint32_t> (batch.data, dev);
+  Append<uint32_t> (batch.data, raw ? (size | RAW_FLAG) : size);
+  std::size_t offset = batch.data.size ();
+  batch.data.resize (offset + size);
+  if (size > 0)
+    {
+      if (raw)
+        {
+          p->CopyData (&batch.data[offset], size);
+        }
+      else
+        {
+          p->Serialize (&batch.data[offset], size);
+        }
+    }
+  batch.count++;
+  return batch.data.size () >= m_maxSize;
+}
+
+uint32_t
+RemotePacketBatcher::GetPending (uint32_t sid) const
+{
+  NS_ASSERT (sid < m_batches.size ());
+  return m_batches[sid].count;
+}
+
+void
+RemotePacketBatcher::SetRequest (uint32_t sid, uint64_t request)
+{
+  NS_LOG_FUNCTION (this << sid << request);
+  NS_ASSERT (sid < m_batches.size ());
+  m_batches[sid].request = request;
+}
+
+uint8_t *
+RemotePacketBatcher::Take (uint32_t sid, uint64_t guarantee, uint32_t &size)
+{
+  NS_LOG_FUNCTION (this << sid << guarantee);
+  NS_ASSERT (sid < m_batches.size ());
+  Batch &batch = m_batches[sid];
+
+  std::memcpy (&batch.data[0], &guarantee, sizeof (guarantee));
+  std::memcpy (&batch.data[sizeof (guarantee)], &batch.request, sizeof (batch.request));
+  std::memcpy (&batch.data[sizeof (guarantee) + sizeof (batch.request)], &batch.count, sizeof (batch.count));
+  size = batch.data.size ();
+  uint8_t *buffer = new uint8_t[size];
+  std::memcpy (buffer, &batch.data[0], size);
+
+  batch.data.resize (HEADER_SIZE);
+  batch.count = 0;
+  batch.request = 0;
+  return buffer;
+}
+
+uint32_t
+RemotePacketBatcher::Deliver (const uint8_t *buffer, uint32_t size, uint64_t &guarantee, uint64_t &request)
+{
+  NS_LOG_FUNCTION (buffer << size);
+  NS_ASSERT (size >= HEADER_SIZE);
+  const uint8_t *p = buffer;
+  guarantee = Read<uint64_t> (p);
+  request = Read<uint64_t> (p);
+  uint32_t count = Read<uint32_t> (p);
+
+  for (uint32_t n = 0; n < count; ++n)
+    {
+      Time rxTime (Read<uint64_t> (p));
+      uint32_t node = Read<uint32_t> (p);
+      uint32_t dev = Read<uint32_t> (p);
+      uint32_t packetSize = Read<uint32_t> (p);
+      bool raw = (packetSize & RAW_FLAG) != 0;
+      packetSize &= ~RAW_FLAG;
+      NS_ASSERT (p + packetSize <= buffer + size);
+
+      Ptr<Packet> packet;
+      if (raw)
+        {
+          packet = Create<Packet> (p, packetSize);
+        }
+      else
+        {
+          packet = Create<Packet> (p, packetSize, true);
+        }
+      p += packetSize;
+
+      // Find the correct node/device to schedule receive event
+      Ptr<Node> pNode = NodeList::GetNode (node);
+      Ptr<MpiReceiver> pMpiRec = 0;
+      uint32_t nDevices = pNode->GetNDevices ();
+      for (uint32_t i = 0; i < nDevices; ++i)
+        {
+          Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
+          if (pThisDev->GetIfIndex () == dev)
+            {
+              pMpiRec = pThisDev->GetObject<MpiReceiver> ();
+              break;
+            }
+        }
+
+      NS_ASSERT (pNode && pMpiRec);
+
+      // Schedule the rx event
+      Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
+                                      &MpiReceiver::Receive, pMpiRec, packet);
+    }
+  return count;
+}
+
+} // namespace ns3
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_REMOTE_PACKET_BATCHER_H
+#define NS3_REMOTE_PACKET_BATCHER_H
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mpi
+ * ns3::RemotePacketBatcher declaration.
+ */
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Aggregates the packets sent to each remote system into
+ * messages, and delivers the packets of received messages.
+ *
+ * The parallel communication interfaces Add() each packet to the batch
+ * of its destination system, and Take() the batch as a single message
+ * when it reaches the size given by the \c MpiAggregationSize global
+ * value, or when the simulator implementation requires it to be
+ * flushed (at the end of a granted time window, before blocking for
+ * messages, or before sending a Null Message).
+ *
+ * \internal
+ * Message format, in host byte order:
+ *
+ *     uint64_t guarantee time (Null Message algorithm), or 0
+ *     uint64_t guarantee time requested in return, or 0
+ *     uint32_t number of packets
+ *
+ * followed by, for each packet:
+ *
+ *     uint64_t time the packet should be delivered
+ *     uint32_t node id of destination
+ *     uint32_t dev id on destination
+ *     uint32_t packet size, with RAW_FLAG set for raw packets
+ *     uint8_t[] serialized packet, or raw packet bytes
+ *
+ * A packet without metadata items, tags or nix-vector is sent as its
+ * raw bytes instead of with Packet::Serialize, which saves the empty
+ * metadata and tag sections and their (de)serialization.
+ */
+class RemotePacketBatcher
+{
+public:
+  RemotePacketBatcher ();
+
+  /**
+   * Allocate one batch per system.
+   * \param [in] size The number of systems.
+   */
+  void Initialize (uint32_t size);
+
+  /**
+   * Append a packet to the batch of a system.
+   * \param [in] sid The system id of the destination node.
+   * \param [in] p The packet.
+   * \param [in] rxTime The time the packet should be delivered.
+   * \param [in] node The destination node.
+   * \param [in] dev The destination device.
+   * \return \c true if the batch should now be sent.
+   */
+  bool Add (uint32_t sid, Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+
+  /**
+   * \param [in] sid The system id.
+   * \return The number of packets in the batch of \p sid.
+   */
+  uint32_t GetPending (uint32_t sid) const;
+
+  /**
+   * Ask a system, with the next message, for a guarantee time (Null
+   * Message algorithm).
+   * \param [in] sid The system id.
+   * \param [in] request The guarantee time requested.
+   */
+  void SetRequest (uint32_t sid, uint64_t request);
+
+  /**
+   * Take the batch of a system as a message, and start a new batch.
+   * \param [in] sid The system id.
+   * \param [in] guarantee The guarantee time to send with the message.
+   * \param [out] size The size of the message.
+   * \return The message, allocated with new[].
+   */
+  uint8_t * Take (uint32_t sid, uint64_t guarantee, uint32_t &size);
+
+  /**
+   * Schedule the reception of the packets of a message.
+   * \param [in] buffer The message.
+   * \param [in] size The size of the message.
+   * \param [out] guarantee The guarantee time sent with the message.
+   * \param [out] request The guarantee time requested by the message.
+   * \return The number of packets in the message.
+   */
+  static uint32_t Deliver (const uint8_t *buffer, uint32_t size, uint64_t &guarantee, uint64_t &request);
+
+  /** Size of the message header. */
+  static const uint32_t HEADER_SIZE = 20;
+
+private:
+  /** Packet size flag marking a raw packet. */
+  static const uint32_t RAW_FLAG = 0x80000000;
+
+  /** A batch being filled. */
+  struct Batch
+  {
+    std::vector<uint8_t> data;   //!< The message, header included
+    uint32_t count;              //!< Number of packets
+    uint64_t request;            //!< Guarantee time requested, or 0
+  };
+
+  std::vector<Batch> m_batches;  //!< One batch per system
+  uint32_t m_maxSize;            //!< Message size which triggers a send
+};
+
+} // namespace ns3
+
+#endif /* NS3_REMOTE_PACKET_BATCHER_H */
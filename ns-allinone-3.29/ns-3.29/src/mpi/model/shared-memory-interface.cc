@@ -0,0 +1,505 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "shared-memory-interface.h"
+
+#include "null-message-simulator-impl.h"
+#include "remote-channel-bundle-manager.h"
+#include "remote-channel-bundle.h"
+
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/packet.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup mpi
+ * ns3::SharedMemoryInterface implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SharedMemoryInterface");
+
+/**
+ * \ingroup mpi
+ * \brief Number of processes of a shared memory distributed
+ * simulation.
+ */
+static GlobalValue g_sharedMemoryRanks =
+  GlobalValue ("SharedMemoryRanks",
+               "The number of processes MpiInterface::Enable runs the "
+               "simulation on, communicating through shared memory "
+               "instead of MPI.  0 uses MPI.",
+               UintegerValue (0),
+               MakeUintegerChecker<uint32_t> ());
+
+/**
+ * \ingroup mpi
+ * \brief Size of each shared memory ring.
+ */
+static GlobalValue g_sharedMemoryRingSize =
+  GlobalValue ("SharedMemoryRingSize",
+               "The size, in bytes, of the shared memory ring from each "
+               "system to each other system.  It must hold the largest "
+               "message, see MpiAggregationSize.",
+               UintegerValue (1 << 20),
+               MakeUintegerChecker<uint32_t> (1024));
+
+/**
+ * Control block of a ring.  The head and tail are free-running byte
+ * counts, each in its own cache line; the data follows the block.
+ */
+struct SharedMemoryInterface::Ring
+{
+  std::atomic<uint64_t> head;  //!< Bytes read, written by the receiver
+  uint8_t pad0[56];            //!< Padding to a cache line
+  std::atomic<uint64_t> tail;  //!< Bytes written, written by the sender
+  uint8_t pad1[56];            //!< Padding to a cache line
+};
+
+namespace {
+
+/**
+ * Wait a little, giving the processor to the other systems.
+ */
+void
+Pause (void)
+{
+  sched_yield ();
+}
+
+/**
+ * Copy bytes into a ring, wrapping around its end.
+ * \param [in] data The ring data.
+ * \param [in] capacity The ring data size.
+ * \param [in] position The free-running position to copy to.
+ * \param [in] from The bytes.
+ * \param [in] size The number of bytes.
+ */
+void
+CopyIn (uint8_t *data, uint32_t capacity, uint64_t position, const uint8_t *from, uint32_t size)
+{
+  uint32_t offset = position % capacity;
+  uint32_t first = std::min (size, capacity - offset);
+  std::memcpy (data + offset, from, first);
+  std::memcpy (data, from + first, size - first);
+}
+
+/**
+ * Copy bytes out of a ring, wrapping around its end.
+ * \param [in] data The ring data.
+ * \param [in] capacity The ring data size.
+ * \param [in] position The free-running position to copy from.
+ * \param [out] to The bytes.
+ * \param [in] size The number of bytes.
+ */
+void
+CopyOut (const uint8_t *data, uint32_t capacity, uint64_t position, uint8_t *to, uint32_t size)
+{
+  uint32_t offset = position % capacity;
+  uint32_t first = std::min (size, capacity - offset);
+  std::memcpy (to, data + offset, first);
+  std::memcpy (to + first, data, size - first);
+}
+
+} // unnamed namespace
+
+SharedMemoryInterface::SharedMemoryInterface ()
+  : m_sid (0),
+    m_size (1),
+    m_numNeighbors (0),
+    m_enabled (false),
+    m_region (0),
+    m_regionSize (0),
+    m_capacity (0),
+    m_stride (0),
+    m_parent (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SharedMemoryInterface::~SharedMemoryInterface ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SharedMemoryInterface::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+SharedMemoryInterface::GetSystemId ()
+{
+  NS_ASSERT (m_enabled);
+  return m_sid;
+}
+
+uint32_t
+SharedMemoryInterface::GetSize ()
+{
+  NS_ASSERT (m_enabled);
+  return m_size;
+}
+
+bool
+SharedMemoryInterface::IsEnabled ()
+{
+  return m_enabled;
+}
+
+void
+SharedMemoryInterface::Enable (int* pargc, char*** pargv)
+{
+  NS_LOG_FUNCTION (this << *pargc);
+  NS_UNUSED (pargv);
+
+  UintegerValue ranks;
+  g_sharedMemoryRanks.GetValue (ranks);
+  UintegerValue ringSize;
+  g_sharedMemoryRingSize.GetValue (ringSize);
+  m_size = ranks.Get ();
+  NS_ABORT_MSG_IF (m_size == 0, "SharedMemoryRanks must be positive");
+
+  m_capacity = ringSize.Get ();
+  m_stride = sizeof (Ring) + ((m_capacity + 63) & ~static_cast<std::size_t> (63));
+  m_regionSize = m_stride * m_size * m_size;
+  void *region = mmap (0, m_regionSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (region == MAP_FAILED)
+    {
+      NS_FATAL_ERROR ("mmap() of " << m_regionSize << " bytes failed: " << std::strerror (errno));
+    }
+  m_region = static_cast<uint8_t *> (region);
+  for (uint32_t from = 0; from < m_size; ++from)
+    {
+      for (uint32_t to = 0; to < m_size; ++to)
+        {
+          Ring *ring = new (m_region + (from * m_size + to) * m_stride) Ring;
+          ring->head.store (0, std::memory_order_relaxed);
+          ring->tail.store (0, std::memory_order_relaxed);
+        }
+    }
+  NS_ASSERT (GetRing (0, 0)->head.is_lock_free ());
+
+  // Output buffered so far must not be printed by every process.
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::fflush (0);
+
+  m_parent = getpid ();
+  m_sid = 0;
+  for (uint32_t sid = 1; sid < m_size; ++sid)
+    {
+      pid_t pid = fork ();
+      if (pid < 0)
+        {
+          NS_FATAL_ERROR ("fork() failed: " << std::strerror (errno));
+        }
+      if (pid == 0)
+        {
+          m_sid = sid;
+          m_children.clear ();
+          break;
+        }
+      m_children.push_back (pid);
+    }
+
+  m_enabled = true;
+}
+
+void
+SharedMemoryInterface::InitializeSendReceiveBuffers (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_enabled);
+
+  m_numNeighbors = RemoteChannelBundleManager::Size ();
+  m_batcher.Initialize (m_size);
+  m_backlog.resize (m_size);
+}
+
+SharedMemoryInterface::Ring *
+SharedMemoryInterface::GetRing (uint32_t from, uint32_t to) const
+{
+  return reinterpret_cast<Ring *> (m_region + (from * m_size + to) * m_stride);
+}
+
+void
+SharedMemoryInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t node, uint32_t dev)
+{
+  NS_LOG_FUNCTION (this << p << rxTime.GetTimeStep () << node << dev);
+  NS_ASSERT (m_enabled);
+
+  // Find the system id for the destination node
+  Ptr<Node> destNode = NodeList::GetNode (node);
+  uint32_t nodeSysId = destNode->GetSystemId ();
+
+  Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (nodeSysId);
+  NS_ASSERT (bundle);
+  bundle->NotifyPacketSent (node, dev, rxTime);
+
+  if (m_batcher.Add (nodeSysId, p, rxTime, node, dev))
+    {
+      Time guarantee_update = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId);
+      Flush (nodeSysId, guarantee_update);
+      NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (nodeSysId);
+    }
+}
+
+void
+SharedMemoryInterface::FlushMessages (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_enabled);
+
+  for (uint32_t sid = 0; sid < m_size; ++sid)
+    {
+      if (m_batcher.GetPending (sid) > 0)
+        {
+          Time guarantee_update = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (sid);
+          Flush (sid, guarantee_update);
+          NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (sid);
+        }
+    }
+}
+
+void
+SharedMemoryInterface::SendNullMessage (const Time& guarantee_update, Ptr<RemoteChannelBundle> bundle, const Time& request)
+{
+  NS_LOG_FUNCTION (this << guarantee_update.GetTimeStep () << bundle << request.GetTimeStep ());
+  NS_ASSERT (m_enabled);
+
+  if (request.IsStrictlyPositive ())
+    {
+      m_batcher.SetRequest (bundle->GetSystemId (), request.GetInteger ());
+    }
+  Flush (bundle->GetSystemId (), guarantee_update);
+}
+
+void
+SharedMemoryInterface::Flush (uint32_t sid, const Time &guaranteeUpdate)
+{
+  NS_LOG_FUNCTION (this << sid << guaranteeUpdate.GetTimeStep ());
+
+  NullMessageSimulatorImpl::GetInstance ()->NotifyMessageSent (sid, guaranteeUpdate, m_batcher.GetPending (sid));
+  uint32_t size;
+  uint8_t *buffer = m_batcher.Take (sid, guaranteeUpdate.GetInteger (), size);
+  Write (sid, buffer, size);
+  delete [] buffer;
+}
+
+void
+SharedMemoryInterface::Write (uint32_t sid, const uint8_t *buffer, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << sid << size);
+
+  uint64_t total = sizeof (size) + size;
+  NS_ABORT_MSG_IF (total > m_capacity,
+                   "Message of " << size << " bytes does not fit in SharedMemoryRingSize " << m_capacity);
+
+  Ring *ring = GetRing (m_sid, sid);
+  uint8_t *data = reinterpret_cast<uint8_t *> (ring + 1);
+  uint64_t tail = ring->tail.load (std::memory_order_relaxed);
+  while (m_capacity - (tail - ring->head.load (std::memory_order_acquire)) < total)
+    {
+      Drain ();
+      CheckPeers ();
+      Pause ();
+    }
+
+  CopyIn (data, m_capacity, tail, reinterpret_cast<const uint8_t *> (&size), sizeof (size));
+  CopyIn (data, m_capacity, tail + sizeof (size), buffer, size);
+  ring->tail.store (tail + total, std::memory_order_release);
+}
+
+bool
+SharedMemoryInterface::Read (uint32_t sid, std::vector<uint8_t> &message)
+{
+  Ring *ring = GetRing (sid, m_sid);
+  const uint8_t *data = reinterpret_cast<const uint8_t *> (ring + 1);
+  uint64_t head = ring->head.load (std::memory_order_relaxed);
+  if (ring->tail.load (std::memory_order_acquire) == head)
+    {
+      return false;
+    }
+
+  uint32_t size;
+  CopyOut (data, m_capacity, head, reinterpret_cast<uint8_t *> (&size), sizeof (size));
+  message.resize (size);
+  CopyOut (data, m_capacity, head + sizeof (size), &message[0], size);
+  ring->head.store (head + sizeof (size) + size, std::memory_order_release);
+  return true;
+}
+
+void
+SharedMemoryInterface::Drain (void)
+{
+  for (uint32_t sid = 0; sid < m_size; ++sid)
+    {
+      if (sid == m_sid)
+        {
+          continue;
+        }
+      std::vector<uint8_t> message;
+      while (Read (sid, message))
+        {
+          m_backlog[sid].push_back (std::vector<uint8_t> ());
+          m_backlog[sid].back ().swap (message);
+        }
+    }
+}
+
+void
+SharedMemoryInterface::ReceiveMessagesBlocking (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  ReceiveMessages (true);
+}
+
+void
+SharedMemoryInterface::ReceiveMessagesNonBlocking (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  ReceiveMessages (false);
+}
+
+void
+SharedMemoryInterface::ReceiveMessages (bool blocking)
+{
+  NS_LOG_FUNCTION (this << blocking);
+  NS_ASSERT (m_enabled);
+
+  if (!m_numNeighbors)
+    {
+      // Not communicating with anyone.
+      return;
+    }
+
+  bool received = false;
+  while (true)
+    {
+      for (uint32_t sid = 0; sid < m_size; ++sid)
+        {
+          if (sid == m_sid)
+            {
+              continue;
+            }
+          while (true)
+            {
+              // Messages moved to the backlog precede the ones in the ring.
+              if (!m_backlog[sid].empty ())
+                {
+                  m_rxBuffer.swap (m_backlog[sid].front ());
+                  m_backlog[sid].pop_front ();
+                }
+              else if (!Read (sid, m_rxBuffer))
+                {
+                  break;
+                }
+
+              // Schedule the packets, and update the guarantee time
+              NullMessageSimulatorImpl::GetInstance ()->HandleMessage (sid, &m_rxBuffer[0], m_rxBuffer.size ());
+              received = true;
+            }
+        }
+      if (!blocking || received)
+        {
+          break;
+        }
+      CheckPeers ();
+      Pause ();
+    }
+}
+
+void
+SharedMemoryInterface::TestSendComplete (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Write() completes when the message is in the ring.
+}
+
+void
+SharedMemoryInterface::CheckPeers (void)
+{
+  if (m_sid != 0)
+    {
+      if (getppid () != m_parent)
+        {
+          NS_FATAL_ERROR ("System 0 exited, system " << m_sid << " aborting");
+        }
+      return;
+    }
+  for (uint32_t i = 0; i < m_children.size (); ++i)
+    {
+      int status;
+      if (m_children[i] != 0 && waitpid (m_children[i], &status, WNOHANG) == m_children[i])
+        {
+          m_children[i] = 0;
+          if (WIFSIGNALED (status) || WEXITSTATUS (status) != 0)
+            {
+              NS_FATAL_ERROR ("System " << i + 1 << " terminated abnormally");
+            }
+        }
+    }
+}
+
+void
+SharedMemoryInterface::Disable ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_enabled);
+
+  for (uint32_t i = 0; i < m_children.size (); ++i)
+    {
+      int status;
+      if (m_children[i] != 0 && waitpid (m_children[i], &status, 0) == m_children[i]
+          && (WIFSIGNALED (status) || WEXITSTATUS (status) != 0))
+        {
+          NS_LOG_WARN ("System " << i + 1 << " terminated abnormally");
+        }
+    }
+  m_children.clear ();
+
+  munmap (m_region, m_regionSize);
+  m_region = 0;
+  m_rxBuffer.clear ();
+  m_backlog.clear ();
+  m_enabled = false;
+}
+
+} // namespace ns3
@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_SHARED_MEMORY_INTERFACE_H
+#define NS3_SHARED_MEMORY_INTERFACE_H
+
+#include "null-message-communication-interface.h"
+#include "remote-packet-batcher.h"
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <deque>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mpi
+ * ns3::SharedMemoryInterface declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Interface between ns-3 and shared memory rings for the Null
+ * Message distributed simulation implementation.
+ *
+ * This interface runs a distributed simulation on a single host
+ * without MPI.  It is used instead of the NullMessageMpiInterface
+ * when the \c SharedMemoryRanks global value is not 0.
+ *
+ * Enable() maps an anonymous shared memory region holding one
+ * single-producer, single-consumer byte ring for each ordered pair
+ * of systems, then forks the processes of systems 1 to
+ * SharedMemoryRanks - 1; the calling process becomes system 0.  Each
+ * process then goes on with the program, exactly as MPI tasks do.
+ * Ranks are processes rather than threads because the Simulator is a
+ * process-wide singleton.
+ *
+ * The messages are the ones of the RemotePacketBatcher, written into
+ * the ring of the destination system after a length prefix.  A sender
+ * finding the ring full moves the messages of its own incoming rings
+ * to local backlogs while it waits, so two systems sending to each
+ * other cannot deadlock.
+ *
+ * Only the Null Message algorithm is supported: the granted time
+ * window algorithm needs collective operations which this interface
+ * does not provide.
+ */
+class SharedMemoryInterface : public NullMessageCommunicationInterface
+{
+public:
+  SharedMemoryInterface ();
+  ~SharedMemoryInterface ();
+
+  // virtual from ParallelCommunicationInterface
+  virtual void Destroy ();
+  virtual uint32_t GetSystemId ();
+  virtual uint32_t GetSize ();
+  virtual bool IsEnabled ();
+  /**
+   * \param pargc number of command line arguments
+   * \param pargv command line arguments
+   *
+   * Map the rings and fork the processes of the other systems.
+   */
+  virtual void Enable (int* pargc, char*** pargv);
+  /**
+   * Wait for the processes of the other systems on system 0, and
+   * unmap the rings.
+   */
+  virtual void Disable ();
+  virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+
+  // virtual from NullMessageCommunicationInterface
+  virtual void InitializeSendReceiveBuffers (void);
+  virtual void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle, const Time& request);
+  virtual void FlushMessages (void);
+  virtual void ReceiveMessagesNonBlocking (void);
+  virtual void ReceiveMessagesBlocking (void);
+  virtual void TestSendComplete (void);
+
+private:
+  /** Control block of a ring, in shared memory. */
+  struct Ring;
+
+  /**
+   * \param [in] from The sending system.
+   * \param [in] to The receiving system.
+   * \return The ring from \p from to \p to.
+   */
+  Ring * GetRing (uint32_t from, uint32_t to) const;
+
+  /**
+   * Send the packets batched for a system, with a guarantee time.
+   * \param [in] sid The system id.
+   * \param [in] guaranteeUpdate The guarantee time.
+   */
+  void Flush (uint32_t sid, const Time &guaranteeUpdate);
+
+  /**
+   * Write a message to the ring of a system, waiting for space.
+   * \param [in] sid The system id.
+   * \param [in] buffer The message.
+   * \param [in] size The size of the message.
+   */
+  void Write (uint32_t sid, const uint8_t *buffer, uint32_t size);
+
+  /**
+   * Read the next message from the ring of a system, if any.
+   * \param [in] sid The sending system id.
+   * \param [out] message The message.
+   * \return \c true if a message was read.
+   */
+  bool Read (uint32_t sid, std::vector<uint8_t> &message);
+
+  /** Move the messages of all incoming rings to the backlogs. */
+  void Drain (void);
+
+  /**
+   * Receive the pending messages.
+   * \param [in] blocking Wait for at least one message.
+   */
+  void ReceiveMessages (bool blocking);
+
+  /** Abort if another system died. */
+  void CheckPeers (void);
+
+  uint32_t m_sid;            //!< System id of this process
+  uint32_t m_size;           //!< Number of systems
+  uint32_t m_numNeighbors;   //!< Number of systems sharing a link with this one
+  bool m_enabled;            //!< Enable() was called
+  uint8_t *m_region;         //!< The shared memory region
+  std::size_t m_regionSize;  //!< Size of the shared memory region
+  uint32_t m_capacity;       //!< Data size of each ring
+  std::size_t m_stride;      //!< Size of each ring, control block included
+  pid_t m_parent;            //!< Process id of system 0
+  std::vector<pid_t> m_children;  //!< Process ids of the other systems, on system 0
+
+  RemotePacketBatcher m_batcher;  //!< Packets waiting to be sent, per system
+  std::vector<uint8_t> m_rxBuffer;  //!< Message being delivered
+  /** Messages read while waiting to send, per sending system. */
+  std::vector<std::deque<std::vector<uint8_t> > > m_backlog;
+};
+
+} // namespace ns3
+
+#endif /* NS3_SHARED_MEMORY_INTERFACE_H */
@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/partition-helper.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mpi
+ * \defgroup mpi-test Mpi module tests
+ */
+
+/**
+ * \ingroup mpi-test
+ * \ingroup tests
+ *
+ * \brief Partition two cliques joined by a single link.
+ *
+ * Each clique must end up on its own system, cutting only the link
+ * between them.
+ */
+class PartitionHelperCliquesTestCase : public TestCase
+{
+public:
+  PartitionHelperCliquesTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PartitionHelperCliquesTestCase::PartitionHelperCliquesTestCase ()
+  : TestCase ("Partition two cliques joined by a link")
+{
+}
+
+void
+PartitionHelperCliquesTestCase::DoRun (void)
+{
+  const uint32_t size = 4;
+  NodeContainer nodes;
+  nodes.Create (2 * size);
+
+  PartitionHelper partition;
+  partition.Add (nodes);
+  for (uint32_t clique = 0; clique < 2; ++clique)
+    {
+      for (uint32_t i = 0; i < size; ++i)
+        {
+          for (uint32_t j = i + 1; j < size; ++j)
+            {
+              partition.AddLink (nodes.Get (clique * size + i), nodes.Get (clique * size + j), MilliSeconds (1));
+            }
+        }
+    }
+  partition.AddLink (nodes.Get (size - 1), nodes.Get (size), MilliSeconds (10));
+  partition.Partition (2);
+
+  NS_TEST_ASSERT_MSG_EQ (partition.GetCutLinks (), 1, "Only the link between the cliques should be cut");
+  NS_TEST_ASSERT_MSG_EQ (partition.GetLookahead (), MilliSeconds (10), "Wrong lookahead");
+  NS_TEST_ASSERT_MSG_EQ_TOL (partition.GetImbalance (), 0, 1e-9, "Systems should be balanced");
+  for (uint32_t i = 0; i < 2 * size; ++i)
+    {
+      uint32_t expected = partition.GetSystemId (nodes.Get (i / size * size));
+      NS_TEST_EXPECT_MSG_EQ (partition.GetSystemId (nodes.Get (i)), expected, "Clique split");
+      NS_TEST_EXPECT_MSG_EQ (nodes.Get (i)->GetSystemId (), expected, "SystemId attribute not set");
+    }
+  NS_TEST_EXPECT_MSG_NE (partition.GetSystemId (nodes.Get (0)), partition.GetSystemId (nodes.Get (size)),
+                         "Cliques on the same system");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mpi-test
+ * \ingroup tests
+ *
+ * \brief Partition a ring with one short link into three systems.
+ *
+ * The short link must not be cut, so that the lookahead is the delay
+ * of the other links.
+ */
+class PartitionHelperRingTestCase : public TestCase
+{
+public:
+  PartitionHelperRingTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PartitionHelperRingTestCase::PartitionHelperRingTestCase ()
+  : TestCase ("Partition a ring with a short link")
+{
+}
+
+void
+PartitionHelperRingTestCase::DoRun (void)
+{
+  const uint32_t n = 12;
+  NodeContainer nodes;
+  nodes.Create (n);
+
+  PartitionHelper partition;
+  partition.Add (nodes);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Time delay = (i == n - 1) ? MicroSeconds (1) : MilliSeconds (1);
+      partition.AddLink (nodes.Get (i), nodes.Get ((i + 1) % n), delay);
+    }
+  partition.Partition (3);
+
+  NS_TEST_ASSERT_MSG_EQ (partition.GetCutLinks (), 3, "The ring should be cut into three arcs");
+  NS_TEST_ASSERT_MSG_EQ (partition.GetLookahead (), MilliSeconds (1), "The short link was cut");
+  NS_TEST_ASSERT_MSG_EQ_TOL (partition.GetImbalance (), 0, 1e-9, "Systems should be balanced");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mpi-test
+ * \ingroup tests
+ *
+ * \brief PartitionHelper TestSuite
+ */
+class PartitionHelperTestSuite : public TestSuite
+{
+public:
+  PartitionHelperTestSuite ();
+};
+
+PartitionHelperTestSuite::PartitionHelperTestSuite ()
+  : TestSuite ("partition-helper", UNIT)
+{
+  AddTestCase (new PartitionHelperCliquesTestCase, TestCase::QUICK);
+  AddTestCase (new PartitionHelperRingTestCase, TestCase::QUICK);
+}
+
+static PartitionHelperTestSuite g_partitionHelperTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,323 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/global-value.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/data-rate.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/point-to-point-helper.h"
+
+#include <cstdio>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace ns3;
+
+/**
+ * \brief Test of the shared memory transport of distributed simulations
+ *
+ * Runs a two-rank null message simulation over a PointToPointRemoteChannel,
+ * with the ranks forked by MpiInterface::Enable and communicating through
+ * SharedMemoryInterface.  Each rank sends requests to the other, which
+ * echoes them back; the echoes must arrive after two link traversals.
+ * The simulation is run with periodic and with demand-driven null
+ * messages, which must deliver the same packets at the same times.
+ *
+ * Each simulation runs in a child process, so that the rank forked from
+ * it does not run the rest of the tests.  Both ranks report the packets
+ * they received, and their message counters, through a pipe.
+ */
+class PointToPointSharedMemoryTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointSharedMemoryTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /// A packet received by a rank
+  struct Reception
+  {
+    int64_t time;       //!< Arrival time, in ns
+    uint32_t protocol;  //!< REQUEST or ECHO
+    uint32_t size;      //!< Packet size
+  };
+
+  /// Outcome of the simulation of a rank
+  struct RankResult
+  {
+    std::vector<Reception> receptions;  //!< Packets received, in order
+    uint64_t counters[4];               //!< Null and packet messages sent and received
+  };
+
+  /**
+   * \brief Run the simulation in a child process
+   *
+   * \param demandDriven the DemandDriven attribute of the simulator
+   * \param results the results of the two ranks
+   * \returns true if both ranks reported their results
+   */
+  bool RunSimulation (bool demandDriven, RankResult results[2]);
+
+  /**
+   * \brief Run the simulation of a rank, in the child process
+   *
+   * \param demandDriven the DemandDriven attribute of the simulator
+   * \param fd the pipe to write the results to
+   */
+  void RunRanks (bool demandDriven, int fd);
+
+  /**
+   * \brief Send one packet to the remote node
+   *
+   * \param device the local device
+   * \param protocol the protocol number
+   */
+  void SendOnePacket (Ptr<NetDevice> device, uint16_t protocol);
+
+  /**
+   * \brief Record a packet, and echo the requests
+   *
+   * \param device the receiving device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the source address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                uint16_t protocol, const Address &from);
+
+  std::vector<Reception> m_receptions; //!< Packets received by this rank
+};
+
+/// Number of requests sent by each rank
+static const uint32_t N_PACKETS = 10;
+/// Protocol number of the requests (IPv4)
+static const uint16_t REQUEST = 0x0800;
+/// Protocol number of the echoes (IPv6, the other one PPP carries)
+static const uint16_t ECHO = 0x86DD;
+/// Names of the message counters of NullMessageSimulatorImpl
+static const char *g_counters[4] = {
+  "NullMessagesSent", "PacketMessagesSent", "NullMessagesReceived", "PacketMessagesReceived"
+};
+
+PointToPointSharedMemoryTest::PointToPointSharedMemoryTest ()
+  : TestCase ("PointToPoint remote channel over shared memory")
+{
+}
+
+void
+PointToPointSharedMemoryTest::SendOnePacket (Ptr<NetDevice> device, uint16_t protocol)
+{
+  device->Send (Create<Packet> (100), device->GetBroadcast (), protocol);
+}
+
+bool
+PointToPointSharedMemoryTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                       uint16_t protocol, const Address &from)
+{
+  Reception reception;
+  reception.time = Simulator::Now ().GetNanoSeconds ();
+  reception.protocol = protocol;
+  reception.size = packet->GetSize ();
+  m_receptions.push_back (reception);
+  if (protocol == REQUEST)
+    {
+      SendOnePacket (device, ECHO);
+    }
+  return true;
+}
+
+void
+PointToPointSharedMemoryTest::RunRanks (bool demandDriven, int fd)
+{
+  // Fail rather than hang if the ranks deadlock
+  alarm (60);
+
+  Simulator::Destroy ();
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::NullMessageSimulatorImpl"));
+  GlobalValue::Bind ("SharedMemoryRanks", UintegerValue (2));
+  Config::SetDefault ("ns3::NullMessageSimulatorImpl::DemandDriven", BooleanValue (demandDriven));
+  int argc = 0;
+  char **argv = 0;
+  MpiInterface::Enable (&argc, &argv);
+  uint32_t rank = MpiInterface::GetSystemId ();
+
+  Ptr<Node> a = CreateObject<Node> (0);
+  Ptr<Node> b = CreateObject<Node> (1);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("5ms"));
+  NetDeviceContainer devices = p2p.Install (a, b);
+
+  // The requests of rank 1 cross those of rank 0 on the link
+  Ptr<NetDevice> device = devices.Get (rank);
+  device->SetReceiveCallback (MakeCallback (&PointToPointSharedMemoryTest::Receive, this));
+  for (uint32_t i = 0; i < N_PACKETS; ++i)
+    {
+      Simulator::Schedule (Seconds (1) + MilliSeconds (10 * i) + MicroSeconds (3000 * rank),
+                           &PointToPointSharedMemoryTest::SendOnePacket, this, device, REQUEST);
+    }
+
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+
+  uint64_t counters[4];
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      UintegerValue value;
+      Simulator::GetImplementation ()->GetAttribute (g_counters[i], value);
+      counters[i] = value.Get ();
+    }
+  Simulator::Destroy ();
+
+  // Rank 0 waits for rank 1 here, so rank 1 reports first
+  MpiInterface::Disable ();
+
+  uint32_t header[2] = { rank, static_cast<uint32_t> (m_receptions.size ()) };
+  ssize_t size = m_receptions.size () * sizeof (Reception);
+  if (write (fd, header, sizeof (header)) != sizeof (header)
+      || write (fd, counters, sizeof (counters)) != sizeof (counters)
+      || (size > 0 && write (fd, &m_receptions[0], size) != size))
+    {
+      _exit (1);
+    }
+  _exit (0);
+}
+
+bool
+PointToPointSharedMemoryTest::RunSimulation (bool demandDriven, RankResult results[2])
+{
+  int fds[2];
+  if (pipe (fds) != 0)
+    {
+      return false;
+    }
+
+  std::fflush (0);
+  pid_t pid = fork ();
+  if (pid == -1)
+    {
+      return false;
+    }
+  if (pid == 0)
+    {
+      close (fds[0]);
+      RunRanks (demandDriven, fds[1]);
+    }
+  close (fds[1]);
+
+  bool reported[2] = { false, false };
+  uint32_t header[2];
+  while (read (fds[0], header, sizeof (header)) == sizeof (header) && header[0] < 2)
+    {
+      RankResult &result = results[header[0]];
+      result.receptions.resize (header[1]);
+      ssize_t size = header[1] * sizeof (Reception);
+      if (read (fds[0], result.counters, sizeof (result.counters)) != sizeof (result.counters)
+          || (size > 0 && read (fds[0], &result.receptions[0], size) != size))
+        {
+          break;
+        }
+      reported[header[0]] = true;
+    }
+  close (fds[0]);
+
+  int status;
+  return waitpid (pid, &status, 0) == pid && WIFEXITED (status) && WEXITSTATUS (status) == 0
+         && reported[0] && reported[1];
+}
+
+void
+PointToPointSharedMemoryTest::DoRun (void)
+{
+  RankResult periodic[2];
+  RankResult demandDriven[2];
+  NS_TEST_ASSERT_MSG_EQ (RunSimulation (false, periodic), true, "Simulation with periodic null messages failed");
+  NS_TEST_ASSERT_MSG_EQ (RunSimulation (true, demandDriven), true, "Simulation with demand-driven null messages failed");
+
+  // Each echo crosses the link twice: 100 bytes and the PPP header
+  int64_t oneWay = (DataRate ("1Mbps").CalculateBytesTxTime (102) + MilliSeconds (5)).GetNanoSeconds ();
+  for (uint32_t rank = 0; rank < 2; ++rank)
+    {
+      const std::vector<Reception> &receptions = periodic[rank].receptions;
+      NS_TEST_ASSERT_MSG_EQ (receptions.size (), 2 * N_PACKETS, "Packets lost on rank " << rank);
+      uint32_t echoes = 0;
+      for (uint32_t i = 0; i < receptions.size (); ++i)
+        {
+          int64_t sent = 1000000000 + 3000000 * rank;
+          if (receptions[i].protocol == ECHO)
+            {
+              NS_TEST_EXPECT_MSG_EQ (receptions[i].time, sent + 10000000 * echoes + 2 * oneWay,
+                                     "Echo " << echoes << " of rank " << rank << " arrived at the wrong time");
+              ++echoes;
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (echoes, N_PACKETS, "Echoes lost on rank " << rank);
+
+      // Same packets, at the same times and in the same order, in both modes
+      NS_TEST_ASSERT_MSG_EQ (demandDriven[rank].receptions.size (), receptions.size (),
+                             "Demand-driven run received other packets on rank " << rank);
+      for (uint32_t i = 0; i < receptions.size (); ++i)
+        {
+          const Reception &other = demandDriven[rank].receptions[i];
+          NS_TEST_EXPECT_MSG_EQ (other.time, receptions[i].time, "Reception " << i << " of rank " << rank << " differs");
+          NS_TEST_EXPECT_MSG_EQ (other.protocol, receptions[i].protocol, "Reception " << i << " of rank " << rank << " differs");
+          NS_TEST_EXPECT_MSG_EQ (other.size, receptions[i].size, "Reception " << i << " of rank " << rank << " differs");
+        }
+
+      // Packets are batched the same way; only the null messages change
+      NS_TEST_EXPECT_MSG_EQ (demandDriven[rank].counters[1], periodic[rank].counters[1],
+                             "Different number of packet messages sent by rank " << rank);
+      NS_TEST_EXPECT_MSG_EQ (demandDriven[rank].counters[3], periodic[rank].counters[3],
+                             "Different number of packet messages received by rank " << rank);
+    }
+}
+
+/**
+ * \brief TestSuite for the shared memory transport of distributed simulations
+ */
+class PointToPointSharedMemoryTestSuite : public TestSuite
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  PointToPointSharedMemoryTestSuite ();
+};
+
+PointToPointSharedMemoryTestSuite::PointToPointSharedMemoryTestSuite ()
+  : TestSuite ("point-to-point-shared-memory", SYSTEM)
+{
+  AddTestCase (new PointToPointSharedMemoryTest, TestCase::QUICK);
+}
+
+static PointToPointSharedMemoryTestSuite g_pointToPointSharedMemoryTestSuite; //!< The testsuite
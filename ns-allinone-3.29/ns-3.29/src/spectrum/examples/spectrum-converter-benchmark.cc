@@ -0,0 +1,277 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the cost of the spectrum conversions of MultiModelSpectrumChannels
+// shared by Wi-Fi and LTE-like devices in the 2.4 GHz band.
+//
+// Four SpectrumModels are used: 20 MHz and 40 MHz Wi-Fi channels made of
+// 312.5 kHz subcarriers (as built by WifiSpectrumValueHelper), and 100 and
+// 50 resource blocks of 180 kHz.  The program reports:
+//  - the time taken to create nChannels channels, each with one receiver of
+//    each SpectrumModel, i.e. to create the converters of the 12 pairs of
+//    SpectrumModels of each channel;
+//  - the time taken by SpectrumConverter::Convert for each pair of
+//    SpectrumModels;
+//  - the time taken per transmission by MultiModelSpectrumChannel::StartTx
+//    on a channel with nPhys receivers of each SpectrumModel.
+//
+//   ./waf --run "spectrum-converter-benchmark --nChannels=100 --nPhys=10"
+
+#include <ns3/core-module.h>
+#include <ns3/net-device.h>
+#include <ns3/mobility-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/spectrum-channel.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/wifi-spectrum-value-helper.h>
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumConverterBenchmark");
+
+/**
+ * A SpectrumPhy which only counts the signals it receives.
+ */
+class BenchmarkSpectrumPhy : public SpectrumPhy
+{
+public:
+  /**
+   * \param rxSpectrumModel the SpectrumModel of the receiver
+   */
+  BenchmarkSpectrumPhy (Ptr<const SpectrumModel> rxSpectrumModel);
+
+  void SetDevice (Ptr<NetDevice> d);
+  Ptr<NetDevice> GetDevice () const;
+  void SetMobility (Ptr<MobilityModel> m);
+  Ptr<MobilityModel> GetMobility ();
+  void SetChannel (Ptr<SpectrumChannel> c);
+  Ptr<const SpectrumModel> GetRxSpectrumModel () const;
+  Ptr<AntennaModel> GetRxAntenna ();
+  void StartRx (Ptr<SpectrumSignalParameters> params);
+
+  /// \return the number of signals received
+  uint64_t GetNRx (void) const;
+
+private:
+  Ptr<const SpectrumModel> m_rxSpectrumModel; ///< the SpectrumModel of the receiver
+  uint64_t m_nRx;                             ///< the number of signals received
+};
+
+BenchmarkSpectrumPhy::BenchmarkSpectrumPhy (Ptr<const SpectrumModel> rxSpectrumModel)
+  : m_rxSpectrumModel (rxSpectrumModel),
+    m_nRx (0)
+{
+}
+
+void
+BenchmarkSpectrumPhy::SetDevice (Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+BenchmarkSpectrumPhy::GetDevice () const
+{
+  return 0;
+}
+
+void
+BenchmarkSpectrumPhy::SetMobility (Ptr<MobilityModel> m)
+{
+}
+
+Ptr<MobilityModel>
+BenchmarkSpectrumPhy::GetMobility ()
+{
+  return 0;
+}
+
+void
+BenchmarkSpectrumPhy::SetChannel (Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+BenchmarkSpectrumPhy::GetRxSpectrumModel () const
+{
+  return m_rxSpectrumModel;
+}
+
+Ptr<AntennaModel>
+BenchmarkSpectrumPhy::GetRxAntenna ()
+{
+  return 0;
+}
+
+void
+BenchmarkSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  m_nRx++;
+}
+
+uint64_t
+BenchmarkSpectrumPhy::GetNRx (void) const
+{
+  return m_nRx;
+}
+
+/**
+ * \param nRbs the number of resource blocks
+ * \param centerFrequency the center frequency in Hz
+ * \return a SpectrumModel made of resource blocks of 180 kHz
+ */
+static Ptr<SpectrumModel>
+CreateResourceBlockModel (uint32_t nRbs, double centerFrequency)
+{
+  Bands bands;
+  double fl = centerFrequency - nRbs * 180e3 / 2;
+  for (uint32_t i = 0; i < nRbs; i++)
+    {
+      BandInfo bi;
+      bi.fl = fl + i * 180e3;
+      bi.fc = bi.fl + 90e3;
+      bi.fh = bi.fl + 180e3;
+      bands.push_back (bi);
+    }
+  return Create<SpectrumModel> (bands);
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nChannels = 100;
+  uint32_t nPhys = 10;
+  uint32_t nConversions = 100000;
+  uint32_t nTransmissions = 10000;
+
+  CommandLine cmd;
+  cmd.AddValue ("nChannels", "Number of channels created", nChannels);
+  cmd.AddValue ("nPhys", "Number of receivers of each SpectrumModel on the transmitting channel", nPhys);
+  cmd.AddValue ("nConversions", "Number of conversions of each pair of SpectrumModels", nConversions);
+  cmd.AddValue ("nTransmissions", "Number of transmissions of each SpectrumModel", nTransmissions);
+  cmd.Parse (argc, argv);
+
+  std::vector<Ptr<const SpectrumValue> > psds;
+  std::vector<std::string> names;
+  psds.push_back (WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (2437, 20, 0.1, 20));
+  names.push_back ("Wi-Fi 20 MHz");
+  psds.push_back (WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (2442, 40, 0.1, 20));
+  names.push_back ("Wi-Fi 40 MHz");
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (CreateResourceBlockModel (100, 2440e6));
+  *psd = 1e-9;
+  psds.push_back (psd);
+  names.push_back ("100 RBs");
+  psd = Create<SpectrumValue> (CreateResourceBlockModel (50, 2425e6));
+  *psd = 2e-9;
+  psds.push_back (psd);
+  names.push_back ("50 RBs");
+
+  SystemWallClockMs clock;
+  std::vector<Ptr<MultiModelSpectrumChannel> > channels;
+  clock.Start ();
+  for (uint32_t c = 0; c < nChannels; c++)
+    {
+      Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+      for (uint32_t m = 0; m < psds.size (); m++)
+        {
+          channel->AddRx (CreateObject<BenchmarkSpectrumPhy> (psds[m]->GetSpectrumModel ()));
+        }
+      for (uint32_t m = 0; m < psds.size (); m++)
+        {
+          Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+          params->txPhy = CreateObject<BenchmarkSpectrumPhy> (psds[m]->GetSpectrumModel ());
+          params->psd = psds[m]->Copy ();
+          params->duration = MicroSeconds (100);
+          channel->StartTx (params);
+        }
+      channels.push_back (channel);
+    }
+  int64_t setupMs = clock.End ();
+  Simulator::Run ();
+  for (uint32_t c = 0; c < nChannels; c++)
+    {
+      channels[c]->Dispose ();
+    }
+  channels.clear ();
+  std::cout << "channel setup: " << std::fixed << std::setprecision (2)
+            << setupMs * 1000.0 / nChannels << " us per channel of " << psds.size () << " SpectrumModels" << std::endl;
+
+  std::cout << std::left << std::setw (16) << "from" << std::setw (16) << "to"
+            << std::right << std::setw (14) << "ns/convert" << std::endl;
+  for (uint32_t from = 0; from < psds.size (); from++)
+    {
+      for (uint32_t to = 0; to < psds.size (); to++)
+        {
+          if (from == to)
+            {
+              continue;
+            }
+          SpectrumConverter converter (psds[from]->GetSpectrumModel (), psds[to]->GetSpectrumModel ());
+          double sum = 0;
+          clock.Start ();
+          for (uint32_t i = 0; i < nConversions; i++)
+            {
+              sum += (*converter.Convert (psds[from]))[0];
+            }
+          int64_t convertMs = clock.End ();
+          NS_LOG_INFO ("sum " << sum);
+          std::cout << std::left << std::setw (16) << names[from] << std::setw (16) << names[to]
+                    << std::right << std::setw (14) << std::setprecision (1) << convertMs * 1e6 / nConversions << std::endl;
+        }
+    }
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  std::vector<Ptr<BenchmarkSpectrumPhy> > phys;
+  for (uint32_t m = 0; m < psds.size (); m++)
+    {
+      for (uint32_t i = 0; i < nPhys; i++)
+        {
+          Ptr<BenchmarkSpectrumPhy> phy = CreateObject<BenchmarkSpectrumPhy> (psds[m]->GetSpectrumModel ());
+          channel->AddRx (phy);
+          phys.push_back (phy);
+        }
+    }
+  clock.Start ();
+  for (uint32_t i = 0; i < nTransmissions; i++)
+    {
+      for (uint32_t m = 0; m < psds.size (); m++)
+        {
+          Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+          params->txPhy = phys[m * nPhys];
+          params->psd = psds[m]->Copy ();
+          params->duration = MicroSeconds (100);
+          channel->StartTx (params);
+        }
+      Simulator::Run ();
+    }
+  int64_t txMs = clock.End ();
+  uint64_t nRx = 0;
+  for (uint32_t i = 0; i < phys.size (); i++)
+    {
+      nRx += phys[i]->GetNRx ();
+    }
+  std::cout << "StartTx: " << std::setprecision (2) << txMs * 1000.0 / (nTransmissions * psds.size ())
+            << " us per transmission to " << psds.size () * nPhys << " receivers ("
+            << nRx / (nTransmissions * psds.size ()) << " signals received per transmission)" << std::endl;
+
+  channel->Dispose ();
+  Simulator::Destroy ();
+  return 0;
+}
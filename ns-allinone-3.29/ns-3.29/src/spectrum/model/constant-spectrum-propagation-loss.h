@@ -45,6 +45,9 @@ public:
   virtual Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
                                                            Ptr<const MobilityModel> a,
                                                            Ptr<const MobilityModel> b) const;
+  virtual bool DoIsFrequencyFlat (void) const;
+  virtual double DoCalcRxPowerGain (Ptr<const MobilityModel> a,
+                                    Ptr<const MobilityModel> b) const;
   /**
    * Set the propagation loss
    * \param lossDb the propagation loss [dB]
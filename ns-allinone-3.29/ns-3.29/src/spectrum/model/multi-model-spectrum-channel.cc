@@ -234,6 +234,7 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   m_txSigParamsTrace (txParamsTrace);
 
   Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
+  bool spectrumPropagationLossIsFlat = m_spectrumPropagationLoss && m_spectrumPropagationLoss->IsFrequencyFlat ();
   SpectrumModelUid_t txSpectrumModelUid = txParams->psd->GetSpectrumModelUid ();
   NS_LOG_LOGIC (" txSpectrumModelUid " << txSpectrumModelUid);
 
@@ -282,7 +283,11 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
             {
               NS_LOG_LOGIC (" copying signal parameters " << txParams);
               Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+              if (convertedTxPowerSpectrum != txParams->psd)
+                {
+                  // Copy () already copied the PSD when no conversion is needed
+                  rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+                }
               Time delay = MicroSeconds (0);
 
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
@@ -319,9 +324,14 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                       continue;
                     }
                   double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
+                  if (spectrumPropagationLossIsFlat)
+                    {
+                      // fold the spectrum propagation loss into the gain instead of copying the PSD
+                      pathGainLinear *= m_spectrumPropagationLoss->CalcRxPowerGain (txMobility, receiverMobility);
+                    }
+                  *(rxParams->psd) *= pathGainLinear;
 
-                  if (m_spectrumPropagationLoss)
+                  if (m_spectrumPropagationLoss && !spectrumPropagationLossIsFlat)
                     {
                       rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
                     }
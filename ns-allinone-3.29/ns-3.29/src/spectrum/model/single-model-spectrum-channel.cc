@@ -105,6 +105,7 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
+  bool spectrumPropagationLossIsFlat = m_spectrumPropagationLoss && m_spectrumPropagationLoss->IsFrequencyFlat ();
 
   for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
        rxPhyIterator != m_phyList.end ();
@@ -150,9 +151,14 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                   continue;
                 }
               double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-              *(rxParams->psd) *= pathGainLinear;              
+              if (spectrumPropagationLossIsFlat)
+                {
+                  // fold the spectrum propagation loss into the gain instead of copying the PSD
+                  pathGainLinear *= m_spectrumPropagationLoss->CalcRxPowerGain (senderMobility, receiverMobility);
+                }
+              *(rxParams->psd) *= pathGainLinear;
 
-              if (m_spectrumPropagationLoss)
+              if (m_spectrumPropagationLoss && !spectrumPropagationLossIsFlat)
                 {
                   rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, senderMobility, receiverMobility);
                 }
@@ -89,6 +89,12 @@ public:
    */
   void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
 
+  /**
+   * Get the single-frequency propagation loss model.
+   * \returns a pointer to the propagation loss model.
+   */
+  Ptr<PropagationLossModel> GetPropagationLossModel (void);
+
   /**
    * Get the frequency-dependent propagation loss model.
    * \returns a pointer to the propagation loss model.
@@ -22,6 +22,7 @@
 #include <ns3/assert.h>
 #include <ns3/log.h>
 #include <algorithm>
+#include <map>
 
 
 
@@ -38,10 +39,32 @@ SpectrumConverter::SpectrumConverter (Ptr<const SpectrumModel> fromSpectrumModel
   NS_LOG_FUNCTION (this);
   m_fromSpectrumModel = fromSpectrumModel;
   m_toSpectrumModel = toSpectrumModel;
+  m_conversionMatrix = GetConversionMatrix (fromSpectrumModel, toSpectrumModel);
+}
+
+
+Ptr<const SpectrumConverter::ConversionMatrix>
+SpectrumConverter::GetConversionMatrix (Ptr<const SpectrumModel> fromSpectrumModel, Ptr<const SpectrumModel> toSpectrumModel)
+{
+  NS_LOG_FUNCTION (fromSpectrumModel->GetUid () << toSpectrumModel->GetUid ());
+  // the SpectrumModels are immutable and their Uids are never reused
+  static std::map<std::pair<SpectrumModelUid_t, SpectrumModelUid_t>, Ptr<const ConversionMatrix> > conversionMatrices;
+  std::pair<SpectrumModelUid_t, SpectrumModelUid_t> key = std::make_pair (fromSpectrumModel->GetUid (), toSpectrumModel->GetUid ());
+  std::map<std::pair<SpectrumModelUid_t, SpectrumModelUid_t>, Ptr<const ConversionMatrix> >::const_iterator it = conversionMatrices.find (key);
+  if (it != conversionMatrices.end ())
+    {
+      return it->second;
+    }
 
-  size_t rowPtr = 0;
+  Ptr<ConversionMatrix> matrix = Create<ConversionMatrix> ();
+  matrix->m_firstRow = 0;
+  size_t row = 0;
   for (Bands::const_iterator toit = toSpectrumModel->Begin (); toit != toSpectrumModel->End (); ++toit)
     {
+      // find the first and the last bands of fromSpectrumModel which overlap this band
+      size_t firstCol = 0;
+      size_t lastCol = 0;
+      bool empty = true;
       size_t colInd = 0;
       for (Bands::const_iterator fromit = fromSpectrumModel->Begin (); fromit != fromSpectrumModel->End (); ++fromit)
         {
@@ -52,21 +75,53 @@ SpectrumConverter::SpectrumConverter (Ptr<const SpectrumModel> fromSpectrumModel
                             << " = " << c);
           if (c > 0)
             {
-              m_conversionMatrix.push_back (c);
-              m_conversionColInd.push_back (colInd);
-              rowPtr++;
+              if (empty)
+                {
+                  firstCol = colInd;
+                  empty = false;
+                }
+              lastCol = colInd;
             }
           colInd++;
         }
-      m_conversionRowPtr.push_back (rowPtr);
+      if (matrix->m_rowPtr.empty ())
+        {
+          // skip the leading empty rows
+          if (empty)
+            {
+              row++;
+              continue;
+            }
+          matrix->m_firstRow = row;
+        }
+      if (!empty)
+        {
+          Bands::const_iterator fromit = fromSpectrumModel->Begin () + firstCol;
+          for (size_t col = firstCol; col <= lastCol; ++col, ++fromit)
+            {
+              matrix->m_coefficients.push_back (GetCoefficient (*fromit, *toit));
+            }
+        }
+      matrix->m_firstCol.push_back (firstCol);
+      matrix->m_rowPtr.push_back (matrix->m_coefficients.size ());
+      row++;
     }
 
+  // drop the trailing empty rows
+  while (matrix->m_rowPtr.size () > 1
+         && matrix->m_rowPtr[matrix->m_rowPtr.size () - 1] == matrix->m_rowPtr[matrix->m_rowPtr.size () - 2])
+    {
+      matrix->m_rowPtr.pop_back ();
+      matrix->m_firstCol.pop_back ();
+    }
+  conversionMatrices.insert (std::make_pair (key, matrix));
+  return matrix;
 }
 
 
-double SpectrumConverter::GetCoefficient (const BandInfo& from, const BandInfo& to) const
+double SpectrumConverter::GetCoefficient (const BandInfo& from, const BandInfo& to)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION_NOARGS ();
   double coeff = std::min (from.fh, to.fh) - std::max (from.fl, to.fl);
   coeff = std::max (0.0, coeff);
   coeff = std::min (1.0, coeff / (to.fh - to.fl));
@@ -80,23 +135,26 @@ SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
 {
   NS_ASSERT ( *(fvvf->GetSpectrumModel ()) == *m_fromSpectrumModel);
 
+  // the values of the bands which do not overlap fvvf are left to zero
   Ptr<SpectrumValue> tvvf = Create<SpectrumValue> (m_toSpectrumModel);
 
-  Values::iterator tvit = tvvf->ValuesBegin ();
-  size_t i = 0; // Index of conversion coefficient
+  const double *from = &(*fvvf->ConstValuesBegin ());
+  double *to = &(*tvvf->ValuesBegin ()) + m_conversionMatrix->m_firstRow;
+  const double *coefficients = m_conversionMatrix->m_coefficients.data ();
+  const size_t *rowPtr = m_conversionMatrix->m_rowPtr.data ();
+  const size_t *firstCol = m_conversionMatrix->m_firstCol.data ();
+  size_t nRows = m_conversionMatrix->m_rowPtr.size ();
 
-  for (std::vector<size_t>::const_iterator convIt = m_conversionRowPtr.begin ();
-       convIt != m_conversionRowPtr.end ();
-       ++convIt)
+  size_t i = 0; // Index of conversion coefficient
+  for (size_t row = 0; row < nRows; ++row)
     {
+      const double *fromCol = from + firstCol[row];
       double sum = 0;
-      while (i < *convIt)
+      for (size_t k = 0; i < rowPtr[row]; ++i, ++k)
         {
-          sum += (*fvvf)[m_conversionColInd.at (i)] * m_conversionMatrix.at (i);
-          i++;
+          sum += fromCol[k] * coefficients[i];
         }
-      *tvit = sum;
-      ++tvit;
+      to[row] = sum;
     }
 
   return tvvf;
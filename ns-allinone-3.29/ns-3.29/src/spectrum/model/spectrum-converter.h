@@ -67,6 +67,24 @@ public:
 
 
 private:
+  /**
+   * The conversion coefficients between two SpectrumModels.  Since the
+   * bands of a SpectrumModel are sorted by frequency, each band of the
+   * target SpectrumModel overlaps a contiguous range of bands of the
+   * source SpectrumModel: the matrix only stores, for each row, the
+   * coefficients from the first to the last non-zero one, and only the
+   * rows from the first to the last non-empty one.  The matrix of a pair
+   * of SpectrumModels is computed once and shared by all the converters
+   * of this pair.
+   */
+  struct ConversionMatrix : public SimpleRefCount<ConversionMatrix>
+  {
+    std::vector<double> m_coefficients; //!< the coefficients of the rows, stored one row after the other
+    std::vector<size_t> m_rowPtr;       //!< offset of the end of each row in m_coefficients
+    std::vector<size_t> m_firstCol;     //!< column of the first coefficient of each row
+    size_t m_firstRow;                  //!< the first row of the matrix
+  };
+
   /**
    * Calculate the coefficient for value conversion between elements
    *
@@ -76,11 +94,21 @@ private:
    * @return the fraction of the value of the "from" BandInfos that is
    * mapped to the "to" BandInfo
    */
-  double GetCoefficient (const BandInfo& from, const BandInfo& to) const;
+  static double GetCoefficient (const BandInfo& from, const BandInfo& to);
+
+  /**
+   * Compute the conversion matrix between two SpectrumModels, or get
+   * it if it was already computed.
+   *
+   * @param fromSpectrumModel the SpectrumModel to convert from
+   * @param toSpectrumModel the SpectrumModel to convert to
+   *
+   * @return the conversion matrix
+   */
+  static Ptr<const ConversionMatrix> GetConversionMatrix (Ptr<const SpectrumModel> fromSpectrumModel,
+                                                          Ptr<const SpectrumModel> toSpectrumModel);
 
-  std::vector<double> m_conversionMatrix; //!< matrix of conversion coefficients stored in Compressed Row Storage format
-  std::vector<size_t> m_conversionRowPtr; //!< offset of rows in m_conversionMatrix
-  std::vector<size_t> m_conversionColInd; //!< column of each non-zero element in m_conversionMatrix
+  Ptr<const ConversionMatrix> m_conversionMatrix; //!< matrix of conversion coefficients
 
   Ptr<const SpectrumModel> m_fromSpectrumModel;  //!<  the SpectrumModel this SpectrumConverter instance can convert from
   Ptr<const SpectrumModel> m_toSpectrumModel;    //!<  the SpectrumModel this SpectrumConverter instance can convert to
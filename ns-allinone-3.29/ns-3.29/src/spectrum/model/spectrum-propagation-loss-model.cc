@@ -21,6 +21,7 @@
 
 #include "spectrum-propagation-loss-model.h"
 #include <ns3/log.h>
+#include <ns3/fatal-error.h>
 
 namespace ns3 {
 
@@ -73,4 +74,40 @@ SpectrumPropagationLossModel::CalcRxPowerSpectralDensity (Ptr<const SpectrumValu
   return rxPsd;
 }
 
+bool
+SpectrumPropagationLossModel::IsFrequencyFlat (void) const
+{
+  if (!DoIsFrequencyFlat ())
+    {
+      return false;
+    }
+  return (m_next == 0 || m_next->IsFrequencyFlat ());
+}
+
+double
+SpectrumPropagationLossModel::CalcRxPowerGain (Ptr<const MobilityModel> a,
+                                               Ptr<const MobilityModel> b) const
+{
+  double gain = DoCalcRxPowerGain (a, b);
+  if (m_next != 0)
+    {
+      gain *= m_next->CalcRxPowerGain (a, b);
+    }
+  return gain;
+}
+
+bool
+SpectrumPropagationLossModel::DoIsFrequencyFlat (void) const
+{
+  return false;
+}
+
+double
+SpectrumPropagationLossModel::DoCalcRxPowerGain (Ptr<const MobilityModel> a,
+                                                 Ptr<const MobilityModel> b) const
+{
+  NS_FATAL_ERROR ("DoCalcRxPowerGain called on a frequency-selective SpectrumPropagationLossModel");
+  return 0;
+}
+
 } // namespace ns3
@@ -78,6 +78,27 @@ public:
                                                  Ptr<const MobilityModel> a,
                                                  Ptr<const MobilityModel> b) const;
 
+  /**
+   * @return true if this model and all the models chained to it apply
+   * the same gain at all frequencies, in which case the channels apply
+   * their gain, as returned by CalcRxPowerGain, to the power spectral
+   * density of each receiver instead of calling CalcRxPowerSpectralDensity,
+   * which creates a new SpectrumValue per model.
+   */
+  bool IsFrequencyFlat (void) const;
+
+  /**
+   * This method can only be called if IsFrequencyFlat returns true.
+   *
+   * @param a sender mobility
+   * @param b receiver mobility
+   *
+   * @return the linear gain (the ratio of the received power to the
+   * transmitted power) of this model and of all the models chained to it
+   */
+  double CalcRxPowerGain (Ptr<const MobilityModel> a,
+                          Ptr<const MobilityModel> b) const;
+
 protected:
   virtual void DoDispose ();
 
@@ -97,6 +118,23 @@ private:
                                                            Ptr<const MobilityModel> a,
                                                            Ptr<const MobilityModel> b) const = 0;
 
+  /**
+   * @return true if this model applies the same gain at all frequencies.
+   * The default implementation returns false.
+   */
+  virtual bool DoIsFrequencyFlat (void) const;
+
+  /**
+   * This method is only called if DoIsFrequencyFlat returns true.
+   *
+   * @param a sender mobility
+   * @param b receiver mobility
+   *
+   * @return the linear gain of this model
+   */
+  virtual double DoCalcRxPowerGain (Ptr<const MobilityModel> a,
+                                    Ptr<const MobilityModel> b) const;
+
   Ptr<SpectrumPropagationLossModel> m_next; //!< SpectrumPropagationLossModel chained to this one.
 };
 
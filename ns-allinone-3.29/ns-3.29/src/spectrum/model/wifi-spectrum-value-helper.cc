@@ -82,6 +82,97 @@ operator < (const WifiSpectrumModelId& a, const WifiSpectrumModelId& b)
 
 static std::map<WifiSpectrumModelId, Ptr<SpectrumModel> > g_wifiSpectrumModelMap; ///< static initializer for the class
 
+/// The kinds of SpectrumValue shared by WifiSpectrumValueHelper
+enum WifiSpectrumValueType
+{
+  WIFI_DSSS_TX_PSD,
+  WIFI_OFDM_TX_PSD,
+  WIFI_HT_OFDM_TX_PSD,
+  WIFI_HE_OFDM_TX_PSD,
+  WIFI_NOISE_PSD,
+  WIFI_RF_FILTER
+};
+
+///< Wifi Spectrum Value structure
+struct WifiSpectrumValueId
+{
+  /**
+   * Constructor
+   * \param t the kind of spectrum value
+   * \param f the frequency (in MHz)
+   * \param w the channel width (in MHz)
+   * \param b the width of each band (in Hz), 0 if implied by the other parameters
+   * \param g the guard band width (in MHz)
+   * \param v the transmit power (in W) or the noise figure (in dB), 0 if not applicable
+   */
+  WifiSpectrumValueId (WifiSpectrumValueType t, uint32_t f, uint16_t w, double b, uint16_t g, double v);
+  WifiSpectrumValueType m_type; ///< the kind of spectrum value
+  uint32_t m_centerFrequency;   ///< center frequency (in MHz)
+  uint16_t m_channelWidth;      ///< channel width (in MHz)
+  double m_bandBandwidth;       ///< width of each band (in Hz)
+  uint16_t m_guardBandwidth;    ///< guard band width (in MHz)
+  double m_value;               ///< transmit power (in W) or noise figure (in dB)
+};
+
+WifiSpectrumValueId::WifiSpectrumValueId (WifiSpectrumValueType t, uint32_t f, uint16_t w, double b, uint16_t g, double v)
+  : m_type (t),
+    m_centerFrequency (f),
+    m_channelWidth (w),
+    m_bandBandwidth (b),
+    m_guardBandwidth (g),
+    m_value (v)
+{
+}
+
+/**
+ * Less than operator
+ * \param a the first wifi spectrum value to compare
+ * \param b the second wifi spectrum value to compare
+ * \returns true if the first spectrum value is less than the second spectrum value
+ */
+bool
+operator < (const WifiSpectrumValueId& a, const WifiSpectrumValueId& b)
+{
+  if (a.m_type != b.m_type)
+    {
+      return a.m_type < b.m_type;
+    }
+  if (a.m_centerFrequency != b.m_centerFrequency)
+    {
+      return a.m_centerFrequency < b.m_centerFrequency;
+    }
+  if (a.m_channelWidth != b.m_channelWidth)
+    {
+      return a.m_channelWidth < b.m_channelWidth;
+    }
+  if (a.m_bandBandwidth != b.m_bandBandwidth)
+    {
+      return a.m_bandBandwidth < b.m_bandBandwidth;
+    }
+  if (a.m_guardBandwidth != b.m_guardBandwidth)
+    {
+      return a.m_guardBandwidth < b.m_guardBandwidth;
+    }
+  return a.m_value < b.m_value;
+}
+
+static std::map<WifiSpectrumValueId, Ptr<const SpectrumValue> > g_wifiSpectrumValueMap; ///< the spectrum values shared so far
+
+/**
+ * \param key the parameters of a spectrum value
+ * \return the shared spectrum value with these parameters, or 0 if it was not created yet
+ */
+static Ptr<const SpectrumValue>
+FindSharedSpectrumValue (const WifiSpectrumValueId &key)
+{
+  std::map<WifiSpectrumValueId, Ptr<const SpectrumValue> >::const_iterator it = g_wifiSpectrumValueMap.find (key);
+  if (it == g_wifiSpectrumValueMap.end ())
+    {
+      return 0;
+    }
+  return it->second;
+}
+
 Ptr<SpectrumModel>
 WifiSpectrumValueHelper::GetSpectrumModel (uint32_t centerFrequency, uint16_t channelWidth, double bandBandwidth, uint16_t guardBandwidth)
 {
@@ -476,6 +567,90 @@ WifiSpectrumValueHelper::CreateRfFilter (uint32_t centerFrequency, uint16_t chan
   return c;
 }
 
+Ptr<const SpectrumValue>
+WifiSpectrumValueHelper::GetDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << txPowerW << guardBandwidth);
+  WifiSpectrumValueId key (WIFI_DSSS_TX_PSD, centerFrequency, 22, 0, guardBandwidth, txPowerW);
+  Ptr<const SpectrumValue> v = FindSharedSpectrumValue (key);
+  if (v == 0)
+    {
+      v = CreateDsssTxPowerSpectralDensity (centerFrequency, txPowerW, guardBandwidth);
+      g_wifiSpectrumValueMap.insert (std::make_pair (key, v));
+    }
+  return v;
+}
+
+Ptr<const SpectrumValue>
+WifiSpectrumValueHelper::GetOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
+  WifiSpectrumValueId key (WIFI_OFDM_TX_PSD, centerFrequency, channelWidth, 0, guardBandwidth, txPowerW);
+  Ptr<const SpectrumValue> v = FindSharedSpectrumValue (key);
+  if (v == 0)
+    {
+      v = CreateOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, txPowerW, guardBandwidth);
+      g_wifiSpectrumValueMap.insert (std::make_pair (key, v));
+    }
+  return v;
+}
+
+Ptr<const SpectrumValue>
+WifiSpectrumValueHelper::GetHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
+  WifiSpectrumValueId key (WIFI_HT_OFDM_TX_PSD, centerFrequency, channelWidth, 0, guardBandwidth, txPowerW);
+  Ptr<const SpectrumValue> v = FindSharedSpectrumValue (key);
+  if (v == 0)
+    {
+      v = CreateHtOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, txPowerW, guardBandwidth);
+      g_wifiSpectrumValueMap.insert (std::make_pair (key, v));
+    }
+  return v;
+}
+
+Ptr<const SpectrumValue>
+WifiSpectrumValueHelper::GetHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
+  WifiSpectrumValueId key (WIFI_HE_OFDM_TX_PSD, centerFrequency, channelWidth, 0, guardBandwidth, txPowerW);
+  Ptr<const SpectrumValue> v = FindSharedSpectrumValue (key);
+  if (v == 0)
+    {
+      v = CreateHeOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, txPowerW, guardBandwidth);
+      g_wifiSpectrumValueMap.insert (std::make_pair (key, v));
+    }
+  return v;
+}
+
+Ptr<const SpectrumValue>
+WifiSpectrumValueHelper::GetNoisePowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double bandBandwidth, double noiseFigure, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << bandBandwidth << noiseFigure << guardBandwidth);
+  WifiSpectrumValueId key (WIFI_NOISE_PSD, centerFrequency, channelWidth, bandBandwidth, guardBandwidth, noiseFigure);
+  Ptr<const SpectrumValue> v = FindSharedSpectrumValue (key);
+  if (v == 0)
+    {
+      v = CreateNoisePowerSpectralDensity (centerFrequency, channelWidth, bandBandwidth, noiseFigure, guardBandwidth);
+      g_wifiSpectrumValueMap.insert (std::make_pair (key, v));
+    }
+  return v;
+}
+
+Ptr<const SpectrumValue>
+WifiSpectrumValueHelper::GetRfFilter (uint32_t centerFrequency, uint16_t channelWidth, double bandBandwidth, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << bandBandwidth << guardBandwidth);
+  WifiSpectrumValueId key (WIFI_RF_FILTER, centerFrequency, channelWidth, bandBandwidth, guardBandwidth, 0);
+  Ptr<const SpectrumValue> v = FindSharedSpectrumValue (key);
+  if (v == 0)
+    {
+      v = CreateRfFilter (centerFrequency, channelWidth, bandBandwidth, guardBandwidth);
+      g_wifiSpectrumValueMap.insert (std::make_pair (key, v));
+    }
+  return v;
+}
+
 void
 WifiSpectrumValueHelper::CreateSpectrumMaskForOfdm (Ptr<SpectrumValue> c, std::vector <StartStop> allocatedSubBands, StartStop maskBand,
                                                     double txPowerPerBandW, uint32_t nGuardBands,
@@ -147,6 +147,79 @@ public:
    */
   static Ptr<SpectrumValue> CreateRfFilter (uint32_t centerFrequency, uint16_t channelWidth, double bandBandwidth, uint16_t guardBandwidth);
 
+  /**
+   * Return the shared transmit power spectral density corresponding to
+   * DSSS, created by CreateDsssTxPowerSpectralDensity the first time it is
+   * requested with these parameters.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \returns the DSSS Transmit Power Spectral Density in W/Hz
+   */
+  static Ptr<const SpectrumValue> GetDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Return the shared transmit power spectral density corresponding to
+   * OFDM (802.11a/g), created by CreateOfdmTxPowerSpectralDensity the first
+   * time it is requested with these parameters.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return the OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<const SpectrumValue> GetOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Return the shared transmit power spectral density corresponding to
+   * OFDM HT (802.11n/ac), created by CreateHtOfdmTxPowerSpectralDensity the
+   * first time it is requested with these parameters.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return the HT OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<const SpectrumValue> GetHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Return the shared transmit power spectral density corresponding to
+   * OFDM HE (802.11ax), created by CreateHeOfdmTxPowerSpectralDensity the
+   * first time it is requested with these parameters.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return the HE OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<const SpectrumValue> GetHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Return the shared power spectral density corresponding to the noise,
+   * created by CreateNoisePowerSpectralDensity the first time it is
+   * requested with these parameters.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param bandBandwidth width of each band (Hz)
+   * \param noiseFigure the noise figure in dB w.r.t. a reference temperature of 290K
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return the noise Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<const SpectrumValue> GetNoisePowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double bandBandwidth, double noiseFigure, uint16_t guardBandwidth);
+  /**
+   * Return the shared spectral density corresponding to the RF filter,
+   * created by CreateRfFilter the first time it is requested with these
+   * parameters.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param bandBandwidth width of each band (Hz)
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return the RF filter applied to a received power spectral density
+   */
+  static Ptr<const SpectrumValue> GetRfFilter (uint32_t centerFrequency, uint16_t channelWidth, double bandBandwidth, uint16_t guardBandwidth);
+
   /**
    * typedef for a pair of start and stop sub-band indexes
    */
@@ -0,0 +1,298 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/constant-spectrum-propagation-loss.h>
+#include <ns3/friis-spectrum-propagation-loss.h>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumChannelLossTest");
+
+/**
+ * \ingroup spectrum
+ * \ingroup tests
+ *
+ * A SpectrumPhy which keeps the PSD of the last signal it received.
+ */
+class SpectrumChannelLossTestPhy : public SpectrumPhy
+{
+public:
+  /**
+   * \param rxSpectrumModel the SpectrumModel of the receiver
+   * \param position the position of the receiver
+   */
+  SpectrumChannelLossTestPhy (Ptr<const SpectrumModel> rxSpectrumModel, Vector position);
+
+  void SetDevice (Ptr<NetDevice> d);
+  Ptr<NetDevice> GetDevice () const;
+  void SetMobility (Ptr<MobilityModel> m);
+  Ptr<MobilityModel> GetMobility ();
+  void SetChannel (Ptr<SpectrumChannel> c);
+  Ptr<const SpectrumModel> GetRxSpectrumModel () const;
+  Ptr<AntennaModel> GetRxAntenna ();
+  void StartRx (Ptr<SpectrumSignalParameters> params);
+
+  /// \return the PSD of the last signal received
+  Ptr<const SpectrumValue> GetRxPsd (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  Ptr<const SpectrumModel> m_rxSpectrumModel; ///< the SpectrumModel of the receiver
+  Ptr<MobilityModel> m_mobility;              ///< the mobility model of the receiver
+  Ptr<const SpectrumValue> m_rxPsd;           ///< the PSD of the last signal received
+};
+
+SpectrumChannelLossTestPhy::SpectrumChannelLossTestPhy (Ptr<const SpectrumModel> rxSpectrumModel, Vector position)
+  : m_rxSpectrumModel (rxSpectrumModel)
+{
+  m_mobility = CreateObject<ConstantPositionMobilityModel> ();
+  m_mobility->SetPosition (position);
+}
+
+void
+SpectrumChannelLossTestPhy::DoDispose (void)
+{
+  m_mobility = 0;
+  m_rxPsd = 0;
+  SpectrumPhy::DoDispose ();
+}
+
+void
+SpectrumChannelLossTestPhy::SetDevice (Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+SpectrumChannelLossTestPhy::GetDevice () const
+{
+  return 0;
+}
+
+void
+SpectrumChannelLossTestPhy::SetMobility (Ptr<MobilityModel> m)
+{
+  m_mobility = m;
+}
+
+Ptr<MobilityModel>
+SpectrumChannelLossTestPhy::GetMobility ()
+{
+  return m_mobility;
+}
+
+void
+SpectrumChannelLossTestPhy::SetChannel (Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+SpectrumChannelLossTestPhy::GetRxSpectrumModel () const
+{
+  return m_rxSpectrumModel;
+}
+
+Ptr<AntennaModel>
+SpectrumChannelLossTestPhy::GetRxAntenna ()
+{
+  return 0;
+}
+
+void
+SpectrumChannelLossTestPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  m_rxPsd = params->psd;
+}
+
+Ptr<const SpectrumValue>
+SpectrumChannelLossTestPhy::GetRxPsd (void) const
+{
+  return m_rxPsd;
+}
+
+
+/**
+ * \ingroup spectrum
+ * \ingroup tests
+ *
+ * Check the PSDs delivered by the spectrum channels with a chain of
+ * spectrum propagation loss models, whether it is frequency flat (its
+ * gain is folded into the path gain) or not.
+ */
+class SpectrumChannelLossTestCase : public TestCase
+{
+public:
+  /**
+   * \param multiModel whether a MultiModelSpectrumChannel is used instead
+   *        of a SingleModelSpectrumChannel
+   * \param frequencySelective whether a FriisSpectrumPropagationLossModel
+   *        is chained to the ConstantSpectrumPropagationLossModels
+   */
+  SpectrumChannelLossTestCase (bool multiModel, bool frequencySelective);
+  virtual ~SpectrumChannelLossTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param multiModel whether a MultiModelSpectrumChannel is used
+   * \param frequencySelective whether a frequency-selective model is chained
+   * \return the name of the test case
+   */
+  static std::string Name (bool multiModel, bool frequencySelective);
+
+  bool m_multiModel;         ///< whether a MultiModelSpectrumChannel is used
+  bool m_frequencySelective; ///< whether a frequency-selective model is chained
+};
+
+SpectrumChannelLossTestCase::SpectrumChannelLossTestCase (bool multiModel, bool frequencySelective)
+  : TestCase (Name (multiModel, frequencySelective)),
+    m_multiModel (multiModel),
+    m_frequencySelective (frequencySelective)
+{
+}
+
+SpectrumChannelLossTestCase::~SpectrumChannelLossTestCase ()
+{
+}
+
+std::string
+SpectrumChannelLossTestCase::Name (bool multiModel, bool frequencySelective)
+{
+  std::string name = multiModel ? "MultiModelSpectrumChannel" : "SingleModelSpectrumChannel";
+  name += frequencySelective ? " with a frequency-selective loss" : " with a frequency-flat loss";
+  return name;
+}
+
+void
+SpectrumChannelLossTestCase::DoRun (void)
+{
+  std::vector<double> frequencies;
+  for (double f = 2400e6; f < 2500e6; f += 5e6)
+    {
+      frequencies.push_back (f);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (frequencies);
+
+  Ptr<ConstantSpectrumPropagationLossModel> loss = CreateObject<ConstantSpectrumPropagationLossModel> ();
+  loss->SetLossDb (10);
+  Ptr<ConstantSpectrumPropagationLossModel> loss2 = CreateObject<ConstantSpectrumPropagationLossModel> ();
+  loss2->SetLossDb (3);
+  loss->SetNext (loss2);
+  Ptr<FriisSpectrumPropagationLossModel> friis = CreateObject<FriisSpectrumPropagationLossModel> ();
+  if (m_frequencySelective)
+    {
+      loss2->SetNext (friis);
+    }
+  NS_TEST_ASSERT_MSG_EQ (loss->IsFrequencyFlat (), !m_frequencySelective, "wrong flatness of the chain of models");
+
+  Ptr<SpectrumChannel> channel;
+  if (m_multiModel)
+    {
+      channel = CreateObject<MultiModelSpectrumChannel> ();
+    }
+  else
+    {
+      channel = CreateObject<SingleModelSpectrumChannel> ();
+    }
+  channel->AddSpectrumPropagationLossModel (loss);
+
+  Ptr<SpectrumChannelLossTestPhy> tx = CreateObject<SpectrumChannelLossTestPhy> (model, Vector (0, 0, 0));
+  std::vector<Ptr<SpectrumChannelLossTestPhy> > rxs;
+  for (uint32_t i = 1; i <= 3; i++)
+    {
+      Ptr<SpectrumChannelLossTestPhy> rx = CreateObject<SpectrumChannelLossTestPhy> (model, Vector (10.0 * i, 0, 0));
+      channel->AddRx (rx);
+      rxs.push_back (rx);
+    }
+  channel->AddRx (tx);
+
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->txPhy = tx;
+  params->psd = Create<SpectrumValue> (model);
+  for (uint32_t i = 0; i < frequencies.size (); i++)
+    {
+      (*params->psd)[i] = 1e-9 * (i + 1);
+    }
+  params->duration = MicroSeconds (100);
+  Ptr<const SpectrumValue> txPsd = params->psd->Copy ();
+  channel->StartTx (params);
+  Simulator::Run ();
+
+  for (uint32_t r = 0; r < rxs.size (); r++)
+    {
+      Ptr<const SpectrumValue> rxPsd = rxs[r]->GetRxPsd ();
+      NS_TEST_ASSERT_MSG_NE (rxPsd, 0, "no signal received by receiver " << r);
+      NS_TEST_ASSERT_MSG_NE (rxPsd, params->psd, "the receiver shares the PSD of the transmitter");
+      double d = 10.0 * (r + 1);
+      for (uint32_t i = 0; i < frequencies.size (); i++)
+        {
+          double expected = (*txPsd)[i] / std::pow (10, 1.0) / std::pow (10, 0.3);
+          if (m_frequencySelective)
+            {
+              expected /= friis->CalculateLoss (frequencies[i], d);
+            }
+          NS_TEST_ASSERT_MSG_EQ_TOL ((*rxPsd)[i], expected, expected * 1e-12,
+                                     "wrong received PSD at receiver " << r << " band " << i);
+        }
+    }
+  for (uint32_t i = 0; i < frequencies.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((*params->psd)[i], (*txPsd)[i], "the PSD of the transmitter was modified");
+    }
+
+  Simulator::Destroy ();
+  channel->Dispose ();
+  tx->Dispose ();
+  for (uint32_t r = 0; r < rxs.size (); r++)
+    {
+      rxs[r]->Dispose ();
+    }
+}
+
+
+/**
+ * \ingroup spectrum
+ * \ingroup tests
+ *
+ * Test suite for the spectrum propagation losses applied by the spectrum channels.
+ */
+class SpectrumChannelLossTestSuite : public TestSuite
+{
+public:
+  SpectrumChannelLossTestSuite ();
+};
+
+SpectrumChannelLossTestSuite::SpectrumChannelLossTestSuite ()
+  : TestSuite ("spectrum-channel-loss", UNIT)
+{
+  AddTestCase (new SpectrumChannelLossTestCase (false, false), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelLossTestCase (false, true), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelLossTestCase (true, false), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelLossTestCase (true, true), TestCase::QUICK);
+}
+
+static SpectrumChannelLossTestSuite g_spectrumChannelLossTestSuite; ///< the test suite
@@ -25,6 +25,7 @@
 #include <ns3/test.h>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 #include "spectrum-test.h"
 
@@ -329,6 +330,86 @@ SpectrumConverterTestSuite::SpectrumConverterTestSuite ()
   AddTestCase (new SpectrumValueTestCase (t21b, *res, ""), TestCase::QUICK);
 
 
+  // a 20 MHz OFDM channel made of subcarriers and a wider model made of
+  // resource blocks, which overlap it partially
+  Bands ofdmBands;
+  for (int i = -32; i < 32; i++)
+    {
+      BandInfo bi;
+      bi.fl = 2412e6 + (i - 0.5) * 312.5e3;
+      bi.fc = 2412e6 + i * 312.5e3;
+      bi.fh = 2412e6 + (i + 0.5) * 312.5e3;
+      ofdmBands.push_back (bi);
+    }
+  Ptr<SpectrumModel> ofdmModel = Create<SpectrumModel> (ofdmBands);
+  Bands rbBands;
+  for (int i = 0; i < 100; i++)
+    {
+      BandInfo bi;
+      bi.fl = 2405e6 + i * 180e3;
+      bi.fc = 2405e6 + (i + 0.5) * 180e3;
+      bi.fh = 2405e6 + (i + 1) * 180e3;
+      rbBands.push_back (bi);
+    }
+  Ptr<SpectrumModel> rbModel = Create<SpectrumModel> (rbBands);
+
+  Ptr<SpectrumValue> ofdmValue = Create<SpectrumValue> (ofdmModel);
+  for (size_t i = 0; i < ofdmBands.size (); i++)
+    {
+      (*ofdmValue)[i] = 1 + (i % 7);
+    }
+  Ptr<SpectrumValue> rbValue = Create<SpectrumValue> (rbModel);
+  for (size_t i = 0; i < rbBands.size (); i++)
+    {
+      (*rbValue)[i] = 1 + (i % 5);
+    }
+
+  // the expected values, computed from the whole matrix of coefficients
+  SpectrumValue tOfdmToRb (rbModel);
+  for (size_t j = 0; j < rbBands.size (); j++)
+    {
+      for (size_t i = 0; i < ofdmBands.size (); i++)
+        {
+          double overlap = std::max (0.0, std::min (ofdmBands[i].fh, rbBands[j].fh) - std::max (ofdmBands[i].fl, rbBands[j].fl));
+          tOfdmToRb[j] += (*ofdmValue)[i] * std::min (1.0, overlap / (rbBands[j].fh - rbBands[j].fl));
+        }
+    }
+  SpectrumValue tRbToOfdm (ofdmModel);
+  for (size_t j = 0; j < ofdmBands.size (); j++)
+    {
+      for (size_t i = 0; i < rbBands.size (); i++)
+        {
+          double overlap = std::max (0.0, std::min (rbBands[i].fh, ofdmBands[j].fh) - std::max (rbBands[i].fl, ofdmBands[j].fl));
+          tRbToOfdm[j] += (*rbValue)[i] * std::min (1.0, overlap / (ofdmBands[j].fh - ofdmBands[j].fl));
+        }
+    }
+
+  SpectrumConverter cOfdmToRb (ofdmModel, rbModel);
+  res = cOfdmToRb.Convert (ofdmValue);
+  AddTestCase (new SpectrumValueTestCase (tOfdmToRb, *res, "OFDM subcarriers to resource blocks"), TestCase::QUICK);
+  SpectrumConverter cRbToOfdm (rbModel, ofdmModel);
+  res = cRbToOfdm.Convert (rbValue);
+  AddTestCase (new SpectrumValueTestCase (tRbToOfdm, *res, "resource blocks to OFDM subcarriers"), TestCase::QUICK);
+  // a second converter of the same pair of models shares the coefficients
+  SpectrumConverter cOfdmToRb2 (ofdmModel, rbModel);
+  res = cOfdmToRb2.Convert (ofdmValue);
+  AddTestCase (new SpectrumValueTestCase (tOfdmToRb, *res, "second converter of the same models"), TestCase::QUICK);
+
+  // a model which does not overlap the OFDM channel
+  Bands farBands;
+  for (int i = 0; i < 10; i++)
+    {
+      BandInfo bi;
+      bi.fl = 5180e6 + i * 1e6;
+      bi.fc = 5180e6 + (i + 0.5) * 1e6;
+      bi.fh = 5180e6 + (i + 1) * 1e6;
+      farBands.push_back (bi);
+    }
+  Ptr<SpectrumModel> farModel = Create<SpectrumModel> (farBands);
+  SpectrumConverter cOfdmToFar (ofdmModel, farModel);
+  res = cOfdmToFar.Convert (ofdmValue);
+  SpectrumValue tOfdmToFar (farModel);
+  AddTestCase (new SpectrumValueTestCase (tOfdmToFar, *res, "non-overlapping models"), TestCase::QUICK);
 }
 
 
@@ -0,0 +1,315 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the memory and the time taken per remote station by the Minstrel
+// and Minstrel-HT rate managers of an AP.
+//
+// nStations remote stations are registered with the rate manager of an AP,
+// with the capabilities of a STA of the same standard, as the AP does when
+// they associate. The heap memory taken per station is the memory allocated
+// through the global operator new while the stations are registered and
+// their tables are initialized by a first transmission. Then, every
+// millisecond for the given duration, a frame (an A-MPDU of 16 MPDUs for
+// 802.11n/ac) is sent to each station. Each station has a capacity drawn
+// at random: the MPDUs sent at a rate below the capacity are received with
+// a probability of 0.9, and the others with a probability of 0.1. The
+// program reports the heap bytes per station and the wall-clock time per
+// transmission, which includes the periodic update of the statistics of
+// the station.
+//
+//   ./waf --run "minstrel-station-benchmark --nStations=10,100,500"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MinstrelStationBenchmark");
+
+/// The number of bytes currently allocated through the global operator new
+static std::size_t g_heapBytes = 0;
+
+/// The room kept before each allocation to store its size
+static const std::size_t HEAP_HEADER_SIZE = 16;
+
+void *
+operator new (std::size_t size)
+{
+  void *p = std::malloc (size + HEAP_HEADER_SIZE);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  *static_cast<std::size_t *> (p) = size;
+  g_heapBytes += size;
+  return static_cast<char *> (p) + HEAP_HEADER_SIZE;
+}
+
+void
+operator delete (void *ptr) noexcept
+{
+  if (ptr != 0)
+    {
+      void *p = static_cast<char *> (ptr) - HEAP_HEADER_SIZE;
+      g_heapBytes -= *static_cast<std::size_t *> (p);
+      std::free (p);
+    }
+}
+
+/**
+ * A configuration of the AP.
+ */
+struct BenchmarkConfig
+{
+  std::string manager;       ///< the TypeId of the rate manager
+  WifiPhyStandard standard;  ///< the standard
+  uint16_t channelWidth;     ///< the channel width in MHz
+  uint8_t streams;           ///< the number of spatial streams
+  std::string name;          ///< the name of the configuration
+};
+
+/**
+ * The AP and its remote stations.
+ */
+class MinstrelStationBenchmark
+{
+public:
+  /**
+   * Create the AP and one STA, whose capabilities are given to the
+   * remote stations.
+   *
+   * \param config the configuration of the AP
+   */
+  MinstrelStationBenchmark (const BenchmarkConfig &config);
+  /**
+   * Register the remote stations and send them a first frame.
+   *
+   * \param nStations the number of remote stations
+   * \return the heap bytes allocated per station
+   */
+  double AddStations (uint32_t nStations);
+  /**
+   * Send a frame to each station every millisecond.
+   *
+   * \param duration the duration of the traffic
+   * \return the wall-clock time per transmission in microseconds
+   */
+  double Run (Time duration);
+
+private:
+  /// Send a frame to each station.
+  void SendFrames (void);
+  /**
+   * Send a frame to a station and report its outcome.
+   *
+   * \param i the index of the station
+   */
+  void SendFrame (uint32_t i);
+
+  Ptr<WifiRemoteStationManager> m_manager;     ///< the rate manager of the AP
+  Ptr<RegularWifiMac> m_staMac;                ///< the MAC of the STA
+  bool m_ht;                                   ///< whether A-MPDUs are sent
+  bool m_vht;                                  ///< whether the stations support VHT
+  std::vector<Mac48Address> m_stations;        ///< the remote stations
+  std::vector<uint64_t> m_capacities;          ///< the capacity of each station in bit/s
+  Ptr<UniformRandomVariable> m_random;         ///< the random outcome of the transmissions
+  uint64_t m_nTransmissions;                   ///< the number of transmissions
+  WifiMacHeader m_header;                      ///< the header of the frames
+  Ptr<Packet> m_packet;                        ///< the payload of the frames
+};
+
+MinstrelStationBenchmark::MinstrelStationBenchmark (const BenchmarkConfig &config)
+  : m_ht (config.standard != WIFI_PHY_STANDARD_80211a),
+    m_vht (config.standard == WIFI_PHY_STANDARD_80211ac),
+    m_nTransmissions (0)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  MobilityHelper mobility;
+  mobility.Install (nodes);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  phy.Set ("ShortGuardEnabled", BooleanValue (true));
+  phy.Set ("Antennas", UintegerValue (config.streams));
+  phy.Set ("MaxSupportedTxSpatialStreams", UintegerValue (config.streams));
+  phy.Set ("MaxSupportedRxSpatialStreams", UintegerValue (config.streams));
+
+  WifiHelper wifi;
+  wifi.SetStandard (config.standard);
+  wifi.SetRemoteStationManager (config.manager);
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 1);
+  Config::Set ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/ChannelWidth", UintegerValue (config.channelWidth));
+  //the rate managers set up their tables when they are initialized
+  nodes.Get (0)->Initialize ();
+  nodes.Get (1)->Initialize ();
+
+  m_manager = DynamicCast<WifiNetDevice> (devices.Get (0))->GetRemoteStationManager ();
+  m_staMac = DynamicCast<RegularWifiMac> (DynamicCast<WifiNetDevice> (devices.Get (1))->GetMac ());
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (100);
+
+  m_header.SetType (WIFI_MAC_QOSDATA);
+  m_header.SetQosTid (0);
+  m_packet = Create<Packet> (1200);
+}
+
+double
+MinstrelStationBenchmark::AddStations (uint32_t nStations)
+{
+  HtCapabilities htCapabilities = m_staMac->GetHtCapabilities ();
+  VhtCapabilities vhtCapabilities = m_staMac->GetVhtCapabilities ();
+  m_stations.reserve (nStations);
+  std::size_t heapBytes = g_heapBytes;
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      Mac48Address address = Mac48Address::Allocate ();
+      m_stations.push_back (address);
+      m_manager->AddAllSupportedModes (address);
+      if (m_ht)
+        {
+          m_manager->AddStationHtCapabilities (address, htCapabilities);
+          if (m_vht)
+            {
+              m_manager->AddStationVhtCapabilities (address, vhtCapabilities);
+            }
+        }
+      m_manager->RecordGotAssocTxOk (address);
+      m_manager->GetDataTxVector (address, &m_header, m_packet);
+    }
+  double bytesPerStation = static_cast<double> (g_heapBytes - heapBytes) / nStations;
+  m_capacities.clear ();
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      m_capacities.push_back (static_cast<uint64_t> (m_random->GetValue (0.1, 1) * 1e9));
+    }
+  return bytesPerStation;
+}
+
+void
+MinstrelStationBenchmark::SendFrame (uint32_t i)
+{
+  Mac48Address address = m_stations[i];
+  WifiTxVector txVector = m_manager->GetDataTxVector (address, &m_header, m_packet);
+  bool belowCapacity = txVector.GetMode ().GetDataRate (txVector) <= m_capacities[i];
+  double successProbability = belowCapacity ? 0.9 : 0.1;
+  m_nTransmissions++;
+  if (m_ht)
+    {
+      uint8_t nSuccessfulMpdus = 0;
+      for (uint8_t j = 0; j < 16; j++)
+        {
+          if (m_random->GetValue () < successProbability)
+            {
+              nSuccessfulMpdus++;
+            }
+        }
+      m_manager->ReportAmpduTxStatus (address, 0, nSuccessfulMpdus, 16 - nSuccessfulMpdus, 20, 20);
+      return;
+    }
+  while (m_random->GetValue () >= successProbability)
+    {
+      m_manager->ReportDataFailed (address, &m_header, m_packet->GetSize ());
+      if (!m_manager->NeedRetransmission (address, &m_header, m_packet))
+        {
+          m_manager->ReportFinalDataFailed (address, &m_header, m_packet->GetSize ());
+          return;
+        }
+      txVector = m_manager->GetDataTxVector (address, &m_header, m_packet);
+      m_nTransmissions++;
+    }
+  m_manager->ReportDataOk (address, &m_header, 20, txVector.GetMode (), 20, m_packet->GetSize ());
+}
+
+void
+MinstrelStationBenchmark::SendFrames (void)
+{
+  for (uint32_t i = 0; i < m_stations.size (); i++)
+    {
+      SendFrame (i);
+    }
+  Simulator::Schedule (MilliSeconds (1), &MinstrelStationBenchmark::SendFrames, this);
+}
+
+double
+MinstrelStationBenchmark::Run (Time duration)
+{
+  Simulator::ScheduleNow (&MinstrelStationBenchmark::SendFrames, this);
+  Simulator::Stop (duration);
+  m_nTransmissions = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsedMs = clock.End ();
+  return m_nTransmissions > 0 ? elapsedMs * 1000.0 / m_nTransmissions : 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string nStationsList = "10,100,500";
+  double duration = 1;
+
+  CommandLine cmd;
+  cmd.AddValue ("nStations", "Comma-separated numbers of remote stations", nStationsList);
+  cmd.AddValue ("duration", "Duration of the traffic in seconds", duration);
+  cmd.Parse (argc, argv);
+
+  std::vector<uint32_t> nStations;
+  std::istringstream iss (nStationsList);
+  std::string token;
+  while (std::getline (iss, token, ','))
+    {
+      nStations.push_back (std::atoi (token.c_str ()));
+    }
+
+  std::vector<BenchmarkConfig> configs;
+  configs.push_back ({"ns3::MinstrelWifiManager", WIFI_PHY_STANDARD_80211a, 20, 1, "11a"});
+  configs.push_back ({"ns3::MinstrelHtWifiManager", WIFI_PHY_STANDARD_80211n_5GHZ, 40, 4, "11n 40MHz 4SS"});
+  configs.push_back ({"ns3::MinstrelHtWifiManager", WIFI_PHY_STANDARD_80211ac, 80, 2, "11ac 80MHz 2SS"});
+  configs.push_back ({"ns3::MinstrelHtWifiManager", WIFI_PHY_STANDARD_80211ac, 160, 4, "11ac 160MHz 4SS"});
+
+  std::cout << std::left << std::setw (28) << "manager" << std::setw (18) << "standard"
+            << std::right << std::setw (10) << "stations" << std::setw (16) << "bytes/station"
+            << std::setw (12) << "us/tx" << std::endl;
+  for (auto &config : configs)
+    {
+      for (auto n : nStations)
+        {
+          MinstrelStationBenchmark benchmark (config);
+          double bytesPerStation = benchmark.AddStations (n);
+          double usPerTx = benchmark.Run (Seconds (duration));
+          std::cout << std::left << std::setw (28) << config.manager << std::setw (18) << config.name
+                    << std::right << std::setw (10) << n << std::setw (16) << std::fixed << std::setprecision (0) << bytesPerStation
+                    << std::setw (12) << std::setprecision (2) << usPerTx << std::endl;
+          Simulator::Destroy ();
+        }
+    }
+  return 0;
+}
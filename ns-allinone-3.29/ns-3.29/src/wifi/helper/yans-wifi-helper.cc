@@ -19,6 +19,7 @@
  *          Sébastien Deronne <sebastien.deronne@gmail.com>
  */
 
+#include <sstream>
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/propagation-loss-model.h"
@@ -159,4 +160,32 @@ YansWifiPhyHelper::Create (Ptr<Node> node, Ptr<NetDevice> device) const
   return phy;
 }
 
+L2smWifiPhyHelper::L2smWifiPhyHelper ()
+{
+  m_phy.SetTypeId ("ns3::L2smWifiPhy");
+}
+
+L2smWifiPhyHelper
+L2smWifiPhyHelper::Default (void)
+{
+  L2smWifiPhyHelper helper;
+  helper.SetErrorRateModel ("ns3::TabulatedErrorRateModel");
+  return helper;
+}
+
+Ptr<WifiPhy>
+L2smWifiPhyHelper::Create (Ptr<Node> node, Ptr<NetDevice> device) const
+{
+  Ptr<WifiPhy> phy = YansWifiPhyHelper::Create (node, device);
+  std::ostringstream config;
+  config << m_errorRateModel;
+  if (m_sharedErrorRateModel == 0 || config.str () != m_sharedErrorRateModelConfig)
+    {
+      m_sharedErrorRateModel = m_errorRateModel.Create<ErrorRateModel> ();
+      m_sharedErrorRateModelConfig = config.str ();
+    }
+  phy->SetErrorRateModel (m_sharedErrorRateModel);
+  return phy;
+}
+
 } //namespace ns3
@@ -23,6 +23,7 @@
 
 #include "wifi-helper.h"
 #include "ns3/yans-wifi-channel.h"
+#include "ns3/error-rate-model.h"
 
 namespace ns3 {
 
@@ -185,7 +186,7 @@ public:
    */
   void SetChannel (std::string channelName);
 
-private:
+protected:
   /**
    * \param node the node on which we wish to create a wifi PHY
    * \param device the device within which this PHY will be created
@@ -195,9 +196,48 @@ private:
    */
   virtual Ptr<WifiPhy> Create (Ptr<Node> node, Ptr<NetDevice> device) const;
 
+private:
   Ptr<YansWifiChannel> m_channel; ///< yans wifi channel
 };
 
+/**
+ * \brief Make it easy to create and manage PHY objects for the L2SM model.
+ *
+ * The PHYs created by this helper are L2smWifiPhy objects, which are
+ * connected to a YansWifiChannel like the YansWifiPhy objects but decide
+ * the reception of each frame with a link-to-system mapping.
+ */
+class L2smWifiPhyHelper : public YansWifiPhyHelper
+{
+public:
+  /**
+   * Create a phy helper without any parameter set. The user must set
+   * them all to be able to call Install later.
+   */
+  L2smWifiPhyHelper ();
+
+  /**
+   * Create a phy helper in a default working state, which uses a
+   * TabulatedErrorRateModel of the NistErrorRateModel.
+   * \returns a default L2smWifiPhyHelper
+   */
+  static L2smWifiPhyHelper Default (void);
+
+private:
+  /**
+   * \param node the node on which we wish to create a wifi PHY
+   * \param device the device within which this PHY will be created
+   * \returns a newly-created PHY object.
+   *
+   * The PHYs created by a helper share one instance of the error rate model,
+   * so that the tables of a TabulatedErrorRateModel are computed once.
+   */
+  virtual Ptr<WifiPhy> Create (Ptr<Node> node, Ptr<NetDevice> device) const;
+
+  mutable Ptr<ErrorRateModel> m_sharedErrorRateModel; ///< the error rate model shared by the PHYs
+  mutable std::string m_sharedErrorRateModelConfig;   ///< the configuration of the shared error rate model
+};
+
 } //namespace ns3
 
 #endif /* YANS_WIFI_HELPER_H */
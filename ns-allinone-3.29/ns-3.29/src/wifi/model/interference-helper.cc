@@ -25,11 +25,26 @@
 #include "interference-helper.h"
 #include "wifi-phy.h"
 #include "error-rate-model.h"
+#include "wifi-utils.h"
+#include <algorithm>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("InterferenceHelper");
 
+/**
+ * Order the signals on the air in a heap, earliest end first.
+ *
+ * \param a a signal
+ * \param b another signal
+ * \return true if a ends after b
+ */
+static bool
+EndsLater (const Ptr<Event> &a, const Ptr<Event> &b)
+{
+  return a->GetEndTime () > b->GetEndTime ();
+}
+
 /****************************************************************
  *       Phy event class
  ****************************************************************/
@@ -39,7 +54,12 @@ Event::Event (Ptr<const Packet> packet, WifiTxVector txVector, Time duration, do
     m_txVector (txVector),
     m_startTime (Simulator::Now ()),
     m_endTime (m_startTime + duration),
-    m_rxPowerW (rxPower)
+    m_rxPowerW (rxPower),
+    m_payloadStartTime (m_startTime),
+    m_headerInterferenceJ (0),
+    m_payloadInterferenceJ (0),
+    m_headerInterferedTime (Seconds (0)),
+    m_payloadInterferedTime (Seconds (0))
 {
 }
 
@@ -83,6 +103,69 @@ Event::GetPayloadMode (void) const
   return m_txVector.GetMode ();
 }
 
+void
+Event::SetPayloadStartTime (Time payloadStart)
+{
+  m_payloadStartTime = payloadStart;
+}
+
+void
+Event::AddInterference (double power, Time start, Time end)
+{
+  start = std::max (start, m_startTime);
+  end = std::min (end, m_endTime);
+  if (end <= start)
+    {
+      return;
+    }
+  if (start < m_payloadStartTime)
+    {
+      Time overlap = std::min (end, m_payloadStartTime) - start;
+      m_headerInterferenceJ += power * overlap.GetSeconds ();
+      m_headerInterferedTime += overlap;
+    }
+  if (end > m_payloadStartTime)
+    {
+      Time overlap = end - std::max (start, m_payloadStartTime);
+      m_payloadInterferenceJ += power * overlap.GetSeconds ();
+      m_payloadInterferedTime += overlap;
+    }
+}
+
+double
+Event::GetHeaderInterferenceW (void) const
+{
+  Time interfered = GetHeaderInterferedTime ();
+  if (interfered.IsZero ())
+    {
+      return 0;
+    }
+  return m_headerInterferenceJ / interfered.GetSeconds ();
+}
+
+Time
+Event::GetHeaderInterferedTime (void) const
+{
+  return std::min (m_headerInterferedTime, m_payloadStartTime - m_startTime);
+}
+
+double
+Event::GetPayloadInterferenceW (void) const
+{
+  Time interfered = GetPayloadInterferedTime ();
+  if (interfered.IsZero ())
+    {
+      return 0;
+    }
+  return m_payloadInterferenceJ / interfered.GetSeconds ();
+}
+
+Time
+Event::GetPayloadInterferedTime (void) const
+{
+  return std::min (m_payloadInterferedTime, m_endTime - m_payloadStartTime);
+}
+
 
 /****************************************************************
  *       Class which records SNIR change events for a
@@ -122,7 +205,8 @@ InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_numRxAntennas (1),
     m_firstPower (0),
-    m_rxing (false)
+    m_rxing (false),
+    m_chunkTracking (true)
 {
   // Always have a zero power noise event in the list
   AddNiChangeEvent (Time (0), NiChange (0.0, 0));
@@ -176,10 +260,43 @@ InterferenceHelper::SetNumberOfReceiveAntennas (uint8_t rx)
   m_numRxAntennas = rx;
 }
 
+void
+InterferenceHelper::SetChunkTracking (bool enable)
+{
+  m_chunkTracking = enable;
+  EraseEvents ();
+}
+
 Time
 InterferenceHelper::GetEnergyDuration (double energyW) const
 {
   Time now = Simulator::Now ();
+  if (!m_chunkTracking)
+    {
+      //remove the signals on the air in the order they end, until the
+      //energy falls below the threshold
+      std::vector<std::pair<Time, double> > ends;
+      double powerW = 0;
+      for (auto &signal : m_signals)
+        {
+          if (signal->GetEndTime () > now)
+            {
+              ends.push_back (std::make_pair (signal->GetEndTime (), signal->GetRxPowerW ()));
+              powerW += signal->GetRxPowerW ();
+            }
+        }
+      std::sort (ends.begin (), ends.end ());
+      for (auto &end : ends)
+        {
+          if (powerW < energyW)
+            {
+              break;
+            }
+          powerW -= end.second;
+          now = end.first;
+        }
+      return now - Simulator::Now ();
+    }
   auto i = GetPreviousPosition (now);
   Time end = i->first;
   for (; i != m_niChanges.end (); ++i)
@@ -198,6 +315,18 @@ void
 InterferenceHelper::AppendEvent (Ptr<Event> event)
 {
   NS_LOG_FUNCTION (this);
+  if (!m_chunkTracking)
+    {
+      ExpireSignals ();
+      //only the signal being received is decided from its interference
+      if (m_rxEvent != 0)
+        {
+          m_rxEvent->AddInterference (event->GetRxPowerW (), event->GetStartTime (), event->GetEndTime ());
+        }
+      m_signals.push_back (event);
+      std::push_heap (m_signals.begin (), m_signals.end (), &EndsLater);
+      return;
+    }
   double previousPowerStart = 0;
   double previousPowerEnd = 0;
   previousPowerStart = GetPreviousPosition (event->GetStartTime ())->second.GetPower ();
@@ -236,6 +365,7 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, uint1
 double
 InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const
 {
+  NS_ASSERT (m_chunkTracking);
   double noiseInterference = m_firstPower;
   auto it = m_niChanges.find (event->GetStartTime ());
   for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it)
@@ -776,9 +906,100 @@ InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<Event> event) const
   return snrPer;
 }
 
+struct InterferenceHelper::EffectiveSnrPer
+InterferenceHelper::CalculateEffectiveSnrPer (Ptr<Event> event) const
+{
+  NS_LOG_FUNCTION (this << event);
+  NS_ASSERT (!m_chunkTracking);
+  const WifiTxVector txVector = event->GetTxVector ();
+  WifiPreamble preamble = txVector.GetPreambleType ();
+  WifiMode payloadMode = event->GetPayloadMode ();
+  WifiMode headerMode = WifiPhy::GetPlcpHeaderMode (txVector);
+  WifiMode mcsHeaderMode;
+  if (preamble == WIFI_PREAMBLE_HT_MF || preamble == WIFI_PREAMBLE_HT_GF)
+    {
+      mcsHeaderMode = WifiPhy::GetHtPlcpHeaderMode ();
+    }
+  else if (preamble == WIFI_PREAMBLE_VHT)
+    {
+      mcsHeaderMode = WifiPhy::GetVhtPlcpHeaderMode ();
+    }
+  else if (preamble == WIFI_PREAMBLE_HE_SU)
+    {
+      mcsHeaderMode = WifiPhy::GetHePlcpHeaderMode ();
+    }
+  Time plcpHeaderStart = event->GetStartTime () + WifiPhy::GetPlcpPreambleDuration (txVector); //packet start time + preamble
+  Time plcpHsigHeaderStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (txVector); //packet start time + preamble + L-SIG
+  Time plcpTrainingSymbolsStart = plcpHsigHeaderStart + WifiPhy::GetPlcpHtSigHeaderDuration (preamble) + WifiPhy::GetPlcpSigA1Duration (preamble) + WifiPhy::GetPlcpSigA2Duration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A
+  Time plcpPayloadStart = plcpTrainingSymbolsStart + WifiPhy::GetPlcpTrainingSymbolDuration (txVector) + WifiPhy::GetPlcpSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A + Training + SIG-B
+  //the header fields sent with the legacy header mode end with L-SIG for HT formats
+  //and with SIG-A for VHT and HE formats (see CalculatePlcpHeaderPer)
+  Time mcsHeaderStart = plcpPayloadStart;
+  if (preamble == WIFI_PREAMBLE_HT_MF || preamble == WIFI_PREAMBLE_HT_GF)
+    {
+      mcsHeaderStart = plcpHsigHeaderStart;
+    }
+  else if (preamble == WIFI_PREAMBLE_VHT || preamble == WIFI_PREAMBLE_HE_SU)
+    {
+      mcsHeaderStart = plcpTrainingSymbolsStart;
+    }
+
+  struct EffectiveSnrPer snrPer;
+  uint16_t channelWidth = txVector.GetChannelWidth ();
+  double signalW = event->GetRxPowerW ();
+  //the other signals which overlap the frame without covering it arrive
+  //after its start: the interfered time of the PLCP header is its end
+  double headerInterferenceW = event->GetHeaderInterferenceW ();
+  Time headerInterfered = event->GetHeaderInterferedTime ();
+  Time headerDuration = plcpPayloadStart - event->GetStartTime ();
+  snrPer.headerSnr = CalculateSnr (signalW, headerInterferenceW * headerInterfered.GetSeconds () / headerDuration.GetSeconds (),
+                                   channelWidth);
+  Time mcsHeaderInterfered = std::min (headerInterfered, plcpPayloadStart - mcsHeaderStart);
+  double headerPsr = CalculatePartSuccessRate (signalW, headerInterferenceW,
+                                               std::min (headerInterfered - mcsHeaderInterfered, mcsHeaderStart - plcpHeaderStart),
+                                               mcsHeaderStart - plcpHeaderStart, headerMode, txVector);
+  if (plcpPayloadStart > mcsHeaderStart)
+    {
+      headerPsr *= CalculatePartSuccessRate (signalW, headerInterferenceW, mcsHeaderInterfered,
+                                             plcpPayloadStart - mcsHeaderStart, mcsHeaderMode, txVector);
+    }
+  snrPer.headerPer = 1 - headerPsr;
+  double payloadInterferenceW = event->GetPayloadInterferenceW ();
+  Time payloadInterfered = event->GetPayloadInterferedTime ();
+  Time payloadDuration = event->GetEndTime () - plcpPayloadStart;
+  snrPer.payloadSnr = CalculateSnr (signalW, payloadInterferenceW * payloadInterfered.GetSeconds () / payloadDuration.GetSeconds (),
+                                    channelWidth);
+  snrPer.payloadPer = 1 - CalculatePartSuccessRate (signalW, payloadInterferenceW, payloadInterfered,
+                                                    payloadDuration, payloadMode, txVector);
+  NS_LOG_DEBUG ("header snr(dB)=" << RatioToDb (snrPer.headerSnr) << ", per=" << snrPer.headerPer <<
+                ", payload snr(dB)=" << RatioToDb (snrPer.payloadSnr) << ", per=" << snrPer.payloadPer);
+  return snrPer;
+}
+
+double
+InterferenceHelper::CalculatePartSuccessRate (double signalW, double interferenceW, Time interfered,
+                                              Time duration, WifiMode mode, WifiTxVector txVector) const
+{
+  uint16_t channelWidth = txVector.GetChannelWidth ();
+  double psr = 1;
+  if (interfered.IsStrictlyPositive ())
+    {
+      psr *= CalculateChunkSuccessRate (CalculateSnr (signalW, interferenceW, channelWidth),
+                                        interfered, mode, txVector);
+    }
+  if (duration > interfered)
+    {
+      psr *= CalculateChunkSuccessRate (CalculateSnr (signalW, 0, channelWidth),
+                                        duration - interfered, mode, txVector);
+    }
+  return psr;
+}
+
 void
 InterferenceHelper::EraseEvents (void)
 {
+  m_signals.clear ();
+  m_rxEvent = 0;
   m_niChanges.clear ();
   // Always have a zero power noise event in the list
   AddNiChangeEvent (Time (0), NiChange (0.0, 0));
@@ -786,6 +1007,17 @@ InterferenceHelper::EraseEvents (void)
   m_firstPower = 0;
 }
 
+void
+InterferenceHelper::ExpireSignals (void)
+{
+  Time now = Simulator::Now ();
+  while (!m_signals.empty () && m_signals.front ()->GetEndTime () <= now)
+    {
+      std::pop_heap (m_signals.begin (), m_signals.end (), &EndsLater);
+      m_signals.pop_back ();
+    }
+}
+
 InterferenceHelper::NiChanges::const_iterator
 InterferenceHelper::GetNextPosition (Time moment) const
 {
@@ -809,10 +1041,24 @@ InterferenceHelper::AddNiChangeEvent (Time moment, NiChange change)
 }
 
 void
-InterferenceHelper::NotifyRxStart ()
+InterferenceHelper::NotifyRxStart (Ptr<Event> event)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << event);
   m_rxing = true;
+  if (m_chunkTracking)
+    {
+      return;
+    }
+  m_rxEvent = event;
+  event->SetPayloadStartTime (event->GetStartTime ()
+                              + WifiPhy::CalculatePlcpPreambleAndHeaderDuration (event->GetTxVector ()));
+  for (auto &signal : m_signals)
+    {
+      if (signal != event)
+        {
+          event->AddInterference (signal->GetRxPowerW (), signal->GetStartTime (), signal->GetEndTime ());
+        }
+    }
 }
 
 void
@@ -820,6 +1066,11 @@ InterferenceHelper::NotifyRxEnd ()
 {
   NS_LOG_FUNCTION (this);
   m_rxing = false;
+  if (!m_chunkTracking)
+    {
+      m_rxEvent = 0;
+      return;
+    }
   //Update m_firstPower for frame capture
   auto it = m_niChanges.find (Simulator::Now ());
   it--;
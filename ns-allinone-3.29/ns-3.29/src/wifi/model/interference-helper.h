@@ -24,6 +24,7 @@
 #include "ns3/nstime.h"
 #include "wifi-tx-vector.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -84,6 +85,55 @@ public:
    * \return the Wi-Fi mode used for the payload
    */
   WifiMode GetPayloadMode (void) const;
+  /**
+   * Set the start time of the PLCP payload of the signal, which splits the
+   * interference recorded by AddInterference.
+   *
+   * \param payloadStart the start time of the PLCP payload
+   */
+  void SetPayloadStartTime (Time payloadStart);
+  /**
+   * Record the energy of another signal overlapping the PLCP header and
+   * the PLCP payload of the signal.  It is only recorded for the signal
+   * being received, when the InterferenceHelper does not track the chunks.
+   *
+   * \param power the power of the other signal (w)
+   * \param start the start time of the other signal
+   * \param end the end time of the other signal
+   */
+  void AddInterference (double power, Time start, Time end);
+  /**
+   * Return the mean power of the other signals while they overlap the PLCP
+   * header (preamble included) of the signal (w).  The other signals are
+   * taken not to overlap each other, unless together they last longer
+   * than the PLCP header.
+   *
+   * \return the mean power of the other signals during the interfered part
+   *         of the PLCP header (w)
+   */
+  double GetHeaderInterferenceW (void) const;
+  /**
+   * Return how long other signals overlap the PLCP header (preamble
+   * included) of the signal, at most its duration.
+   *
+   * \return the interfered time of the PLCP header
+   */
+  Time GetHeaderInterferedTime (void) const;
+  /**
+   * Return the mean power of the other signals while they overlap the PLCP
+   * payload of the signal (w), as GetHeaderInterferenceW.
+   *
+   * \return the mean power of the other signals during the interfered part
+   *         of the PLCP payload (w)
+   */
+  double GetPayloadInterferenceW (void) const;
+  /**
+   * Return how long other signals overlap the PLCP payload of the signal,
+   * at most its duration.
+   *
+   * \return the interfered time of the PLCP payload
+   */
+  Time GetPayloadInterferedTime (void) const;
 
 
 private:
@@ -92,6 +142,11 @@ private:
   Time m_startTime; ///< start time
   Time m_endTime; ///< end time
   double m_rxPowerW; ///< receive power in watts
+  Time m_payloadStartTime; ///< start time of the PLCP payload
+  double m_headerInterferenceJ; ///< energy of the other signals during the PLCP header in joules
+  double m_payloadInterferenceJ; ///< energy of the other signals during the PLCP payload in joules
+  Time m_headerInterferedTime; ///< overlap of the other signals with the PLCP header
+  Time m_payloadInterferedTime; ///< overlap of the other signals with the PLCP payload
 };
 
 /**
@@ -114,6 +169,18 @@ public:
     double per; ///< PER
   };
 
+  /**
+   * A struct for the effective SNRs and the PERs of the PLCP header and of
+   * the PLCP payload of a frame
+   */
+  struct EffectiveSnrPer
+  {
+    double headerSnr;  ///< effective SNR of the PLCP header
+    double headerPer;  ///< PER of the PLCP header
+    double payloadSnr; ///< effective SNR of the PLCP payload
+    double payloadPer; ///< PER of the PLCP payload
+  };
+
   InterferenceHelper ();
   ~InterferenceHelper ();
 
@@ -189,11 +256,40 @@ public:
    * \return struct of SNR and PER
    */
   struct InterferenceHelper::SnrPer CalculatePlcpHeaderSnrPer (Ptr<Event> event) const;
+  /**
+   * Calculate the effective SNRs of the PLCP header and of the PLCP payload
+   * of a frame from the energy of the other signals overlapping each part,
+   * averaged over its duration, and the PERs of both parts.  Each part is
+   * decided as two chunks: the noise only, then the interfered end of the
+   * part, at the mean power of the other signals while they overlap it.
+   * The error rate model is called at most twice per mode, whatever the
+   * number of other signals.  Only available when the chunks are not
+   * tracked.
+   *
+   * \param event the event corresponding to the first time the corresponding packet arrives
+   *
+   * \return struct of effective SNRs and PERs
+   */
+  struct InterferenceHelper::EffectiveSnrPer CalculateEffectiveSnrPer (Ptr<Event> event) const;
+  /**
+   * Enable or disable the tracking of the changes of noise and interference
+   * during the signals.  When disabled, only the signals on the air are
+   * kept, which is enough for the CCA, and the event being received records
+   * the energy of the other signals overlapping it, for
+   * CalculateEffectiveSnrPer.
+   * The PLCP header and payload SNR and PER per chunk are then not
+   * available.  Enabled by default.
+   *
+   * \param enable whether to track the changes of noise and interference
+   */
+  void SetChunkTracking (bool enable);
 
   /**
    * Notify that RX has started.
+   *
+   * \param event the event being received
    */
-  void NotifyRxStart ();
+  void NotifyRxStart (Ptr<Event> event);
   /**
    * Notify that RX has ended.
    */
@@ -286,6 +382,22 @@ private:
    * \return the success rate
    */
   double CalculateChunkSuccessRate (double snir, Time duration, WifiMode mode, WifiTxVector txVector) const;
+  /**
+   * Calculate the success rate of a part of a frame whose end is interfered
+   * by other signals, as a chunk with the noise only followed by an
+   * interfered chunk.
+   *
+   * \param signalW the power of the frame (w)
+   * \param interferenceW the power of the other signals during the interfered chunk (w)
+   * \param interfered the duration of the interfered chunk, at most the duration of the part
+   * \param duration the duration of the part
+   * \param mode the mode of the part
+   * \param txVector the TXVECTOR of the frame
+   *
+   * \return the success rate
+   */
+  double CalculatePartSuccessRate (double signalW, double interferenceW, Time interfered,
+                                   Time duration, WifiMode mode, WifiTxVector txVector) const;
   /**
    * Calculate the error rate of the given plcp payload. The plcp payload can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
@@ -306,6 +418,11 @@ private:
    * \return the error rate of the packet
    */
   double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  /**
+   * Remove the signals which have ended from the signals on the air, when
+   * the chunks are not tracked.
+   */
+  void ExpireSignals (void);
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel; ///< error rate model
@@ -314,6 +431,9 @@ private:
   NiChanges m_niChanges;
   double m_firstPower; ///< first power
   bool m_rxing; ///< flag whether it is in receiving state
+  bool m_chunkTracking; ///< flag whether the changes of noise and interference are tracked
+  std::vector<Ptr<Event> > m_signals; ///< heap of the signals on the air, earliest end first, when the chunks are not tracked
+  Ptr<Event> m_rxEvent; ///< the signal being received, when the chunks are not tracked
 
   /**
    * Returns an iterator to the first nichange that is later than moment
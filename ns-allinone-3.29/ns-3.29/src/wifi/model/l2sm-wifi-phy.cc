@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "l2sm-wifi-phy.h"
+#include "wifi-utils.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("L2smWifiPhy");
+
+NS_OBJECT_ENSURE_REGISTERED (L2smWifiPhy);
+
+TypeId
+L2smWifiPhy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::L2smWifiPhy")
+    .SetParent<YansWifiPhy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<L2smWifiPhy> ()
+  ;
+  return tid;
+}
+
+L2smWifiPhy::L2smWifiPhy ()
+{
+  NS_LOG_FUNCTION (this);
+  m_interference.SetChunkTracking (false);
+}
+
+L2smWifiPhy::~L2smWifiPhy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+L2smWifiPhy::ScheduleEndOfPlcpHeader (Ptr<Packet> packet, WifiTxVector txVector, MpduType mpdutype, Ptr<Event> event)
+{
+  NS_LOG_FUNCTION (this << packet << txVector << +mpdutype);
+  //the PLCP header is checked by CalculatePlcpPayloadSnrPer at the end of the frame
+}
+
+InterferenceHelper::SnrPer
+L2smWifiPhy::CalculatePlcpPayloadSnrPer (Ptr<Packet> packet, Ptr<Event> event)
+{
+  NS_LOG_FUNCTION (this << packet << event);
+  InterferenceHelper::EffectiveSnrPer effectiveSnrPer = m_interference.CalculateEffectiveSnrPer (event);
+
+  WifiTxVector txVector = event->GetTxVector ();
+  if (txVector.GetPreambleType () != WIFI_PREAMBLE_NONE)
+    {
+      NS_LOG_DEBUG ("header snr(dB)=" << RatioToDb (effectiveSnrPer.headerSnr) << ", per=" << effectiveSnrPer.headerPer);
+      if (m_random->GetValue () > effectiveSnrPer.headerPer) //plcp reception succeeded
+        {
+          if (IsModeSupported (txVector.GetMode ()) || IsMcsSupported (txVector.GetMode ()))
+            {
+              m_plcpSuccess = true;
+            }
+          else //mode is not allowed
+            {
+              NS_LOG_DEBUG ("drop packet because it was sent using an unsupported mode (" << txVector.GetMode () << ")");
+              NotifyRxDrop (packet);
+              m_plcpSuccess = false;
+            }
+        }
+      else //plcp reception failed
+        {
+          NS_LOG_DEBUG ("drop packet because plcp preamble/header reception failed");
+          NotifyRxDrop (packet);
+          m_plcpSuccess = false;
+        }
+    }
+
+  InterferenceHelper::SnrPer snrPer;
+  snrPer.snr = effectiveSnrPer.payloadSnr;
+  snrPer.per = effectiveSnrPer.payloadPer;
+  return snrPer;
+}
+
+} //namespace ns3
@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef L2SM_WIFI_PHY_H
+#define L2SM_WIFI_PHY_H
+
+#include "yans-wifi-phy.h"
+
+namespace ns3 {
+
+/**
+ * \brief 802.11 PHY layer model with a link-to-system mapping
+ * \ingroup wifi
+ *
+ * This PHY is connected to a YansWifiChannel like the YansWifiPhy, and
+ * shares its state machine and its CCA, but abstracts the reception of a
+ * frame: instead of tracking the noise and interference changes during the
+ * frame, checking the PLCP header when it ends and then computing the error
+ * rate of every chunk of the payload, it decides the fate of the whole
+ * frame at its end, in a single event.  Each other signal overlapping the
+ * frame adds its energy and its overlap with the PLCP header and with the
+ * PLCP payload to those of the frame when it arrives, and the PER of each
+ * part is computed from a chunk with the noise only and an interfered chunk
+ * at the mean power of the other signals (see
+ * InterferenceHelper::CalculateEffectiveSnrPer).
+ *
+ * The PERs are computed by the error rate model of the PHY.  The
+ * L2smWifiPhyHelper uses a TabulatedErrorRateModel, whose tables hold the
+ * bit success rate of each MCS and scale it to the size of the frame.
+ *
+ * The outcome of a frame received without interference is the same as with
+ * the YansWifiPhy or the SpectrumWifiPhy, except that the PLCP header is
+ * checked at the end of the frame.
+ */
+class L2smWifiPhy : public YansWifiPhy
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  L2smWifiPhy ();
+  virtual ~L2smWifiPhy ();
+
+
+protected:
+  // Inherited
+  virtual void ScheduleEndOfPlcpHeader (Ptr<Packet> packet,
+                                        WifiTxVector txVector,
+                                        MpduType mpdutype,
+                                        Ptr<Event> event);
+  virtual InterferenceHelper::SnrPer CalculatePlcpPayloadSnrPer (Ptr<Packet> packet, Ptr<Event> event);
+};
+
+} //namespace ns3
+
+#endif /* L2SM_WIFI_PHY_H */
@@ -67,7 +67,7 @@ struct MinstrelHtWifiRemoteStation : MinstrelWifiRemoteStation
   McsGroupData m_groupsTable;  //!< Table of groups with stats.
   bool m_isHt;                 //!< If the station is HT capable.
 
-  std::ofstream m_statsFile;   //!< File where statistics table is written.
+  HtMinstrelRateStats m_ratesStats; //!< Statistics of each rate index which are only printed, empty unless PrintStats is enabled.
 };
 
 NS_OBJECT_ENSURE_REGISTERED (MinstrelHtWifiManager);
@@ -454,13 +454,9 @@ MinstrelHtWifiManager::CheckInit (MinstrelHtWifiRemoteStation *station)
           NS_LOG_DEBUG ("HT station " << station);
           station->m_isHt = true;
           station->m_nModes = GetNMcsSupported (station);
-          station->m_minstrelTable = MinstrelRate (station->m_nModes);
-          station->m_sampleTable = SampleRate (m_numRates, std::vector<uint8_t> (m_nSampleCol));
+          station->m_sampleTable = SampleRate (m_numRates * m_nSampleCol);
           InitSampleTable (station);
           RateInit (station);
-          std::ostringstream tmp;
-          tmp << "minstrel-ht-stats-" << station->m_state->m_address << ".txt";
-          station->m_statsFile.open (tmp.str ().c_str (), std::ios::out);
           station->m_initialized = true;
         }
     }
@@ -546,10 +542,10 @@ MinstrelHtWifiManager::DoReportDataOk (WifiRemoteStation *st, double ackSnr, Wif
       return;
     }
 
-  NS_LOG_DEBUG ("DoReportDataOk m_txrate = " << station->m_txrate << ", attempt = " << station->m_minstrelTable[station->m_txrate].numRateAttempt << ", success = " << station->m_minstrelTable[station->m_txrate].numRateSuccess << " (before update).");
-
   if (!station->m_isHt)
     {
+      NS_LOG_DEBUG ("DoReportDataOk m_txrate = " << station->m_txrate << ", attempt = " << station->m_minstrelTable[station->m_txrate].numRateAttempt << ", success = " << station->m_minstrelTable[station->m_txrate].numRateSuccess << " (before update).");
+
       station->m_minstrelTable[station->m_txrate].numRateSuccess++;
       station->m_minstrelTable[station->m_txrate].numRateAttempt++;
 
@@ -569,12 +565,14 @@ MinstrelHtWifiManager::DoReportDataOk (WifiRemoteStation *st, double ackSnr, Wif
     {
       uint8_t rateId = GetRateId (station->m_txrate);
       uint8_t groupId = GetGroupId (station->m_txrate);
+      NS_LOG_DEBUG ("DoReportDataOk m_txrate = " << station->m_txrate << ", attempt = " << station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt << ", success = " << station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess << " (before update).");
+
       station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess++;
       station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt++;
 
       UpdatePacketCounters (station, 1, 0);
 
-      NS_LOG_DEBUG ("DoReportDataOk m_txrate = " << station->m_txrate << ", attempt = " << station->m_minstrelTable[station->m_txrate].numRateAttempt << ", success = " << station->m_minstrelTable[station->m_txrate].numRateSuccess << " (after update).");
+      NS_LOG_DEBUG ("DoReportDataOk m_txrate = " << station->m_txrate << ", attempt = " << station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt << ", success = " << station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess << " (after update).");
 
       station->m_isSampling = false;
       station->m_sampleDeferred = false;
@@ -1026,7 +1024,7 @@ MinstrelHtWifiManager::GetNextSample (MinstrelHtWifiRemoteStation *station)
   uint8_t sampleGroup = station->m_sampleGroup;
   uint8_t index = station->m_groupsTable[sampleGroup].m_index;
   uint8_t col = station->m_groupsTable[sampleGroup].m_col;
-  uint8_t sampleIndex = station->m_sampleTable[index][col];
+  uint8_t sampleIndex = station->m_sampleTable[index * m_nSampleCol + col];
   uint16_t rateIndex = GetIndex (sampleGroup, sampleIndex);
   NS_LOG_DEBUG ("Next Sample is " << rateIndex);
   SetNextSample (station); //Calculate the next sample rate.
@@ -1061,7 +1059,7 @@ MinstrelHtWifiManager::SetNextSample (MinstrelHtWifiRemoteStation *station)
       index = station->m_groupsTable[station->m_sampleGroup].m_index;
       col = station->m_groupsTable[sampleGroup].m_col;
     }
-  NS_LOG_DEBUG ("New sample set: group= " << +sampleGroup << " index= " << +station->m_sampleTable[index][col]);
+  NS_LOG_DEBUG ("New sample set: group= " << +sampleGroup << " index= " << +station->m_sampleTable[index * m_nSampleCol + col]);
 }
 
 uint16_t
@@ -1189,6 +1187,12 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
       station->m_ampduPacketCount = 0;
     }
 
+  if (m_printStats && station->m_ratesStats.empty ())
+    {
+      station->m_ratesStats = HtMinstrelRateStats (m_numGroups * m_numRates);
+    }
+  bool printStats = !station->m_ratesStats.empty ();
+
   /* Initialize global rate indexes */
   station->m_maxTpRate = GetLowestIndex (station);
   station->m_maxTpRate2 = GetLowestIndex (station);
@@ -1210,6 +1214,7 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
             {
               if (station->m_groupsTable[j].m_ratesTable[i].supported)
                 {
+                  HtRateStats *rateStats = printStats ? &station->m_ratesStats[GetIndex (j, i)] : 0;
                   station->m_groupsTable[j].m_ratesTable[i].retryUpdated = false;
 
                   NS_LOG_DEBUG (+i << " " << GetMcsSupported (station, station->m_groupsTable[j].m_ratesTable[i].mcsIndex) <<
@@ -1227,17 +1232,22 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
                       tempProb = (100 * station->m_groupsTable[j].m_ratesTable[i].numRateSuccess) / station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
 
                       /// Bookkeeping.
-                      station->m_groupsTable[j].m_ratesTable[i].prob = tempProb;
+                      if (printStats)
+                        {
+                          rateStats->prob = tempProb;
+                        }
 
-                      if (station->m_groupsTable[j].m_ratesTable[i].successHist == 0)
+                      if (!station->m_groupsTable[j].m_ratesTable[i].succeeded)
                         {
                           station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
                         }
                       else
                         {
-                          station->m_groupsTable[j].m_ratesTable[i].ewmsdProb = CalculateEwmsd (station->m_groupsTable[j].m_ratesTable[i].ewmsdProb,
-                                                                                                tempProb, station->m_groupsTable[j].m_ratesTable[i].ewmaProb,
-                                                                                                m_ewmaLevel);
+                          if (printStats)
+                            {
+                              rateStats->ewmsdProb = CalculateEwmsd (rateStats->ewmsdProb, tempProb,
+                                                                     station->m_groupsTable[j].m_ratesTable[i].ewmaProb, m_ewmaLevel);
+                            }
                           /// EWMA probability
                           tempProb = (tempProb * (100 - m_ewmaLevel) + station->m_groupsTable[j].m_ratesTable[i].ewmaProb * m_ewmaLevel)  / 100;
                           station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
@@ -1245,8 +1255,15 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
 
                       station->m_groupsTable[j].m_ratesTable[i].throughput = CalculateThroughput (station, j, i, tempProb);
 
-                      station->m_groupsTable[j].m_ratesTable[i].successHist += station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                      station->m_groupsTable[j].m_ratesTable[i].attemptHist += station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
+                      if (station->m_groupsTable[j].m_ratesTable[i].numRateSuccess > 0)
+                        {
+                          station->m_groupsTable[j].m_ratesTable[i].succeeded = true;
+                        }
+                      if (printStats)
+                        {
+                          rateStats->successHist += station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
+                          rateStats->attemptHist += station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
+                        }
                     }
                   else
                     {
@@ -1254,8 +1271,11 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
                     }
 
                   /// Bookkeeping.
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateSuccess = station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateAttempt = station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
+                  if (printStats)
+                    {
+                      rateStats->prevNumRateSuccess = station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
+                      rateStats->prevNumRateAttempt = station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
+                    }
                   station->m_groupsTable[j].m_ratesTable[i].numRateSuccess = 0;
                   station->m_groupsTable[j].m_ratesTable[i].numRateAttempt = 0;
 
@@ -1441,6 +1461,7 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
   NS_LOG_FUNCTION (this << station);
 
   station->m_groupsTable = McsGroupData (m_numGroups);
+  station->m_ratesStats.clear ();
 
   /**
   * Initialize groups supported by the receiver.
@@ -1495,17 +1516,12 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
                       station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex = i;         ///Mapping between rateId and operationalMcsSet
                       station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt = 0;
                       station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].prob = 0;
                       station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateAttempt = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateSuccess = 0;
                       station->m_groupsTable[groupId].m_ratesTable[rateId].numSamplesSkipped = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].successHist = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].attemptHist = 0;
+                      station->m_groupsTable[groupId].m_ratesTable[rateId].succeeded = false;
                       station->m_groupsTable[groupId].m_ratesTable[rateId].throughput = 0;
                       station->m_groupsTable[groupId].m_ratesTable[rateId].perfectTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, i));
                       station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].adjustedRetryCount = 0;
                       CalculateRetransmits (station, groupId, rateId);
                     }
                 }
@@ -1613,11 +1629,11 @@ MinstrelHtWifiManager::InitSampleTable (MinstrelHtWifiRemoteStation *station)
           newIndex = (i + uv) % numSampleRates;
 
           //this loop is used for filling in other uninitialized places
-          while (station->m_sampleTable[newIndex][col] != 0)
+          while (station->m_sampleTable[newIndex * m_nSampleCol + col] != 0)
             {
               newIndex = (newIndex + 1) % m_numRates;
             }
-          station->m_sampleTable[newIndex][col] = i;
+          station->m_sampleTable[newIndex * m_nSampleCol + col] = i;
         }
     }
 }
@@ -1625,6 +1641,12 @@ MinstrelHtWifiManager::InitSampleTable (MinstrelHtWifiRemoteStation *station)
 void
 MinstrelHtWifiManager::PrintTable (MinstrelHtWifiRemoteStation *station)
 {
+  if (!station->m_statsFile.is_open ())
+    {
+      std::ostringstream tmp;
+      tmp << "minstrel-ht-stats-" << station->m_state->m_address << ".txt";
+      station->m_statsFile.open (tmp.str ().c_str (), std::ios::out);
+    }
   station->m_statsFile << "               best   ____________rate__________    ________statistics________    ________last_______    ______sum-of________\n" <<
     " mode guard #  rate  [name   idx airtime  max_tp]  [avg(tp) avg(prob) sd(prob)]  [prob.|retry|suc|att]  [#success | #attempts]\n";
   for (uint8_t i = 0; i < m_numGroups; i++)
@@ -1672,6 +1694,7 @@ MinstrelHtWifiManager::StatsDump (MinstrelHtWifiRemoteStation *station, uint8_t
           uint16_t maxProbRate = station->m_maxProbRate;
 
           uint16_t idx = GetIndex (groupId, i);
+          const HtRateStats &rateStats = station->m_ratesStats[idx];
           if (idx == maxTpRate)
             {
               of << 'A';
@@ -1715,13 +1738,13 @@ MinstrelHtWifiManager::StatsDump (MinstrelHtWifiRemoteStation *station, uint8_t
           of << std::setw (7) << CalculateThroughput (station, groupId, i, 100) / 100 << "   " <<
             std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].throughput / 100 << "   " <<
             std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].ewmaProb << "  " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].ewmsdProb << "  " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].prob << "  " <<
+            std::setw (7) << rateStats.ewmsdProb << "  " <<
+            std::setw (7) << rateStats.prob << "  " <<
             std::setw (2) << station->m_groupsTable[groupId].m_ratesTable[i].retryCount << "   " <<
-            std::setw (3) << station->m_groupsTable[groupId].m_ratesTable[i].prevNumRateSuccess << "  " <<
-            std::setw (3) << station->m_groupsTable[groupId].m_ratesTable[i].prevNumRateAttempt << "   " <<
-            std::setw (9) << station->m_groupsTable[groupId].m_ratesTable[i].successHist << "   " <<
-            std::setw (9) << station->m_groupsTable[groupId].m_ratesTable[i].attemptHist << "\n";
+            std::setw (3) << rateStats.prevNumRateSuccess << "  " <<
+            std::setw (3) << rateStats.prevNumRateAttempt << "   " <<
+            std::setw (9) << rateStats.successHist << "   " <<
+            std::setw (9) << rateStats.attemptHist << "\n";
         }
     }
 }
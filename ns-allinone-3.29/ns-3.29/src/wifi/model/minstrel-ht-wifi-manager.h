@@ -63,7 +63,9 @@ typedef std::vector<McsGroup> MinstrelMcsGroups;
 
 struct MinstrelHtWifiRemoteStation;
 /**
- * A struct to contain all statistics information related to a data rate.
+ * A struct to contain the statistics information related to a data rate
+ * which is used to select the rates.  This struct is kept small since the
+ * tables of the stations hold one instance per rate of each supported group.
  */
 struct HtRateInfo
 {
@@ -72,27 +74,36 @@ struct HtRateInfo
    * Given a bit rate and a packet length n bytes.
    */
   Time perfectTxTime;
-  bool supported;               //!< If the rate is supported.
-  uint8_t mcsIndex;             //!< The index in the operationalMcsSet of the WifiRemoteStationManager.
-  uint32_t retryCount;          //!< Retry limit.
-  uint32_t adjustedRetryCount;  //!< Adjust the retry limit for this rate.
-  uint32_t numRateAttempt;      //!< Number of transmission attempts so far.
-  uint32_t numRateSuccess;      //!< Number of successful frames transmitted so far.
-  double prob;                  //!< Current probability within last time interval. (# frame success )/(# total frames)
-  bool retryUpdated;            //!< If number of retries was updated already.
   /**
    * Exponential weighted moving average of probability.
    * EWMA calculation:
    * ewma_prob =[prob *(100 - ewma_level) + (ewma_prob_old * ewma_level)]/100
    */
   double ewmaProb;
+  double throughput;            //!< Throughput of this rate (in pkts per second).
+  uint32_t retryCount;          //!< Retry limit.
+  uint32_t numRateAttempt;      //!< Number of transmission attempts so far.
+  uint32_t numRateSuccess;      //!< Number of successful frames transmitted so far.
+  uint32_t numSamplesSkipped;   //!< Number of times this rate statistics were not updated because no attempts have been made.
+  uint8_t mcsIndex;             //!< The index in the operationalMcsSet of the WifiRemoteStationManager.
+  bool supported;               //!< If the rate is supported.
+  bool retryUpdated;            //!< If number of retries was updated already.
+  bool succeeded;               //!< If a frame was successfully transmitted at this rate in a past update interval.
+};
+
+/**
+ * A struct to contain the statistics information related to a data rate
+ * which is only written to the statistics table.  The stations only hold
+ * these statistics when PrintStats is enabled.
+ */
+struct HtRateStats
+{
+  double prob;                  //!< Current probability within last time interval. (# frame success )/(# total frames)
   double ewmsdProb;             //!< Exponential weighted moving standard deviation of probability.
   uint32_t prevNumRateAttempt;  //!< Number of transmission attempts with previous rate.
   uint32_t prevNumRateSuccess;  //!< Number of successful frames transmitted with previous rate.
-  uint32_t numSamplesSkipped;   //!< Number of times this rate statistics were not updated because no attempts have been made.
   uint64_t successHist;         //!< Aggregate of all transmission successes.
   uint64_t attemptHist;         //!< Aggregate of all transmission attempts.
-  double throughput;            //!< Throughput of this rate (in pkts per second).
 };
 
 /**
@@ -101,6 +112,12 @@ struct HtRateInfo
  */
 typedef std::vector<HtRateInfo> HtMinstrelRate;
 
+/**
+ * Data structure for the table of the statistics which are only printed.
+ * A vector of a struct HtRateStats.
+ */
+typedef std::vector<HtRateStats> HtMinstrelRateStats;
+
 /**
  * A struct to contain information of a group.
  */
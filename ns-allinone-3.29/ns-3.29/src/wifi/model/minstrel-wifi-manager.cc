@@ -194,13 +194,10 @@ MinstrelWifiManager::CheckInit (MinstrelWifiRemoteStation *station)
       //before we perform our own initialization.
       station->m_nModes = GetNSupported (station);
       station->m_minstrelTable = MinstrelRate (station->m_nModes);
-      station->m_sampleTable = SampleRate (station->m_nModes, std::vector<uint8_t> (m_sampleCol));
+      station->m_sampleTable = SampleRate (station->m_nModes * m_sampleCol);
       InitSampleTable (station);
       RateInit (station);
       station->m_initialized = true;
-      std::ostringstream tmp;
-      tmp << "minstrel-stats-" << station->m_state->m_address << ".txt";
-      station->m_statsFile.open (tmp.str ().c_str (), std::ios::out);
     }
 }
 
@@ -888,7 +885,7 @@ MinstrelWifiManager::GetNextSample (MinstrelWifiRemoteStation *station)
 {
   NS_LOG_FUNCTION (this << station);
   uint16_t bitrate;
-  bitrate = station->m_sampleTable[station->m_index][station->m_col];
+  bitrate = station->m_sampleTable[station->m_index * m_sampleCol + station->m_col];
   station->m_index++;
 
   //bookkeeping for m_index and m_col variables
@@ -997,11 +994,11 @@ MinstrelWifiManager::InitSampleTable (MinstrelWifiRemoteStation *station)
           newIndex = (i + uv) % numSampleRates;
 
           //this loop is used for filling in other uninitialized places
-          while (station->m_sampleTable[newIndex][col] != 0)
+          while (station->m_sampleTable[newIndex * m_sampleCol + col] != 0)
             {
               newIndex = (newIndex + 1) % station->m_nModes;
             }
-          station->m_sampleTable[newIndex][col] = i;
+          station->m_sampleTable[newIndex * m_sampleCol + col] = i;
         }
     }
 }
@@ -1015,7 +1012,7 @@ MinstrelWifiManager::PrintSampleTable (MinstrelWifiRemoteStation *station)
     {
       for (uint8_t j = 0; j < m_sampleCol; j++)
         {
-          table << station->m_sampleTable[i][j] << "\t";
+          table << station->m_sampleTable[i * m_sampleCol + j] << "\t";
         }
       table << std::endl;
     }
@@ -1025,6 +1022,12 @@ MinstrelWifiManager::PrintSampleTable (MinstrelWifiRemoteStation *station)
 void
 MinstrelWifiManager::PrintTable (MinstrelWifiRemoteStation *station)
 {
+  if (!station->m_statsFile.is_open ())
+    {
+      std::ostringstream tmp;
+      tmp << "minstrel-stats-" << station->m_state->m_address << ".txt";
+      station->m_statsFile.open (tmp.str ().c_str (), std::ios::out);
+    }
   station->m_statsFile << "best   _______________rate________________    ________statistics________    ________last_______    ______sum-of________\n" <<
     "rate  [      name       idx airtime max_tp]  [avg(tp) avg(prob) sd(prob)]  [prob.|retry|suc|att]  [#success | #attempts]\n";
 
@@ -70,9 +70,11 @@ struct RateInfo
 typedef std::vector<RateInfo> MinstrelRate;
 /**
  * Data structure for a Sample Rate table
- * A vector of a vector uint8_t
+ * A flat vector of uint8_t, holding one row of sample columns per rate:
+ * the entry of the rate index i and of the column col is at
+ * i * (number of sample columns) + col.
  */
-typedef std::vector<std::vector<uint8_t> > SampleRate;
+typedef std::vector<uint8_t> SampleRate;
 
 /**
  * \brief hold per-remote-station state for Minstrel Wifi manager.
@@ -109,7 +111,7 @@ struct MinstrelWifiRemoteStation : public WifiRemoteStation
   bool m_initialized;            ///< for initializing tables
   MinstrelRate m_minstrelTable;  ///< minstrel table
   SampleRate m_sampleTable;      ///< sample table
-  std::ofstream m_statsFile;     ///< stats file
+  std::ofstream m_statsFile;     ///< stats file, opened when the table is first printed
 };
 
 
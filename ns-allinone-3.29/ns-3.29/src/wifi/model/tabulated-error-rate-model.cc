@@ -0,0 +1,367 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "tabulated-error-rate-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TabulatedErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TabulatedErrorRateModel);
+
+/// The magic number at the beginning of the table files
+static const char TABLE_FILE_MAGIC[8] = {'N', 'S', '3', 'W', 'B', 'E', 'R', '\0'};
+
+/// The fixed size part of a table file, followed by the tables
+struct TableFileHeader
+{
+  char magic[8];        ///< TABLE_FILE_MAGIC
+  uint32_t version;     ///< the version of the format
+  uint32_t nPoints;     ///< the number of points of the SNR grid
+  double minSnr;        ///< the lowest SNR of the grid in dB
+  double maxSnr;        ///< the highest SNR of the grid in dB
+  double snrStep;       ///< the step of the grid in dB
+  uint32_t nTables;     ///< the number of tables in the file
+  uint32_t modelLength; ///< the length of the TypeId name of the tabulated model which follows
+};
+
+/// The fixed size part of a table, followed by the mode name and the table values
+struct TableRecordHeader
+{
+  uint16_t channelWidth;  ///< the channel width in MHz
+  uint16_t guardInterval; ///< the guard interval in nanoseconds
+  uint8_t nss;            ///< the number of spatial streams
+  uint8_t reserved;       ///< unused
+  uint16_t modeLength;    ///< the length of the unique name of the mode which follows
+};
+
+TypeId
+TabulatedErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TabulatedErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TabulatedErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model whose chunk success rate is tabulated.",
+                   StringValue ("ns3::NistErrorRateModel"),
+                   MakePointerAccessor (&TabulatedErrorRateModel::m_errorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnr",
+                   "The lowest SNR (dB) of the tables.  Lower SNRs are passed to the tabulated model.",
+                   DoubleValue (-15.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_minSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The highest SNR (dB) of the tables.  Higher SNRs are passed to the tabulated model.",
+                   DoubleValue (60.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_maxSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrStep",
+                   "The step (dB) between the SNRs of the tables.",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_snrStep),
+                   MakeDoubleChecker<double> (0.001))
+    .AddAttribute ("TableFile",
+                   "The name of a file saved by TabulatedErrorRateModel::Save, loaded when the "
+                   "model is first used if it exists.  Empty to compute all the tables.",
+                   StringValue (""),
+                   MakeStringAccessor (&TabulatedErrorRateModel::m_tableFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+TabulatedErrorRateModel::TabulatedErrorRateModel ()
+  : m_tableFileLoaded (false),
+    m_lastTable (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TabulatedErrorRateModel::~TabulatedErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+TabulatedErrorRateModel::TableKey::operator < (const TableKey &other) const
+{
+  if (mode.GetUid () != other.mode.GetUid ())
+    {
+      return mode.GetUid () < other.mode.GetUid ();
+    }
+  if (channelWidth != other.channelWidth)
+    {
+      return channelWidth < other.channelWidth;
+    }
+  if (guardInterval != other.guardInterval)
+    {
+      return guardInterval < other.guardInterval;
+    }
+  return nss < other.nss;
+}
+
+bool
+TabulatedErrorRateModel::TableKey::operator == (const TableKey &other) const
+{
+  return mode == other.mode && channelWidth == other.channelWidth
+         && guardInterval == other.guardInterval && nss == other.nss;
+}
+
+TabulatedErrorRateModel::TableKey
+TabulatedErrorRateModel::GetKey (WifiMode mode, WifiTxVector txVector)
+{
+  TableKey key;
+  key.mode = mode;
+  key.channelWidth = txVector.GetChannelWidth ();
+  key.guardInterval = txVector.GetGuardInterval ();
+  key.nss = txVector.GetNss ();
+  return key;
+}
+
+double
+TabulatedErrorRateModel::ToTableValue (double successRate)
+{
+  if (successRate <= 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  if (successRate >= 1)
+    {
+      return -std::numeric_limits<double>::infinity ();
+    }
+  return std::log (-std::log (successRate));
+}
+
+double
+TabulatedErrorRateModel::FromTableValue (double value)
+{
+  return std::exp (-std::exp (value));
+}
+
+uint32_t
+TabulatedErrorRateModel::GetNPoints (void) const
+{
+  NS_ABORT_MSG_IF (m_maxSnr <= m_minSnr, "MaxSnr must be higher than MinSnr");
+  return static_cast<uint32_t> (std::floor ((m_maxSnr - m_minSnr) / m_snrStep + 0.5)) + 1;
+}
+
+Ptr<ErrorRateModel>
+TabulatedErrorRateModel::GetErrorRateModel (void) const
+{
+  return m_errorRateModel;
+}
+
+void
+TabulatedErrorRateModel::Tabulate (WifiMode mode, WifiTxVector txVector) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector);
+  GetTable (mode, txVector);
+}
+
+const TabulatedErrorRateModel::Table &
+TabulatedErrorRateModel::GetTable (WifiMode mode, WifiTxVector txVector) const
+{
+  TableKey key = GetKey (mode, txVector);
+  if (m_lastTable != 0 && key == m_lastKey)
+    {
+      return *m_lastTable;
+    }
+  LoadTableFile ();
+  std::map<TableKey, Table>::iterator it = m_tables.find (key);
+  if (it == m_tables.end ())
+    {
+      NS_LOG_DEBUG ("tabulating " << mode << " width=" << key.channelWidth
+                                  << " gi=" << key.guardInterval << " nss=" << +key.nss);
+      uint32_t nPoints = GetNPoints ();
+      Table table (nPoints);
+      for (uint32_t i = 0; i < nPoints; i++)
+        {
+          double snr = std::pow (10.0, (m_minSnr + i * m_snrStep) / 10.0);
+          table[i] = ToTableValue (m_errorRateModel->GetChunkSuccessRate (mode, txVector, snr, 1));
+        }
+      it = m_tables.insert (std::make_pair (key, table)).first;
+    }
+  m_lastKey = key;
+  m_lastTable = &it->second;
+  return it->second;
+}
+
+double
+TabulatedErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector.GetMode () << snr << nbits);
+  const Table &table = GetTable (mode, txVector);
+  double position = (10.0 * std::log10 (snr) - m_minSnr) / m_snrStep;
+  if (!(position >= 0) || position >= table.size () - 1)
+    {
+      return m_errorRateModel->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  uint32_t index = static_cast<uint32_t> (position);
+  double fraction = position - index;
+  double lower = table[index];
+  double upper = table[index + 1];
+  if (std::isfinite (lower) && std::isfinite (upper))
+    {
+      double logSuccessRate = -std::exp (lower + fraction * (upper - lower));
+      return std::exp (nbits * logSuccessRate);
+    }
+  if (lower == upper)
+    {
+      // the success rate of a bit is 0 or 1 over the whole interval
+      return FromTableValue (lower);
+    }
+  // the success rate of a bit reaches 0 or 1 within the interval, possibly
+  // through a discontinuity of the tabulated model
+  return m_errorRateModel->GetChunkSuccessRate (mode, txVector, snr, nbits);
+}
+
+void
+TabulatedErrorRateModel::LoadTableFile (void) const
+{
+  if (m_tableFileLoaded)
+    {
+      return;
+    }
+  m_tableFileLoaded = true;
+  if (m_tableFile.empty ())
+    {
+      return;
+    }
+  std::ifstream in (m_tableFile.c_str ());
+  if (!in.good ())
+    {
+      NS_LOG_INFO ("table file " << m_tableFile << " not found, computing the tables");
+      return;
+    }
+  in.close ();
+  ReadTables (m_tableFile);
+}
+
+void
+TabulatedErrorRateModel::Load (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  m_tableFileLoaded = true;
+  ReadTables (fileName);
+}
+
+void
+TabulatedErrorRateModel::ReadTables (std::string fileName) const
+{
+  std::ifstream in (fileName.c_str (), std::ios::binary);
+  if (!in.good ())
+    {
+      NS_FATAL_ERROR ("Cannot open error rate table file " << fileName);
+    }
+  TableFileHeader header;
+  in.read (reinterpret_cast<char *> (&header), sizeof (header));
+  if (!in.good () || std::memcmp (header.magic, TABLE_FILE_MAGIC, sizeof (TABLE_FILE_MAGIC)) != 0
+      || header.version != 1)
+    {
+      NS_FATAL_ERROR ("Error rate table file " << fileName << " has an unsupported format");
+    }
+  std::string model (header.modelLength, ' ');
+  in.read (&model[0], header.modelLength);
+  if (model != m_errorRateModel->GetInstanceTypeId ().GetName ())
+    {
+      NS_FATAL_ERROR ("Error rate table file " << fileName << " tabulates " << model
+                      << ", expected " << m_errorRateModel->GetInstanceTypeId ().GetName ());
+    }
+  uint32_t nPoints = GetNPoints ();
+  if (header.nPoints != nPoints || header.minSnr != m_minSnr
+      || header.maxSnr != m_maxSnr || header.snrStep != m_snrStep)
+    {
+      NS_FATAL_ERROR ("Error rate table file " << fileName << " has an SNR grid from "
+                      << header.minSnr << " to " << header.maxSnr << " dB by " << header.snrStep
+                      << " dB, expected " << m_minSnr << " to " << m_maxSnr << " dB by "
+                      << m_snrStep << " dB");
+    }
+  for (uint32_t t = 0; t < header.nTables; t++)
+    {
+      TableRecordHeader record;
+      in.read (reinterpret_cast<char *> (&record), sizeof (record));
+      std::string modeName (record.modeLength, ' ');
+      in.read (&modeName[0], record.modeLength);
+      Table table (nPoints);
+      in.read (reinterpret_cast<char *> (&table[0]), nPoints * sizeof (double));
+      if (!in.good ())
+        {
+          NS_FATAL_ERROR ("Error rate table file " << fileName << " is truncated");
+        }
+      TableKey key;
+      key.mode = WifiMode (modeName);
+      key.channelWidth = record.channelWidth;
+      key.guardInterval = record.guardInterval;
+      key.nss = record.nss;
+      m_tables[key] = table;
+    }
+  m_lastTable = 0;
+  NS_LOG_DEBUG ("loaded " << header.nTables << " tables from " << fileName);
+}
+
+void
+TabulatedErrorRateModel::Save (std::string fileName) const
+{
+  NS_LOG_FUNCTION (this << fileName);
+  std::ofstream out (fileName.c_str (), std::ios::binary);
+  if (!out.good ())
+    {
+      NS_FATAL_ERROR ("Cannot open error rate table file " << fileName);
+    }
+  std::string model = m_errorRateModel->GetInstanceTypeId ().GetName ();
+  TableFileHeader header;
+  std::memset (&header, 0, sizeof (header));
+  std::memcpy (header.magic, TABLE_FILE_MAGIC, sizeof (TABLE_FILE_MAGIC));
+  header.version = 1;
+  header.nPoints = GetNPoints ();
+  header.minSnr = m_minSnr;
+  header.maxSnr = m_maxSnr;
+  header.snrStep = m_snrStep;
+  header.nTables = m_tables.size ();
+  header.modelLength = model.size ();
+  out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  out.write (model.data (), model.size ());
+  for (std::map<TableKey, Table>::const_iterator it = m_tables.begin (); it != m_tables.end (); ++it)
+    {
+      std::string modeName = it->first.mode.GetUniqueName ();
+      TableRecordHeader record;
+      std::memset (&record, 0, sizeof (record));
+      record.channelWidth = it->first.channelWidth;
+      record.guardInterval = it->first.guardInterval;
+      record.nss = it->first.nss;
+      record.modeLength = modeName.size ();
+      out.write (reinterpret_cast<const char *> (&record), sizeof (record));
+      out.write (modeName.data (), modeName.size ());
+      out.write (reinterpret_cast<const char *> (&it->second[0]), it->second.size () * sizeof (double));
+    }
+  if (!out.good ())
+    {
+      NS_FATAL_ERROR ("Cannot write error rate table file " << fileName);
+    }
+}
+
+} //namespace ns3
@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TABULATED_ERROR_RATE_MODEL_H
+#define TABULATED_ERROR_RATE_MODEL_H
+
+#include <map>
+#include <vector>
+#include "error-rate-model.h"
+#include "wifi-mode.h"
+#include "wifi-tx-vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * An error rate model which tabulates the chunk success rate of another
+ * error rate model (the NistErrorRateModel by default) and interpolates
+ * it, instead of evaluating the BER expressions of that model for every
+ * chunk of every received frame.
+ *
+ * The wrapped model is assumed to treat the bits of a chunk as
+ * independent, i.e., the success rate of a chunk of n bits is the success
+ * rate of a single bit raised to the power n, which is the case of the
+ * NistErrorRateModel, the YansErrorRateModel and the DsssErrorRateModel.
+ * The success rate of a single bit is therefore evaluated, the first time
+ * a combination of WifiMode, channel width, guard interval and number of
+ * spatial streams is used, on an SNR grid spanning [MinSnr, MaxSnr] with
+ * a step of SnrStep dB.  Between the points of the grid, the logarithm
+ * of the bit error rate is interpolated linearly in dB, which follows the
+ * waterfall of the curves much more closely than a linear interpolation
+ * of the error rate.  SNRs outside of the grid, and SNRs of an interval
+ * of the grid where the success rate of a bit reaches 0 or 1, are passed
+ * to the wrapped model.
+ *
+ * The tables can be saved to a binary file with Save, and the file named
+ * by the TableFile attribute is loaded when the model is first used, so
+ * that simulation campaigns do not recompute them in every run.  The
+ * attributes must be set before the model is first used.
+ */
+class TabulatedErrorRateModel : public ErrorRateModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TabulatedErrorRateModel ();
+  virtual ~TabulatedErrorRateModel ();
+
+  double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+  /**
+   * Tabulate the success rate of the given mode and transmission
+   * parameters, unless it is already tabulated.
+   *
+   * \param mode the Wi-Fi mode
+   * \param txVector the TXVECTOR providing the channel width, the guard
+   *        interval and the number of spatial streams
+   */
+  void Tabulate (WifiMode mode, WifiTxVector txVector) const;
+  /**
+   * Load the tables saved in a file by Save.  The file must have been
+   * generated with the same SNR grid and the same wrapped error rate model.
+   *
+   * \param fileName the name of the file
+   */
+  void Load (std::string fileName);
+  /**
+   * Save all the tables computed or loaded so far in a binary file.
+   *
+   * \param fileName the name of the file
+   */
+  void Save (std::string fileName) const;
+  /**
+   * \return the error rate model whose success rate is tabulated
+   */
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+
+
+private:
+  /// The parameters of a transmission which a table applies to
+  struct TableKey
+  {
+    WifiMode mode;          ///< the Wi-Fi mode
+    uint16_t channelWidth;  ///< the channel width in MHz
+    uint16_t guardInterval; ///< the guard interval in nanoseconds
+    uint8_t nss;            ///< the number of spatial streams
+
+    /**
+     * \param other the key to compare with
+     * \return true if this key is ordered before the other key
+     */
+    bool operator < (const TableKey &other) const;
+    /**
+     * \param other the key to compare with
+     * \return true if both keys are equal
+     */
+    bool operator == (const TableKey &other) const;
+  };
+
+  /**
+   * Tabulated success rate of a single bit.  Each entry holds
+   * ln (-ln (p)), where p is the success rate of a bit at the
+   * corresponding SNR of the grid: infinite values stand for p == 0
+   * (+inf) and p == 1 (-inf).
+   */
+  typedef std::vector<double> Table;
+
+  /**
+   * \param mode the Wi-Fi mode
+   * \param txVector the TXVECTOR of the transmission
+   * \return the key of the table of this transmission
+   */
+  static TableKey GetKey (WifiMode mode, WifiTxVector txVector);
+  /**
+   * \param successRate the success rate of a bit
+   * \return the value stored in a table for this success rate
+   */
+  static double ToTableValue (double successRate);
+  /**
+   * \param value a value stored in a table
+   * \return the success rate of a bit corresponding to this value
+   */
+  static double FromTableValue (double value);
+  /**
+   * \param mode the Wi-Fi mode
+   * \param txVector the TXVECTOR of the transmission
+   * \return the table of this transmission, computed if needed
+   */
+  const Table & GetTable (WifiMode mode, WifiTxVector txVector) const;
+  /**
+   * Load the TableFile if it is set and exists, the first time this
+   * method is called.
+   */
+  void LoadTableFile (void) const;
+  /**
+   * Read the tables saved in a file, replacing the tables of the same
+   * transmission parameters.
+   *
+   * \param fileName the name of the file
+   */
+  void ReadTables (std::string fileName) const;
+  /**
+   * \return the number of points of the SNR grid
+   */
+  uint32_t GetNPoints (void) const;
+
+  Ptr<ErrorRateModel> m_errorRateModel; ///< the error rate model to tabulate
+  double m_minSnr;                      ///< the lowest SNR of the grid in dB
+  double m_maxSnr;                      ///< the highest SNR of the grid in dB
+  double m_snrStep;                     ///< the step of the grid in dB
+  std::string m_tableFile;              ///< the file from which the tables are loaded
+
+  mutable bool m_tableFileLoaded;              ///< whether TableFile was looked up
+  mutable std::map<TableKey, Table> m_tables;  ///< the tables computed or loaded so far
+  mutable TableKey m_lastKey;                  ///< the key of the last table used
+  mutable const Table *m_lastTable;            ///< the last table used
+};
+
+} //namespace ns3
+
+#endif /* TABULATED_ERROR_RATE_MODEL_H */
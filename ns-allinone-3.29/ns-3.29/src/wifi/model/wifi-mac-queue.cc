@@ -31,6 +31,11 @@ NS_LOG_COMPONENT_DEFINE ("WifiMacQueue");
 
 NS_OBJECT_ENSURE_REGISTERED (WifiMacQueue);
 
+/// The TID under which the non-QoS data frames are indexed
+static const uint8_t NON_QOS_DATA_KEY = 16;
+/// The TID under which the frames other than data frames are indexed
+static const uint8_t OTHER_FRAME_KEY = 17;
+
 TypeId
 WifiMacQueue::GetTypeId (void)
 {
@@ -52,7 +57,9 @@ WifiMacQueue::GetTypeId (void)
 }
 
 WifiMacQueue::WifiMacQueue ()
-  : NS_LOG_TEMPLATE_DEFINE ("WifiMacQueue")
+  : m_frontPosition (0),
+    m_backPosition (0),
+    NS_LOG_TEMPLATE_DEFINE ("WifiMacQueue")
 {
 }
 
@@ -74,20 +81,136 @@ WifiMacQueue::GetMaxDelay (void) const
   return m_maxDelay;
 }
 
+WifiMacQueue::IndexKey
+WifiMacQueue::GetIndexKey (Ptr<const WifiMacQueueItem> item)
+{
+  const WifiMacHeader &hdr = item->GetHeader ();
+  if (hdr.IsQosData ())
+    {
+      return IndexKey (hdr.GetAddr1 (), hdr.GetQosTid ());
+    }
+  // TIDs are 4-bit values: the keys of the other frames follow the keys of
+  // the QoS data frames, so that the data frames of a receiver are contiguous
+  return IndexKey (hdr.GetAddr1 (), hdr.IsData () ? NON_QOS_DATA_KEY : OTHER_FRAME_KEY);
+}
+
 bool
-WifiMacQueue::TtlExceeded (ConstIterator &it)
+WifiMacQueue::DoEnqueueAndIndex (ConstIterator pos, Ptr<WifiMacQueueItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+  NS_ASSERT (pos == Head () || pos == Tail ());
+  bool front = (pos == Head ());
+
+  if (!DoEnqueue (pos, item))
+    {
+      return false;
+    }
+
+  ConstIterator it = (front ? Head () : std::prev (Tail ()));
+  int64_t position = (front ? --m_frontPosition : m_backPosition++);
+  IndexKey key = GetIndexKey (item);
+  std::list<IndexEntry> &entries = m_index[key];
+
+  if (front)
+    {
+      // the item becomes the first item of its key
+      if (!entries.empty ())
+        {
+          m_heads.erase (std::make_pair (entries.front ().first, key));
+        }
+      entries.push_front (IndexEntry (position, it));
+      m_heads.insert (std::make_pair (position, key));
+    }
+  else
+    {
+      if (entries.empty ())
+        {
+          m_heads.insert (std::make_pair (position, key));
+        }
+      entries.push_back (IndexEntry (position, it));
+    }
+  m_expiry.insert (std::make_pair (std::make_pair (item->GetTimeStamp (), position), it));
+  return true;
+}
+
+void
+WifiMacQueue::Unindex (ConstIterator it)
 {
   NS_LOG_FUNCTION (this);
+  IndexKey key = GetIndexKey (*it);
+  auto indexIt = m_index.find (key);
+  NS_ASSERT (indexIt != m_index.end ());
+  std::list<IndexEntry> &entries = indexIt->second;
+
+  // items are mostly removed from the front of their key, hence the
+  // linear search is expected to end at the first entry
+  auto entryIt = entries.begin ();
+  while (entryIt != entries.end () && entryIt->second != it)
+    {
+      entryIt++;
+    }
+  NS_ASSERT (entryIt != entries.end ());
+  int64_t position = entryIt->first;
 
-  if (Simulator::Now () > (*it)->GetTimeStamp () + m_maxDelay)
+  if (entryIt == entries.begin ())
+    {
+      m_heads.erase (std::make_pair (position, key));
+      entries.pop_front ();
+      if (entries.empty ())
+        {
+          m_index.erase (indexIt);
+        }
+      else
+        {
+          m_heads.insert (std::make_pair (entries.front ().first, key));
+        }
+    }
+  else
     {
+      entries.erase (entryIt);
+    }
+  m_expiry.erase (std::make_pair ((*it)->GetTimeStamp (), position));
+}
+
+void
+WifiMacQueue::RemoveExpired (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_expiry.empty ()
+         && Simulator::Now () > m_expiry.begin ()->first.first + m_maxDelay)
+    {
+      ConstIterator it = m_expiry.begin ()->second;
       NS_LOG_DEBUG ("Removing packet that stayed in the queue for too long (" <<
                     Simulator::Now () - (*it)->GetTimeStamp () << ")");
-      auto curr = it++;
-      DoRemove (curr);
-      return true;
+      Unindex (it);
+      DoRemove (it);
     }
-  return false;
+}
+
+WifiMacQueue::ConstIterator
+WifiMacQueue::FindFirst (const IndexKey &key) const
+{
+  auto indexIt = m_index.find (key);
+  if (indexIt == m_index.end ())
+    {
+      return Tail ();
+    }
+  return indexIt->second.front ().second;
+}
+
+WifiMacQueue::ConstIterator
+WifiMacQueue::FindFirstAvailable (const Ptr<QosBlockedDestinations> blockedPackets) const
+{
+  // visit the keys in the order of their first item in the queue
+  for (auto &head : m_heads)
+    {
+      const IndexKey &key = head.second;
+      if (key.second >= NON_QOS_DATA_KEY || !blockedPackets->IsBlocked (key.first, key.second))
+        {
+          return FindFirst (key);
+        }
+    }
+  return Tail ();
 }
 
 bool
@@ -97,24 +220,21 @@ WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
   NS_ASSERT_MSG (GetMaxSize ().GetUnit () == QueueSizeUnit::PACKETS,
                  "WifiMacQueues must be in packet mode");
 
-  // if the queue is full, remove the first stale packet (if any) encountered
-  // starting from the head of the queue, in order to make room for the new packet.
+  // if the queue is full, remove the stale packets (if any) in order to make
+  // room for the new packet.
   if (QueueBase::GetNPackets () == GetMaxSize ().GetValue ())
     {
-      auto it = Head ();
-      while (it != Tail () && !TtlExceeded (it))
-        {
-          it++;
-        }
+      RemoveExpired ();
     }
 
   if (QueueBase::GetNPackets () == GetMaxSize ().GetValue () && m_dropPolicy == DROP_OLDEST)
     {
       NS_LOG_DEBUG ("Remove the oldest item in the queue");
+      Unindex (Head ());
       DoRemove (Head ());
     }
 
-  return DoEnqueue (Tail (), item);
+  return DoEnqueueAndIndex (Tail (), item);
 }
 
 bool
@@ -124,36 +244,32 @@ WifiMacQueue::PushFront (Ptr<WifiMacQueueItem> item)
   NS_ASSERT_MSG (GetMaxSize ().GetUnit () == QueueSizeUnit::PACKETS,
                  "WifiMacQueues must be in packet mode");
 
-  // if the queue is full, remove the first stale packet (if any) encountered
-  // starting from the head of the queue, in order to make room for the new packet.
+  // if the queue is full, remove the stale packets (if any) in order to make
+  // room for the new packet.
   if (QueueBase::GetNPackets () == GetMaxSize ().GetValue ())
     {
-      auto it = Head ();
-      while (it != Tail () && !TtlExceeded (it))
-        {
-          it++;
-        }
+      RemoveExpired ();
     }
 
   if (QueueBase::GetNPackets () == GetMaxSize ().GetValue () && m_dropPolicy == DROP_OLDEST)
     {
       NS_LOG_DEBUG ("Remove the oldest item in the queue");
+      Unindex (Head ());
       DoRemove (Head ());
     }
 
-  return DoEnqueue (Head (), item);
+  return DoEnqueueAndIndex (Head (), item);
 }
 
 Ptr<WifiMacQueueItem>
 WifiMacQueue::Dequeue (void)
 {
   NS_LOG_FUNCTION (this);
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+  if (Head () != Tail ())
     {
-      if (!TtlExceeded (it))
-        {
-          return DoDequeue (it);
-        }
+      Unindex (Head ());
+      return DoDequeue (Head ());
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -163,19 +279,28 @@ Ptr<WifiMacQueueItem>
 WifiMacQueue::DequeueByAddress (Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+
+  // the first data frame is the first item of the keys from (dest, 0)
+  // to (dest, NON_QOS_DATA_KEY)
+  int64_t first = m_backPosition;
+  ConstIterator it = Tail ();
+  for (auto indexIt = m_index.lower_bound (IndexKey (dest, 0));
+       indexIt != m_index.end () && indexIt->first.first == dest
+       && indexIt->first.second <= NON_QOS_DATA_KEY; indexIt++)
     {
-      if (!TtlExceeded (it))
+      if (indexIt->second.front ().first < first)
         {
-          if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
-            {
-              return DoDequeue (it);
-            }
-
-          it++;
+          first = indexIt->second.front ().first;
+          it = indexIt->second.front ().second;
         }
     }
+
+  if (it != Tail ())
+    {
+      Unindex (it);
+      return DoDequeue (it);
+    }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
 }
@@ -184,18 +309,12 @@ Ptr<WifiMacQueueItem>
 WifiMacQueue::DequeueByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+  ConstIterator it = FindFirst (IndexKey (dest, tid));
+  if (it != Tail ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoDequeue (it);
-            }
-
-          it++;
-        }
+      Unindex (it);
+      return DoDequeue (it);
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -205,18 +324,12 @@ Ptr<WifiMacQueueItem>
 WifiMacQueue::DequeueFirstAvailable (const Ptr<QosBlockedDestinations> blockedPackets)
 {
   NS_LOG_FUNCTION (this);
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+  ConstIterator it = FindFirstAvailable (blockedPackets);
+  if (it != Tail ())
     {
-      if (!TtlExceeded (it))
-        {
-          if (!(*it)->GetHeader ().IsQosData ()
-              || !blockedPackets->IsBlocked ((*it)->GetHeader ().GetAddr1 (), (*it)->GetHeader ().GetQosTid ()))
-            {
-              return DoDequeue (it);
-            }
-
-          it++;
-        }
+      Unindex (it);
+      return DoDequeue (it);
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -243,18 +356,11 @@ Ptr<const WifiMacQueueItem>
 WifiMacQueue::PeekByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+  ConstIterator it = FindFirst (IndexKey (dest, tid));
+  if (it != Tail ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoPeek (it);
-            }
-
-          it++;
-        }
+      return DoPeek (it);
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -264,18 +370,11 @@ Ptr<const WifiMacQueueItem>
 WifiMacQueue::PeekFirstAvailable (const Ptr<QosBlockedDestinations> blockedPackets)
 {
   NS_LOG_FUNCTION (this);
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+  ConstIterator it = FindFirstAvailable (blockedPackets);
+  if (it != Tail ())
     {
-      if (!TtlExceeded (it))
-        {
-          if (!(*it)->GetHeader ().IsQosData ()
-              || !blockedPackets->IsBlocked ((*it)->GetHeader ().GetAddr1 (), (*it)->GetHeader ().GetQosTid ()))
-            {
-              return DoPeek (it);
-            }
-
-          it++;
-        }
+      return DoPeek (it);
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -285,13 +384,11 @@ Ptr<WifiMacQueueItem>
 WifiMacQueue::Remove (void)
 {
   NS_LOG_FUNCTION (this);
-
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+  if (Head () != Tail ())
     {
-      if (!TtlExceeded (it))
-        {
-          return DoRemove (it);
-        }
+      Unindex (Head ());
+      return DoRemove (Head ());
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -301,17 +398,14 @@ bool
 WifiMacQueue::Remove (Ptr<const Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet);
-  for (auto it = Head (); it != Tail (); )
+  RemoveExpired ();
+  for (auto it = Head (); it != Tail (); it++)
     {
-      if (!TtlExceeded (it))
+      if ((*it)->GetPacket () == packet)
         {
-          if ((*it)->GetPacket () == packet)
-            {
-              DoRemove (it);
-              return true;
-            }
-
-          it++;
+          Unindex (it);
+          DoRemove (it);
+          return true;
         }
     }
   NS_LOG_DEBUG ("Packet " << packet << " not found in the queue");
@@ -322,20 +416,14 @@ uint32_t
 WifiMacQueue::GetNPacketsByAddress (Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
+  RemoveExpired ();
 
   uint32_t nPackets = 0;
-
-  for (auto it = Head (); it != Tail (); )
+  for (auto indexIt = m_index.lower_bound (IndexKey (dest, 0));
+       indexIt != m_index.end () && indexIt->first.first == dest
+       && indexIt->first.second <= NON_QOS_DATA_KEY; indexIt++)
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
-            {
-              nPackets++;
-            }
-
-          it++;
-        }
+      nPackets += indexIt->second.size ();
     }
   NS_LOG_DEBUG ("returns " << nPackets);
   return nPackets;
@@ -345,19 +433,13 @@ uint32_t
 WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
+  RemoveExpired ();
+
   uint32_t nPackets = 0;
-  for (auto it = Head (); it != Tail (); )
+  auto indexIt = m_index.find (IndexKey (dest, tid));
+  if (indexIt != m_index.end ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              nPackets++;
-            }
-
-          it++;
-        }
+      nPackets = indexIt->second.size ();
     }
   NS_LOG_DEBUG ("returns " << nPackets);
   return nPackets;
@@ -367,16 +449,10 @@ bool
 WifiMacQueue::IsEmpty (void)
 {
   NS_LOG_FUNCTION (this);
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          NS_LOG_DEBUG ("returns false");
-          return false;
-        }
-    }
-  NS_LOG_DEBUG ("returns true");
-  return true;
+  RemoveExpired ();
+  bool empty = QueueBase::IsEmpty ();
+  NS_LOG_DEBUG ("returns " << empty);
+  return empty;
 }
 
 uint32_t
@@ -384,13 +460,7 @@ WifiMacQueue::GetNPackets (void)
 {
   NS_LOG_FUNCTION (this);
   // remove packets that stayed in the queue for too long
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  RemoveExpired ();
   return QueueBase::GetNPackets ();
 }
 
@@ -399,13 +469,7 @@ WifiMacQueue::GetNBytes (void)
 {
   NS_LOG_FUNCTION (this);
   // remove packets that stayed in the queue for too long
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  RemoveExpired ();
   return QueueBase::GetNBytes ();
 }
 
@@ -24,6 +24,9 @@
 #ifndef WIFI_MAC_QUEUE_H
 #define WIFI_MAC_QUEUE_H
 
+#include <list>
+#include <map>
+#include <set>
 #include "wifi-mac-queue-item.h"
 
 namespace ns3 {
@@ -44,6 +47,12 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * Besides the FIFO list of the base class, the queue keeps the items
+ * of each receiver and TID in FIFO order, the heads of these lists sorted
+ * by their position in the queue and the items sorted by timestamp, so
+ * that the lookups by receiver and TID and the removal of the stale
+ * packets do not scan the whole queue.
  */
 class WifiMacQueue : public Queue<WifiMacQueueItem>
 {
@@ -220,18 +229,61 @@ public:
 
 private:
   /**
-   * Remove the item pointed to by the iterator <i>it</i> if it has been in the
-   * queue for too long. If the item is removed, the iterator is updated to
-   * point to the item that followed the erased one.
+   * The receiver address and the TID of a QoS data frame.  The other frames
+   * use a TID which QoS data frames cannot have (see GetIndexKey).
+   */
+  typedef std::pair<Mac48Address, uint8_t> IndexKey;
+  /// The position of an item in the queue and an iterator pointing to it
+  typedef std::pair<int64_t, ConstIterator> IndexEntry;
+
+  /**
+   * \param item the Wifi MAC queue item
+   * \return the key under which the item is indexed
+   */
+  static IndexKey GetIndexKey (Ptr<const WifiMacQueueItem> item);
+  /**
+   * Enqueue the given item before the item pointed to by <i>pos</i>, which
+   * must be either the head or the tail of the queue, and index it.
+   *
+   * \param pos the position before which the item is enqueued
+   * \param item the Wifi MAC queue item
+   * \return true if success, false if the packet has been dropped
+   */
+  bool DoEnqueueAndIndex (ConstIterator pos, Ptr<WifiMacQueueItem> item);
+  /**
+   * Remove the item pointed to by the iterator <i>it</i> from the indexes.
+   * This method must be called before the item is removed from the queue.
    *
    * \param it an iterator pointing to the item
-   * \return true if the item is removed, false otherwise
    */
-  bool TtlExceeded (ConstIterator &it);
+  void Unindex (ConstIterator it);
+  /**
+   * Remove all the items that have been in the queue for too long.
+   */
+  void RemoveExpired (void);
+  /**
+   * \param key the index key
+   * \return an iterator pointing to the first item having the given key,
+   *         or the tail of the queue if there is no such item
+   */
+  ConstIterator FindFirst (const IndexKey &key) const;
+  /**
+   * \param blockedPackets the blocked receivers and TIDs
+   * \return an iterator pointing to the first item which is not a QoS data
+   *         frame of a blocked receiver and TID, or the tail of the queue if
+   *         there is no such item
+   */
+  ConstIterator FindFirstAvailable (const Ptr<QosBlockedDestinations> blockedPackets) const;
 
   Time m_maxDelay;                          //!< Time to live for packets in the queue
   DropPolicy m_dropPolicy;                  //!< Drop behavior of queue
 
+  std::map<IndexKey, std::list<IndexEntry> > m_index;  //!< the items of each key in FIFO order
+  std::set<std::pair<int64_t, IndexKey> > m_heads;     //!< the position of the first item of each key
+  std::map<std::pair<Time, int64_t>, ConstIterator> m_expiry;  //!< the items sorted by timestamp
+  int64_t m_frontPosition;                  //!< the position of the last item pushed to the front
+  int64_t m_backPosition;                   //!< the position of the next item enqueued at the end
+
   NS_LOG_TEMPLATE_DECLARE;                  //!< redefinition of the log component
 };
 
@@ -2537,6 +2537,22 @@ WifiPhy::StartReceivePacket (Ptr<Packet> packet,
     }
 }
 
+void
+WifiPhy::ScheduleEndOfPlcpHeader (Ptr<Packet> packet, WifiTxVector txVector, MpduType mpdutype, Ptr<Event> event)
+{
+  NS_LOG_FUNCTION (this << packet << txVector << +mpdutype);
+  NS_ASSERT (m_endPlcpRxEvent.IsExpired ());
+  Time preambleAndHeaderDuration = CalculatePlcpPreambleAndHeaderDuration (txVector);
+  m_endPlcpRxEvent = Simulator::Schedule (preambleAndHeaderDuration, &WifiPhy::StartReceivePacket, this,
+                                          packet, txVector, mpdutype, event);
+}
+
+InterferenceHelper::SnrPer
+WifiPhy::CalculatePlcpPayloadSnrPer (Ptr<Packet> packet, Ptr<Event> event)
+{
+  return m_interference.CalculatePlcpPayloadSnrPer (event);
+}
+
 void
 WifiPhy::EndReceive (Ptr<Packet> packet, WifiPreamble preamble, MpduType mpdutype, Ptr<Event> event)
 {
@@ -2545,7 +2561,7 @@ WifiPhy::EndReceive (Ptr<Packet> packet, WifiPreamble preamble, MpduType mpdutyp
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
 
   InterferenceHelper::SnrPer snrPer;
-  snrPer = m_interference.CalculatePlcpPayloadSnrPer (event);
+  snrPer = CalculatePlcpPayloadSnrPer (packet, event);
   m_interference.NotifyRxEnd ();
   m_currentEvent = 0;
 
@@ -3666,14 +3682,11 @@ WifiPhy::StartRx (Ptr<Packet> packet, WifiTxVector txVector, MpduType mpdutype,
       m_state->SwitchToRx (rxDuration);
       NS_ASSERT (m_endPlcpRxEvent.IsExpired ());
       NotifyRxBegin (packet);
-      m_interference.NotifyRxStart ();
+      m_interference.NotifyRxStart (event);
 
       if (preamble != WIFI_PREAMBLE_NONE)
         {
-          NS_ASSERT (m_endPlcpRxEvent.IsExpired ());
-          Time preambleAndHeaderDuration = CalculatePlcpPreambleAndHeaderDuration (txVector);
-          m_endPlcpRxEvent = Simulator::Schedule (preambleAndHeaderDuration, &WifiPhy::StartReceivePacket, this,
-                                                  packet, txVector, mpdutype, event);
+          ScheduleEndOfPlcpHeader (packet, txVector, mpdutype, event);
         }
 
       NS_ASSERT (m_endRxEvent.IsExpired ());
@@ -1495,6 +1495,32 @@ protected:
    */
   void SwitchMaybeToCcaBusy (void);
 
+  /**
+   * Schedule the end of the reception of the PLCP preamble and header of a
+   * frame the PHY has synchronized on.  The default implementation schedules
+   * StartReceivePacket at the end of the PLCP header.
+   *
+   * \param packet the arriving packet
+   * \param txVector the TXVECTOR of the arriving packet
+   * \param mpdutype the type of the MPDU as defined in WifiPhy::MpduType.
+   * \param event the corresponding event of the first time the packet arrives
+   */
+  virtual void ScheduleEndOfPlcpHeader (Ptr<Packet> packet,
+                                        WifiTxVector txVector,
+                                        MpduType mpdutype,
+                                        Ptr<Event> event);
+  /**
+   * Calculate the SNR and the PER of the PLCP payload of a frame whose last
+   * bit has arrived.  The default implementation asks the InterferenceHelper
+   * for the PER of each chunk of the payload.
+   *
+   * \param packet the packet that the last bit has arrived
+   * \param event the corresponding event of the first time the packet arrives
+   *
+   * \return struct of SNR and PER
+   */
+  virtual InterferenceHelper::SnrPer CalculatePlcpPayloadSnrPer (Ptr<Packet> packet, Ptr<Event> event);
+
   InterferenceHelper m_interference;   //!< Pointer to InterferenceHelper
   Ptr<UniformRandomVariable> m_random; //!< Provides uniform random variables.
   Ptr<WifiPhyStateHelper> m_state;     //!< Pointer to WifiPhyStateHelper
@@ -0,0 +1,360 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/spectrum-wifi-phy.h"
+#include "ns3/l2sm-wifi-phy.h"
+#include "ns3/wifi-spectrum-value-helper.h"
+#include "ns3/wifi-spectrum-signal-parameters.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/tabulated-error-rate-model.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-mac-trailer.h"
+#include "ns3/wifi-phy-tag.h"
+#include "ns3/wifi-utils.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("L2smWifiPhyTest");
+
+static const uint8_t CHANNEL_NUMBER = 36;
+static const uint32_t FREQUENCY = 5180; // MHz
+static const uint16_t CHANNEL_WIDTH = 20; // MHz
+static const uint16_t GUARD_WIDTH = CHANNEL_WIDTH; // MHz
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief L2smWifiPhy validation against the SpectrumWifiPhy
+ *
+ * The same frames are injected into a SpectrumWifiPhy using the
+ * NistErrorRateModel and into an L2smWifiPhy using a TabulatedErrorRateModel
+ * of the NistErrorRateModel, at the in-band power computed by the
+ * SpectrumWifiPhy, over a range of receive powers spanning the waterfall
+ * of the mode, and the number of frames successfully received by both PHYs
+ * at each receive power are compared.
+ *
+ * Both PHYs draw from the same random stream and draw the same number of
+ * variables per frame, so that, without interference, where the PERs of
+ * both PHYs are equal but for the interpolation of the tables, they
+ * receive the same frames.  The interferer, when there is one, ends after
+ * the frame.  If it starts before the frame, it is an incomplete frame,
+ * which neither PHY synchronizes to; both PHYs then see the same SNIR over
+ * the whole frame.  If it starts during the frame, it is a complete frame,
+ * which both PHYs drop as they are receiving (an incomplete frame would
+ * abort the reception).  The SpectrumWifiPhy computes the success rate of
+ * each chunk, while the L2smWifiPhy only records the energy and the overlap
+ * of the interferer with the PLCP header and with the PLCP payload; with a
+ * single interferer, both amount to the same chunks.  The fraction of
+ * received frames may differ by at most 0.02 at each receive power.
+ */
+class L2smWifiPhyValidationTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param mode the mode of the frames
+   * \param preamble the preamble of the frames
+   * \param minRxPowerDbm the lowest receive power in dBm
+   * \param maxRxPowerDbm the highest receive power in dBm
+   * \param interferenceDb the power of the interferer relative to the frame
+   *        in dB, or 0 for no interferer
+   * \param interfererStart the start of the interferer relative to the
+   *        start of the frame
+   * \param tolerance the largest difference allowed between the fractions
+   *        of frames received by both PHYs at a given receive power
+   */
+  L2smWifiPhyValidationTest (WifiMode mode, WifiPreamble preamble,
+                             double minRxPowerDbm, double maxRxPowerDbm,
+                             double interferenceDb, Time interfererStart, double tolerance);
+  virtual ~L2smWifiPhyValidationTest ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+
+  /**
+   * \param frameComplete whether the PHYs may synchronize to the frame
+   * \return the frame to inject, carrying its WifiPhyTag
+   */
+  Ptr<Packet> MakeFrame (bool frameComplete) const;
+  /**
+   * \param txPowerW the transmit power in W
+   * \return the PSD of a frame transmitted with this power
+   */
+  Ptr<SpectrumValue> MakePsd (double txPowerW) const;
+  /**
+   * Inject a frame into both PHYs.
+   *
+   * \param txPowerW the transmit power in W
+   */
+  void SendFrame (double txPowerW);
+  /**
+   * Inject an interferer into both PHYs.
+   *
+   * \param txPowerW the transmit power in W
+   * \param duration the duration of the interferer
+   * \param frameComplete whether the PHYs may synchronize to the interferer
+   */
+  void SendInterferer (double txPowerW, Time duration, bool frameComplete);
+  /**
+   * Inject a signal into both PHYs.
+   *
+   * \param pkt the frame
+   * \param txPowerW the transmit power in W
+   * \param duration the duration of the signal
+   */
+  void SendSignal (Ptr<Packet> pkt, double txPowerW, Time duration);
+  /**
+   * \return the duration of the frames
+   */
+  Time GetFrameDuration (void) const;
+  /**
+   * Select the receive power whose successful receptions are counted.
+   *
+   * \param index the index of the receive power
+   */
+  void SetIndex (uint32_t index);
+  /**
+   * Receive success callback of the SpectrumWifiPhy
+   * \param p the packet
+   * \param snr the SNR
+   * \param txVector the TXVECTOR
+   */
+  void SpectrumRxSuccess (Ptr<Packet> p, double snr, WifiTxVector txVector);
+  /**
+   * Receive success callback of the L2smWifiPhy
+   * \param p the packet
+   * \param snr the SNR
+   * \param txVector the TXVECTOR
+   */
+  void L2smRxSuccess (Ptr<Packet> p, double snr, WifiTxVector txVector);
+
+  WifiMode m_mode;                      ///< the mode of the frames
+  WifiPreamble m_preamble;              ///< the preamble of the frames
+  double m_minRxPowerDbm;               ///< the lowest receive power in dBm
+  double m_maxRxPowerDbm;               ///< the highest receive power in dBm
+  double m_interferenceDb;              ///< the relative power of the interferer in dB
+  Time m_interfererStart;               ///< the start of the interferer relative to the frame
+  double m_tolerance;                   ///< the tolerance on the fraction of received frames
+  Ptr<SpectrumWifiPhy> m_spectrumPhy;   ///< the reference PHY
+  Ptr<L2smWifiPhy> m_l2smPhy;           ///< the PHY under test
+  uint32_t m_index;                     ///< the index of the current receive power
+  std::vector<uint32_t> m_spectrumCount; ///< the frames received by the SpectrumWifiPhy per receive power
+  std::vector<uint32_t> m_l2smCount;    ///< the frames received by the L2smWifiPhy per receive power
+};
+
+L2smWifiPhyValidationTest::L2smWifiPhyValidationTest (WifiMode mode, WifiPreamble preamble,
+                                                      double minRxPowerDbm, double maxRxPowerDbm,
+                                                      double interferenceDb, Time interfererStart, double tolerance)
+  : TestCase ("Check that the L2smWifiPhy receives the frames of mode " + mode.GetUniqueName ()
+              + (interferenceDb != 0 ? " with an interferer from " + std::to_string (interfererStart.GetMicroSeconds ()) + " us" : "")
+              + " like the SpectrumWifiPhy"),
+    m_mode (mode),
+    m_preamble (preamble),
+    m_minRxPowerDbm (minRxPowerDbm),
+    m_maxRxPowerDbm (maxRxPowerDbm),
+    m_interferenceDb (interferenceDb),
+    m_interfererStart (interfererStart),
+    m_tolerance (tolerance),
+    m_index (0)
+{
+}
+
+L2smWifiPhyValidationTest::~L2smWifiPhyValidationTest ()
+{
+}
+
+Ptr<Packet>
+L2smWifiPhyValidationTest::MakeFrame (bool frameComplete) const
+{
+  WifiTxVector txVector = WifiTxVector (m_mode, 0, m_preamble, 800, 1, 1, 0, CHANNEL_WIDTH, false, false);
+  Ptr<Packet> pkt = Create<Packet> (1000);
+  WifiMacHeader hdr;
+  WifiMacTrailer trailer;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  pkt->AddHeader (hdr);
+  pkt->AddTrailer (trailer);
+  WifiPhyTag tag (txVector, NORMAL_MPDU, frameComplete ? 1 : 0);
+  pkt->AddPacketTag (tag);
+  return pkt;
+}
+
+Ptr<SpectrumValue>
+L2smWifiPhyValidationTest::MakePsd (double txPowerW) const
+{
+  if (m_mode.GetModulationClass () == WIFI_MOD_CLASS_HT)
+    {
+      return WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (FREQUENCY, CHANNEL_WIDTH, txPowerW, GUARD_WIDTH);
+    }
+  return WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (FREQUENCY, CHANNEL_WIDTH, txPowerW, GUARD_WIDTH);
+}
+
+Time
+L2smWifiPhyValidationTest::GetFrameDuration (void) const
+{
+  WifiTxVector txVector = WifiTxVector (m_mode, 0, m_preamble, 800, 1, 1, 0, CHANNEL_WIDTH, false, false);
+  return m_spectrumPhy->CalculateTxDuration (MakeFrame (true)->GetSize (), txVector, FREQUENCY);
+}
+
+void
+L2smWifiPhyValidationTest::SendFrame (double txPowerW)
+{
+  SendSignal (MakeFrame (true), txPowerW, GetFrameDuration ());
+}
+
+void
+L2smWifiPhyValidationTest::SendInterferer (double txPowerW, Time duration, bool frameComplete)
+{
+  SendSignal (MakeFrame (frameComplete), txPowerW, duration);
+}
+
+void
+L2smWifiPhyValidationTest::SendSignal (Ptr<Packet> pkt, double txPowerW, Time duration)
+{
+  Ptr<SpectrumValue> psd = MakePsd (txPowerW);
+  Ptr<WifiSpectrumSignalParameters> txParams = Create<WifiSpectrumSignalParameters> ();
+  txParams->psd = psd;
+  txParams->txPhy = 0;
+  txParams->duration = duration;
+  txParams->packet = pkt;
+  m_spectrumPhy->StartRx (txParams);
+
+  //the same in-band power as the SpectrumWifiPhy
+  Ptr<const SpectrumValue> filter = WifiSpectrumValueHelper::GetRfFilter (FREQUENCY, CHANNEL_WIDTH, m_spectrumPhy->GetBandBandwidth (),
+                                                                          m_spectrumPhy->GetGuardBandwidth (CHANNEL_WIDTH));
+  double rxPowerW = Integral ((*filter) * (*psd));
+  m_l2smPhy->StartReceivePreambleAndHeader (pkt->Copy (), rxPowerW, duration);
+}
+
+void
+L2smWifiPhyValidationTest::SetIndex (uint32_t index)
+{
+  m_index = index;
+}
+
+void
+L2smWifiPhyValidationTest::SpectrumRxSuccess (Ptr<Packet> p, double snr, WifiTxVector txVector)
+{
+  NS_LOG_FUNCTION (this << p << snr << txVector);
+  m_spectrumCount[m_index]++;
+}
+
+void
+L2smWifiPhyValidationTest::L2smRxSuccess (Ptr<Packet> p, double snr, WifiTxVector txVector)
+{
+  NS_LOG_FUNCTION (this << p << snr << txVector);
+  m_l2smCount[m_index]++;
+}
+
+void
+L2smWifiPhyValidationTest::DoSetup (void)
+{
+  m_spectrumPhy = CreateObject<SpectrumWifiPhy> ();
+  m_spectrumPhy->ConfigureStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  m_spectrumPhy->SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  m_spectrumPhy->SetChannelNumber (CHANNEL_NUMBER);
+  m_spectrumPhy->SetFrequency (FREQUENCY);
+  m_spectrumPhy->SetReceiveOkCallback (MakeCallback (&L2smWifiPhyValidationTest::SpectrumRxSuccess, this));
+  m_spectrumPhy->AssignStreams (1);
+
+  m_l2smPhy = CreateObject<L2smWifiPhy> ();
+  m_l2smPhy->ConfigureStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  m_l2smPhy->SetErrorRateModel (CreateObject<TabulatedErrorRateModel> ());
+  m_l2smPhy->SetChannelNumber (CHANNEL_NUMBER);
+  m_l2smPhy->SetFrequency (FREQUENCY);
+  m_l2smPhy->SetReceiveOkCallback (MakeCallback (&L2smWifiPhyValidationTest::L2smRxSuccess, this));
+  m_l2smPhy->AssignStreams (1);
+}
+
+void
+L2smWifiPhyValidationTest::DoRun (void)
+{
+  const uint32_t nFrames = 200;
+  const double step = 1.0; // dB
+  uint32_t nPowers = static_cast<uint32_t> ((m_maxRxPowerDbm - m_minRxPowerDbm) / step) + 1;
+  m_spectrumCount.assign (nPowers, 0);
+  m_l2smCount.assign (nPowers, 0);
+
+  Time interfererDuration = GetFrameDuration () - m_interfererStart + MicroSeconds (20);
+  bool interfererComplete = m_interfererStart.IsStrictlyPositive ();
+  Time start = Seconds (0);
+  for (uint32_t i = 0; i < nPowers; i++)
+    {
+      double txPowerW = DbmToW (m_minRxPowerDbm + i * step);
+      Simulator::Schedule (start, &L2smWifiPhyValidationTest::SetIndex, this, i);
+      for (uint32_t j = 0; j < nFrames; j++)
+        {
+          Time t = start + MilliSeconds (5 * j) + MicroSeconds (1);
+          if (m_interferenceDb != 0)
+            {
+              //an interferer ending after the frame
+              Simulator::Schedule (t + MicroSeconds (10) + m_interfererStart, &L2smWifiPhyValidationTest::SendInterferer, this,
+                                   txPowerW * DbToRatio (m_interferenceDb), interfererDuration, interfererComplete);
+            }
+          Simulator::Schedule (t + MicroSeconds (10), &L2smWifiPhyValidationTest::SendFrame, this, txPowerW);
+        }
+      start += MilliSeconds (5 * nFrames);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  for (uint32_t i = 0; i < nPowers; i++)
+    {
+      NS_LOG_DEBUG ("rx power " << m_minRxPowerDbm + i * step << " dBm: SpectrumWifiPhy " << m_spectrumCount[i]
+                    << ", L2smWifiPhy " << m_l2smCount[i]);
+      double difference = (static_cast<double> (m_l2smCount[i]) - m_spectrumCount[i]) / nFrames;
+      NS_TEST_ASSERT_MSG_EQ_TOL (difference, 0, m_tolerance, "Unexpected fraction of received frames at "
+                                 << m_minRxPowerDbm + i * step << " dBm");
+    }
+  //the range of receive powers must span the waterfall of the mode
+  NS_TEST_ASSERT_MSG_EQ (m_spectrumCount.front (), 0, "Range of receive powers too high");
+  NS_TEST_ASSERT_MSG_GT (m_spectrumCount.back (), nFrames * 0.9, "Range of receive powers too low");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief L2smWifiPhy Test Suite
+ */
+class L2smWifiPhyTestSuite : public TestSuite
+{
+public:
+  L2smWifiPhyTestSuite ();
+};
+
+L2smWifiPhyTestSuite::L2smWifiPhyTestSuite ()
+  : TestSuite ("l2sm-wifi-phy", UNIT)
+{
+  AddTestCase (new L2smWifiPhyValidationTest (WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG, -96, -86, 0, Seconds (0), 0.02), TestCase::QUICK);
+  AddTestCase (new L2smWifiPhyValidationTest (WifiPhy::GetHtMcs4 (), WIFI_PREAMBLE_HT_MF, -85, -75, 0, Seconds (0), 0.02), TestCase::QUICK);
+  AddTestCase (new L2smWifiPhyValidationTest (WifiPhy::GetHtMcs7 (), WIFI_PREAMBLE_HT_MF, -78, -68, 0, Seconds (0), 0.02), TestCase::QUICK);
+  AddTestCase (new L2smWifiPhyValidationTest (WifiPhy::GetHtMcs1 (), WIFI_PREAMBLE_HT_MF, -95, -75, -8, MicroSeconds (-10), 0.02), TestCase::QUICK);
+  AddTestCase (new L2smWifiPhyValidationTest (WifiPhy::GetHtMcs4 (), WIFI_PREAMBLE_HT_MF, -85, -65, -17, MicroSeconds (-10), 0.02), TestCase::QUICK);
+  AddTestCase (new L2smWifiPhyValidationTest (WifiPhy::GetHtMcs1 (), WIFI_PREAMBLE_HT_MF, -95, -75, -8, MicroSeconds (24), 0.02), TestCase::QUICK);
+  AddTestCase (new L2smWifiPhyValidationTest (WifiPhy::GetHtMcs1 (), WIFI_PREAMBLE_HT_MF, -95, -75, -8, MicroSeconds (100), 0.02), TestCase::QUICK);
+  AddTestCase (new L2smWifiPhyValidationTest (WifiPhy::GetHtMcs4 (), WIFI_PREAMBLE_HT_MF, -85, -65, -17, MicroSeconds (100), 0.02), TestCase::QUICK);
+  AddTestCase (new L2smWifiPhyValidationTest (WifiPhy::GetHtMcs4 (), WIFI_PREAMBLE_HT_MF, -85, -65, -17, MicroSeconds (200), 0.02), TestCase::QUICK);
+}
+
+static L2smWifiPhyTestSuite l2smWifiPhyTestSuite; ///< the test suite
@@ -22,7 +22,12 @@
 #include "ns3/test.h"
 #include "ns3/nist-error-rate-model.h"
 #include "ns3/dsss-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/tabulated-error-rate-model.h"
+#include "ns3/wifi-phy.h"
 #include "ns3/wifi-tx-vector.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
 
 using namespace ns3;
 
@@ -291,6 +296,94 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models Test Case Tabulated
+ *
+ * Check that the TabulatedErrorRateModel follows the NIST and YANS models
+ * it tabulates, and that it returns the same success rates after its
+ * tables are saved and loaded again.
+ */
+class WifiErrorRateModelsTestCaseTabulated : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTabulated ();
+  virtual ~WifiErrorRateModelsTestCaseTabulated ();
+
+private:
+  virtual void DoRun (void);
+};
+
+WifiErrorRateModelsTestCaseTabulated::WifiErrorRateModelsTestCaseTabulated ()
+  : TestCase ("WifiErrorRateModel test case tabulated")
+{
+}
+
+WifiErrorRateModelsTestCaseTabulated::~WifiErrorRateModelsTestCaseTabulated ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTabulated::DoRun (void)
+{
+  uint64_t nbits = 2000 * 8;
+  std::vector<WifiTxVector> txVectors;
+  WifiTxVector txVector;
+  txVector.SetMode (WifiPhy::GetDsssRate1Mbps ());
+  txVectors.push_back (txVector);
+  txVector.SetMode (WifiPhy::GetDsssRate11Mbps ());
+  txVectors.push_back (txVector);
+  txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+  txVectors.push_back (txVector);
+  txVector.SetMode (WifiPhy::GetOfdmRate54Mbps ());
+  txVectors.push_back (txVector);
+  txVector.SetMode (WifiPhy::GetHtMcs7 ());
+  txVector.SetGuardInterval (400);
+  txVectors.push_back (txVector);
+  txVector.SetMode (WifiPhy::GetVhtMcs8 ());
+  txVector.SetChannelWidth (80);
+  txVector.SetNss (2);
+  txVectors.push_back (txVector);
+
+  std::vector<Ptr<ErrorRateModel> > models;
+  models.push_back (CreateObject<NistErrorRateModel> ());
+  models.push_back (CreateObject<YansErrorRateModel> ());
+  for (std::vector<Ptr<ErrorRateModel> >::const_iterator model = models.begin (); model != models.end (); ++model)
+    {
+      Ptr<TabulatedErrorRateModel> tabulated = CreateObject<TabulatedErrorRateModel> ();
+      tabulated->SetAttribute ("ErrorRateModel", PointerValue (*model));
+      for (std::vector<WifiTxVector>::const_iterator tx = txVectors.begin (); tx != txVectors.end (); ++tx)
+        {
+          for (double snrDb = -20.0; snrDb < 65.0; snrDb += 0.0371)
+            {
+              double snr = std::pow (10.0, snrDb / 10.0);
+              double expected = (*model)->GetChunkSuccessRate (tx->GetMode (), *tx, snr, nbits);
+              double ps = tabulated->GetChunkSuccessRate (tx->GetMode (), *tx, snr, nbits);
+              NS_TEST_ASSERT_MSG_EQ_TOL (ps, expected, 1e-3, "Wrong success rate of " << tx->GetMode ()
+                                         << " at " << snrDb << " dB with " << (*model)->GetInstanceTypeId ().GetName ());
+            }
+        }
+
+      std::string fileName = CreateTempDirFilename ("tabulated-error-rate-model.bin");
+      tabulated->Save (fileName);
+      Ptr<TabulatedErrorRateModel> loaded = CreateObject<TabulatedErrorRateModel> ();
+      loaded->SetAttribute ("ErrorRateModel", PointerValue (*model));
+      loaded->SetAttribute ("TableFile", StringValue (fileName));
+      for (std::vector<WifiTxVector>::const_iterator tx = txVectors.begin (); tx != txVectors.end (); ++tx)
+        {
+          for (double snrDb = -10.0; snrDb < 40.0; snrDb += 0.173)
+            {
+              double snr = std::pow (10.0, snrDb / 10.0);
+              NS_TEST_ASSERT_MSG_EQ (loaded->GetChunkSuccessRate (tx->GetMode (), *tx, snr, nbits),
+                                     tabulated->GetChunkSuccessRate (tx->GetMode (), *tx, snr, nbits),
+                                     "Wrong success rate of " << tx->GetMode () << " at " << snrDb << " dB after loading");
+            }
+        }
+    }
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -308,6 +401,7 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
 {
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTabulated, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite; ///< the test suite
@@ -21,6 +21,7 @@
  *          Sébastien Deronne <sebastien.deronne@gmail.com>
  */
 
+#include <algorithm>
 #include "ns3/string.h"
 #include "ns3/yans-wifi-helper.h"
 #include "ns3/mobility-helper.h"
@@ -43,6 +44,8 @@
 #include "ns3/wifi-phy-tag.h"
 #include "ns3/yans-wifi-phy.h"
 #include "ns3/mgt-headers.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/qos-blocked-destinations.h"
 
 using namespace ns3;
 
@@ -1690,6 +1693,241 @@ StaWifiMacScanningTestCase::DoRun (void)
   }
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi MAC queue index test
+ *
+ * A random sequence of operations is performed on a WifiMacQueue and on a
+ * reference list, which is scanned from the head to find the packets, and
+ * the packets returned by the queue are checked against the reference.
+ */
+class WifiMacQueueIndexTest : public TestCase
+{
+public:
+  WifiMacQueueIndexTest ();
+  virtual ~WifiMacQueueIndexTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Remove the stale packets from the reference list
+   */
+  void RemoveExpired (void);
+  /**
+   * \param item the Wifi MAC queue item
+   * \param tid the TID
+   * \param dest the receiver address
+   * \return true if the item is a QoS data frame having the given TID and receiver
+   */
+  static bool Matches (Ptr<const WifiMacQueueItem> item, uint8_t tid, Mac48Address dest);
+  /**
+   * \param item the Wifi MAC queue item
+   * \return true if the item is available for transmission
+   */
+  bool IsAvailable (Ptr<const WifiMacQueueItem> item) const;
+  /**
+   * Perform a random operation on the queue and on the reference list.
+   */
+  void DoOperation (void);
+
+  Ptr<WifiMacQueue> m_queue;                        ///< the queue under test
+  std::list<Ptr<WifiMacQueueItem> > m_reference;    ///< the reference list
+  std::vector<Ptr<WifiMacQueueItem> > m_dequeued;   ///< the items which can be pushed back
+  Ptr<QosBlockedDestinations> m_blocked;            ///< the blocked receivers and TIDs
+  Ptr<UniformRandomVariable> m_random;              ///< the random variable
+  Mac48Address m_addresses[3];                      ///< the receiver addresses
+  uint32_t m_maxSize;                               ///< the size of the queue
+  Time m_maxDelay;                                  ///< the lifetime of the packets
+};
+
+WifiMacQueueIndexTest::WifiMacQueueIndexTest ()
+  : TestCase ("Check the lookups of the Wifi MAC queue against a linear search"),
+    m_maxSize (20),
+    m_maxDelay (MilliSeconds (5))
+{
+  m_addresses[0] = Mac48Address ("00:00:00:00:00:01");
+  m_addresses[1] = Mac48Address ("00:00:00:00:00:02");
+  m_addresses[2] = Mac48Address ("00:00:00:00:00:03");
+}
+
+WifiMacQueueIndexTest::~WifiMacQueueIndexTest ()
+{
+}
+
+void
+WifiMacQueueIndexTest::RemoveExpired (void)
+{
+  for (auto it = m_reference.begin (); it != m_reference.end (); )
+    {
+      if (Simulator::Now () > (*it)->GetTimeStamp () + m_maxDelay)
+        {
+          it = m_reference.erase (it);
+        }
+      else
+        {
+          it++;
+        }
+    }
+}
+
+bool
+WifiMacQueueIndexTest::Matches (Ptr<const WifiMacQueueItem> item, uint8_t tid, Mac48Address dest)
+{
+  return item->GetHeader ().IsQosData () && item->GetDestinationAddress () == dest
+         && item->GetHeader ().GetQosTid () == tid;
+}
+
+bool
+WifiMacQueueIndexTest::IsAvailable (Ptr<const WifiMacQueueItem> item) const
+{
+  return !item->GetHeader ().IsQosData ()
+         || !m_blocked->IsBlocked (item->GetHeader ().GetAddr1 (), item->GetHeader ().GetQosTid ());
+}
+
+void
+WifiMacQueueIndexTest::DoOperation (void)
+{
+  RemoveExpired ();
+
+  Mac48Address dest = m_addresses[m_random->GetInteger (0, 2)];
+  uint8_t tid = static_cast<uint8_t> (m_random->GetInteger (0, 2));
+  auto found = m_reference.end ();
+
+  switch (m_random->GetInteger (0, 13))
+    {
+    case 0:
+    case 1:
+    case 2:
+    case 12:
+    case 13:
+      {
+        WifiMacHeader hdr;
+        uint32_t type = m_random->GetInteger (0, 4);
+        if (type < 3)
+          {
+            hdr.SetType (WIFI_MAC_QOSDATA);
+            hdr.SetQosTid (tid);
+          }
+        else
+          {
+            hdr.SetType (type == 3 ? WIFI_MAC_DATA : WIFI_MAC_MGT_ACTION);
+          }
+        hdr.SetAddr1 (dest);
+        Ptr<WifiMacQueueItem> item = Create<WifiMacQueueItem> (Create<Packet> (100), hdr);
+        bool enqueued = m_queue->Enqueue (item);
+        NS_TEST_EXPECT_MSG_EQ (enqueued, (m_reference.size () < m_maxSize), "Unexpected result of Enqueue");
+        if (enqueued)
+          {
+            m_reference.push_back (item);
+          }
+        break;
+      }
+    case 3:
+      if (!m_dequeued.empty ())
+        {
+          Ptr<WifiMacQueueItem> item = m_dequeued.back ();
+          m_dequeued.pop_back ();
+          bool enqueued = m_queue->PushFront (item);
+          NS_TEST_EXPECT_MSG_EQ (enqueued, (m_reference.size () < m_maxSize), "Unexpected result of PushFront");
+          if (enqueued)
+            {
+              m_reference.push_front (item);
+            }
+        }
+      break;
+    case 4:
+      found = m_reference.begin ();
+      NS_TEST_EXPECT_MSG_EQ (m_queue->Peek (), (found == m_reference.end () ? 0 : *found), "Unexpected result of Peek");
+      NS_TEST_EXPECT_MSG_EQ (m_queue->Dequeue (), (found == m_reference.end () ? 0 : *found), "Unexpected result of Dequeue");
+      break;
+    case 5:
+      found = std::find_if (m_reference.begin (), m_reference.end (),
+                            [dest] (Ptr<WifiMacQueueItem> item)
+                            { return item->GetHeader ().IsData () && item->GetDestinationAddress () == dest; });
+      NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByAddress (dest), (found == m_reference.end () ? 0 : *found),
+                             "Unexpected result of DequeueByAddress");
+      break;
+    case 6:
+      found = std::find_if (m_reference.begin (), m_reference.end (),
+                            [tid, dest] (Ptr<WifiMacQueueItem> item) { return Matches (item, tid, dest); });
+      NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (tid, dest), (found == m_reference.end () ? 0 : *found),
+                             "Unexpected result of PeekByTidAndAddress");
+      NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (tid, dest), (found == m_reference.end () ? 0 : *found),
+                             "Unexpected result of DequeueByTidAndAddress");
+      break;
+    case 7:
+      found = std::find_if (m_reference.begin (), m_reference.end (),
+                            [this] (Ptr<WifiMacQueueItem> item) { return IsAvailable (item); });
+      NS_TEST_EXPECT_MSG_EQ (m_queue->PeekFirstAvailable (m_blocked), (found == m_reference.end () ? 0 : *found),
+                             "Unexpected result of PeekFirstAvailable");
+      NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueFirstAvailable (m_blocked), (found == m_reference.end () ? 0 : *found),
+                             "Unexpected result of DequeueFirstAvailable");
+      break;
+    case 8:
+      if (!m_reference.empty ())
+        {
+          auto it = m_reference.begin ();
+          std::advance (it, m_random->GetInteger (0, m_reference.size () - 1));
+          NS_TEST_EXPECT_MSG_EQ (m_queue->Remove ((*it)->GetPacket ()), true, "Unexpected result of Remove");
+          m_reference.erase (it);
+        }
+      break;
+    case 9:
+      {
+        uint32_t n = std::count_if (m_reference.begin (), m_reference.end (),
+                                    [tid, dest] (Ptr<WifiMacQueueItem> item) { return Matches (item, tid, dest); });
+        NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (tid, dest), n,
+                               "Unexpected result of GetNPacketsByTidAndAddress");
+        n = std::count_if (m_reference.begin (), m_reference.end (),
+                           [dest] (Ptr<WifiMacQueueItem> item)
+                           { return item->GetHeader ().IsData () && item->GetDestinationAddress () == dest; });
+        NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByAddress (dest), n, "Unexpected result of GetNPacketsByAddress");
+        NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (), m_reference.size (), "Unexpected result of GetNPackets");
+        break;
+      }
+    case 10:
+      if (m_blocked->IsBlocked (dest, tid))
+        {
+          m_blocked->Unblock (dest, tid);
+        }
+      else
+        {
+          m_blocked->Block (dest, tid);
+        }
+      break;
+    default:
+      NS_TEST_EXPECT_MSG_EQ (m_queue->IsEmpty (), m_reference.empty (), "Unexpected result of IsEmpty");
+      break;
+    }
+
+  if (found != m_reference.end ())
+    {
+      m_dequeued.push_back (*found);
+      m_reference.erase (found);
+    }
+}
+
+void
+WifiMacQueueIndexTest::DoRun (void)
+{
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxSize (QueueSize (QueueSizeUnit::PACKETS, m_maxSize));
+  m_queue->SetMaxDelay (m_maxDelay);
+  m_blocked = Create<QosBlockedDestinations> ();
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      Simulator::Schedule (MicroSeconds (500 * i), &WifiMacQueueIndexTest::DoOperation, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -1715,6 +1953,7 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug2483TestCase, TestCase::QUICK); //Bug 2483
   AddTestCase (new Bug2831TestCase, TestCase::QUICK); //Bug 2831
   AddTestCase (new StaWifiMacScanningTestCase, TestCase::QUICK); //Bug 2399
+  AddTestCase (new WifiMacQueueIndexTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite; ///< the test suite
@@ -228,6 +228,94 @@ WifiOfdmMaskSlopesTestCase::DoRun (void)
 }
 
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test that the spectrum values shared by WifiSpectrumValueHelper are
+ * created once per set of parameters, and equal to the newly created ones.
+ */
+class WifiSharedSpectrumValueTestCase : public TestCase
+{
+public:
+  WifiSharedSpectrumValueTestCase ();
+  virtual ~WifiSharedSpectrumValueTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check that a shared spectrum value is equal to a newly created one
+   *
+   * \param shared the shared spectrum value
+   * \param created the newly created spectrum value
+   * \param name the name of the spectrum value
+   */
+  void CheckEqual (Ptr<const SpectrumValue> shared, Ptr<const SpectrumValue> created, std::string name);
+};
+
+WifiSharedSpectrumValueTestCase::WifiSharedSpectrumValueTestCase ()
+  : TestCase ("Shared spectrum values")
+{
+}
+
+WifiSharedSpectrumValueTestCase::~WifiSharedSpectrumValueTestCase ()
+{
+}
+
+void
+WifiSharedSpectrumValueTestCase::CheckEqual (Ptr<const SpectrumValue> shared, Ptr<const SpectrumValue> created, std::string name)
+{
+  NS_TEST_ASSERT_MSG_EQ (shared->GetSpectrumModelUid (), created->GetSpectrumModelUid (), "Wrong spectrum model of " << name);
+  Values::const_iterator it = created->ConstValuesBegin ();
+  for (Values::const_iterator sit = shared->ConstValuesBegin (); sit != shared->ConstValuesEnd (); ++sit, ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (*sit, *it, "Wrong value of " << name);
+    }
+}
+
+void
+WifiSharedSpectrumValueTestCase::DoRun (void)
+{
+  double txPowerW = 0.1;
+  Ptr<const SpectrumValue> ofdm = WifiSpectrumValueHelper::GetOfdmTxPowerSpectralDensity (5180, 20, txPowerW, 20);
+  NS_TEST_ASSERT_MSG_EQ (ofdm, WifiSpectrumValueHelper::GetOfdmTxPowerSpectralDensity (5180, 20, txPowerW, 20),
+                         "OFDM PSD not shared");
+  NS_TEST_ASSERT_MSG_NE (ofdm, WifiSpectrumValueHelper::GetOfdmTxPowerSpectralDensity (5180, 20, 2 * txPowerW, 20),
+                         "OFDM PSD shared by different powers");
+  NS_TEST_ASSERT_MSG_NE (ofdm, WifiSpectrumValueHelper::GetOfdmTxPowerSpectralDensity (5200, 20, txPowerW, 20),
+                         "OFDM PSD shared by different channels");
+  CheckEqual (ofdm, WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (5180, 20, txPowerW, 20), "OFDM PSD");
+
+  Ptr<const SpectrumValue> ht = WifiSpectrumValueHelper::GetHtOfdmTxPowerSpectralDensity (5180, 20, txPowerW, 20);
+  NS_TEST_ASSERT_MSG_NE (ofdm, ht, "OFDM PSD shared with HT");
+  NS_TEST_ASSERT_MSG_EQ (ht, WifiSpectrumValueHelper::GetHtOfdmTxPowerSpectralDensity (5180, 20, txPowerW, 20),
+                         "HT PSD not shared");
+  CheckEqual (ht, WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (5180, 20, txPowerW, 20), "HT PSD");
+
+  Ptr<const SpectrumValue> he = WifiSpectrumValueHelper::GetHeOfdmTxPowerSpectralDensity (5210, 80, txPowerW, 80);
+  NS_TEST_ASSERT_MSG_EQ (he, WifiSpectrumValueHelper::GetHeOfdmTxPowerSpectralDensity (5210, 80, txPowerW, 80),
+                         "HE PSD not shared");
+  CheckEqual (he, WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (5210, 80, txPowerW, 80), "HE PSD");
+
+  Ptr<const SpectrumValue> dsss = WifiSpectrumValueHelper::GetDsssTxPowerSpectralDensity (2412, txPowerW, 10);
+  NS_TEST_ASSERT_MSG_EQ (dsss, WifiSpectrumValueHelper::GetDsssTxPowerSpectralDensity (2412, txPowerW, 10),
+                         "DSSS PSD not shared");
+  CheckEqual (dsss, WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (2412, txPowerW, 10), "DSSS PSD");
+
+  Ptr<const SpectrumValue> noise = WifiSpectrumValueHelper::GetNoisePowerSpectralDensity (5180, 20, 312500, 7, 20);
+  NS_TEST_ASSERT_MSG_EQ (noise, WifiSpectrumValueHelper::GetNoisePowerSpectralDensity (5180, 20, 312500, 7, 20),
+                         "Noise PSD not shared");
+  NS_TEST_ASSERT_MSG_NE (noise, WifiSpectrumValueHelper::GetNoisePowerSpectralDensity (5180, 20, 312500, 5, 20),
+                         "Noise PSD shared by different noise figures");
+  CheckEqual (noise, WifiSpectrumValueHelper::CreateNoisePowerSpectralDensity (5180, 20, 312500, 7, 20), "noise PSD");
+
+  Ptr<const SpectrumValue> filter = WifiSpectrumValueHelper::GetRfFilter (5180, 20, 312500, 20);
+  NS_TEST_ASSERT_MSG_EQ (filter, WifiSpectrumValueHelper::GetRfFilter (5180, 20, 312500, 20), "RF filter not shared");
+  NS_TEST_ASSERT_MSG_NE (filter, WifiSpectrumValueHelper::GetRfFilter (5180, 20, 78125, 20),
+                         "RF filter shared by different band widths");
+  CheckEqual (filter, WifiSpectrumValueHelper::CreateRfFilter (5180, 20, 312500, 20), "RF filter");
+}
+
 
 /**
  * \ingroup wifi-test
@@ -711,4 +799,5 @@ WifiTransmitMaskTestSuite::WifiTransmitMaskTestSuite ()
                                                maskSlopesLeft, maskSlopesRight, tol),
                TestCase::QUICK);
 
+  AddTestCase (new WifiSharedSpectrumValueTestCase, TestCase::QUICK);
 }
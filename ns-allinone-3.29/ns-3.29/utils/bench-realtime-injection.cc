@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the rate at which RealtimeSimulatorImpl accepts packets
+// injected from other threads, as done by the reader threads of the
+// emulated net devices.
+//
+// Each of --threads injecting threads copies a frame of --size bytes
+// into a buffer allocated on the heap and schedules its reception with
+// ScheduleWithContext, --events times in a tight loop, like the reader
+// threads of FdNetDevice and TapBridge.  The reception handler creates
+// the packet from the buffer in the simulation thread, frees the buffer
+// and delivers the packet; the simulation stops once all of them have
+// been delivered.
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <sys/time.h>
+
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+
+using namespace ns3;
+
+namespace {
+
+uint64_t g_expected = 0;   //!< Number of packets to deliver
+uint64_t g_received = 0;   //!< Number of packets delivered
+uint32_t g_events = 0;     //!< Packets injected by each thread
+uint32_t g_size = 0;       //!< Size of the packets
+std::vector<uint64_t> g_bytes;  //!< Bytes delivered per injecting thread
+
+/**
+ * Packet handler, in the simulation thread.
+ * \param [in] thread The index of the injecting thread.
+ * \param [in] packet The packet.
+ */
+void
+Deliver (uint32_t thread, Ptr<Packet> packet)
+{
+  g_bytes[thread] += packet->GetSize ();
+  if (++g_received == g_expected)
+    {
+      Simulator::Stop ();
+    }
+}
+
+/**
+ * Reception event handler: create the packet in the simulation thread,
+ * as the emulated net devices do.
+ * \param [in] thread The index of the injecting thread.
+ * \param [in] buf The frame, allocated by the injecting thread.
+ * \param [in] len The size of the frame.
+ */
+void
+Receive (uint32_t thread, uint8_t *buf, ssize_t len)
+{
+  Ptr<Packet> packet = Create<Packet> (buf, len);
+  std::free (buf);
+  Deliver (thread, packet);
+}
+
+/**
+ * Body of an injecting thread.
+ * \param [in] thread The thread index.
+ */
+void
+Inject (uint32_t thread)
+{
+  std::vector<uint8_t> frame (g_size, static_cast<uint8_t> (thread));
+  for (uint32_t i = 0; i < g_events; ++i)
+    {
+      uint8_t *buf = static_cast<uint8_t *> (std::malloc (g_size));
+      std::memcpy (buf, &frame[0], g_size);
+      Simulator::ScheduleWithContext (thread, Seconds (0),
+                                      MakeEvent (&Receive, thread, buf, static_cast<ssize_t> (g_size)));
+    }
+}
+
+/**
+ * Start the injecting threads.
+ * \param [in,out] threads The threads.
+ */
+void
+Start (std::vector<Ptr<SystemThread> > *threads)
+{
+  for (uint32_t i = 0; i < threads->size (); ++i)
+    {
+      (*threads)[i]->Start ();
+    }
+}
+
+/**
+ * Get the wall-clock time.
+ * \return The time, in seconds.
+ */
+double
+GetWallTime (void)
+{
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+} // unnamed namespace
+
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nThreads = 4;
+  g_events = 100000;
+  g_size = 1500;
+
+  CommandLine cmd;
+  cmd.AddValue ("threads", "number of injecting threads", nThreads);
+  cmd.AddValue ("events", "number of packets injected by each thread", g_events);
+  cmd.AddValue ("size", "size of the packets in bytes", g_size);
+  cmd.Parse (argc, argv);
+
+  GlobalValue::Bind ("SimulatorImplementationType",
+                     StringValue ("ns3::RealtimeSimulatorImpl"));
+  Config::SetDefault ("ns3::RealtimeSimulatorImpl::SynchronizationMode",
+                      StringValue ("BestEffort"));
+
+  g_expected = static_cast<uint64_t> (nThreads) * g_events;
+  g_bytes.assign (nThreads, 0);
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < nThreads; ++i)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&Inject, i)));
+    }
+  Simulator::Schedule (Seconds (0), &Start, &threads);
+
+  double start = GetWallTime ();
+  Simulator::Run ();
+  double elapsed = GetWallTime () - start;
+  for (uint32_t i = 0; i < nThreads; ++i)
+    {
+      threads[i]->Join ();
+    }
+  Simulator::Destroy ();
+
+  for (uint32_t i = 0; i < nThreads; ++i)
+    {
+      if (g_bytes[i] != static_cast<uint64_t> (g_events) * g_size)
+        {
+          std::cerr << "thread " << i << " delivered " << g_bytes[i] << " bytes" << std::endl;
+          return 1;
+        }
+    }
+  std::cout << "threads " << nThreads
+            << " packets " << g_received
+            << " seconds " << elapsed
+            << " packets/s " << g_received / elapsed
+            << std::endl;
+  return 0;
+}